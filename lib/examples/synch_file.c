@@ -198,8 +198,11 @@ int main(int argc, char** argv)
       N_id_2           = force_N_id_2;
       peak_pos[N_id_2] = srsran_pss_find_pss(&pss[N_id_2], input, &peak_value[N_id_2]);
     } else {
+      // All the PSS objects share the sizes, transform the input only once
+      const cf_t* input_fft = srsran_pss_input_fft(&pss[0], input);
       for (N_id_2 = 0; N_id_2 < 3; N_id_2++) {
-        peak_pos[N_id_2] = srsran_pss_find_pss(&pss[N_id_2], input, &peak_value[N_id_2]);
+        peak_pos[N_id_2] = input_fft != NULL ? srsran_pss_find_pss_fft(&pss[N_id_2], input_fft, &peak_value[N_id_2])
+                                             : srsran_pss_find_pss(&pss[N_id_2], input, &peak_value[N_id_2]);
       }
       float max_value = -99999;
       N_id_2          = -1;
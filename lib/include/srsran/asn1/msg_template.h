@@ -0,0 +1,115 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSASN_MSG_TEMPLATE_H
+#define SRSASN_MSG_TEMPLATE_H
+
+#include "asn1_utils.h"
+#include <array>
+#include <vector>
+
+namespace asn1 {
+
+/**
+ * @brief Encoded message with variable fields that are rewritten in place.
+ *
+ * The message is packed once as reference. Variable fields (identities, counters, measurement results) are located by
+ * packing a probe that differs from the reference only in that field, or registered with their known bit offset. New
+ * instances are then produced by patching the fields into the cached encoding, without running the packer.
+ *
+ * Only fields whose encoded length does not depend on their value can be patched, e.g. fixed size bit and octet
+ * strings, constrained integers and enumerations. Fields are written MSB first, as in PER and NAS encodings.
+ */
+class msg_template
+{
+public:
+  static const uint32_t max_fields = 8;
+
+  /// Sets the reference encoding and removes all fields.
+  void set_reference(const uint8_t* buf, uint32_t nof_bytes);
+
+  /// Adds the field that differs between the reference and the probe. All bits of the field must differ, so the
+  /// reference should hold the field set to all zeros and the probe all ones. Returns the field index or -1 if the
+  /// encodings have different lengths, are equal or differ in more than 64 bits.
+  int learn_field(const uint8_t* probe, uint32_t nof_bytes);
+
+  /// Adds a field of nof_bits <= 64 at the given bit offset of the reference. Returns the field index or -1.
+  int add_field(uint32_t bit_offset, uint32_t nof_bits);
+
+  /// Writes the nof_bits least significant bits of value into the field.
+  void set_field(uint32_t idx, uint64_t value);
+
+  /// Copies the current encoding to out. Returns the number of bytes written, 0 if it does not fit.
+  uint32_t write(uint8_t* out, uint32_t max_bytes) const;
+
+  /// PER packs msg as reference.
+  template <class Msg>
+  SRSASN_CODE pack_reference(const Msg& msg)
+  {
+    std::vector<uint8_t> buf;
+    HANDLE_CODE(per_pack(msg, buf));
+    set_reference(buf.data(), buf.size());
+    return SRSASN_SUCCESS;
+  }
+
+  /// PER packs msg and adds the field where it differs from the reference, see learn_field().
+  template <class Msg>
+  int learn_field(const Msg& probe)
+  {
+    std::vector<uint8_t> buf;
+    if (per_pack(probe, buf) != SRSASN_SUCCESS) {
+      return -1;
+    }
+    return learn_field(buf.data(), buf.size());
+  }
+
+  bool           empty() const { return buffer.empty(); }
+  uint32_t       size() const { return buffer.size(); }
+  const uint8_t* data() const { return buffer.data(); }
+  uint32_t       nof_fields() const { return nof_fields_; }
+  uint32_t       field_offset(uint32_t idx) const { return fields[idx].offset; }
+  uint32_t       field_length(uint32_t idx) const { return fields[idx].nof_bits; }
+
+private:
+  struct field_t {
+    uint32_t offset;
+    uint32_t nof_bits;
+  };
+
+  template <class Msg>
+  static SRSASN_CODE per_pack(const Msg& msg, std::vector<uint8_t>& buf)
+  {
+    buf.resize(SRSRAN_MAX_BUFFER_SIZE_BYTES);
+    bit_ref bref(buf.data(), buf.size());
+    HANDLE_CODE(msg.pack(bref));
+    bref.align_bytes_zero();
+    buf.resize(bref.distance_bytes());
+    return SRSASN_SUCCESS;
+  }
+
+  std::vector<uint8_t>            buffer;
+  std::array<field_t, max_fields> fields      = {};
+  uint32_t                        nof_fields_ = 0;
+};
+
+} // namespace asn1
+
+#endif // SRSASN_MSG_TEMPLATE_H
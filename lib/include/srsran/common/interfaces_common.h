@@ -62,6 +62,7 @@ struct rf_args_t {
   std::string device_args;
   std::string time_adv_nsamples;
   std::string continuous_tx;
+  uint32_t    rx_ring_ms; // RX pump ring depth in ms, 0 receives in the rx_now caller thread
 
   std::array<rf_args_band_t, SRSRAN_MAX_CARRIERS> ch_rx_bands;
   std::array<rf_args_band_t, SRSRAN_MAX_CARRIERS> ch_tx_bands;
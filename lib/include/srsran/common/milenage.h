@@ -0,0 +1,111 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_MILENAGE_H
+#define SRSRAN_MILENAGE_H
+
+#include "srsran/common/ssl.h"
+#include <cstdint>
+
+namespace srsran {
+
+/// Inputs of one Milenage evaluation. On the network side SQN and AMF are given, on the USIM side they are recovered
+/// from AUTN, see milenage::compute_from_autn().
+struct milenage_input_t {
+  uint8_t rand[16];
+  uint8_t sqn[6];
+  uint8_t amf[2];
+};
+
+/// Outputs of functions f1, f1*, f2, f3, f4, f5 and f5* (TS 35.206) for one RAND.
+struct milenage_vector_t {
+  uint8_t mac_a[8];
+  uint8_t mac_s[8];
+  uint8_t res[8];
+  uint8_t ck[16];
+  uint8_t ik[16];
+  uint8_t ak[6];
+  uint8_t ak_star[6];
+};
+
+/**
+ * @brief Milenage for one subscriber, with the AES key schedule of K and OPc computed once.
+ *
+ * Every evaluation computes TEMP = E_K(RAND xor OPc) a single time and derives all of f1 to f5* from it, that is six
+ * block encryptions and no key expansion. With AES-NI the blocks of an evaluation, and those of different subscribers
+ * in a batch, are encrypted interleaved.
+ */
+class milenage
+{
+public:
+  milenage() { aes_init(&ctx); }
+  ~milenage() { aes_free(&ctx); }
+
+  /// The mbedtls context points into itself, copies expand the key again.
+  milenage(const milenage& other);
+  milenage& operator=(const milenage& other);
+
+  /// Sets K and OPc.
+  void set_k_opc(const uint8_t k[16], const uint8_t opc[16]);
+
+  /// Sets K and derives OPc from OP.
+  void set_k_op(const uint8_t k[16], const uint8_t op[16]);
+
+  const uint8_t* get_opc() const { return opc; }
+
+  /// Network side: computes all functions for the given RAND, SQN and AMF.
+  void compute(const milenage_input_t& in, milenage_vector_t& out) const;
+
+  /// USIM side: recovers SQN = AUTN[0..5] xor AK and AMF = AUTN[6..7], then computes all functions. The caller checks
+  /// out.mac_a against AUTN[8..15].
+  void compute_from_autn(const uint8_t rand[16], const uint8_t autn[16], milenage_vector_t& out, uint8_t sqn[6]) const;
+
+  /// Computes nof_vectors evaluations, the i-th with subscribers[i] and in[i]. A subscriber may appear several times.
+  static void compute_batch(const milenage* const*  subscribers,
+                            const milenage_input_t* in,
+                            milenage_vector_t*      out,
+                            uint32_t                nof_vectors);
+
+private:
+  static const uint32_t nof_rounds = 10;
+  static const uint32_t batch_size = 4;
+
+  /// Encrypts n blocks in place, block i with the key of subscribers[i].
+  static void encrypt_blocks(const milenage* const* subscribers, uint8_t (*blocks)[16], uint32_t n);
+
+  /// Computes n <= batch_size evaluations. When autn is given, SQN and AMF are taken from it instead of from in and SQN
+  /// is written to sqn.
+  static void compute_group(const milenage* const*  subscribers,
+                            const milenage_input_t* in,
+                            const uint8_t (*autn)[16],
+                            milenage_vector_t*      out,
+                            uint8_t (*sqn)[6],
+                            uint32_t                n);
+
+  alignas(16) uint8_t round_keys[(nof_rounds + 1) * 16] = {};
+  uint8_t             opc[16]                           = {};
+  uint8_t             k[16]                             = {};
+  aes_context         ctx                               = {};
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_MILENAGE_H
@@ -91,6 +91,20 @@ public:
     return false;
   }
 
+  //! Same as above, but the task and the internal tasks run with the given lock held. The wait is done unlocked.
+  template <typename Lockable>
+  bool run_next_task(Lockable& lockable)
+  {
+    srsran::move_task_t task{};
+    bool                ret = external_tasks.wait_pop(&task);
+    std::lock_guard<Lockable> lock(lockable);
+    if (ret) {
+      task();
+    }
+    run_all_internal_tasks();
+    return ret;
+  }
+
   //! Processes the next task in the multiqueue if it exists.
   void run_pending_tasks()
   {
@@ -78,6 +78,15 @@ typedef struct SRSRAN_API {
   /// Channel estimates, size coreset_sz
   cf_t* ce;
 
+  /// Channel estimates without the DMRS sub-carriers, (SRSRAN_NRE - 3) for every CORESET RB and symbol
+  cf_t* ce_data;
+
+  /// Pilots LSE power added for every CORESET RB, one vector for each possible symbol
+  float* rb_pwr[SRSRAN_CORESET_DURATION_MAX];
+
+  /// Conjugate products of adjacent pilots LSE, x[i + 1] * conj(x[i]), one vector for each possible symbol
+  cf_t* lse_diff[SRSRAN_CORESET_DURATION_MAX];
+
   /// Frequency domain smoothing filter
   float*   filter;
   uint32_t filter_len;
@@ -109,7 +118,8 @@ SRSRAN_API void srsran_dmrs_pdcch_estimator_free(srsran_dmrs_pdcch_estimator_t*
  * @brief Estimates the configured CORESET channel from the received PDCCH's DMRS.
  *
  * This function is designed to be called prior to the PDCCH blind decoding and shall be called only once for every
- * CORESET in every slot.
+ * CORESET in every slot. It also computes the per RB pilot statistics and the data RE channel estimates for the whole
+ * CORESET, so the candidate measurements and extraction only gather them.
  *
  * The channel estimate measurements are performed at PDCCH candidate level through the function
  * srsran_dmrs_pdcch_estimator_measure.
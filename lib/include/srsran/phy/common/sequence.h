@@ -53,6 +53,12 @@ srsran_sequence_state_apply_c(srsran_sequence_state_t* s, const int8_t* in, int8
 SRSRAN_API
 void srsran_sequence_state_apply_bit(srsran_sequence_state_t* s, const uint8_t* in, uint8_t* out, uint32_t length);
 
+/**
+ * @brief Advances the sequence state by length chips. Long advances jump ahead with precomputed LFSR transition
+ * matrices, so the cost grows with the logarithm of the length.
+ * @param s Sequence state
+ * @param length Number of chips to skip
+ */
 SRSRAN_API void srsran_sequence_state_advance(srsran_sequence_state_t* s, uint32_t length);
 
 typedef struct SRSRAN_API {
@@ -83,6 +89,84 @@ SRSRAN_API void srsran_sequence_apply_packed(const uint8_t* in, uint8_t* out, ui
 
 SRSRAN_API void srsran_sequence_apply_bit(const uint8_t* in, uint8_t* out, uint32_t length, uint32_t seed);
 
+/**
+ * Default number of sequences kept by a scrambling sequence cache
+ */
+#define SRSRAN_SEQUENCE_CACHE_DEFAULT_NOF_ENTRIES 16
+
+/**
+ * @brief Cached packed sequence
+ */
+typedef struct SRSRAN_API {
+  uint32_t c_init;    ///< Sequence seed
+  uint32_t len;       ///< Generated length in bits, 0 if the entry is empty
+  uint32_t max_len;   ///< Allocated length in bits
+  uint64_t last_used; ///< Cache clock value of the last access
+  uint8_t* c_packed;  ///< Packed sequence, first chip in the MSB
+} srsran_sequence_cache_entry_t;
+
+/**
+ * @brief Least recently used cache of packed scrambling sequences keyed by seed and length. An entry holding a longer
+ * sequence for the same seed serves shorter requests, since they are prefixes of it.
+ */
+typedef struct SRSRAN_API {
+  srsran_sequence_cache_entry_t* entries;
+  uint32_t                       nof_entries;
+  uint64_t                       clock;
+  uint64_t                       nof_hits;
+  uint64_t                       nof_misses;
+} srsran_sequence_cache_t;
+
+/**
+ * @brief Initialises a sequence cache, sequence buffers are allocated on demand
+ * @param q Sequence cache object
+ * @param nof_entries Maximum number of cached sequences
+ * @return SRSRAN_SUCCESS if successful, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_sequence_cache_init(srsran_sequence_cache_t* q, uint32_t nof_entries);
+
+SRSRAN_API void srsran_sequence_cache_free(srsran_sequence_cache_t* q);
+
+/**
+ * @brief Gets the packed sequence for a seed, generating it if it is not cached
+ * @param q Sequence cache object
+ * @param seed Sequence seed (c_init)
+ * @param length Number of chips
+ * @return Pointer to at least length packed chips, NULL if length is zero or the sequence could not be allocated
+ */
+SRSRAN_API const uint8_t* srsran_sequence_cache_get(srsran_sequence_cache_t* q, uint32_t seed, uint32_t length);
+
+/**
+ * @brief Cached counterparts of srsran_sequence_apply_*, applying the packed sequence in a single pass. They fall back
+ * to generating the sequence if the cache cannot allocate it.
+ */
+SRSRAN_API void
+srsran_sequence_cache_apply_f(srsran_sequence_cache_t* q, const float* in, float* out, uint32_t length, uint32_t seed);
+
+SRSRAN_API void srsran_sequence_cache_apply_s(srsran_sequence_cache_t* q,
+                                              const int16_t*           in,
+                                              int16_t*                 out,
+                                              uint32_t                 length,
+                                              uint32_t                 seed);
+
+SRSRAN_API void srsran_sequence_cache_apply_c(srsran_sequence_cache_t* q,
+                                              const int8_t*            in,
+                                              int8_t*                  out,
+                                              uint32_t                 length,
+                                              uint32_t                 seed);
+
+SRSRAN_API void srsran_sequence_cache_apply_packed(srsran_sequence_cache_t* q,
+                                                   const uint8_t*           in,
+                                                   uint8_t*                 out,
+                                                   uint32_t                 length,
+                                                   uint32_t                 seed);
+
+SRSRAN_API void srsran_sequence_cache_apply_bit(srsran_sequence_cache_t* q,
+                                                const uint8_t*           in,
+                                                uint8_t*                 out,
+                                                uint32_t                 length,
+                                                uint32_t                 seed);
+
 SRSRAN_API int srsran_sequence_pbch(srsran_sequence_t* seq, srsran_cp_t cp, uint32_t cell_id);
 
 SRSRAN_API int srsran_sequence_pcfich(srsran_sequence_t* seq, uint32_t nslot, uint32_t cell_id);
@@ -41,6 +41,9 @@
  *
  * @remark Implemented as defined in TS 36.211 section 5.5.1 Generation of the reference signal sequence
  *
+ * @remark Generated sequences are kept in a process-wide cache by length, u, v and alpha, so a sequence is only computed
+ * the first time it is requested
+ *
  * @param[in] u Group number {0,1,...29}
  * @param[in] v Base sequence
  * @param[in] alpha Phase shift
@@ -55,6 +58,9 @@ SRSRAN_API int srsran_zc_sequence_generate_lte(uint32_t u, uint32_t v, float alp
  *
  * @remark Implemented as defined in TS 38.211 section 5.2.2 Low-PAPR sequence generation
  *
+ * @remark Generated sequences are kept in a process-wide cache by length, u, v and alpha, so a sequence is only computed
+ * the first time it is requested
+ *
  * @param u Group number {0,1,...29}
  * @param v base sequence
  * @param alpha Phase shift
@@ -66,6 +72,17 @@ SRSRAN_API int srsran_zc_sequence_generate_lte(uint32_t u, uint32_t v, float alp
 SRSRAN_API int
 srsran_zc_sequence_generate_nr(uint32_t u, uint32_t v, float alpha, uint32_t m, uint32_t delta, cf_t* sequence);
 
+/**
+ * @brief Gets the table of 2N_zc-th roots of unity exp(-j*pi*k/N_zc), for k=0..2N_zc-1
+ *
+ * @remark The table is generated on first use and shared process-wide. It is never modified nor freed, so it can be
+ * read from any thread without locking
+ *
+ * @param N_zc ZC sequence length
+ * @return Pointer to the table if N_zc is valid, NULL otherwise
+ */
+SRSRAN_API const cf_t* srsran_zc_sequence_roots(uint32_t N_zc);
+
 /**
  * @brief Low-PAPR ZC sequence look-up-table
  */
@@ -36,6 +36,11 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+/**
+ * Number of folding distances used by the carry-less multiply kernels
+ */
+#define SRSRAN_CRC_CLMUL_NOF_K 7
+
 typedef struct SRSRAN_API {
   uint64_t table[256];
   int      polynom;
@@ -44,12 +49,26 @@ typedef struct SRSRAN_API {
   uint64_t crcmask;
   uint64_t crchighbit;
   uint32_t srsran_crc_out;
+
+  // Carry-less multiply (PCLMULQDQ) folding, selected at init time from the CPU features
+  bool     clmul;                                ///< Use the 128-bit folding kernels
+  bool     clmul512;                             ///< Use the AVX-512 (VPCLMULQDQ) folding kernel for long inputs
+  uint64_t clmul_k[SRSRAN_CRC_CLMUL_NOF_K][2];   ///< {x^(128n+64), x^(128n)} mod polynom, n = 1, 2, 3, 4, 8, 12, 16
+  uint64_t clmul_x64;                            ///< x^64 mod polynom
 } srsran_crc_t;
 
 SRSRAN_API int srsran_crc_init(srsran_crc_t* h, uint32_t srsran_crc_poly, int srsran_crc_order);
 
 SRSRAN_API int srsran_crc_set_init(srsran_crc_t* h, uint64_t init_value);
 
+/**
+ * @brief Enables or disables the carry-less multiply kernels, for instance to compare them against the table lookup.
+ * Enabling has no effect if the CPU does not support PCLMULQDQ.
+ * @param h CRC object
+ * @param enable Set to true to use the folding kernels whenever the input is long enough
+ */
+SRSRAN_API void srsran_crc_set_clmul(srsran_crc_t* h, bool enable);
+
 SRSRAN_API uint32_t srsran_crc_attach(srsran_crc_t* h, uint8_t* data, int len);
 
 SRSRAN_API uint32_t srsran_crc_attach_byte(srsran_crc_t* h, uint8_t* data, int len);
@@ -61,6 +61,8 @@ typedef struct SRSRAN_API {
   srsran_polar_rm_t      rm;
   srsran_carrier_nr_t    carrier;
   srsran_coreset_t       coreset;
+  uint32_t               coreset_bw;                      // Number of CORESET RB
+  uint32_t               coreset_rb_k0[SRSRAN_MAX_PRB_NR]; // First grid sub-carrier of every CORESET RB
   srsran_crc_t           crc24c;
   uint8_t*               c;         // Message bits with attached CRC
   uint8_t*               d;         // encoded bits
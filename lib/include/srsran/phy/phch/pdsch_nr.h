@@ -54,20 +54,21 @@ typedef struct SRSRAN_API {
  * @brief PDSCH NR object
  */
 typedef struct SRSRAN_API {
-  uint32_t             max_prb;                         ///< Maximum number of allocated prb
-  uint32_t             max_layers;                      ///< Maximum number of allocated layers
-  uint32_t             max_cw;                          ///< Maximum number of allocated code words
-  srsran_carrier_nr_t  carrier;                         ///< NR carrier configuration
-  srsran_sch_nr_t      sch;                             ///< SCH Encoder/Decoder Object
-  uint8_t*             b[SRSRAN_MAX_CODEWORDS];         ///< SCH Encoded and scrambled data
-  cf_t*                d[SRSRAN_MAX_CODEWORDS];         ///< PDSCH modulated bits
-  cf_t*                x[SRSRAN_MAX_LAYERS_NR];         ///< PDSCH modulated bits
-  srsran_modem_table_t modem_tables[SRSRAN_MOD_NITEMS]; ///< Modulator tables
-  srsran_evm_buffer_t* evm_buffer;
-  bool                 meas_time_en;
-  uint32_t             meas_time_us;
-  srsran_re_pattern_t  dmrs_re_pattern;
-  uint32_t             nof_rvd_re;
+  uint32_t                max_prb;                         ///< Maximum number of allocated prb
+  uint32_t                max_layers;                      ///< Maximum number of allocated layers
+  uint32_t                max_cw;                          ///< Maximum number of allocated code words
+  srsran_carrier_nr_t     carrier;                         ///< NR carrier configuration
+  srsran_sch_nr_t         sch;                             ///< SCH Encoder/Decoder Object
+  uint8_t*                b[SRSRAN_MAX_CODEWORDS];         ///< SCH Encoded and scrambled data
+  cf_t*                   d[SRSRAN_MAX_CODEWORDS];         ///< PDSCH modulated bits
+  cf_t*                   x[SRSRAN_MAX_LAYERS_NR];         ///< PDSCH modulated bits
+  srsran_modem_table_t    modem_tables[SRSRAN_MOD_NITEMS]; ///< Modulator tables
+  srsran_evm_buffer_t*    evm_buffer;
+  bool                    meas_time_en;
+  uint32_t                meas_time_us;
+  srsran_re_pattern_t     dmrs_re_pattern;
+  srsran_sequence_cache_t scrambling; ///< Scrambling sequences, the seed does not depend on the slot
+  uint32_t                nof_rvd_re;
 } srsran_pdsch_nr_t;
 
 /**
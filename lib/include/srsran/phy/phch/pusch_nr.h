@@ -42,39 +42,43 @@ typedef struct SRSRAN_API {
   bool                 measure_time;
   uint32_t             max_layers;
   uint32_t             max_prb;
+  uint32_t             nof_encoder_threads; ///< UL-SCH code block encoder helper threads, 0 for none
 } srsran_pusch_nr_args_t;
 
 /**
  * @brief PDSCH NR object
  */
 typedef struct SRSRAN_API {
-  uint32_t             max_prb;                         ///< Maximum number of allocated prb
-  uint32_t             max_layers;                      ///< Maximum number of allocated layers
-  uint32_t             max_cw;                          ///< Maximum number of allocated code words
-  srsran_carrier_nr_t  carrier;                         ///< NR carrier configuration
-  srsran_sch_nr_t      sch;                             ///< SCH Encoder/Decoder Object
-  srsran_uci_nr_t      uci;                             ///< UCI Encoder/Decoder Object
-  uint8_t*             b[SRSRAN_MAX_CODEWORDS];         ///< SCH Encoded and scrambled data
-  cf_t*                d[SRSRAN_MAX_CODEWORDS];         ///< PDSCH modulated bits
-  cf_t*                x[SRSRAN_MAX_LAYERS_NR];         ///< PDSCH modulated bits
-  srsran_modem_table_t modem_tables[SRSRAN_MOD_NITEMS]; ///< Modulator tables
-  srsran_evm_buffer_t* evm_buffer;
-  bool                 meas_time_en;
-  uint32_t             meas_time_us;
-  srsran_re_pattern_t  dmrs_re_pattern;
-  uint8_t*             g_ulsch;   ///< Temporal Encoded UL-SCH data
-  uint8_t*             g_ack;     ///< Temporal Encoded HARQ-ACK bits
-  uint8_t*             g_csi1;    ///< Temporal Encoded CSI part 1 bits
-  uint8_t*             g_csi2;    ///< Temporal Encoded CSI part 2 bits
-  uint32_t*            pos_ulsch; ///< Reserved resource elements for HARQ-ACK multiplexing position
-  uint32_t*            pos_ack;   ///< Reserved resource elements for HARQ-ACK multiplexing position
-  uint32_t*            pos_csi1;  ///< Reserved resource elements for CSI part 1 multiplexing position
-  uint32_t*            pos_csi2;  ///< Reserved resource elements for CSI part 1 multiplexing position
-  bool                 uci_mux;   ///< Set to true if PUSCH needs to multiplex UCI
-  uint32_t             G_ack;     ///< Number of encoded HARQ-ACK bits
-  uint32_t             G_csi1;    ///< Number of encoded CSI part 1 bits
-  uint32_t             G_csi2;    ///< Number of encoded CSI part 2 bits
-  uint32_t             G_ulsch;   ///< Number of encoded shared channel
+  uint32_t                max_prb;                         ///< Maximum number of allocated prb
+  uint32_t                max_layers;                      ///< Maximum number of allocated layers
+  uint32_t                max_cw;                          ///< Maximum number of allocated code words
+  srsran_carrier_nr_t     carrier;                         ///< NR carrier configuration
+  srsran_sch_nr_t         sch;                             ///< SCH Encoder/Decoder Object
+  srsran_uci_nr_t         uci;                             ///< UCI Encoder/Decoder Object
+  uint8_t*                b[SRSRAN_MAX_CODEWORDS];         ///< SCH Encoded and scrambled data
+  cf_t*                   d[SRSRAN_MAX_CODEWORDS];         ///< PDSCH modulated bits
+  cf_t*                   x[SRSRAN_MAX_LAYERS_NR];         ///< PDSCH modulated bits
+  srsran_modem_table_t    modem_tables[SRSRAN_MOD_NITEMS]; ///< Modulator tables
+  srsran_evm_buffer_t*    evm_buffer;
+  bool                    meas_time_en;
+  uint32_t                meas_time_us;
+  srsran_re_pattern_t     dmrs_re_pattern;
+  srsran_sequence_cache_t scrambling; ///< Scrambling sequences, the seed does not depend on the slot
+  uint8_t*                g_ulsch;    ///< Temporal Encoded UL-SCH data
+  uint8_t*                g_ack;      ///< Temporal Encoded HARQ-ACK bits
+  uint8_t*                g_csi1;     ///< Temporal Encoded CSI part 1 bits
+  uint8_t*                g_csi2;     ///< Temporal Encoded CSI part 2 bits
+  uint32_t*               pos_ulsch;  ///< Reserved resource elements for HARQ-ACK multiplexing position
+  uint32_t*               pos_ack;    ///< Reserved resource elements for HARQ-ACK multiplexing position
+  uint32_t*               pos_csi1;   ///< Reserved resource elements for CSI part 1 multiplexing position
+  uint32_t*               pos_csi2;   ///< Reserved resource elements for CSI part 1 multiplexing position
+  bool                    uci_mux;    ///< Set to true if PUSCH needs to multiplex UCI
+  uint32_t                G_ack;      ///< Number of encoded HARQ-ACK bits
+  uint32_t                G_csi1;     ///< Number of encoded CSI part 1 bits
+  uint32_t                G_csi2;     ///< Number of encoded CSI part 2 bits
+  uint32_t                G_ulsch;    ///< Number of encoded shared channel
+  uint32_t*               re_idx;     ///< Grid index of each PUSCH resource element, for the code block encoder
+  void*                   coworkers;  ///< Code block encoder helper threads, NULL if disabled
 } srsran_pusch_nr_t;
 
 /**
@@ -183,6 +183,54 @@ SRSRAN_API int srsran_ulsch_nr_encode(srsran_sch_nr_t*        q,
                                       const uint8_t*          data,
                                       uint8_t*                e_bits);
 
+/**
+ * @brief Checks the encoder and soft-buffer for an UL-SCH transport block, fills its code block segmentation and
+ * calculates the transport block CRC. Together with srsran_ulsch_nr_encode_cb it splits srsran_ulsch_nr_encode into
+ * independent code blocks.
+ * @param q SCH object
+ * @param sch_cfg Provides higher layers configuration
+ * @param tb Provides transport block configuration
+ * @param data Transport block data
+ * @param[out] cfg Code block segmentation and rate matching parameters
+ * @param[out] checksum_tb Transport block CRC
+ * @return SRSRAN_SUCCESS if successful, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_ulsch_nr_encode_prepare(srsran_sch_nr_t*         q,
+                                              const srsran_sch_cfg_t*  sch_cfg,
+                                              const srsran_sch_tb_t*   tb,
+                                              const uint8_t*           data,
+                                              srsran_sch_nr_tb_info_t* cfg,
+                                              uint32_t*                checksum_tb);
+
+/**
+ * @brief Encodes a single UL-SCH code block into the soft-buffer and rate matches it. Code blocks only share read-only
+ * data, so they can be encoded concurrently as long as each thread uses its own SCH object.
+ * @param q SCH object
+ * @param cfg Parameters given by srsran_ulsch_nr_encode_prepare
+ * @param tb Provides transport block configuration
+ * @param data Transport block data
+ * @param checksum_tb Transport block CRC given by srsran_ulsch_nr_encode_prepare
+ * @param r Code block index
+ * @param e_bits Destination of the E rate matched bits of the code block, see srsran_sch_nr_cb_offset
+ * @return SRSRAN_SUCCESS if successful, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_ulsch_nr_encode_cb(srsran_sch_nr_t*               q,
+                                         const srsran_sch_nr_tb_info_t* cfg,
+                                         const srsran_sch_tb_t*         tb,
+                                         const uint8_t*                 data,
+                                         uint32_t                       checksum_tb,
+                                         uint32_t                       r,
+                                         uint8_t*                       e_bits);
+
+/**
+ * @brief Gets the position of a code block within the rate matched codeword
+ * @param cfg Code block segmentation and rate matching parameters
+ * @param r Code block index
+ * @param[out] E Number of rate matched bits of the code block, 0 if it is not transmitted. Ignored if NULL
+ * @return Offset in bits of the code block rate matched bits
+ */
+SRSRAN_API uint32_t srsran_sch_nr_cb_offset(const srsran_sch_nr_tb_info_t* cfg, uint32_t r, uint32_t* E);
+
 SRSRAN_API int srsran_ulsch_nr_decode(srsran_sch_nr_t*        q,
                                       const srsran_sch_cfg_t* sch_cfg,
                                       const srsran_sch_tb_t*  tb,
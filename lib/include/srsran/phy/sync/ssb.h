@@ -60,6 +60,9 @@ typedef struct SRSRAN_API {
   bool                        enable_decode;      ///< Enables PBCH Decoder
   bool                        disable_polar_simd; ///< Disables polar encoder/decoder SIMD acceleration
   float                       pbch_dmrs_thr;      ///< NR-PBCH DMRS threshold for blind decoding, set to 0 for default
+  float                       pbch_dmrs_margin;   ///< PBCH DMRS margin relative to the best hypothesis, 0 for default
+  uint32_t                    pbch_max_decodes;   ///< Maximum number of PBCH hypotheses to decode, 0 for default (1)
+  float                       pss_prescreen_thr;  ///< CP autocorrelation pre-screen for the PSS search, 0 disables
 } srsran_ssb_args_t;
 
 /**
@@ -80,6 +83,14 @@ typedef struct SRSRAN_API {
   float                       scaling;        ///< IFFT scaling (used for modulation), set to 0 for default
 } srsran_ssb_cfg_t;
 
+/**
+ * @brief Describes the PSS search pre-screen metrics
+ */
+typedef struct SRSRAN_API {
+  uint64_t nof_windows; ///< Number of correlation windows screened
+  uint64_t nof_hits;    ///< Number of windows that passed the pre-screen and were correlated
+} srsran_ssb_prescreen_metrics_t;
+
 /**
  * @brief Describes SSB object
  */
@@ -113,11 +124,16 @@ typedef struct SRSRAN_API {
   srsran_pbch_nr_t  pbch;      ///< PBCH encoder and decoder
 
   /// Frequency/Time domain temporal data
-  cf_t* tmp_freq;                     ///< Temporal frequency domain buffer
-  cf_t* tmp_time;                     ///< Temporal time domain buffer
-  cf_t* tmp_corr;                     ///< Temporal correlation frequency domain buffer
-  cf_t* sf_buffer;                    ///< subframe buffer
-  cf_t* pss_seq[SRSRAN_NOF_NID_2_NR]; ///< Possible frequency domain PSS for find
+  cf_t*  tmp_freq;                     ///< Temporal frequency domain buffer
+  cf_t*  tmp_time;                     ///< Temporal time domain buffer
+  cf_t*  tmp_corr;                     ///< Temporal correlation frequency domain buffer
+  cf_t*  sf_buffer;                    ///< subframe buffer
+  cf_t*  pss_seq[SRSRAN_NOF_NID_2_NR]; ///< Possible frequency domain PSS for find
+  cf_t*  prescreen_prod;               ///< Pre-screen CP autocorrelation products
+  float* prescreen_pwr;                ///< Pre-screen CP and symbol tail power
+
+  /// Metrics
+  srsran_ssb_prescreen_metrics_t prescreen_metrics; ///< PSS search pre-screen metrics
 } srsran_ssb_t;
 
 /**
@@ -163,6 +179,13 @@ SRSRAN_API int srsran_ssb_set_cfg(srsran_ssb_t* q, const srsran_ssb_cfg_t* cfg);
  */
 SRSRAN_API int srsran_ssb_search(srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples, srsran_ssb_search_res_t* res);
 
+/**
+ * @brief Gets the PSS search pre-screen metrics accumulated since the last call and resets them
+ * @param q SSB object
+ * @param metrics Pre-screen metrics
+ */
+SRSRAN_API void srsran_ssb_get_prescreen_metrics(srsran_ssb_t* q, srsran_ssb_prescreen_metrics_t* metrics);
+
 /**
  * @brief Decides if the SSB object is configured and a given subframe is configured for SSB transmission
  * @param q SSB object
@@ -261,6 +284,28 @@ SRSRAN_API int srsran_ssb_csi_measure(srsran_ssb_t*                  q,
                                       const cf_t*                    in,
                                       srsran_csi_trs_measurements_t* meas);
 
+/**
+ * @brief Perform Channel State Information (CSI) measurement from an SSB at a known position, for example given by a
+ * previous srsran_ssb_csi_search(). It does not require the SSB transmission to be aligned with the input signal. The
+ * SSB is demodulated once and measured for every given Physical Cell Identifier
+ * @param q SSB object
+ * @param N_id Physical Cell Identifiers
+ * @param nof_N_id Number of Physical Cell Identifiers
+ * @param in Base-band signal buffer
+ * @param nof_samples Number of samples available in the buffer
+ * @param t_offset SSB start in samples, including the cyclic prefix of the first symbol
+ * @param meas SSB-based CSI measurement of each Physical Cell Identifier, the delay is given from the start of the
+ * buffer like in srsran_ssb_csi_search()
+ * @return SRSRAN_SUCCESS if the parameters are valid, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_ssb_csi_measure_offset(srsran_ssb_t*                  q,
+                                             const uint32_t*                N_id,
+                                             uint32_t                       nof_N_id,
+                                             const cf_t*                    in,
+                                             uint32_t                       nof_samples,
+                                             uint32_t                       t_offset,
+                                             srsran_csi_trs_measurements_t* meas);
+
 /**
  * @brief Find SSB signal in a given time domain subframe buffer
  * @param q SSB object
@@ -40,12 +40,34 @@
 #include "srsran/phy/phch/pucch_nr.h"
 #include "srsran/phy/phch/pusch_nr.h"
 
+/**
+ * @brief Number of PUCCH format 1 waveforms kept by the UE uplink, enough for one resource in every slot of a 15 kHz
+ * radio frame. Buffers are only allocated for the entries in use
+ */
+#define SRSRAN_UE_UL_NR_PUCCH_WAVEFORM_NOF_ENTRIES 10
+
 typedef struct SRSRAN_API {
   srsran_pusch_nr_args_t pusch;
   srsran_pucch_nr_args_t pucch;
   uint32_t               nof_max_prb;
 } srsran_ue_ul_nr_args_t;
 
+/**
+ * @brief Time-domain signal of a PUCCH format 1 resource in a slot of the radio frame. The OFDM modulation is linear,
+ * so the transmitted slot is the DMRS waveform plus the data waveform scaled by the modulated symbol d and no IFFT is
+ * required once both are known
+ */
+typedef struct SRSRAN_API {
+  bool                         valid;
+  uint32_t                     n_slot;   ///< Slot index within the radio frame
+  srsran_pucch_nr_common_cfg_t cfg;      ///< Common configuration the waveforms were generated with
+  srsran_pucch_nr_resource_t   resource; ///< Resource the waveforms were generated with
+  uint64_t                     last_use; ///< Least recently used entry gets replaced
+  cf_t*                        dmrs;     ///< DMRS waveform
+  cf_t*                        data;     ///< Data waveform for the symbol d_ref
+  cf_t                         d_ref;    ///< Modulated symbol of the data waveform
+} srsran_ue_ul_nr_pucch_waveform_t;
+
 typedef struct SRSRAN_API {
   uint32_t max_prb;
 
@@ -59,6 +81,9 @@ typedef struct SRSRAN_API {
   srsran_dmrs_sch_t dmrs;
 
   float freq_offset_hz;
+
+  srsran_ue_ul_nr_pucch_waveform_t pucch_waveforms[SRSRAN_UE_UL_NR_PUCCH_WAVEFORM_NOF_ENTRIES];
+  uint64_t                         pucch_waveform_count;
 } srsran_ue_ul_nr_t;
 
 SRSRAN_API int srsran_ue_ul_nr_init(srsran_ue_ul_nr_t* q, cf_t* output, const srsran_ue_ul_nr_args_t* args);
@@ -30,6 +30,7 @@
 #ifndef SRSRAN_BIT_H
 #define SRSRAN_BIT_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -39,18 +40,38 @@
 extern "C" {
 #endif
 
+/**
+ * Bit interleaver. The permutation is kept per output bit for the byte-wise gather, and compiled into a byte-gather
+ * plus bit-test program for any output offset and the AVX-512 VBMI kernel. The program produces output bits in groups
+ * of 64: lane k of group g gathers the input byte holding bit interleaver[64 * g + 63 - k] and tests it against its
+ * bit mask, so the lane results read as a 64-bit word are the output bits, first bit in the MSB.
+ */
 typedef struct {
   uint32_t  nof_bits;
   uint16_t* interleaver;
-  uint16_t* byte_idx;
-  uint8_t*  bit_mask;
-  uint8_t   n_128;
+  uint16_t* byte_idx;   ///< Input byte of each output bit
+  uint8_t*  bit_mask;   ///< Input bit mask of each output bit
+  uint32_t  nof_groups; ///< Number of 64-bit output groups, the last one may be partial
+  uint16_t* lane_idx;   ///< Input byte of each lane
+  uint8_t*  lane_mask;  ///< Input bit mask of each lane
+  uint8_t*  byte_lo;    ///< Input byte of each lane within its 128-byte window, for the AVX-512 VBMI kernel
+  uint8_t*  byte_win;   ///< 128-byte window of the input byte of each lane, for the AVX-512 VBMI kernel
+  uint32_t  nof_bytes;  ///< Number of input bytes read
+  bool      vbmi;       ///< Use the AVX-512 VBMI kernel
 } srsran_bit_interleaver_t;
 
 SRSRAN_API void srsran_bit_interleaver_init(srsran_bit_interleaver_t* q, uint16_t* interleaver, uint32_t nof_bits);
 
 SRSRAN_API void srsran_bit_interleaver_free(srsran_bit_interleaver_t* q);
 
+/**
+ * @brief Interleaves packed bits, output bit j + w_offset takes input bit interleaver[j]. Bits of output that are not
+ * written, before w_offset and after the last bit, are kept.
+ * @param q Interleaver object
+ * @param input Packed input bits
+ * @param output Packed output bits
+ * @param w_offset Output bit offset
+ */
 SRSRAN_API void
 srsran_bit_interleaver_run(srsran_bit_interleaver_t* q, uint8_t* input, uint8_t* output, uint16_t w_offset);
 
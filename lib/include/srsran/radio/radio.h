@@ -31,6 +31,7 @@
 #include "srsran/srslog/srslog.h"
 #include "srsran/srsran.h"
 
+#include <condition_variable>
 #include <list>
 #include <string>
 
@@ -112,6 +113,27 @@ private:
   std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS> decimators    = {};
   std::atomic<bool> decimator_busy = {false}; ///< Indicates the decimator is changing the rate
 
+  /// RX pump ring slot, one block of decimated samples and the timestamp of its first sample for every device
+  struct rx_ring_slot_t {
+    std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS> samples;
+    rf_timestamp_t                                     time;
+    uint32_t                                           nof_samples = 0;
+    uint32_t                                           epoch       = 0;
+    double                                             srate_hz    = 0.0;
+  };
+  std::vector<rx_ring_slot_t>                        rx_ring;
+  std::atomic<uint32_t>                              rx_ring_wr        = {0}; ///< Slots written, only the pump stores
+  std::atomic<uint32_t>                              rx_ring_rd        = {0}; ///< Slots read, only rx_now stores
+  uint32_t                                           rx_ring_offset    = 0;   ///< Samples already read from next slot
+  std::atomic<uint32_t>                              rx_ring_max_depth = {0}; ///< Peak number of slots in the ring
+  std::atomic<uint32_t> rx_epoch = {0}; ///< Increments on every Rx rate or frequency change, older slots are dropped
+  std::mutex                                         rx_ring_mutex;
+  std::condition_variable                            rx_ring_cvar;
+  std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS> rx_pump_buffer;
+  pthread_t                                          rx_pump_thread  = {};
+  bool                                               rx_pump_started = false;
+  std::atomic<bool>                                  rx_pump_running = {false};
+
   rf_timestamp_t    end_of_burst_time = {};
   std::atomic<bool> is_start_of_burst{false};
   uint32_t          tx_adv_nsamples    = 0;
@@ -137,6 +159,7 @@ private:
                                                             ///< buffers
   constexpr static double tx_max_gap_zeros = 4e-3; ///< Maximum transmission gap to fill with zeros, otherwise the burst
                                                    ///< shall be stopped
+  constexpr static int rx_pump_prio = 0; ///< Real-time priority offset of the RX pump thread
 
   // Define default values for known radios
   constexpr static int    uhd_default_tx_adv_samples    = 98;
@@ -209,6 +232,34 @@ private:
    */
   bool rx_dev(const uint32_t& device_idx, const rf_buffer_interface& buffer, srsran_timestamp_t* rxd_time);
 
+  /**
+   * Helper methods for the RX pump. When rf_args_t::rx_ring_ms is set, a dedicated thread receives and decimates blocks
+   * of up to 1 ms into a single-producer single-consumer ring and rx_now only copies samples out of it, so stalls in
+   * the caller thread are absorbed by the ring instead of overflowing the driver.
+   */
+  bool         rx_pump_start();
+  void         rx_pump_stop();
+  void         rx_pump_run();
+  static void* rx_pump_entry(void* arg);
+
+  /**
+   * Receives one block from all devices and decimates it into the given slot
+   *
+   * @param slot Destination slot, nullptr to receive and discard the block
+   * @param valid Set to true if the slot holds a block at the current rate (write only)
+   * @return it returns true if the reception was successful, otherwise it returns false
+   */
+  bool rx_pump_block(rx_ring_slot_t* slot, bool& valid);
+
+  /**
+   * Reads the requested number of samples from the RX pump ring, waiting for the pump if the ring runs empty
+   *
+   * @param buffer Common receive buffers
+   * @param rxd_time Receive time of the first sample (write only)
+   * @return it returns true if the samples were read, false if the pump stopped
+   */
+  bool rx_ring_read(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time);
+
   /**
    * Helper method for mapping logical channels into physical radio buffers.
    *
@@ -28,6 +28,9 @@ typedef struct {
   uint32_t rf_o;
   uint32_t rf_u;
   uint32_t rf_l;
+  uint32_t rf_ring_o;     ///< Blocks dropped by the RX pump because the ring was full
+  uint32_t rf_ring_depth; ///< Peak RX ring occupancy in blocks since the last report
+  uint32_t rf_ring_sz;    ///< RX ring capacity in blocks, 0 if the RX pump is disabled
   bool     rf_error;
 } rf_metrics_t;
 
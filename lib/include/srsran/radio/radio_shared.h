@@ -0,0 +1,173 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_RADIO_SHARED_H
+#define SRSRAN_RADIO_SHARED_H
+
+#include "srsran/radio/radio.h"
+
+#include <condition_variable>
+#include <memory>
+#include <vector>
+
+namespace srsran {
+
+/**
+ * One radio shared by several UE instances in the same process
+ *
+ * A pump thread receives blocks of 1 ms at the fixed RF sampling rate into a ring that every port reads with its own
+ * cursor, so each UE keeps its own synchronization and its own decimation. Uplink samples of all ports are summed by
+ * timestamp into a transmit accumulator, which the pump sends to the radio a configurable lead time ahead of the last
+ * received block. Samples a port transmits after their block was sent are dropped and counted as late.
+ *
+ * Ports never overwrite shared radio state except frequencies and gains, which are expected to be the same for all
+ * the UEs camping on one cell.
+ */
+class radio_shared : public phy_interface_radio
+{
+public:
+  class port : public radio_interface_phy, public radio_base
+  {
+  public:
+    port(radio_shared& parent_, uint32_t idx_);
+    ~port();
+
+    std::string get_type() override { return "shared"; }
+    int         init(const rf_args_t& args_, phy_interface_radio* phy_) override;
+    void        stop() override;
+    bool        get_metrics(rf_metrics_t* metrics) override;
+
+    // radio_interface_phy
+    void              tx_end() override {}
+    bool              tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_time) override;
+    bool              rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time) override;
+    void              set_tx_freq(const uint32_t& carrier_idx, const double& freq) override;
+    void              set_rx_freq(const uint32_t& carrier_idx, const double& freq) override;
+    void              release_freq(const uint32_t& carrier_idx) override {}
+    void              set_tx_gain(const float& gain) override;
+    void              set_rx_gain_th(const float& gain) override;
+    void              set_rx_gain(const float& gain) override;
+    void              set_tx_srate(const double& srate) override;
+    void              set_rx_srate(const double& srate) override;
+    /// Forwards the device alignment offset to the shared radio. The offset applies to all ports, not per UE.
+    void              set_channel_rx_offset(uint32_t ch, int32_t offset_samples) override;
+    double            get_freq_offset() override;
+    float             get_rx_gain() override;
+    bool              is_continuous_tx() override;
+    bool              get_is_start_of_burst() override;
+    bool              is_init() override;
+    void              reset() override;
+    srsran_rf_info_t* get_info() override;
+
+  private:
+    friend class radio_shared;
+
+    radio_shared&                     parent;
+    uint32_t                          idx;
+    std::atomic<phy_interface_radio*> phy = {nullptr};
+    srslog::basic_logger&             logger;
+
+    uint64_t rd_blk    = 0; ///< Next ring block to read
+    uint32_t rd_offset = 0; ///< Samples already read from the next block
+    bool     rd_sync   = false; ///< Set once the cursor points to the newest block
+
+    std::mutex                                              rx_mutex;
+    std::mutex                                              tx_mutex;
+    std::mutex                                              metrics_mutex;
+    rf_metrics_t                                            metrics = {};
+    std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS> decimators    = {};
+    std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS> interpolators = {};
+    std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS>      rx_buffer;
+    std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS>      tx_buffer;
+
+    bool read_ring(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time);
+  };
+
+  radio_shared();
+  ~radio_shared();
+
+  /**
+   * Opens the radio and starts the pump
+   *
+   * @param args RF arguments, the sampling rate must be fixed. rx_ring_ms sets the ring depth shared by all ports
+   * @param nof_ports Number of UE instances sharing the radio
+   * @param tx_lead_ms Time the uplink is sent ahead of the last received block
+   * @return SRSRAN_SUCCESS if the radio and the pump were started, SRSRAN_ERROR otherwise
+   */
+  int  init(const rf_args_t& args, uint32_t nof_ports, uint32_t tx_lead_ms);
+  void stop();
+
+  port* get_port(uint32_t idx) { return idx < ports.size() ? ports[idx].get() : nullptr; }
+
+  // phy_interface_radio, forwarded to the PHY of every port
+  void radio_overflow() override;
+  void radio_failure() override;
+
+private:
+  struct ring_block_t {
+    std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS> samples;
+    rf_timestamp_t                                     time;
+  };
+
+  radio                              radio_dev;
+  std::mutex                         cfg_mutex; ///< Serialises the radio setters called by the ports
+  std::vector<std::unique_ptr<port>> ports;
+  srslog::basic_logger&              logger = srslog::fetch_basic_logger("RF", false);
+  double                             srate_hz     = 0.0;
+  uint32_t                           nof_channels = 0;
+  uint32_t                           nof_devices  = 0;
+  uint32_t                           block_len    = 0; ///< Samples in a block of 1 ms
+
+  // Receive ring, written by the pump only. A block is valid for a reader as long as fewer than ring.size() blocks
+  // were written after it
+  std::vector<ring_block_t> ring;
+  std::atomic<uint64_t>     ring_wr = {0};
+  std::mutex                ring_mutex;
+  std::condition_variable   ring_cvar;
+  rf_timestamp_t            base_time; ///< Timestamp of the first received sample, origin of the sample indexes
+
+  // Transmit accumulator, indexed by absolute sample index modulo its length
+  std::mutex                                         tx_mutex;
+  std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS> tx_acc;
+  std::vector<bool>                                  tx_blk_used;
+  uint64_t                                           tx_flush_blk  = 0; ///< Next block to send to the radio
+  uint32_t                                           tx_lead_blk   = 0;
+  std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS> tx_out;
+
+  pthread_t         pump_thread  = {};
+  bool              pump_started = false;
+  std::atomic<bool> running      = {false};
+
+  static void* pump_entry(void* arg);
+  void         pump_run();
+  void         tx_flush(uint64_t end_blk);
+
+  /**
+   * Adds port samples into the transmit accumulator
+   *
+   * @return the number of samples dropped because their block was already sent
+   */
+  uint32_t tx_add(const rf_buffer_interface& buffer, uint32_t nof_samples, const srsran_timestamp_t& tx_time);
+};
+
+} // namespace srsran
+
+#endif // SRSRAN_RADIO_SHARED_H
@@ -51,6 +51,32 @@ struct metric_value_formatter<metric<Ty, Name, Units> > {
   }
 };
 
+/// Metric value of arithmetic type in its native representation, handed to
+/// formatters that encode numbers natively instead of as text.
+struct metric_number {
+  enum class num_type { boolean, sint, uint, float32, float64 };
+
+  explicit metric_number(bool v) : type(num_type::boolean), u(v) {}
+  explicit metric_number(float v) : type(num_type::float32), f(v) {}
+  explicit metric_number(double v) : type(num_type::float64), d(v) {}
+  explicit metric_number(long double v) : type(num_type::float64), d(v) {}
+  template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type = 0>
+  explicit metric_number(T v) : type(num_type::sint), i(v)
+  {}
+  template <typename T,
+            typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, int>::type = 0>
+  explicit metric_number(T v) : type(num_type::uint), u(v)
+  {}
+
+  num_type type;
+  union {
+    int64_t  i;
+    uint64_t u;
+    float    f;
+    double   d;
+  };
+};
+
 /// This is the base class that provides a common framework to format log
 /// entries to different kinds of formats. User should implement two different
 /// kinds of formats:
@@ -112,6 +138,10 @@ private:
   template <typename Ty, typename Name, typename Units>
   void process_element(const metric<Ty, Name, Units>& t, unsigned level, fmt::memory_buffer& buffer)
   {
+    if (formats_native_numbers() && process_number(t.name(), t.value, t.units(), level, buffer)) {
+      return;
+    }
+
     fmt::memory_buffer value;
     metric_value_formatter<typename std::decay<decltype(t)>::type>{}.format(t.value, value);
     value.push_back('\0');
@@ -119,6 +149,59 @@ private:
     format_metric(t.name(), value.data(), t.units(), t.kind(), level, buffer);
   }
 
+  /// Passes arithmetic metric values to format_metric_number, other types are
+  /// formatted as text. Characters are kept as text.
+  template <typename T>
+  typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, char>::value, bool>::type
+  process_number(fmt::string_view name, const T& v, fmt::string_view units, unsigned level, fmt::memory_buffer& buffer)
+  {
+    format_metric_number(name, metric_number(v), units, level, buffer);
+    return true;
+  }
+  template <typename T>
+  typename std::enable_if<!std::is_arithmetic<T>::value || std::is_same<T, char>::value, bool>::type
+  process_number(fmt::string_view name, const T& v, fmt::string_view units, unsigned level, fmt::memory_buffer& buffer)
+  {
+    return false;
+  }
+
+  /// Returns true when arithmetic metric values should be passed to
+  /// format_metric_number instead of being formatted as text. Note that
+  /// metric_value_formatter specializations are bypassed for these values.
+  virtual bool formats_native_numbers() const { return false; }
+
+  /// This callback gets called for each metric of arithmetic type when
+  /// formats_native_numbers() returns true. The default implementation
+  /// formats the value as text and forwards it to format_metric.
+  virtual void format_metric_number(fmt::string_view    metric_name,
+                                    metric_number       metric_value,
+                                    fmt::string_view    metric_units,
+                                    unsigned            level,
+                                    fmt::memory_buffer& buffer)
+  {
+    fmt::memory_buffer value;
+    switch (metric_value.type) {
+      case metric_number::num_type::boolean:
+        fmt::format_to(value, "{}", metric_value.u != 0);
+        break;
+      case metric_number::num_type::sint:
+        fmt::format_to(value, "{}", metric_value.i);
+        break;
+      case metric_number::num_type::uint:
+        fmt::format_to(value, "{}", metric_value.u);
+        break;
+      case metric_number::num_type::float32:
+        fmt::format_to(value, "{}", metric_value.f);
+        break;
+      case metric_number::num_type::float64:
+        fmt::format_to(value, "{}", metric_value.d);
+        break;
+    }
+    value.push_back('\0');
+
+    format_metric(metric_name, value.data(), metric_units, metric_kind::numeric, level, buffer);
+  }
+
 private:
   /// Derived classes should implement the following callbacks to format metric
   /// objects. Each callback is invoked at a different place of the formatting
@@ -156,6 +156,11 @@ std::unique_ptr<log_formatter> create_text_formatter();
 /// Creates a new instance of a JSON formatter.
 std::unique_ptr<log_formatter> create_json_formatter();
 
+/// Creates a new instance of a CBOR formatter. It writes the same objects as
+/// the JSON formatter in binary form, use the srslog_cbor2json tool to convert
+/// its output back to JSON text.
+std::unique_ptr<log_formatter> create_cbor_formatter();
+
 ///
 /// Sink management functions.
 ///
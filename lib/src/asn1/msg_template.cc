@@ -0,0 +1,95 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/asn1/msg_template.h"
+#include <cstring>
+
+namespace asn1 {
+
+void msg_template::set_reference(const uint8_t* buf, uint32_t nof_bytes)
+{
+  buffer.assign(buf, buf + nof_bytes);
+  nof_fields_ = 0;
+}
+
+int msg_template::learn_field(const uint8_t* probe, uint32_t nof_bytes)
+{
+  if (nof_bytes != buffer.size()) {
+    log_error("Template probe length %d differs from reference length %zd", nof_bytes, buffer.size());
+    return -1;
+  }
+
+  uint32_t first = 0;
+  while (first < nof_bytes and probe[first] == buffer[first]) {
+    first++;
+  }
+  if (first == nof_bytes) {
+    log_error("Template probe does not differ from reference");
+    return -1;
+  }
+  uint32_t last = nof_bytes - 1;
+  while (probe[last] == buffer[last]) {
+    last--;
+  }
+
+  // Bit positions counted from the MSB of the first octet
+  uint32_t first_bit = first * 8 + __builtin_clz((uint32_t)(probe[first] ^ buffer[first])) - 24;
+  uint32_t last_bit  = last * 8 + 7 - __builtin_ctz((uint32_t)(probe[last] ^ buffer[last]));
+  return add_field(first_bit, last_bit - first_bit + 1);
+}
+
+int msg_template::add_field(uint32_t bit_offset, uint32_t nof_bits)
+{
+  if (nof_fields_ == max_fields or nof_bits == 0 or nof_bits > 64 or bit_offset + nof_bits > buffer.size() * 8) {
+    log_error("Can't add template field of %d bits at offset %d", nof_bits, bit_offset);
+    return -1;
+  }
+  fields[nof_fields_] = {bit_offset, nof_bits};
+  return nof_fields_++;
+}
+
+void msg_template::set_field(uint32_t idx, uint64_t value)
+{
+  const field_t& f         = fields[idx];
+  uint32_t       pos       = f.offset;
+  uint32_t       remaining = f.nof_bits;
+  while (remaining > 0) {
+    uint32_t bit_in_byte = pos % 8;
+    uint32_t n           = std::min(8 - bit_in_byte, remaining);
+    uint32_t shift       = 8 - bit_in_byte - n;
+    uint8_t  mask        = ((1u << n) - 1) << shift;
+    uint8_t  bits        = ((value >> (remaining - n)) << shift) & mask;
+    buffer[pos / 8]      = (buffer[pos / 8] & ~mask) | bits;
+    pos += n;
+    remaining -= n;
+  }
+}
+
+uint32_t msg_template::write(uint8_t* out, uint32_t max_bytes) const
+{
+  if (buffer.size() > max_bytes) {
+    return 0;
+  }
+  memcpy(out, buffer.data(), buffer.size());
+  return buffer.size();
+}
+
+} // namespace asn1
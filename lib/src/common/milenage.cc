@@ -0,0 +1,236 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/milenage.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef __AES__
+#include <wmmintrin.h>
+#endif // __AES__
+
+namespace srsran {
+
+/// Byte rotations and constants of OUT2 to OUT5, TS 35.206 Sec. 4.1 (r2..r5 = 0, 32, 64, 96 bits, c2..c5 = 1, 2, 4, 8)
+static const uint32_t milenage_out_shift[4] = {0, 12, 8, 4};
+static const uint8_t  milenage_out_const[4] = {1, 2, 4, 8};
+
+#ifdef __AES__
+static __m128i aes_128_key_expand_step(__m128i key, __m128i keygened)
+{
+  keygened = _mm_shuffle_epi32(keygened, _MM_SHUFFLE(3, 3, 3, 3));
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key      = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, keygened);
+}
+#endif // __AES__
+
+milenage::milenage(const milenage& other)
+{
+  aes_init(&ctx);
+  *this = other;
+}
+
+milenage& milenage::operator=(const milenage& other)
+{
+  if (this != &other) {
+    set_k_opc(other.k, other.opc);
+  }
+  return *this;
+}
+
+void milenage::set_k_opc(const uint8_t k_[16], const uint8_t opc_[16])
+{
+  memcpy(k, k_, sizeof(k));
+  memcpy(opc, opc_, sizeof(opc));
+
+#ifdef __AES__
+  __m128i* rk = (__m128i*)round_keys;
+  rk[0]       = _mm_loadu_si128((const __m128i*)k);
+  rk[1]       = aes_128_key_expand_step(rk[0], _mm_aeskeygenassist_si128(rk[0], 0x01));
+  rk[2]       = aes_128_key_expand_step(rk[1], _mm_aeskeygenassist_si128(rk[1], 0x02));
+  rk[3]       = aes_128_key_expand_step(rk[2], _mm_aeskeygenassist_si128(rk[2], 0x04));
+  rk[4]       = aes_128_key_expand_step(rk[3], _mm_aeskeygenassist_si128(rk[3], 0x08));
+  rk[5]       = aes_128_key_expand_step(rk[4], _mm_aeskeygenassist_si128(rk[4], 0x10));
+  rk[6]       = aes_128_key_expand_step(rk[5], _mm_aeskeygenassist_si128(rk[5], 0x20));
+  rk[7]       = aes_128_key_expand_step(rk[6], _mm_aeskeygenassist_si128(rk[6], 0x40));
+  rk[8]       = aes_128_key_expand_step(rk[7], _mm_aeskeygenassist_si128(rk[7], 0x80));
+  rk[9]       = aes_128_key_expand_step(rk[8], _mm_aeskeygenassist_si128(rk[8], 0x1b));
+  rk[10]      = aes_128_key_expand_step(rk[9], _mm_aeskeygenassist_si128(rk[9], 0x36));
+#else  // __AES__
+  aes_setkey_enc(&ctx, k, 128);
+#endif // __AES__
+}
+
+void milenage::set_k_op(const uint8_t k[16], const uint8_t op[16])
+{
+  // OPc = E_K(OP) xor OP
+  uint8_t opc_[16] = {};
+  set_k_opc(k, opc_);
+  uint8_t block[1][16];
+  memcpy(block[0], op, 16);
+  const milenage* self = this;
+  encrypt_blocks(&self, block, 1);
+  for (uint32_t i = 0; i < 16; i++) {
+    opc[i] = block[0][i] ^ op[i];
+  }
+}
+
+void milenage::encrypt_blocks(const milenage* const* subscribers, uint8_t (*blocks)[16], uint32_t n)
+{
+#ifdef __AES__
+  // Rounds outermost, so that the n independent AES chains overlap in the pipeline
+  __m128i b[batch_size * 4];
+  for (uint32_t i = 0; i < n; i++) {
+    b[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i*)blocks[i]),
+                         ((const __m128i*)subscribers[i]->round_keys)[0]);
+  }
+  for (uint32_t r = 1; r < nof_rounds; r++) {
+    for (uint32_t i = 0; i < n; i++) {
+      b[i] = _mm_aesenc_si128(b[i], ((const __m128i*)subscribers[i]->round_keys)[r]);
+    }
+  }
+  for (uint32_t i = 0; i < n; i++) {
+    b[i] = _mm_aesenclast_si128(b[i], ((const __m128i*)subscribers[i]->round_keys)[nof_rounds]);
+    _mm_storeu_si128((__m128i*)blocks[i], b[i]);
+  }
+#else  // __AES__
+  for (uint32_t i = 0; i < n; i++) {
+    aes_crypt_ecb((aes_context*)&subscribers[i]->ctx, AES_ENCRYPT, blocks[i], blocks[i]);
+  }
+#endif // __AES__
+}
+
+void milenage::compute_group(const milenage* const*  subscribers,
+                             const milenage_input_t* in,
+                             const uint8_t (*autn)[16],
+                             milenage_vector_t*      out,
+                             uint8_t (*sqn)[6],
+                             uint32_t                n)
+{
+  uint8_t         temp[batch_size][16];
+  uint8_t         blocks[batch_size * 4][16];
+  const milenage* block_subscribers[batch_size * 4] = {};
+
+  // TEMP = E_K(RAND xor OPc)
+  for (uint32_t i = 0; i < n; i++) {
+    for (uint32_t j = 0; j < 16; j++) {
+      temp[i][j] = in[i].rand[j] ^ subscribers[i]->opc[j];
+    }
+  }
+  encrypt_blocks(subscribers, temp, n);
+
+  // OUT2 to OUT5 of all evaluations in one pass
+  for (uint32_t i = 0; i < n; i++) {
+    const uint8_t* opc = subscribers[i]->opc;
+    for (uint32_t o = 0; o < 4; o++) {
+      uint8_t* block = blocks[4 * i + o];
+      for (uint32_t j = 0; j < 16; j++) {
+        block[(j + milenage_out_shift[o]) % 16] = temp[i][j] ^ opc[j];
+      }
+      block[15] ^= milenage_out_const[o];
+      block_subscribers[4 * i + o] = subscribers[i];
+    }
+  }
+  encrypt_blocks(block_subscribers, blocks, 4 * n);
+
+  for (uint32_t i = 0; i < n; i++) {
+    const uint8_t* opc = subscribers[i]->opc;
+    for (uint32_t o = 0; o < 4; o++) {
+      for (uint32_t j = 0; j < 16; j++) {
+        blocks[4 * i + o][j] ^= opc[j];
+      }
+    }
+    memcpy(out[i].res, &blocks[4 * i][8], 8);
+    memcpy(out[i].ak, &blocks[4 * i][0], 6);
+    memcpy(out[i].ck, blocks[4 * i + 1], 16);
+    memcpy(out[i].ik, blocks[4 * i + 2], 16);
+    memcpy(out[i].ak_star, &blocks[4 * i + 3][0], 6);
+  }
+
+  // OUT1 = E_K(TEMP xor rot(IN1 xor OPc, r1) xor c1) xor OPc, with IN1 = SQN || AMF || SQN || AMF, r1 = 64, c1 = 0
+  for (uint32_t i = 0; i < n; i++) {
+    const uint8_t* opc = subscribers[i]->opc;
+    uint8_t        in1[16];
+    if (autn != nullptr) {
+      for (uint32_t j = 0; j < 6; j++) {
+        sqn[i][j] = autn[i][j] ^ out[i].ak[j];
+      }
+      memcpy(&in1[0], sqn[i], 6);
+      memcpy(&in1[6], &autn[i][6], 2);
+    } else {
+      memcpy(&in1[0], in[i].sqn, 6);
+      memcpy(&in1[6], in[i].amf, 2);
+    }
+    memcpy(&in1[8], &in1[0], 8);
+
+    for (uint32_t j = 0; j < 16; j++) {
+      blocks[i][(j + 8) % 16] = in1[j] ^ opc[j];
+    }
+    for (uint32_t j = 0; j < 16; j++) {
+      blocks[i][j] ^= temp[i][j];
+    }
+  }
+  encrypt_blocks(subscribers, blocks, n);
+
+  for (uint32_t i = 0; i < n; i++) {
+    const uint8_t* opc = subscribers[i]->opc;
+    for (uint32_t j = 0; j < 8; j++) {
+      out[i].mac_a[j] = blocks[i][j] ^ opc[j];
+      out[i].mac_s[j] = blocks[i][j + 8] ^ opc[j + 8];
+    }
+  }
+}
+
+void milenage::compute(const milenage_input_t& in, milenage_vector_t& out) const
+{
+  const milenage* self = this;
+  compute_group(&self, &in, nullptr, &out, nullptr, 1);
+}
+
+void milenage::compute_from_autn(const uint8_t      rand[16],
+                                 const uint8_t      autn[16],
+                                 milenage_vector_t& out,
+                                 uint8_t            sqn[6]) const
+{
+  const milenage*  self = this;
+  milenage_input_t in   = {};
+  uint8_t          autn_[1][16];
+  uint8_t          sqn_[1][6];
+  memcpy(in.rand, rand, 16);
+  memcpy(autn_[0], autn, 16);
+  compute_group(&self, &in, autn_, &out, sqn_, 1);
+  memcpy(sqn, sqn_[0], 6);
+}
+
+void milenage::compute_batch(const milenage* const*  subscribers,
+                             const milenage_input_t* in,
+                             milenage_vector_t*      out,
+                             uint32_t                nof_vectors)
+{
+  for (uint32_t i = 0; i < nof_vectors; i += batch_size) {
+    uint32_t n = std::min(batch_size, nof_vectors - i);
+    compute_group(&subscribers[i], &in[i], nullptr, &out[i], nullptr, n);
+  }
+}
+
+} // namespace srsran
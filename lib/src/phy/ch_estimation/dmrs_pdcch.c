@@ -31,6 +31,13 @@
 
 #define NOF_PILOTS_X_RB 3
 
+/// @brief Number of data resource elements in every resource block and symbol
+#define NOF_DATA_RE_X_RB (SRSRAN_NRE - NOF_PILOTS_X_RB)
+
+/// @brief Sub-carrier indexes of the data resource elements within a resource block, the DMRS use one every four
+/// sub-carriers starting at 1
+static const uint32_t dmrs_pdcch_data_re[NOF_DATA_RE_X_RB] = {0, 2, 3, 4, 6, 7, 8, 10, 11};
+
 /// @brief Every frequency resource is 6 Resource blocks, every resource block carries 3 pilots. So 18 possible pilots
 /// per frequency resource.
 #define NOF_PILOTS_X_FREQ_RES (NOF_PILOTS_X_RB * 6)
@@ -223,11 +230,24 @@ int srsran_dmrs_pdcch_estimator_init(srsran_dmrs_pdcch_estimator_t* q,
         free(q->lse[l]);
         q->lse[l] = NULL;
       }
+      if (q->rb_pwr[l] != NULL) {
+        free(q->rb_pwr[l]);
+        q->rb_pwr[l] = NULL;
+      }
+      if (q->lse_diff[l] != NULL) {
+        free(q->lse_diff[l]);
+        q->lse_diff[l] = NULL;
+      }
 
       // Allocate
       if (l < coreset->duration) {
         // Allocate for 3 pilots per physical resource block
-        q->lse[l] = srsran_vec_cf_malloc(coreset_bw * 3);
+        q->lse[l]      = srsran_vec_cf_malloc(coreset_bw * 3);
+        q->rb_pwr[l]   = srsran_vec_f_malloc(coreset_bw);
+        q->lse_diff[l] = srsran_vec_cf_malloc(coreset_bw * 3);
+        if (q->lse[l] == NULL || q->rb_pwr[l] == NULL || q->lse_diff[l] == NULL) {
+          return SRSRAN_ERROR;
+        }
       }
     }
 
@@ -235,6 +255,15 @@ int srsran_dmrs_pdcch_estimator_init(srsran_dmrs_pdcch_estimator_t* q,
       free(q->ce);
     }
     q->ce = srsran_vec_cf_malloc(coreset_sz);
+
+    if (q->ce_data) {
+      free(q->ce_data);
+    }
+    q->ce_data = srsran_vec_cf_malloc((coreset_sz / SRSRAN_NRE) * NOF_DATA_RE_X_RB);
+
+    if (q->ce == NULL || q->ce_data == NULL) {
+      return SRSRAN_ERROR;
+    }
   }
 
   if (q->filter == NULL) {
@@ -265,10 +294,20 @@ void srsran_dmrs_pdcch_estimator_free(srsran_dmrs_pdcch_estimator_t* q)
     free(q->ce);
   }
 
+  if (q->ce_data) {
+    free(q->ce_data);
+  }
+
   for (uint32_t i = 0; i < SRSRAN_CORESET_DURATION_MAX; i++) {
     if (q->lse[i]) {
       free(q->lse[i]);
     }
+    if (q->rb_pwr[i]) {
+      free(q->rb_pwr[i]);
+    }
+    if (q->lse_diff[i]) {
+      free(q->lse_diff[i]);
+    }
   }
 
   if (q->filter) {
@@ -334,6 +373,22 @@ srsran_dmrs_pdcch_extract(srsran_dmrs_pdcch_estimator_t* q, uint32_t cinit, cons
   }
 }
 
+static void dmrs_pdcch_rb_stats(srsran_dmrs_pdcch_estimator_t* q, uint32_t l)
+{
+  uint32_t nof_pilots = q->coreset_bw * NOF_PILOTS_X_RB;
+
+  // Products between adjacent pilots of the whole symbol, every candidate picks the ones it spans
+  srsran_vec_prod_conj_ccc(&q->lse[l][1], q->lse[l], q->lse_diff[l], nof_pilots - 1);
+
+  // Pilot power added per RB
+  float pwr[SRSRAN_MAX_PRB_NR * NOF_PILOTS_X_RB];
+  srsran_vec_abs_square_cf(q->lse[l], pwr, nof_pilots);
+  for (uint32_t rb = 0; rb < q->coreset_bw; rb++) {
+    const float* rb_pwr = &pwr[rb * NOF_PILOTS_X_RB];
+    q->rb_pwr[l][rb]    = rb_pwr[0] + rb_pwr[1] + rb_pwr[2];
+  }
+}
+
 int srsran_dmrs_pdcch_estimate(srsran_dmrs_pdcch_estimator_t* q,
                                const srsran_slot_cfg_t*       slot_cfg,
                                const cf_t*                    sf_symbols)
@@ -358,6 +413,9 @@ int srsran_dmrs_pdcch_estimate(srsran_dmrs_pdcch_estimator_t* q,
 
     // Extract pilots least square estimates
     srsran_dmrs_pdcch_extract(q, cinit, &sf_symbols[l * q->carrier.nof_prb * SRSRAN_NRE], q->lse[l]);
+
+    // Compute the pilot statistics shared by all the candidate measurements
+    dmrs_pdcch_rb_stats(q, l);
   }
 
   // Time averaging and smoothing should be implemented here
@@ -403,9 +461,39 @@ int srsran_dmrs_pdcch_estimate(srsran_dmrs_pdcch_estimator_t* q,
   }
 #endif // DMRS_PDCCH_INTERPOLATE_GROUP
 
+  // Remove the DMRS sub-carriers from the estimates once, the candidates gather whole RB from the result
+  for (uint32_t i = 0; i < q->coreset_bw * q->coreset.duration; i++) {
+    const cf_t* src = &q->ce[i * SRSRAN_NRE];
+    cf_t*       dst = &q->ce_data[i * NOF_DATA_RE_X_RB];
+    for (uint32_t j = 0; j < NOF_DATA_RE_X_RB; j++) {
+      dst[j] = src[dmrs_pdcch_data_re[j]];
+    }
+  }
+
   return SRSRAN_SUCCESS;
 }
 
+/// Lists the CORESET RB used by a candidate in ascending order, returns the number of RB or SRSRAN_ERROR
+static int dmrs_pdcch_candidate_rb(const srsran_dmrs_pdcch_estimator_t* q,
+                                   const srsran_dci_location_t*         dci_location,
+                                   uint32_t                             rb_idx[SRSRAN_MAX_PRB_NR])
+{
+  // Calculate CCE-to-REG mapping mask
+  bool rb_mask[SRSRAN_MAX_PRB_NR] = {};
+  if (srsran_pdcch_nr_cce_to_reg_mapping(&q->coreset, dci_location, rb_mask) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  uint32_t nof_rb = 0;
+  for (uint32_t rb = 0; rb < q->coreset_bw; rb++) {
+    if (rb_mask[rb]) {
+      rb_idx[nof_rb++] = rb;
+    }
+  }
+
+  return (int)nof_rb;
+}
+
 int srsran_dmrs_pdcch_get_measure(const srsran_dmrs_pdcch_estimator_t* q,
                                   const srsran_dci_location_t*         dci_location,
                                   srsran_dmrs_pdcch_measure_t*         measure)
@@ -420,9 +508,10 @@ int srsran_dmrs_pdcch_get_measure(const srsran_dmrs_pdcch_estimator_t* q,
     return SRSRAN_ERROR;
   }
 
-  // Calculate CCE-to-REG mapping mask
-  bool rb_mask[SRSRAN_MAX_PRB_NR] = {};
-  if (srsran_pdcch_nr_cce_to_reg_mapping(&q->coreset, dci_location, rb_mask) < SRSRAN_SUCCESS) {
+  // Calculate CCE-to-REG mapping
+  uint32_t rb_idx[SRSRAN_MAX_PRB_NR];
+  int      nof_rb = dmrs_pdcch_candidate_rb(q, dci_location, rb_idx);
+  if (nof_rb < SRSRAN_SUCCESS) {
     ERROR("Error in CCE-to-REG mapping");
     return SRSRAN_SUCCESS;
   }
@@ -440,15 +529,25 @@ int srsran_dmrs_pdcch_get_measure(const srsran_dmrs_pdcch_estimator_t* q,
     cf_t     tmp[DMRS_PDCCH_MAX_NOF_PILOTS_CANDIDATE] = {};
     uint32_t nof_pilots = 0;
 
-    // For each RB in the CORESET
-    for (uint32_t rb = 0; rb < q->coreset_bw; rb++) {
-      // Skip RB if unused
-      if (!rb_mask[rb]) {
-        continue;
+    // Pilot statistics gathered from the CORESET-wide ones
+    float pwr  = 0.0f; //< Accumulates the pilots power
+    cf_t  diff = 0.0f; //< Accumulates the adjacent pilots products
+
+    // For each RB in the candidate
+    for (uint32_t i = 0; i < (uint32_t)nof_rb; i++) {
+      uint32_t    rb  = rb_idx[i];
+      const cf_t* lse = &q->lse[l][rb * NOF_PILOTS_X_RB];
+
+      // The product with the previous RB last pilot is precomputed only if both RB are contiguous
+      if (i > 0) {
+        diff += (rb_idx[i - 1] + 1 == rb) ? q->lse_diff[l][rb * NOF_PILOTS_X_RB - 1]
+                                          : lse[0] * conjf(tmp[nof_pilots - 1]);
       }
+      diff += q->lse_diff[l][rb * NOF_PILOTS_X_RB] + q->lse_diff[l][rb * NOF_PILOTS_X_RB + 1];
+      pwr += q->rb_pwr[l][rb];
 
       // Copy LSE
-      srsran_vec_cf_copy(&tmp[nof_pilots], &q->lse[l][rb * NOF_PILOTS_X_RB], NOF_PILOTS_X_RB);
+      srsran_vec_cf_copy(&tmp[nof_pilots], lse, NOF_PILOTS_X_RB);
       nof_pilots += NOF_PILOTS_X_RB;
     }
 
@@ -457,8 +556,8 @@ int srsran_dmrs_pdcch_get_measure(const srsran_dmrs_pdcch_estimator_t* q,
       srsran_vec_fprint_c(stdout, tmp, nof_pilots);
     }
 
-    // Measure synchronization error and accumulate for average
-    float tmp_sync_err = srsran_vec_estimate_frequency(tmp, nof_pilots);
+    // Measure synchronization error and accumulate for average, same as srsran_vec_estimate_frequency()
+    float tmp_sync_err = -cargf(diff) * M_1_PI * 0.5f;
     sync_err_avg += tmp_sync_err;
 
 #if DMRS_PDCCH_SYNC_PRECOMPENSATE_MEAS
@@ -477,8 +576,8 @@ int srsran_dmrs_pdcch_get_measure(const srsran_dmrs_pdcch_estimator_t* q,
     // Measure symbol RSRP
     rsrp += __real__ corr[l] * __real__ corr[l] + __imag__ corr[l] * __imag__ corr[l];
 
-    // Measure symbol EPRE
-    epre += srsran_vec_avg_power_cf(tmp, nof_pilots);
+    // Measure symbol EPRE, the synchronization error pre-compensation does not change it
+    epre += pwr / (float)nof_pilots;
 
     // Measure CFO only from the second and third symbols
     if (l != 0) {
@@ -541,31 +640,29 @@ int srsran_dmrs_pdcch_get_ce(const srsran_dmrs_pdcch_estimator_t* q,
     return SRSRAN_ERROR;
   }
 
-  // Calculate CCE-to-REG mapping mask
-  bool rb_mask[SRSRAN_MAX_PRB_NR] = {};
-  if (srsran_pdcch_nr_cce_to_reg_mapping(&q->coreset, dci_location, rb_mask) < SRSRAN_SUCCESS) {
+  // Calculate CCE-to-REG mapping
+  uint32_t rb_idx[SRSRAN_MAX_PRB_NR];
+  int      nof_rb = dmrs_pdcch_candidate_rb(q, dci_location, rb_idx);
+  if (nof_rb < SRSRAN_SUCCESS) {
     ERROR("Error in CCE-to-REG mapping");
     return SRSRAN_SUCCESS;
   }
 
+  if ((uint32_t)nof_rb * q->coreset.duration * NOF_DATA_RE_X_RB > SRSRAN_PDCCH_MAX_RE) {
+    ERROR("Too many RB in the candidate (%d)", nof_rb);
+    return SRSRAN_ERROR;
+  }
+
   // Extract CE for PDCCH
   uint32_t count = 0;
 
   // For each PDCCH symbol
   for (uint32_t l = 0; l < q->coreset.duration; l++) {
-    // For each CORESET RB
-    for (uint32_t rb = 0; rb < q->coreset_bw; rb++) {
-      // Skip RB if unused
-      if (!rb_mask[rb]) {
-        continue;
-      }
-
-      // Copy RB, skipping DMRS
-      for (uint32_t k = rb * SRSRAN_NRE; k < (rb + 1) * SRSRAN_NRE; k++) {
-        if (k % 4 != 1) {
-          ce->ce[count++] = q->ce[q->coreset_bw * SRSRAN_NRE * l + k];
-        }
-      }
+    // Gather the candidate RB, the DMRS are already removed
+    for (uint32_t i = 0; i < (uint32_t)nof_rb; i++) {
+      srsran_vec_cf_copy(
+          &ce->ce[count], &q->ce_data[(q->coreset_bw * l + rb_idx[i]) * NOF_DATA_RE_X_RB], NOF_DATA_RE_X_RB);
+      count += NOF_DATA_RE_X_RB;
     }
   }
 
@@ -146,6 +146,28 @@ static inline uint32_t sequence_gen_LTE_pr_memless_step_x2(uint32_t state)
 static uint32_t sequence_x1_init                    = 0;
 static uint32_t sequence_x2_init[SEQUENCE_SEED_LEN] = {};
 
+/**
+ * Jump-ahead transition matrices
+ * ------------------------------
+ *
+ * Both LFSR are linear, so advancing them 2^k chips is a 31x31 binary matrix. Column i of sequence_xN_jump[k] is the
+ * state reached after 2^k chips starting from the state 1 << i. Advances shorter than 2^SEQUENCE_JUMP_MIN_LOG2 chips
+ * are cheaper with the parallel steps.
+ */
+#define SEQUENCE_JUMP_NOF_LOG2 (32U)
+#define SEQUENCE_JUMP_MIN_LOG2 (9U)
+static uint32_t sequence_x1_jump[SEQUENCE_JUMP_NOF_LOG2][SEQUENCE_SEED_LEN] = {};
+static uint32_t sequence_x2_jump[SEQUENCE_JUMP_NOF_LOG2][SEQUENCE_SEED_LEN] = {};
+
+static inline uint32_t sequence_jump(const uint32_t* matrix, uint32_t state)
+{
+  uint32_t r = 0;
+  for (uint32_t i = 0; i < SEQUENCE_SEED_LEN; i++) {
+    r ^= matrix[i] & (0U - ((state >> i) & 1U));
+  }
+  return r;
+}
+
 /**
  * C constructor, pre-computes X1 and X2 initial states
  */
@@ -165,6 +187,18 @@ __attribute__((constructor)) __attribute__((unused)) static void srsran_lte_pr_p
       sequence_x2_init[i] = sequence_gen_LTE_pr_memless_step_x2(sequence_x2_init[i]);
     }
   }
+
+  // Jump-ahead matrices, each power of two squares the previous one
+  for (uint32_t i = 0; i < SEQUENCE_SEED_LEN; i++) {
+    sequence_x1_jump[0][i] = sequence_gen_LTE_pr_memless_step_x1(1U << i);
+    sequence_x2_jump[0][i] = sequence_gen_LTE_pr_memless_step_x2(1U << i);
+  }
+  for (uint32_t k = 1; k < SEQUENCE_JUMP_NOF_LOG2; k++) {
+    for (uint32_t i = 0; i < SEQUENCE_SEED_LEN; i++) {
+      sequence_x1_jump[k][i] = sequence_jump(sequence_x1_jump[k - 1], sequence_x1_jump[k - 1][i]);
+      sequence_x2_jump[k][i] = sequence_jump(sequence_x2_jump[k - 1], sequence_x2_jump[k - 1][i]);
+    }
+  }
 }
 
 static uint32_t sequence_get_x2_init(uint32_t seed)
@@ -334,6 +368,15 @@ void srsran_sequence_state_apply_f(srsran_sequence_state_t* s, const float* in,
 
 void srsran_sequence_state_advance(srsran_sequence_state_t* s, uint32_t length)
 {
+  // Jump the most significant bits of the length
+  for (uint32_t k = SEQUENCE_JUMP_MIN_LOG2; k < SEQUENCE_JUMP_NOF_LOG2; k++) {
+    if ((length >> k) & 1U) {
+      s->x1 = sequence_jump(sequence_x1_jump[k], s->x1);
+      s->x2 = sequence_jump(sequence_x2_jump[k], s->x2);
+    }
+  }
+  length &= (1U << SEQUENCE_JUMP_MIN_LOG2) - 1U;
+
   uint32_t i = 0;
   if (length >= SEQUENCE_PAR_BITS) {
     for (; i < length - (SEQUENCE_PAR_BITS - 1); i += SEQUENCE_PAR_BITS) {
@@ -797,3 +840,305 @@ void srsran_sequence_apply_packed(const uint8_t* in, uint8_t* out, uint32_t leng
   }
 #endif // SEQUENCE_PAR_BITS % 8 == 0
 }
+
+int srsran_sequence_cache_init(srsran_sequence_cache_t* q, uint32_t nof_entries)
+{
+  if (q == NULL || nof_entries == 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_sequence_cache_t, 1);
+
+  q->entries = SRSRAN_MEM_ALLOC(srsran_sequence_cache_entry_t, nof_entries);
+  if (q->entries == NULL) {
+    ERROR("Malloc");
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(q->entries, srsran_sequence_cache_entry_t, nof_entries);
+  q->nof_entries = nof_entries;
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_sequence_cache_free(srsran_sequence_cache_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  if (q->entries != NULL) {
+    for (uint32_t i = 0; i < q->nof_entries; i++) {
+      if (q->entries[i].c_packed != NULL) {
+        free(q->entries[i].c_packed);
+      }
+    }
+    free(q->entries);
+  }
+
+  SRSRAN_MEM_ZERO(q, srsran_sequence_cache_t, 1);
+}
+
+const uint8_t* srsran_sequence_cache_get(srsran_sequence_cache_t* q, uint32_t seed, uint32_t length)
+{
+  if (q == NULL || q->entries == NULL || length == 0) {
+    return NULL;
+  }
+
+  q->clock++;
+
+  // Look up the seed and the least recently used entry
+  srsran_sequence_cache_entry_t* entry = NULL;
+  srsran_sequence_cache_entry_t* lru   = &q->entries[0];
+  for (uint32_t i = 0; i < q->nof_entries; i++) {
+    srsran_sequence_cache_entry_t* e = &q->entries[i];
+    if (e->len > 0 && e->c_init == seed) {
+      entry = e;
+      break;
+    }
+    if (e->last_used < lru->last_used) {
+      lru = e;
+    }
+  }
+
+  if (entry != NULL && entry->len >= length) {
+    q->nof_hits++;
+    entry->last_used = q->clock;
+    return entry->c_packed;
+  }
+  q->nof_misses++;
+
+  // Replace the least recently used entry, or extend the sequence for the same seed
+  if (entry == NULL) {
+    entry = lru;
+  }
+
+  if (length > entry->max_len) {
+    if (entry->c_packed != NULL) {
+      free(entry->c_packed);
+    }
+    // Extra bytes allow the SIMD kernels to read whole words past the end
+    entry->c_packed = srsran_vec_u8_malloc(length / 8 + 8);
+    if (entry->c_packed == NULL) {
+      SRSRAN_MEM_ZERO(entry, srsran_sequence_cache_entry_t, 1);
+      return NULL;
+    }
+    entry->max_len = length;
+  }
+
+  srsran_vec_u8_zero(entry->c_packed, length / 8 + 8);
+  srsran_sequence_apply_packed(entry->c_packed, entry->c_packed, length, seed);
+
+  entry->c_init    = seed;
+  entry->len       = length;
+  entry->last_used = q->clock;
+
+  return entry->c_packed;
+}
+
+// Reads the i-th chip of a packed sequence
+#define SEQUENCE_PACKED_CHIP(C, I) (((C)[(I) / 8U] >> (7U - (I) % 8U)) & 1U)
+
+#ifdef LV_HAVE_SSE
+// Expands 16 packed chips into a byte mask, 0xff for the chips set to one
+static inline __m128i sequence_packed_mask_16(const uint8_t* c)
+{
+  uint16_t c16;
+  memcpy(&c16, c, sizeof(c16));
+  __m128i mask = _mm_shuffle_epi8(_mm_set1_epi16((short)c16),
+                                  _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1));
+  const __m128i bits = _mm_set_epi64x(0x0102040810204080, 0x0102040810204080);
+  return _mm_cmpeq_epi8(_mm_and_si128(mask, bits), bits);
+}
+#endif /* LV_HAVE_SSE */
+
+#ifdef LV_HAVE_AVX2
+// Expands 32 packed chips into a byte mask, 0xff for the chips set to one
+static inline __m256i sequence_packed_mask_32(const uint8_t* c)
+{
+  uint32_t c32;
+  memcpy(&c32, c, sizeof(c32));
+  __m256i mask = _mm256_shuffle_epi8(_mm256_set1_epi32((int)c32),
+                                     _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                                      2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3));
+  const __m256i bits = _mm256_set1_epi64x(0x0102040810204080);
+  return _mm256_cmpeq_epi8(_mm256_and_si256(mask, bits), bits);
+}
+#endif /* LV_HAVE_AVX2 */
+
+static void sequence_packed_apply_c(const uint8_t* c, const int8_t* in, int8_t* out, uint32_t length)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX2
+  for (; i + 32 <= length; i += 32) {
+    __m256i mask = sequence_packed_mask_32(&c[i / 8]);
+    __m256i v    = _mm256_loadu_si256((__m256i*)(in + i));
+
+    // Negate where the mask is set, (v ^ -1) - (-1) = -v
+    v = _mm256_sub_epi8(_mm256_xor_si256(v, mask), mask);
+
+    _mm256_storeu_si256((__m256i*)(out + i), v);
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  for (; i + 16 <= length; i += 16) {
+    __m128i mask = sequence_packed_mask_16(&c[i / 8]);
+    __m128i v    = _mm_loadu_si128((__m128i*)(in + i));
+
+    v = _mm_sub_epi8(_mm_xor_si128(v, mask), mask);
+
+    _mm_storeu_si128((__m128i*)(out + i), v);
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < length; i++) {
+    out[i] = SEQUENCE_PACKED_CHIP(c, i) ? -in[i] : in[i];
+  }
+}
+
+static void sequence_packed_apply_bit(const uint8_t* c, const uint8_t* in, uint8_t* out, uint32_t length)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX2
+  for (; i + 32 <= length; i += 32) {
+    __m256i mask = _mm256_and_si256(sequence_packed_mask_32(&c[i / 8]), _mm256_set1_epi8(1));
+    __m256i v    = _mm256_loadu_si256((__m256i*)(in + i));
+    _mm256_storeu_si256((__m256i*)(out + i), _mm256_xor_si256(v, mask));
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  for (; i + 16 <= length; i += 16) {
+    __m128i mask = _mm_and_si128(sequence_packed_mask_16(&c[i / 8]), _mm_set1_epi8(1));
+    __m128i v    = _mm_loadu_si128((__m128i*)(in + i));
+    _mm_storeu_si128((__m128i*)(out + i), _mm_xor_si128(v, mask));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < length; i++) {
+    out[i] = in[i] ^ SEQUENCE_PACKED_CHIP(c, i);
+  }
+}
+
+static void sequence_packed_apply_s(const uint8_t* c, const int16_t* in, int16_t* out, uint32_t length)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_SSE
+  const __m128i bits = _mm_setr_epi16(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+  for (; i + 8 <= length; i += 8) {
+    __m128i mask = _mm_cmpeq_epi16(_mm_and_si128(_mm_set1_epi16(c[i / 8]), bits), bits);
+    __m128i v    = _mm_loadu_si128((__m128i*)(in + i));
+
+    v = _mm_sub_epi16(_mm_xor_si128(v, mask), mask);
+
+    _mm_storeu_si128((__m128i*)(out + i), v);
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < length; i++) {
+    out[i] = SEQUENCE_PACKED_CHIP(c, i) ? -in[i] : in[i];
+  }
+}
+
+static void sequence_packed_apply_f(const uint8_t* c, const float* in, float* out, uint32_t length)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_SSE
+  const __m128i bits_hi = _mm_setr_epi32(0x80, 0x40, 0x20, 0x10);
+  const __m128i bits_lo = _mm_setr_epi32(0x08, 0x04, 0x02, 0x01);
+  const __m128i sign    = (__m128i)_mm_set1_ps(-0.0F);
+  for (; i + 8 <= length; i += 8) {
+    __m128i c32     = _mm_set1_epi32(c[i / 8]);
+    __m128i mask_hi = _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(c32, bits_hi), bits_hi), sign);
+    __m128i mask_lo = _mm_and_si128(_mm_cmpeq_epi32(_mm_and_si128(c32, bits_lo), bits_lo), sign);
+
+    _mm_storeu_ps(out + i, _mm_xor_ps(_mm_loadu_ps(in + i), (__m128)mask_hi));
+    _mm_storeu_ps(out + i + 4, _mm_xor_ps(_mm_loadu_ps(in + i + 4), (__m128)mask_lo));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < length; i++) {
+    FLOAT_U32_XOR(out[i], in[i], SEQUENCE_PACKED_CHIP(c, i) << 31U);
+  }
+}
+
+void srsran_sequence_cache_apply_f(srsran_sequence_cache_t* q,
+                                   const float*             in,
+                                   float*                   out,
+                                   uint32_t                 length,
+                                   uint32_t                 seed)
+{
+  const uint8_t* c = srsran_sequence_cache_get(q, seed, length);
+  if (c == NULL) {
+    srsran_sequence_apply_f(in, out, length, seed);
+    return;
+  }
+  sequence_packed_apply_f(c, in, out, length);
+}
+
+void srsran_sequence_cache_apply_s(srsran_sequence_cache_t* q,
+                                   const int16_t*           in,
+                                   int16_t*                 out,
+                                   uint32_t                 length,
+                                   uint32_t                 seed)
+{
+  const uint8_t* c = srsran_sequence_cache_get(q, seed, length);
+  if (c == NULL) {
+    srsran_sequence_apply_s(in, out, length, seed);
+    return;
+  }
+  sequence_packed_apply_s(c, in, out, length);
+}
+
+void srsran_sequence_cache_apply_c(srsran_sequence_cache_t* q,
+                                   const int8_t*            in,
+                                   int8_t*                  out,
+                                   uint32_t                 length,
+                                   uint32_t                 seed)
+{
+  const uint8_t* c = srsran_sequence_cache_get(q, seed, length);
+  if (c == NULL) {
+    srsran_sequence_apply_c(in, out, length, seed);
+    return;
+  }
+  sequence_packed_apply_c(c, in, out, length);
+}
+
+void srsran_sequence_cache_apply_packed(srsran_sequence_cache_t* q,
+                                        const uint8_t*           in,
+                                        uint8_t*                 out,
+                                        uint32_t                 length,
+                                        uint32_t                 seed)
+{
+  const uint8_t* c = srsran_sequence_cache_get(q, seed, length);
+  if (c == NULL) {
+    srsran_sequence_apply_packed(in, out, length, seed);
+    return;
+  }
+
+  srsran_vec_xor_bbb(in, c, out, length / 8);
+
+  // The cached sequence can be longer, only the remaining chips are applied to the last byte
+  uint32_t rem8 = length % 8;
+  if (rem8 != 0) {
+    out[length / 8] = in[length / 8] ^ (c[length / 8] & (uint8_t)(0xffU << (8U - rem8)));
+  }
+}
+
+void srsran_sequence_cache_apply_bit(srsran_sequence_cache_t* q,
+                                     const uint8_t*           in,
+                                     uint8_t*                 out,
+                                     uint32_t                 length,
+                                     uint32_t                 seed)
+{
+  const uint8_t* c = srsran_sequence_cache_get(q, seed, length);
+  if (c == NULL) {
+    srsran_sequence_apply_bit(in, out, length, seed);
+    return;
+  }
+  sequence_packed_apply_bit(c, in, out, length);
+}
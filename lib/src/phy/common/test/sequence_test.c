@@ -23,6 +23,8 @@
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include <inttypes.h>
 
 #define Nc 1600
 #define MAX_SEQ_LEN (256 * 1024)
@@ -43,7 +45,77 @@ static int8_t  ones_char[Nc + MAX_SEQ_LEN + 31];
 static uint8_t ones_packed[(MAX_SEQ_LEN * 7) / 8];
 static uint8_t ones_unpacked[MAX_SEQ_LEN];
 
-static int test_sequence(srsran_sequence_t* sequence, uint32_t seed, uint32_t length, uint32_t repetitions)
+static float   cache_float[MAX_SEQ_LEN];
+static int16_t cache_short[MAX_SEQ_LEN];
+static int8_t  cache_char[MAX_SEQ_LEN];
+static uint8_t cache_packed[MAX_SEQ_LEN / 8];
+static uint8_t cache_unpacked[MAX_SEQ_LEN];
+
+static int test_cache(srsran_sequence_cache_t* cache, uint32_t seed, uint32_t length)
+{
+  // An empty sequence is never cached
+  if (srsran_sequence_cache_get(cache, seed, 0) != NULL) {
+    ERROR("Unexpected cached empty sequence");
+    return SRSRAN_ERROR;
+  }
+
+  int ret = SRSRAN_SUCCESS;
+
+  srsran_sequence_cache_apply_f(cache, ones_float, cache_float, length, seed);
+  if (memcmp(c_float, cache_float, length * sizeof(float)) != 0) {
+    ERROR("Unmatched cached c_float");
+    ret = SRSRAN_ERROR;
+  }
+
+  srsran_sequence_cache_apply_s(cache, ones_short, cache_short, length, seed);
+  if (memcmp(c_short, cache_short, length * sizeof(int16_t)) != 0) {
+    ERROR("Unmatched cached c_short");
+    ret = SRSRAN_ERROR;
+  }
+
+  srsran_sequence_cache_apply_c(cache, ones_char, cache_char, length, seed);
+  if (memcmp(c_char, cache_char, length * sizeof(int8_t)) != 0) {
+    ERROR("Unmatched cached c_char");
+    ret = SRSRAN_ERROR;
+  }
+
+  srsran_sequence_cache_apply_bit(cache, ones_unpacked, cache_unpacked, length, seed);
+  if (memcmp(c, cache_unpacked, length) != 0) {
+    ERROR("Unmatched cached c_unpacked");
+    ret = SRSRAN_ERROR;
+  }
+
+  // Shorter request served by the same entry, the last byte must keep the input bits past the length
+  uint32_t short_len = length - length / 3;
+  srsran_vec_u8_zero(cache_packed, (length + 7) / 8);
+  srsran_sequence_cache_apply_packed(cache, ones_packed, cache_packed, short_len, seed);
+  uint8_t last_mask = (short_len % 8 == 0) ? 0xff : (uint8_t)(0xffU << (8U - short_len % 8));
+  if (memcmp(c_packed_gold, cache_packed, short_len / 8) != 0 ||
+      (short_len % 8 != 0 && cache_packed[short_len / 8] != (c_packed_gold[short_len / 8] & last_mask))) {
+    ERROR("Unmatched cached c_packed");
+    ret = SRSRAN_ERROR;
+  }
+
+  // Jump-ahead to an arbitrary offset
+  uint32_t                offset = length / 2;
+  uint32_t                n      = SRSRAN_MIN(length - offset, 64);
+  srsran_sequence_state_t state  = {};
+  srsran_sequence_state_init(&state, seed);
+  srsran_sequence_state_advance(&state, offset);
+  srsran_sequence_state_apply_bit(&state, ones_unpacked, cache_unpacked, n);
+  if (memcmp(&c[offset], cache_unpacked, n) != 0) {
+    ERROR("Unmatched advance by %d", offset);
+    ret = SRSRAN_ERROR;
+  }
+
+  return ret;
+}
+
+static int test_sequence(srsran_sequence_t*       sequence,
+                         srsran_sequence_cache_t* cache,
+                         uint32_t                 seed,
+                         uint32_t                 length,
+                         uint32_t                 repetitions)
 {
   int            ret                      = SRSRAN_SUCCESS;
   struct timeval t[3]                     = {};
@@ -53,6 +125,7 @@ static int test_sequence(srsran_sequence_t* sequence, uint32_t seed, uint32_t le
   uint64_t       interval_xor_char_us     = 0;
   uint64_t       interval_xor_unpacked_us = 0;
   uint64_t       interval_xor_packed_us   = 0;
+  uint64_t       interval_cache_char_us   = 0;
 
   gettimeofday(&t[1], NULL);
 
@@ -178,7 +251,20 @@ static int test_sequence(srsran_sequence_t* sequence, uint32_t seed, uint32_t le
     ret = SRSRAN_ERROR;
   }
 
-  printf("%08x; %8d; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8c\n",
+  if (test_cache(cache, seed, length) < SRSRAN_SUCCESS) {
+    ret = SRSRAN_ERROR;
+  }
+
+  // Test cached Char XOR, the sequence is already in the cache
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < repetitions; r++) {
+    srsran_sequence_cache_apply_c(cache, ones_char, cache_char, length, seed);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  interval_cache_char_us = t->tv_sec * 1000000UL + t->tv_usec;
+
+  printf("%08x; %8d; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8c\n",
          seed,
          length,
          (double)(length * repetitions) / (double)interval_gen_us,
@@ -187,9 +273,10 @@ static int test_sequence(srsran_sequence_t* sequence, uint32_t seed, uint32_t le
          (double)(length * repetitions) / (double)interval_xor_char_us,
          (double)(length * repetitions) / (double)interval_xor_unpacked_us,
          (double)(length * repetitions) / (double)interval_xor_packed_us,
+         (double)(length * repetitions) / (double)interval_cache_char_us,
          ret == SRSRAN_SUCCESS ? 'y' : 'n');
 
-  return SRSRAN_SUCCESS;
+  return ret;
 }
 
 int main(int argc, char** argv)
@@ -198,8 +285,10 @@ int main(int argc, char** argv)
   uint32_t min_length  = 16;
   uint32_t max_length  = MAX_SEQ_LEN;
 
-  srsran_sequence_t sequence   = {};
-  srsran_random_t   random_gen = srsran_random_init(0);
+  int                     ret        = SRSRAN_SUCCESS;
+  srsran_sequence_t       sequence   = {};
+  srsran_sequence_cache_t cache      = {};
+  srsran_random_t         random_gen = srsran_random_init(0);
 
   // Initialise vectors with ones
   for (uint32_t i = 0; i < MAX_SEQ_LEN; i++) {
@@ -218,7 +307,13 @@ int main(int argc, char** argv)
     return SRSRAN_ERROR;
   }
 
-  printf("%8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s;\n",
+  // Small cache, so that it also replaces entries
+  if (srsran_sequence_cache_init(&cache, 4) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Error initializing sequence cache\n");
+    return SRSRAN_ERROR;
+  }
+
+  printf("%8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s;\n",
          "seed",
          "length",
          "GEN",
@@ -227,15 +322,22 @@ int main(int argc, char** argv)
          "XOR 8",
          "XOR Unpack",
          "XOR Pack",
+         "Cache 8",
          "Passed");
 
   for (uint32_t length = min_length; length <= max_length; length = (length * 5) / 4) {
-    test_sequence(&sequence, (uint32_t)srsran_random_uniform_int_dist(random_gen, 1, INT32_MAX), length, repetitions);
+    uint32_t seed = (uint32_t)srsran_random_uniform_int_dist(random_gen, 1, INT32_MAX);
+    if (test_sequence(&sequence, &cache, seed, length, repetitions) < SRSRAN_SUCCESS) {
+      ret = SRSRAN_ERROR;
+    }
   }
 
+  printf("Cache hits=%" PRIu64 "; misses=%" PRIu64 ";\n", cache.nof_hits, cache.nof_misses);
+
   // Free sequence object
   srsran_sequence_free(&sequence);
+  srsran_sequence_cache_free(&cache);
   srsran_random_free(random_gen);
 
-  return SRSRAN_SUCCESS;
+  return ret;
 }
@@ -0,0 +1,137 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#include "srsran/common/test_common.h"
+#include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/common/zc_sequence.h"
+#include "srsran/phy/utils/primes.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <math.h>
+
+#define MAX_NOF_PRB 275
+#define MAX_M_ZC (MAX_NOF_PRB * SRSRAN_NRE)
+#define MAX_ERROR 1e-3
+
+static const float alphas[] = {0.0f, M_PI / 6.0f, M_PI / 2.0f, 11.0f * M_PI / 6.0f};
+
+static cf_t sequence[MAX_M_ZC];
+
+// Reference sequence for M_zc >= 36 straight from TS 38.211 section 5.2.2.1, in double precision
+static int test_sequence(uint32_t M_zc, uint32_t u, uint32_t v, float alpha)
+{
+  int32_t N_zc = srsran_prime_lower_than(M_zc);
+  TESTASSERT(N_zc > 0);
+
+  double q_hat = (double)N_zc * (u + 1) / 31.0;
+  double q     = floor(q_hat + 0.5) + v * (((int)floor(2.0 * q_hat) % 2 == 0) ? 1.0 : -1.0);
+
+  double max_error = 0.0;
+  for (uint32_t n = 0; n < M_zc; n++) {
+    double         m    = (double)(n % N_zc);
+    double complex gold = cexp(-I * M_PI * q * m * (m + 1.0) / N_zc) * cexp(I * (double)alpha * n);
+    double         err  = cabs(gold - sequence[n]);
+    max_error           = SRSRAN_MAX(max_error, err);
+  }
+
+  if (max_error > MAX_ERROR) {
+    printf("M_zc=%d; u=%d; v=%d; alpha=%.3f; max_error=%e;\n", M_zc, u, v, alpha, max_error);
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static int test_short(uint32_t M_zc)
+{
+  // Sequences shorter than 36 are QPSK-like, every sample must have unit modulus
+  for (uint32_t n = 0; n < M_zc; n++) {
+    TESTASSERT(fabsf(cabsf(sequence[n]) - 1.0f) < MAX_ERROR);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static int test_roots(uint32_t N_zc)
+{
+  const cf_t* roots = srsran_zc_sequence_roots(N_zc);
+  TESTASSERT(roots != NULL);
+
+  // The table is shared, so the second call must return the same pointer
+  TESTASSERT(roots == srsran_zc_sequence_roots(N_zc));
+
+  for (uint32_t k = 0; k < 2 * N_zc; k++) {
+    TESTASSERT(cabs(cexp(-I * M_PI * (double)k / N_zc) - roots[k]) < MAX_ERROR);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  TESTASSERT(test_roots(139) == SRSRAN_SUCCESS);
+  TESTASSERT(test_roots(839) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_zc_sequence_roots(0) == NULL);
+
+  // The second pass reads the sequences back from the cache
+  for (uint32_t pass = 0; pass < 2; pass++) {
+    for (uint32_t u = 0; u < SRSRAN_ZC_SEQUENCE_NOF_GROUPS; u++) {
+      for (uint32_t a = 0; a < sizeof(alphas) / sizeof(alphas[0]); a++) {
+        // NR low-PAPR sequences with delta 0 and 1
+        for (uint32_t delta = 0; delta < 2; delta++) {
+          // Every length up to 50 PRB and a spread of longer ones, the prime numbers table limits M_zc to 3299
+          for (uint32_t m = 1; m < MAX_NOF_PRB; m += (m < 50) ? 1 : 11) {
+            uint32_t M_zc = (m * SRSRAN_NRE) >> delta;
+
+            // There is no sequence between 24 and 36 samples
+            if (M_zc > 24 && M_zc < 36) {
+              continue;
+            }
+
+            for (uint32_t v = 0; v < SRSRAN_ZC_SEQUENCE_NOF_BASE; v++) {
+              if (M_zc < 72 && v > 0) {
+                continue;
+              }
+              TESTASSERT(srsran_zc_sequence_generate_nr(u, v, alphas[a], m, delta, sequence) == SRSRAN_SUCCESS);
+              if (M_zc < 36) {
+                TESTASSERT(test_short(M_zc) == SRSRAN_SUCCESS);
+              } else {
+                TESTASSERT(test_sequence(M_zc, u, v, alphas[a]) == SRSRAN_SUCCESS);
+              }
+            }
+          }
+        }
+
+        // LTE sequences
+        for (uint32_t nof_prb = 1; nof_prb <= 110; nof_prb += (nof_prb < 50) ? 1 : 7) {
+          uint32_t M_zc = nof_prb * SRSRAN_NRE;
+          TESTASSERT(srsran_zc_sequence_generate_lte(u, 0, alphas[a], nof_prb, sequence) == SRSRAN_SUCCESS);
+          if (M_zc < 36) {
+            TESTASSERT(test_short(M_zc) == SRSRAN_SUCCESS);
+          } else {
+            TESTASSERT(test_sequence(M_zc, u, 0, alphas[a]) == SRSRAN_SUCCESS);
+          }
+        }
+      }
+    }
+  }
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
@@ -26,6 +26,9 @@
 #include "srsran/phy/utils/vector.h"
 #include <assert.h>
 #include <complex.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
 
 #define NOF_ZC_SEQ 30
 
@@ -175,40 +178,140 @@ static const float zc_sequence_nr_phi_M_sc_24[NOF_ZC_SEQ][24] = {
     {-3, 1, -3, 1, -3, 1, 1, 3, 1, -3, -3, -1, 1, 3, -1, -3, 3, 1, -1, -3, -3, -3, -3, -3},
     {3, -3, -1, 1, 3, -1, -1, -3, -1, 3, -1, -3, -1, -3, 3, -1, 3, 1, 1, -3, 3, -3, -3, -3}};
 
-static void zc_sequence_lte_r_uv_arg_1prb(uint32_t u, cf_t* tmp_arg)
+// Longest ZC sequence, NR low-PAPR sequences span up to 275 PRB
+#define ZC_SEQUENCE_MAX_N_ZC 3300
+
+// Number of samples of the cyclic shift phasor computed with complex exponentials
+#define ZC_SEQUENCE_PHASOR_BLOCK 32
+
+// Tables of exp(-j*pi*k/N_zc) for k = 0..2*N_zc-1, indexed by N_zc. They are generated on first use and shared by all
+// objects, once published they are never modified nor freed so the returned pointers need no locking
+static const cf_t*     zc_sequence_roots_table[ZC_SEQUENCE_MAX_N_ZC + 1] = {};
+static pthread_mutex_t zc_sequence_roots_mutex                           = PTHREAD_MUTEX_INITIALIZER;
+
+const cf_t* srsran_zc_sequence_roots(uint32_t N_zc)
 {
-  assert(u < NOF_ZC_SEQ);
-  srsran_vec_sc_prod_fcc(zc_sequence_lte_phi_M_sc_12[u], M_PI_4, tmp_arg, SRSRAN_NRE);
+  if (N_zc == 0 || N_zc > ZC_SEQUENCE_MAX_N_ZC) {
+    return NULL;
+  }
+
+  pthread_mutex_lock(&zc_sequence_roots_mutex);
+  const cf_t* roots = zc_sequence_roots_table[N_zc];
+  if (roots == NULL) {
+    cf_t* table = srsran_vec_cf_malloc(2 * N_zc);
+    if (table != NULL) {
+      for (uint32_t k = 0; k < 2 * N_zc; k++) {
+        table[k] = (cf_t)cexp(-I * M_PI * (double)k / (double)N_zc);
+      }
+      zc_sequence_roots_table[N_zc] = table;
+      roots                         = table;
+    }
+  }
+  pthread_mutex_unlock(&zc_sequence_roots_mutex);
+
+  return roots;
 }
 
-static void zc_sequence_lte_r_uv_arg_2prb(uint32_t u, cf_t* tmp_arg)
+// Process-wide cache of generated sequences by standard, length, u, v and alpha. Entries are immutable once inserted
+// and never freed. The cache stops growing at ZC_SEQUENCE_CACHE_MAX_SAMPLES, later sequences are generated every time
+#define ZC_SEQUENCE_CACHE_NOF_BUCKETS 1024
+#define ZC_SEQUENCE_CACHE_MAX_SAMPLES (1U << 20)
+
+typedef struct zc_sequence_cache_entry_s {
+  struct zc_sequence_cache_entry_s* next;
+  bool                              nr;
+  uint32_t                          M_zc;
+  uint32_t                          u;
+  uint32_t                          v;
+  float                             alpha;
+  cf_t*                             sequence;
+} zc_sequence_cache_entry_t;
+
+static zc_sequence_cache_entry_t* zc_sequence_cache[ZC_SEQUENCE_CACHE_NOF_BUCKETS] = {};
+static uint32_t                   zc_sequence_cache_nof_samples                     = 0;
+static pthread_mutex_t            zc_sequence_cache_mutex                           = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t zc_sequence_cache_hash(bool nr, uint32_t M_zc, uint32_t u, uint32_t v, float alpha)
 {
-  assert(u < NOF_ZC_SEQ);
-  srsran_vec_sc_prod_fcc(zc_sequence_lte_phi_M_sc_24[u], M_PI_4, tmp_arg, 2 * SRSRAN_NRE);
+  uint32_t alpha_bits = 0;
+  memcpy(&alpha_bits, &alpha, sizeof(alpha_bits));
+
+  uint32_t h = (M_zc * SRSRAN_ZC_SEQUENCE_NOF_GROUPS + u) * SRSRAN_ZC_SEQUENCE_NOF_BASE + v;
+  h          = (h << 1U) | (nr ? 1U : 0U);
+  h ^= alpha_bits * 2654435761U;
+  return (h ^ (h >> 16U)) % ZC_SEQUENCE_CACHE_NOF_BUCKETS;
 }
 
-static void zc_sequence_nr_r_uv_arg_0dot5prb(uint32_t u, cf_t* tmp_arg)
+// Must be called with the cache mutex held
+static const zc_sequence_cache_entry_t*
+zc_sequence_cache_find(uint32_t bucket, bool nr, uint32_t M_zc, uint32_t u, uint32_t v, float alpha)
 {
-  assert(u < NOF_ZC_SEQ);
-  srsran_vec_sc_prod_fcc(zc_sequence_nr_phi_M_sc_6[u], M_PI_4, tmp_arg, SRSRAN_NRE / 2);
+  for (const zc_sequence_cache_entry_t* e = zc_sequence_cache[bucket]; e != NULL; e = e->next) {
+    // Alpha is compared bit-wise, callers derive it from the same cyclic shift expression
+    if (e->nr == nr && e->M_zc == M_zc && e->u == u && e->v == v && memcmp(&e->alpha, &alpha, sizeof(alpha)) == 0) {
+      return e;
+    }
+  }
+  return NULL;
 }
 
-static void zc_sequence_nr_r_uv_arg_1prb(uint32_t u, cf_t* tmp_arg)
+// Copies the sequence from the cache, returns false if it is not cached
+static bool zc_sequence_cache_get(bool nr, uint32_t M_zc, uint32_t u, uint32_t v, float alpha, cf_t* sequence)
 {
-  assert(u < NOF_ZC_SEQ);
-  srsran_vec_sc_prod_fcc(zc_sequence_nr_phi_M_sc_12[u], M_PI_4, tmp_arg, SRSRAN_NRE);
+  uint32_t bucket = zc_sequence_cache_hash(nr, M_zc, u, v, alpha);
+
+  pthread_mutex_lock(&zc_sequence_cache_mutex);
+  const zc_sequence_cache_entry_t* e = zc_sequence_cache_find(bucket, nr, M_zc, u, v, alpha);
+  if (e != NULL) {
+    srsran_vec_cf_copy(sequence, e->sequence, M_zc);
+  }
+  pthread_mutex_unlock(&zc_sequence_cache_mutex);
+
+  return e != NULL;
 }
 
-static void zc_sequence_nr_r_uv_arg_1dot5prb(uint32_t u, cf_t* tmp_arg)
+// Inserts a generated sequence, unless another thread did it first or the cache is full
+static void zc_sequence_cache_put(bool nr, uint32_t M_zc, uint32_t u, uint32_t v, float alpha, const cf_t* sequence)
 {
-  assert(u < NOF_ZC_SEQ);
-  srsran_vec_sc_prod_fcc(zc_sequence_nr_phi_M_sc_18[u], M_PI_4, tmp_arg, (3 * SRSRAN_NRE) / 2);
+  uint32_t bucket = zc_sequence_cache_hash(nr, M_zc, u, v, alpha);
+
+  pthread_mutex_lock(&zc_sequence_cache_mutex);
+  if (zc_sequence_cache_nof_samples + M_zc <= ZC_SEQUENCE_CACHE_MAX_SAMPLES &&
+      zc_sequence_cache_find(bucket, nr, M_zc, u, v, alpha) == NULL) {
+    zc_sequence_cache_entry_t* e = calloc(1, sizeof(zc_sequence_cache_entry_t));
+    cf_t*                      c = srsran_vec_cf_malloc(M_zc);
+    if (e != NULL && c != NULL) {
+      srsran_vec_cf_copy(c, sequence, M_zc);
+      e->next                   = zc_sequence_cache[bucket];
+      e->nr                     = nr;
+      e->M_zc                   = M_zc;
+      e->u                      = u;
+      e->v                      = v;
+      e->alpha                  = alpha;
+      e->sequence               = c;
+      zc_sequence_cache[bucket] = e;
+      zc_sequence_cache_nof_samples += M_zc;
+    } else {
+      free(e);
+      free(c);
+    }
+  }
+  pthread_mutex_unlock(&zc_sequence_cache_mutex);
 }
 
-static void zc_sequence_nr_r_uv_arg_2prb(uint32_t u, cf_t* tmp_arg)
+// Sequences shorter than 36 take exp(j*pi*phi/4), that is the entry -phi mod 8 of the 8th roots of unity
+static int zc_sequence_r_uv_phi(const float* phi, uint32_t M_zc, cf_t* sequence)
 {
-  assert(u < NOF_ZC_SEQ);
-  srsran_vec_sc_prod_fcc(zc_sequence_nr_phi_M_sc_24[u], M_PI_4, tmp_arg, 2 * SRSRAN_NRE);
+  const cf_t* roots = srsran_zc_sequence_roots(4);
+  if (roots == NULL) {
+    return SRSRAN_ERROR;
+  }
+
+  for (uint32_t i = 0; i < M_zc; i++) {
+    sequence[i] = roots[(8 - (int32_t)phi[i]) % 8];
+  }
+
+  return SRSRAN_SUCCESS;
 }
 
 static uint32_t zc_sequence_q(uint32_t u, uint32_t v, uint32_t N_sz)
@@ -227,59 +330,105 @@ static uint32_t zc_sequence_q(uint32_t u, uint32_t v, uint32_t N_sz)
 }
 
 // Common for LTE and NR
-static void zc_sequence_r_uv_arg_mprb(uint32_t M_zc, uint32_t u, uint32_t v, cf_t* tmp_arg)
+static int zc_sequence_r_uv_mprb(uint32_t M_zc, uint32_t u, uint32_t v, cf_t* sequence)
 {
   int32_t N_sz = srsran_prime_lower_than(M_zc); // N_zc - Zadoff Chu Sequence Length
-  if (N_sz > 0) {
-    float q    = zc_sequence_q(u, v, N_sz);
-    float n_sz = (float)N_sz;
-    for (uint32_t i = 0; i < M_zc; i++) {
-      float m    = (float)(i % N_sz);
-      tmp_arg[i] = -M_PI * q * m * (m + 1) / n_sz;
+  if (N_sz <= 0) {
+    ERROR("Invalid M_zc (%d)", M_zc);
+    return SRSRAN_ERROR;
+  }
+
+  const cf_t* roots = srsran_zc_sequence_roots(N_sz);
+  if (roots == NULL) {
+    ERROR("Error getting ZC roots of unity for N_zc=%d", N_sz);
+    return SRSRAN_ERROR;
+  }
+
+  // The argument -pi*q*m*(m+1)/N_sz is tracked as the integer phase index q*m*(m+1) mod 2*N_sz, which grows by
+  // 2*q*(m+1) from one sample to the next
+  uint32_t two_n = 2 * (uint32_t)N_sz;
+  uint32_t q2    = (2 * zc_sequence_q(u, v, N_sz)) % two_n;
+  uint32_t idx   = 0;
+  uint32_t step  = q2;
+  for (uint32_t i = 0, m = 0; i < M_zc; i++) {
+    sequence[i] = roots[idx];
+
+    if (++m == N_sz) {
+      m    = 0;
+      idx  = 0;
+      step = q2;
+      continue;
     }
+
+    idx += step;
+    idx -= (idx >= two_n) ? two_n : 0;
+    step += q2;
+    step -= (step >= two_n) ? two_n : 0;
   }
+
+  return SRSRAN_SUCCESS;
 }
 
-static int zc_sequence_lte_r_uv_arg(uint32_t M_zc, uint32_t u, uint32_t v, cf_t* tmp_arg)
+static int zc_sequence_lte_r_uv(uint32_t M_zc, uint32_t u, uint32_t v, cf_t* sequence)
 {
+  assert(u < NOF_ZC_SEQ);
+
   if (M_zc == 12) {
-    zc_sequence_lte_r_uv_arg_1prb(u, tmp_arg);
-  } else if (M_zc == 24) {
-    zc_sequence_lte_r_uv_arg_2prb(u, tmp_arg);
-  } else if (M_zc >= 36) {
-    zc_sequence_r_uv_arg_mprb(M_zc, u, v, tmp_arg);
-  } else {
-    ERROR("Invalid M_zc (%d)", M_zc);
-    return SRSRAN_ERROR;
+    return zc_sequence_r_uv_phi(zc_sequence_lte_phi_M_sc_12[u], M_zc, sequence);
+  }
+  if (M_zc == 24) {
+    return zc_sequence_r_uv_phi(zc_sequence_lte_phi_M_sc_24[u], M_zc, sequence);
+  }
+  if (M_zc >= 36) {
+    return zc_sequence_r_uv_mprb(M_zc, u, v, sequence);
   }
 
-  return SRSRAN_SUCCESS;
+  ERROR("Invalid M_zc (%d)", M_zc);
+  return SRSRAN_ERROR;
 }
 
-static int zc_sequence_nr_r_uv_arg(uint32_t M_zc, uint32_t u, uint32_t v, cf_t* tmp_arg)
+static int zc_sequence_nr_r_uv(uint32_t M_zc, uint32_t u, uint32_t v, cf_t* sequence)
 {
+  assert(u < NOF_ZC_SEQ);
+
   if (M_zc == 6) {
-    zc_sequence_nr_r_uv_arg_0dot5prb(u, tmp_arg);
-  } else if (M_zc == 12) {
-    zc_sequence_nr_r_uv_arg_1prb(u, tmp_arg);
-  } else if (M_zc == 18) {
-    zc_sequence_nr_r_uv_arg_1dot5prb(u, tmp_arg);
-  } else if (M_zc == 24) {
-    zc_sequence_nr_r_uv_arg_2prb(u, tmp_arg);
-  } else if (M_zc >= 36) {
-    zc_sequence_r_uv_arg_mprb(M_zc, u, v, tmp_arg);
-  } else {
-    ERROR("Invalid M_zc (%d)", M_zc);
-    return SRSRAN_ERROR;
+    return zc_sequence_r_uv_phi(zc_sequence_nr_phi_M_sc_6[u], M_zc, sequence);
+  }
+  if (M_zc == 12) {
+    return zc_sequence_r_uv_phi(zc_sequence_nr_phi_M_sc_12[u], M_zc, sequence);
+  }
+  if (M_zc == 18) {
+    return zc_sequence_r_uv_phi(zc_sequence_nr_phi_M_sc_18[u], M_zc, sequence);
+  }
+  if (M_zc == 24) {
+    return zc_sequence_r_uv_phi(zc_sequence_nr_phi_M_sc_24[u], M_zc, sequence);
+  }
+  if (M_zc >= 36) {
+    return zc_sequence_r_uv_mprb(M_zc, u, v, sequence);
   }
 
-  return SRSRAN_SUCCESS;
+  ERROR("Invalid M_zc (%d)", M_zc);
+  return SRSRAN_ERROR;
 }
 
-static void zc_sequence_generate(uint32_t M_zc, float alpha, const cf_t* tmp_arg, cf_t* sequence)
+// Applies the cyclic shift exp(j*alpha*n). Only the first block and one seed per block take a complex exponential and
+// every sample is a single product of both, so the rounding error does not build up along the sequence
+static void zc_sequence_apply_alpha(uint32_t M_zc, float alpha, cf_t* sequence)
 {
-  for (uint32_t i = 0; i < M_zc; i++) {
-    sequence[i] = cexpf(I * (tmp_arg[i] + alpha * (cf_t)i));
+  if (alpha == 0.0f) {
+    return;
+  }
+
+  cf_t phasor[ZC_SEQUENCE_PHASOR_BLOCK];
+  for (uint32_t i = 0; i < ZC_SEQUENCE_PHASOR_BLOCK; i++) {
+    phasor[i] = cexpf(I * alpha * (float)i);
+  }
+
+  for (uint32_t i = 0; i < M_zc; i += ZC_SEQUENCE_PHASOR_BLOCK) {
+    uint32_t n    = SRSRAN_MIN(ZC_SEQUENCE_PHASOR_BLOCK, M_zc - i);
+    cf_t     seed = (cf_t)cexp(I * (double)alpha * (double)i);
+    srsran_vec_prod_ccc(&sequence[i], phasor, &sequence[i], n);
+    srsran_vec_sc_prod_ccc(&sequence[i], seed, &sequence[i], n);
   }
 }
 
@@ -299,13 +448,20 @@ int srsran_zc_sequence_generate_lte(uint32_t u, uint32_t v, float alpha, uint32_
   // Calculate number of samples
   uint32_t M_zc = nof_prb * SRSRAN_NRE;
 
-  // Calculate argument
-  if (zc_sequence_lte_r_uv_arg(M_zc, u, v, sequence) < SRSRAN_SUCCESS) {
+  // Look up the cache
+  if (zc_sequence_cache_get(false, M_zc, u, v, alpha, sequence)) {
+    return SRSRAN_SUCCESS;
+  }
+
+  // Generate base sequence
+  if (zc_sequence_lte_r_uv(M_zc, u, v, sequence) < SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
-  // Do complex exponential and adjust amplitude
-  zc_sequence_generate(M_zc, alpha, sequence, sequence);
+  // Apply cyclic shift
+  zc_sequence_apply_alpha(M_zc, alpha, sequence);
+
+  zc_sequence_cache_put(false, M_zc, u, v, alpha, sequence);
 
   return SRSRAN_SUCCESS;
 }
@@ -326,13 +482,20 @@ int srsran_zc_sequence_generate_nr(uint32_t u, uint32_t v, float alpha, uint32_t
   // Calculate number of samples
   uint32_t M_zc = (m * SRSRAN_NRE) >> delta;
 
-  // Calculate argument
-  if (zc_sequence_nr_r_uv_arg(M_zc, u, v, sequence) < SRSRAN_SUCCESS) {
+  // Look up the cache
+  if (zc_sequence_cache_get(true, M_zc, u, v, alpha, sequence)) {
+    return SRSRAN_SUCCESS;
+  }
+
+  // Generate base sequence
+  if (zc_sequence_nr_r_uv(M_zc, u, v, sequence) < SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
-  // Do complex exponential and adjust amplitude
-  zc_sequence_generate(M_zc, alpha, sequence, sequence);
+  // Apply cyclic shift
+  zc_sequence_apply_alpha(M_zc, alpha, sequence);
+
+  zc_sequence_cache_put(true, M_zc, u, v, alpha, sequence);
 
   return SRSRAN_SUCCESS;
 }
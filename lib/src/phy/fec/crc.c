@@ -23,10 +23,233 @@
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
 
+#include <string.h>
+
 #ifdef LV_HAVE_SSE
 #include <immintrin.h>
 #endif // LV_HAVE_SSE
 
+/*
+ * Carry-less multiply CRC, see "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" (Intel).
+ *
+ * The message is folded in 128-bit blocks (MSB first) keeping four independent accumulators, using the identity
+ * (H * x^64 + L) * x^N = H * (x^(N+64) mod P) + L * (x^N mod P). The input is zero-padded at the front up to a whole
+ * number of blocks, which does not change a CRC with zero initial value. The last 64 bits are reduced with the lookup
+ * table. The kernels are compiled for any x86 SIMD build and enabled at init time if the CPU supports them.
+ */
+#define CRC_CLMUL_MIN_BITS 256
+#define CRC_CLMUL512_MIN_BLOCKS 32
+#define CRC_CLMUL_MAX_ORDER 32
+
+// Indexes in clmul_k
+#define CRC_CLMUL_K128 0
+#define CRC_CLMUL_K256 1
+#define CRC_CLMUL_K384 2
+#define CRC_CLMUL_K512 3
+#define CRC_CLMUL_K1024 4
+#define CRC_CLMUL_K1536 5
+#define CRC_CLMUL_K2048 6
+
+#ifdef LV_HAVE_SSE
+#define CRC_CLMUL_TARGET __attribute__((target("pclmul")))
+#define CRC_CLMUL_INLINE static inline __attribute__((always_inline, target("pclmul")))
+
+CRC_CLMUL_INLINE __m128i crc_clmul_fold(__m128i x, const uint64_t k[2])
+{
+  __m128i kk = _mm_set_epi64x((long long)k[0], (long long)k[1]);
+  return _mm_xor_si128(_mm_clmulepi64_si128(x, kk, 0x11), _mm_clmulepi64_si128(x, kk, 0x00));
+}
+
+// Loads 16 packed bytes, first byte in the most significant position
+CRC_CLMUL_INLINE __m128i crc_clmul_load_bytes(const uint8_t* ptr)
+{
+  const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)ptr), bswap);
+}
+
+// Packs 128 unpacked bits into one block, first bit in the most significant position
+CRC_CLMUL_INLINE __m128i crc_clmul_load_bits(const uint8_t* ptr)
+{
+#ifdef LV_HAVE_AVX2
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i rev  = _mm256_set_epi8(
+      8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+  uint32_t m[4];
+  for (uint32_t i = 0; i < 4; i++) {
+    __m256i mask = _mm256_cmpgt_epi8(_mm256_loadu_si256((const __m256i*)(ptr + 32 * i)), zero);
+    m[i]         = (uint32_t)_mm256_movemask_epi8(_mm256_shuffle_epi8(mask, rev));
+  }
+  __m128i packed = _mm_set_epi32((int)m[3], (int)m[2], (int)m[1], (int)m[0]);
+#else  /* LV_HAVE_AVX2 */
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i rev  = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+  uint16_t      m[8];
+  for (uint32_t i = 0; i < 8; i++) {
+    __m128i mask = _mm_cmpgt_epi8(_mm_loadu_si128((const __m128i*)(ptr + 16 * i)), zero);
+    m[i]         = (uint16_t)_mm_movemask_epi8(_mm_shuffle_epi8(mask, rev));
+  }
+  __m128i packed = _mm_loadu_si128((const __m128i*)m);
+#endif /* LV_HAVE_AVX2 */
+  const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  return _mm_shuffle_epi8(packed, bswap);
+}
+
+CRC_CLMUL_INLINE uint32_t crc_clmul_finish(srsran_crc_t* h, __m128i x)
+{
+  // 128 to 64 bits, twice since the first product can exceed 64 bits
+  __m128i k = _mm_cvtsi64_si128((long long)h->clmul_x64);
+  x         = _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x01), _mm_move_epi64(x));
+  x         = _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x01), _mm_move_epi64(x));
+
+  // The remainder of the 64 bits times x^order is the CRC of these 8 bytes
+  uint64_t t = (uint64_t)_mm_cvtsi128_si64(x);
+  h->crcinit = 0;
+  for (int i = 7; i >= 0; i--) {
+    srsran_crc_checksum_put_byte(h, (uint8_t)(t >> (8U * i)));
+  }
+  return (uint32_t)srsran_crc_checksum_get(h);
+}
+
+// Folds nof_blocks blocks into the accumulators, which hold x0 * x^384 + x1 * x^256 + x2 * x^128 + x3
+CRC_CLMUL_INLINE uint32_t crc_clmul_run(srsran_crc_t*  h,
+                                        __m128i        x0,
+                                        __m128i        x1,
+                                        __m128i        x2,
+                                        __m128i        x3,
+                                        const uint8_t* ptr,
+                                        uint32_t       nof_blocks,
+                                        bool           unpacked)
+{
+  uint32_t stride = unpacked ? 128 : 16;
+
+  for (; nof_blocks >= 4; nof_blocks -= 4) {
+    const uint64_t* k = h->clmul_k[CRC_CLMUL_K512];
+    if (unpacked) {
+      x0 = _mm_xor_si128(crc_clmul_fold(x0, k), crc_clmul_load_bits(ptr));
+      x1 = _mm_xor_si128(crc_clmul_fold(x1, k), crc_clmul_load_bits(ptr + stride));
+      x2 = _mm_xor_si128(crc_clmul_fold(x2, k), crc_clmul_load_bits(ptr + 2 * stride));
+      x3 = _mm_xor_si128(crc_clmul_fold(x3, k), crc_clmul_load_bits(ptr + 3 * stride));
+    } else {
+      x0 = _mm_xor_si128(crc_clmul_fold(x0, k), crc_clmul_load_bytes(ptr));
+      x1 = _mm_xor_si128(crc_clmul_fold(x1, k), crc_clmul_load_bytes(ptr + stride));
+      x2 = _mm_xor_si128(crc_clmul_fold(x2, k), crc_clmul_load_bytes(ptr + 2 * stride));
+      x3 = _mm_xor_si128(crc_clmul_fold(x3, k), crc_clmul_load_bytes(ptr + 3 * stride));
+    }
+    ptr += 4 * stride;
+  }
+
+  __m128i x = _mm_xor_si128(crc_clmul_fold(x0, h->clmul_k[CRC_CLMUL_K384]), x3);
+  x         = _mm_xor_si128(x, crc_clmul_fold(x1, h->clmul_k[CRC_CLMUL_K256]));
+  x         = _mm_xor_si128(x, crc_clmul_fold(x2, h->clmul_k[CRC_CLMUL_K128]));
+
+  for (; nof_blocks > 0; nof_blocks--) {
+    __m128i block = unpacked ? crc_clmul_load_bits(ptr) : crc_clmul_load_bytes(ptr);
+    x             = _mm_xor_si128(crc_clmul_fold(x, h->clmul_k[CRC_CLMUL_K128]), block);
+    ptr += stride;
+  }
+
+  return crc_clmul_finish(h, x);
+}
+
+#ifdef LV_HAVE_AVX512
+// Folds 256 bytes per iteration with four 512-bit accumulators, then hands over to the 128-bit kernel
+__attribute__((target("pclmul,vpclmulqdq"))) static uint32_t
+crc_clmul512_bytes(srsran_crc_t* h, const uint8_t* head, const uint8_t* ptr, uint32_t nof_blocks)
+{
+  const __m512i bswap = _mm512_broadcast_i32x4(_mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+  const __m512i k2048 = _mm512_broadcast_i32x4(
+      _mm_set_epi64x((long long)h->clmul_k[CRC_CLMUL_K2048][0], (long long)h->clmul_k[CRC_CLMUL_K2048][1]));
+
+  __m512i z[4];
+  z[0] = _mm512_setzero_si512();
+  z[1] = _mm512_setzero_si512();
+  z[2] = _mm512_setzero_si512();
+  z[3] = _mm512_inserti32x4(_mm512_setzero_si512(), crc_clmul_load_bytes(head), 3);
+
+  for (; nof_blocks >= 16; nof_blocks -= 16) {
+    for (uint32_t i = 0; i < 4; i++) {
+      __m512i block = _mm512_shuffle_epi8(_mm512_loadu_si512((const void*)(ptr + 64 * i)), bswap);
+      z[i]          = _mm512_ternarylogic_epi64(
+          _mm512_clmulepi64_epi128(z[i], k2048, 0x11), _mm512_clmulepi64_epi128(z[i], k2048, 0x00), block, 0x96);
+    }
+    ptr += 256;
+  }
+
+  // Merge into one 512-bit accumulator, its lanes are the four 128-bit accumulators
+  const uint32_t k_idx[3] = {CRC_CLMUL_K1536, CRC_CLMUL_K1024, CRC_CLMUL_K512};
+  __m512i        acc      = z[3];
+  for (uint32_t i = 0; i < 3; i++) {
+    const uint64_t* k  = h->clmul_k[k_idx[i]];
+    __m512i         kk = _mm512_broadcast_i32x4(_mm_set_epi64x((long long)k[0], (long long)k[1]));
+    acc                = _mm512_ternarylogic_epi64(
+        acc, _mm512_clmulepi64_epi128(z[i], kk, 0x11), _mm512_clmulepi64_epi128(z[i], kk, 0x00), 0x96);
+  }
+
+  return crc_clmul_run(h,
+                       _mm512_extracti32x4_epi32(acc, 0),
+                       _mm512_extracti32x4_epi32(acc, 1),
+                       _mm512_extracti32x4_epi32(acc, 2),
+                       _mm512_extracti32x4_epi32(acc, 3),
+                       ptr,
+                       nof_blocks,
+                       false);
+}
+#endif /* LV_HAVE_AVX512 */
+
+CRC_CLMUL_TARGET static uint32_t crc_clmul_bytes(srsran_crc_t* h, const uint8_t* data, uint32_t nof_bytes)
+{
+  // Leading partial block, zero-padded at the front
+  uint32_t head_len = nof_bytes % 16;
+  uint8_t  head[16] = {0};
+  memcpy(&head[16 - head_len], data, head_len);
+  data += head_len;
+  uint32_t nof_blocks = nof_bytes / 16;
+
+#ifdef LV_HAVE_AVX512
+  if (h->clmul512 && nof_blocks >= CRC_CLMUL512_MIN_BLOCKS) {
+    return crc_clmul512_bytes(h, head, data, nof_blocks);
+  }
+#endif /* LV_HAVE_AVX512 */
+
+  const __m128i zero = _mm_setzero_si128();
+  return crc_clmul_run(h, zero, zero, zero, crc_clmul_load_bytes(head), data, nof_blocks, false);
+}
+
+// Packs and folds unpacked bits in a single pass, any length
+CRC_CLMUL_TARGET static uint32_t crc_clmul_bits(srsran_crc_t* h, const uint8_t* data, uint32_t nof_bits)
+{
+  uint32_t head_len  = nof_bits % 128;
+  uint8_t  head[128] = {0};
+  memcpy(&head[128 - head_len], data, head_len);
+  data += head_len;
+
+  const __m128i zero = _mm_setzero_si128();
+  return crc_clmul_run(h, zero, zero, zero, crc_clmul_load_bits(head), data, nof_bits / 128, true);
+}
+#endif /* LV_HAVE_SSE */
+
+static uint64_t crc_xpow_mod(const srsran_crc_t* h, uint32_t n)
+{
+  uint64_t r = 1;
+  for (uint32_t i = 0; i < n; i++) {
+    r <<= 1U;
+    if (r & ((uint64_t)1 << (uint32_t)h->order)) {
+      r ^= (uint32_t)h->polynom;
+    }
+  }
+  return r;
+}
+
+static void gen_crc_clmul(srsran_crc_t* h)
+{
+  const uint32_t n[SRSRAN_CRC_CLMUL_NOF_K] = {1, 2, 3, 4, 8, 12, 16};
+  for (uint32_t i = 0; i < SRSRAN_CRC_CLMUL_NOF_K; i++) {
+    h->clmul_k[i][0] = crc_xpow_mod(h, 128 * n[i] + 64);
+    h->clmul_k[i][1] = crc_xpow_mod(h, 128 * n[i]);
+  }
+  h->clmul_x64 = crc_xpow_mod(h, 64);
+}
+
 static void gen_crc_table(srsran_crc_t* h)
 {
   uint32_t pad        = (h->order < 8) ? (8 - h->order) : 0;
@@ -89,15 +312,40 @@ int srsran_crc_init(srsran_crc_t* h, uint32_t crc_poly, int crc_order)
   // generate lookup table
   gen_crc_table(h);
 
+  // Folding constants and CPU support
+  gen_crc_clmul(h);
+  srsran_crc_set_clmul(h, true);
+
   return 0;
 }
 
+void srsran_crc_set_clmul(srsran_crc_t* h, bool enable)
+{
+  h->clmul    = false;
+  h->clmul512 = false;
+  if (!enable || h->order > CRC_CLMUL_MAX_ORDER) {
+    return;
+  }
+#ifdef LV_HAVE_SSE
+  h->clmul = __builtin_cpu_supports("pclmul");
+#ifdef LV_HAVE_AVX512
+  h->clmul512 = h->clmul && __builtin_cpu_supports("vpclmulqdq");
+#endif /* LV_HAVE_AVX512 */
+#endif /* LV_HAVE_SSE */
+}
+
 uint32_t srsran_crc_checksum(srsran_crc_t* h, uint8_t* data, int len)
 {
   int      i, k, len8, res8, a = 0;
   uint32_t crc = 0;
   uint8_t* pter;
 
+#ifdef LV_HAVE_SSE
+  if (h->clmul && len >= CRC_CLMUL_MIN_BITS) {
+    return crc_clmul_bits(h, data, (uint32_t)len);
+  }
+#endif /* LV_HAVE_SSE */
+
   srsran_crc_set_init(h, 0);
 
   // Pack bits into bytes
@@ -149,6 +397,12 @@ uint32_t srsran_crc_checksum_byte(srsran_crc_t* h, const uint8_t* data, int len)
   int      i;
   uint32_t crc = 0;
 
+#ifdef LV_HAVE_SSE
+  if (h->clmul && len >= CRC_CLMUL_MIN_BITS) {
+    return crc_clmul_bytes(h, data, (uint32_t)len / 8);
+  }
+#endif /* LV_HAVE_SSE */
+
   srsran_crc_set_init(h, 0);
 
   // Calculate CRC
@@ -0,0 +1,167 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Checks the carry-less multiply CRC kernels against the lookup table for the LTE/NR polynomials and measures the
+ * throughput of both.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "srsran/srsran.h"
+
+static uint32_t nof_reps  = 1000;
+static uint32_t bench_len = 8448; // Largest NR code block (LDPC BG1)
+static uint32_t seed      = 1;
+
+static volatile uint32_t bench_sink = 0;
+
+typedef struct {
+  const char* name;
+  uint32_t    poly;
+  int         order;
+} crc_poly_t;
+
+static const crc_poly_t polys[] = {{"24A", SRSRAN_LTE_CRC24A, 24},
+                                   {"24B", SRSRAN_LTE_CRC24B, 24},
+                                   {"24C", SRSRAN_LTE_CRC24C, 24},
+                                   {"16", SRSRAN_LTE_CRC16, 16},
+                                   {"11", SRSRAN_LTE_CRC11, 11},
+                                   {"8", SRSRAN_LTE_CRC8, 8},
+                                   {"6", SRSRAN_LTE_CRC6, 6}};
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [Rls]\n", prog);
+  printf("\t-R Number of benchmark repetitions [Default %d]\n", nof_reps);
+  printf("\t-l Benchmark length in bits [Default %d]\n", bench_len);
+  printf("\t-s seed [Default %d, 0=time]\n", seed);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "Rls")) != -1) {
+    switch (opt) {
+      case 'R':
+        nof_reps = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        bench_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        seed = (uint32_t)strtoul(argv[optind], NULL, 0);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// Returns the elapsed seconds for nof_reps checksums
+static double bench(srsran_crc_t* crc, uint8_t* data, uint32_t len, bool packed)
+{
+  struct timeval t[3];
+  uint32_t       acc = 0;
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < nof_reps; r++) {
+    acc ^= packed ? srsran_crc_checksum_byte(crc, data, len) : srsran_crc_checksum(crc, data, len);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+
+  bench_sink = acc;
+  return t[0].tv_sec + 1e-6 * t[0].tv_usec;
+}
+
+int main(int argc, char** argv)
+{
+  int ret = SRSRAN_SUCCESS;
+
+  parse_args(argc, argv);
+
+  if (!seed) {
+    seed = time(NULL);
+  }
+  srand(seed);
+
+  uint32_t max_len = SRSRAN_MAX(bench_len, 4 * 8448);
+  uint8_t* bits    = srsran_vec_u8_malloc(max_len);
+  uint8_t* bytes   = srsran_vec_u8_malloc(max_len / 8 + 1);
+  if (bits == NULL || bytes == NULL) {
+    perror("malloc");
+    exit(-1);
+  }
+  for (uint32_t i = 0; i < max_len; i++) {
+    bits[i] = rand() % 2;
+  }
+  srsran_bit_pack_vector(bits, bytes, max_len);
+
+  srsran_crc_t crc_table, crc_clmul;
+  for (uint32_t p = 0; p < sizeof(polys) / sizeof(crc_poly_t) && ret == SRSRAN_SUCCESS; p++) {
+    if (srsran_crc_init(&crc_table, polys[p].poly, polys[p].order) < SRSRAN_SUCCESS ||
+        srsran_crc_init(&crc_clmul, polys[p].poly, polys[p].order) < SRSRAN_SUCCESS) {
+      ERROR("Error initialising CRC %s", polys[p].name);
+      exit(-1);
+    }
+    srsran_crc_set_clmul(&crc_table, false);
+
+    // Every length around the block boundaries, then random lengths up to the maximum
+    for (uint32_t i = 0; i < 2048 + 1000; i++) {
+      uint32_t len = (i < 2048) ? i : (uint32_t)(rand() % max_len);
+      if (srsran_crc_checksum(&crc_table, bits, len) != srsran_crc_checksum(&crc_clmul, bits, len)) {
+        ERROR("CRC %s unpacked mismatch for %d bits", polys[p].name, len);
+        ret = SRSRAN_ERROR;
+        break;
+      }
+      uint32_t len8 = len & ~7U;
+      if (srsran_crc_checksum_byte(&crc_table, bytes, len8) != srsran_crc_checksum_byte(&crc_clmul, bytes, len8)) {
+        ERROR("CRC %s packed mismatch for %d bits", polys[p].name, len8);
+        ret = SRSRAN_ERROR;
+        break;
+      }
+    }
+
+    double t_table  = bench(&crc_table, bits, bench_len, false);
+    double t_clmul  = bench(&crc_clmul, bits, bench_len, false);
+    double t_table8 = bench(&crc_table, bytes, bench_len, true);
+    double t_clmul8 = bench(&crc_clmul, bytes, bench_len, true);
+    double nbytes   = (double)nof_reps * bench_len / 8;
+    printf("CRC%-3s unpacked: table %6.2f GB/s, clmul %6.2f GB/s; packed: table %6.2f GB/s, clmul %6.2f GB/s%s\n",
+           polys[p].name,
+           nbytes / t_table / 1e9,
+           nbytes / t_clmul / 1e9,
+           nbytes / t_table8 / 1e9,
+           nbytes / t_clmul8 / 1e9,
+           crc_clmul.clmul ? (crc_clmul.clmul512 ? " (vpclmulqdq)" : " (pclmulqdq)") : " (not supported)");
+  }
+
+  free(bits);
+  free(bytes);
+
+  printf("%s\n", ret == SRSRAN_SUCCESS ? "Ok" : "Failed");
+  return ret;
+}
@@ -310,6 +310,17 @@ int srsran_pdcch_nr_set_carrier(srsran_pdcch_nr_t*         q,
     q->coreset = *coreset;
   }
 
+  // Locate every CORESET RB in the grid once, so the RE mapping only walks the candidate RB
+  q->coreset_bw = 0;
+  for (uint32_t r = 0; r < SRSRAN_CORESET_FREQ_DOMAIN_RES_SIZE; r++) {
+    if (!q->coreset.freq_resources[r]) {
+      continue;
+    }
+    for (uint32_t i = r * 6; i < (r + 1) * 6 && q->coreset_bw < SRSRAN_MAX_PRB_NR; i++) {
+      q->coreset_rb_k0[q->coreset_bw++] = (q->coreset.offset_rb + i) * SRSRAN_NRE;
+    }
+  }
+
   return SRSRAN_SUCCESS;
 }
 
@@ -404,14 +415,15 @@ int srsran_pdcch_nr_cce_to_reg_mapping(const srsran_coreset_t*      coreset,
   return pdcch_nr_cce_to_reg_mapping_interleaved(coreset, dci_location, rb_mask);
 }
 
+/// Sub-carrier indexes of the PDCCH resource elements within a RB, the rest carry DMRS
+static const uint32_t pdcch_nr_data_re[SRSRAN_NRE - 3] = {0, 2, 3, 4, 6, 7, 8, 10, 11};
+
 static uint32_t pdcch_nr_cp(const srsran_pdcch_nr_t*     q,
                             const srsran_dci_location_t* dci_location,
                             cf_t*                        slot_grid,
                             cf_t*                        symbols,
                             bool                         put)
 {
-  uint32_t offset_k = q->coreset.offset_rb * SRSRAN_NRE;
-
   // Compute REG list
   bool rb_mask[SRSRAN_MAX_PRB_NR] = {};
   if (srsran_pdcch_nr_cce_to_reg_mapping(&q->coreset, dci_location, rb_mask) < SRSRAN_SUCCESS) {
@@ -422,34 +434,24 @@ static uint32_t pdcch_nr_cp(const srsran_pdcch_nr_t*     q,
 
   // Iterate over symbols
   for (uint32_t l = 0; l < q->coreset.duration; l++) {
-    // Iterate over frequency resource groups
-    uint32_t rb = 0;
-    for (uint32_t r = 0; r < SRSRAN_CORESET_FREQ_DOMAIN_RES_SIZE; r++) {
-      // Skip frequency resource if not set
-      if (!q->coreset.freq_resources[r]) {
+    cf_t* symbol = &slot_grid[q->carrier.nof_prb * SRSRAN_NRE * l];
+
+    // For each CORESET RB
+    for (uint32_t rb = 0; rb < q->coreset_bw; rb++) {
+      // Skip if this RB is not marked as mapped
+      if (!rb_mask[rb]) {
         continue;
       }
 
-      // For each RB in the frequency resource
-      for (uint32_t i = r * 6; i < (r + 1) * 6; i++, rb++) {
-        // Skip if this RB is not marked as mapped
-        if (!rb_mask[rb]) {
-          continue;
+      // Read or write the RB data RE in the grid
+      cf_t* re = &symbol[q->coreset_rb_k0[rb]];
+      if (put) {
+        for (uint32_t j = 0; j < SRSRAN_NRE - 3; j++) {
+          re[pdcch_nr_data_re[j]] = symbols[count++];
         }
-
-        // For each RE in the RB
-        for (uint32_t k = i * SRSRAN_NRE; k < (i + 1) * SRSRAN_NRE; k++) {
-          // Skip if it is a DMRS
-          if (k % 4 == 1) {
-            continue;
-          }
-
-          // Read or write in the grid
-          if (put) {
-            slot_grid[q->carrier.nof_prb * SRSRAN_NRE * l + k + offset_k] = symbols[count++];
-          } else {
-            symbols[count++] = slot_grid[q->carrier.nof_prb * SRSRAN_NRE * l + k + offset_k];
-          }
+      } else {
+        for (uint32_t j = 0; j < SRSRAN_NRE - 3; j++) {
+          symbols[count++] = re[pdcch_nr_data_re[j]];
         }
       }
     }
@@ -71,6 +71,11 @@ int pdsch_nr_init_common(srsran_pdsch_nr_t* q, const srsran_pdsch_nr_args_t* arg
     return SRSRAN_ERROR;
   }
 
+  if (srsran_sequence_cache_init(&q->scrambling, SRSRAN_SEQUENCE_CACHE_DEFAULT_NOF_ENTRIES) < SRSRAN_SUCCESS) {
+    ERROR("Initialising scrambling sequence cache");
+    return SRSRAN_ERROR;
+  }
+
   return SRSRAN_SUCCESS;
 }
 
@@ -197,6 +202,8 @@ void srsran_pdsch_nr_free(srsran_pdsch_nr_t* q)
     srsran_evm_free(q->evm_buffer);
   }
 
+  srsran_sequence_cache_free(&q->scrambling);
+
   SRSRAN_MEM_ZERO(q, srsran_pdsch_nr_t, 1);
 }
 
@@ -337,7 +344,7 @@ static inline int pdsch_nr_encode_codeword(srsran_pdsch_nr_t*         q,
 
   // 7.3.1.1 Scrambling
   uint32_t cinit = pdsch_nr_cinit(&q->carrier, cfg, rnti, tb->cw_idx);
-  srsran_sequence_apply_bit(q->b[tb->cw_idx], q->b[tb->cw_idx], tb->nof_bits, cinit);
+  srsran_sequence_cache_apply_bit(&q->scrambling, q->b[tb->cw_idx], q->b[tb->cw_idx], tb->nof_bits, cinit);
 
   // 7.3.1.2 Modulation
   srsran_mod_modulate(&q->modem_tables[tb->mod], q->b[tb->cw_idx], q->d[tb->cw_idx], tb->nof_bits);
@@ -467,7 +474,8 @@ static inline int pdsch_nr_decode_codeword(srsran_pdsch_nr_t*         q,
   srsran_vec_neg_bb(llr, llr, tb->nof_bits);
 
   // Descrambling
-  srsran_sequence_apply_c(llr, llr, tb->nof_bits, pdsch_nr_cinit(&q->carrier, cfg, rnti, tb->cw_idx));
+  uint32_t cinit = pdsch_nr_cinit(&q->carrier, cfg, rnti, tb->cw_idx);
+  srsran_sequence_cache_apply_c(&q->scrambling, llr, llr, tb->nof_bits, cinit);
 
   if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
     DEBUG("b=");
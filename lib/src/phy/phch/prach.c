@@ -25,6 +25,7 @@
 
 #include "srsran/phy/common/phy_common.h"
 #include "srsran/phy/common/phy_common_nr.h"
+#include "srsran/phy/common/zc_sequence.h"
 #include "srsran/phy/phch/prach.h"
 #include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/vector.h"
@@ -45,55 +46,20 @@
 //#define PRACH_CANCELLATION_HARD
 #define PRACH_AMP 1.0
 
-// Comment following line for disabling complex exponential look-up table
-#define PRACH_USE_CEXP_LUT
-
-#ifdef PRACH_USE_CEXP_LUT
-
-// Define read-only complex exponential tables for two possibles size of sequences, common for all possible PRACH
-// objects
-#define PRACH_N_ZC_LONG_LUT_SIZE (2 * SRSRAN_PRACH_N_ZC_LONG)
-static cf_t cexp_table_long[PRACH_N_ZC_LONG_LUT_SIZE] = {};
-#define PRACH_N_ZC_SHORT_LUT_SIZE (2 * SRSRAN_PRACH_N_ZC_SHORT)
-static cf_t cexp_table_short[PRACH_N_ZC_SHORT_LUT_SIZE] = {};
-
-// Use constructor attribute for writing complex exponential tables
-__attribute__((constructor)) static void prach_cexp_init()
-{
-  for (uint32_t i = 0; i < PRACH_N_ZC_LONG_LUT_SIZE; i++) {
-    cexp_table_long[i] = cexpf(-I * 2.0f * M_PI * (float)i / (float)PRACH_N_ZC_LONG_LUT_SIZE);
-  }
-  for (uint32_t i = 0; i < PRACH_N_ZC_SHORT_LUT_SIZE; i++) {
-    cexp_table_short[i] = cexpf(-I * 2.0f * M_PI * (float)i / (float)PRACH_N_ZC_SHORT_LUT_SIZE);
-  }
-}
-
-#endif // PRACH_USE_CEXP_LUT
-
-// Generate ZC sequence using either look-up tables or conventional cexp function
+// Generate ZC sequence using the shared roots of unity table or conventional cexp function
 static void prach_cexp(uint32_t N_zc, uint32_t u, cf_t* root)
 {
-#ifdef PRACH_USE_CEXP_LUT
-  // Use long N_zc table (839 length)
-  if (N_zc == SRSRAN_PRACH_N_ZC_LONG) {
-    for (int j = 0; j < SRSRAN_PRACH_N_ZC_LONG; j++) {
-      uint32_t phase_idx = u * j * (j + 1);
-      root[j]            = cexp_table_long[phase_idx % PRACH_N_ZC_LONG_LUT_SIZE];
-    }
-    return;
-  }
-
-  // Use short N_zc table (139 length)
-  if (N_zc == SRSRAN_PRACH_N_ZC_SHORT) {
-    for (int j = 0; j < SRSRAN_PRACH_N_ZC_SHORT; j++) {
+  // The phase -pi*u*j*(j+1)/N_zc is exactly the entry u*j*(j+1) mod 2*N_zc of the table
+  const cf_t* roots = srsran_zc_sequence_roots(N_zc);
+  if (roots != NULL) {
+    for (uint32_t j = 0; j < N_zc; j++) {
       uint32_t phase_idx = u * j * (j + 1);
-      root[j]            = cexp_table_short[phase_idx % PRACH_N_ZC_SHORT_LUT_SIZE];
+      root[j]            = roots[phase_idx % (2 * N_zc)];
     }
     return;
   }
-#endif // PRACH_USE_CEXP_LUT
 
-  // If the N_zc does not match any of the tables, use conventional exponential function
+  // If the table is not available, use conventional exponential function
   for (int j = 0; j < N_zc; j++) {
     double phase = -M_PI * u * j * (j + 1) / N_zc;
     root[j]      = cexp(phase * I);
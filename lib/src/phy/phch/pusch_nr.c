@@ -26,6 +26,58 @@
 #include "srsran/phy/phch/csi.h"
 #include "srsran/phy/phch/ra_nr.h"
 #include "srsran/phy/phch/uci_cfg.h"
+#include "srsran/phy/utils/bit.h"
+#include <pthread.h>
+#include <semaphore.h>
+
+/**
+ * @brief Code block job of the fused UL-SCH encoder. Every code block is encoded, rate matched, scrambled, modulated
+ * and mapped straight into the resource grid while it is still in cache, instead of running each stage over the whole
+ * codeword
+ */
+typedef struct {
+  const srsran_sch_nr_tb_info_t* cfg;         ///< Code block segmentation and rate matching parameters
+  const srsran_sch_tb_t*         tb;          ///< Transport block configuration
+  const uint8_t*                 data;        ///< Transport block data
+  uint32_t                       checksum_tb; ///< Transport block CRC
+  const uint8_t*                 c;           ///< Packed scrambling sequence of the whole codeword
+  const srsran_modem_table_t*    table;       ///< Modulation table with packed bit tables
+  const uint32_t*                re_idx;      ///< Grid index of each resource element
+  uint8_t*                       g;           ///< Codeword bits, each code block writes its own segment
+  cf_t*                          d;           ///< Codeword symbols, each code block writes its own segment
+  cf_t*                          grid;        ///< Resource grid
+  uint32_t                       stride;      ///< Code block stride between threads
+} pusch_nr_cb_job_t;
+
+typedef struct {
+  /* Thread identifier: they must set before thread creation */
+  pthread_t pthread;
+  uint32_t  idx; ///< First code block, the main thread encodes code block 0
+
+  /* Encoder and code block buffers */
+  srsran_sch_nr_t sch;
+  uint8_t*        e_packed;
+
+  /* Job: it must be set before posting start semaphore */
+  const pusch_nr_cb_job_t* job;
+
+  /* Execution status */
+  int ret_status;
+
+  /* Semaphores */
+  sem_t start;
+  sem_t finish;
+
+  /* Thread flags */
+  bool quit;
+} srsran_pusch_nr_coworker_t;
+
+typedef struct {
+  srsran_pusch_nr_coworker_t* h;
+  uint32_t                    nof_coworkers;
+} srsran_pusch_nr_coworkers_t;
+
+static void* pusch_nr_encode_thread(void* arg);
 
 static int pusch_nr_alloc(srsran_pusch_nr_t* q, uint32_t max_mimo_layers, uint32_t max_prb)
 {
@@ -70,6 +122,11 @@ int pusch_nr_init_common(srsran_pusch_nr_t* q, const srsran_pusch_nr_args_t* arg
     return SRSRAN_ERROR;
   }
 
+  if (srsran_sequence_cache_init(&q->scrambling, SRSRAN_SEQUENCE_CACHE_DEFAULT_NOF_ENTRIES) < SRSRAN_SUCCESS) {
+    ERROR("Initialising scrambling sequence cache");
+    return SRSRAN_ERROR;
+  }
+
   if (srsran_uci_nr_init(&q->uci, &args->uci) < SRSRAN_SUCCESS) {
     ERROR("Initialising UCI");
     return SRSRAN_ERROR;
@@ -98,6 +155,90 @@ int pusch_nr_init_common(srsran_pusch_nr_t* q, const srsran_pusch_nr_args_t* arg
   return SRSRAN_SUCCESS;
 }
 
+static void pusch_nr_coworker_free(srsran_pusch_nr_coworker_t* h)
+{
+  srsran_sch_nr_free(&h->sch);
+  if (h->e_packed) {
+    free(h->e_packed);
+  }
+}
+
+static void pusch_nr_disable_coworkers(srsran_pusch_nr_t* q)
+{
+  srsran_pusch_nr_coworkers_t* w = (srsran_pusch_nr_coworkers_t*)q->coworkers;
+  if (w == NULL) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < w->nof_coworkers; i++) {
+    srsran_pusch_nr_coworker_t* h = &w->h[i];
+
+    /* Stop thread */
+    h->quit = true;
+    sem_post(&h->start);
+    pthread_join(h->pthread, NULL);
+
+    sem_destroy(&h->start);
+    sem_destroy(&h->finish);
+    pusch_nr_coworker_free(h);
+  }
+
+  free(w->h);
+  free(w);
+  q->coworkers = NULL;
+}
+
+static int pusch_nr_enable_coworkers(srsran_pusch_nr_t* q, const srsran_pusch_nr_args_t* args)
+{
+  srsran_pusch_nr_coworkers_t* w = SRSRAN_MEM_ALLOC(srsran_pusch_nr_coworkers_t, 1);
+  if (w == NULL) {
+    ERROR("Allocating coworkers");
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(w, srsran_pusch_nr_coworkers_t, 1);
+  q->coworkers = w;
+
+  w->h = SRSRAN_MEM_ALLOC(srsran_pusch_nr_coworker_t, args->nof_encoder_threads);
+  if (w->h == NULL) {
+    ERROR("Allocating coworkers");
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(w->h, srsran_pusch_nr_coworker_t, args->nof_encoder_threads);
+
+  for (uint32_t i = 0; i < args->nof_encoder_threads; i++) {
+    srsran_pusch_nr_coworker_t* h = &w->h[i];
+    h->idx                        = i + 1;
+
+    if (srsran_sch_nr_init_tx(&h->sch, &args->sch) < SRSRAN_SUCCESS) {
+      ERROR("Initialising coworker SCH");
+      pusch_nr_coworker_free(h);
+      return SRSRAN_ERROR;
+    }
+
+    h->e_packed = srsran_vec_u8_malloc(SRSRAN_SLOT_MAX_NOF_BITS_NR / 8);
+    if (h->e_packed == NULL) {
+      ERROR("Malloc");
+      pusch_nr_coworker_free(h);
+      return SRSRAN_ERROR;
+    }
+
+    if (sem_init(&h->start, 0, 0) || sem_init(&h->finish, 0, 0)) {
+      ERROR("Creating semaphore");
+      pusch_nr_coworker_free(h);
+      return SRSRAN_ERROR;
+    }
+
+    if (pthread_create(&h->pthread, NULL, pusch_nr_encode_thread, (void*)h)) {
+      ERROR("Creating coworker thread");
+      pusch_nr_coworker_free(h);
+      return SRSRAN_ERROR;
+    }
+    w->nof_coworkers++;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 int srsran_pusch_nr_init_ue(srsran_pusch_nr_t* q, const srsran_pusch_nr_args_t* args)
 {
   if (q == NULL) {
@@ -113,6 +254,24 @@ int srsran_pusch_nr_init_ue(srsran_pusch_nr_t* q, const srsran_pusch_nr_args_t*
     return SRSRAN_ERROR;
   }
 
+  // The fused code block encoder modulates packed bits
+  if (!args->measure_evm) {
+    for (srsran_mod_t mod = SRSRAN_MOD_BPSK; mod < SRSRAN_MOD_NITEMS; mod++) {
+      srsran_modem_table_bytes(&q->modem_tables[mod]);
+    }
+  }
+
+  q->re_idx = srsran_vec_u32_malloc(SRSRAN_SLOT_MAX_LEN_RE_NR);
+  if (q->re_idx == NULL) {
+    ERROR("Malloc");
+    return SRSRAN_ERROR;
+  }
+
+  if (args->nof_encoder_threads > 0 && pusch_nr_enable_coworkers(q, args) < SRSRAN_SUCCESS) {
+    ERROR("Initialising UL-SCH encoder threads");
+    return SRSRAN_ERROR;
+  }
+
   return SRSRAN_SUCCESS;
 }
 
@@ -180,6 +339,13 @@ int srsran_pusch_nr_set_carrier(srsran_pusch_nr_t* q, const srsran_carrier_nr_t*
     return SRSRAN_ERROR;
   }
 
+  srsran_pusch_nr_coworkers_t* w = (srsran_pusch_nr_coworkers_t*)q->coworkers;
+  for (uint32_t i = 0; w != NULL && i < w->nof_coworkers; i++) {
+    if (srsran_sch_nr_set_carrier(&w->h[i].sch, carrier) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+  }
+
   if (q->evm_buffer != NULL) {
     srsran_evm_buffer_resize(q->evm_buffer, SRSRAN_SLOT_LEN_RE_NR(q->max_prb) * SRSRAN_MAX_QM);
   }
@@ -193,6 +359,8 @@ void srsran_pusch_nr_free(srsran_pusch_nr_t* q)
     return;
   }
 
+  pusch_nr_disable_coworkers(q);
+
   if (q->g_ulsch != NULL) {
     free(q->g_ulsch);
   }
@@ -218,6 +386,9 @@ void srsran_pusch_nr_free(srsran_pusch_nr_t* q)
   if (q->pos_csi2 != NULL) {
     free(q->pos_csi2);
   }
+  if (q->re_idx != NULL) {
+    free(q->re_idx);
+  }
 
   for (uint32_t cw = 0; cw < SRSRAN_MAX_CODEWORDS; cw++) {
     if (q->b[cw]) {
@@ -246,6 +417,8 @@ void srsran_pusch_nr_free(srsran_pusch_nr_t* q)
     srsran_evm_free(q->evm_buffer);
   }
 
+  srsran_sequence_cache_free(&q->scrambling);
+
   SRSRAN_MEM_ZERO(q, srsran_pusch_nr_t, 1);
 }
 
@@ -350,6 +523,193 @@ pusch_nr_cinit(const srsran_carrier_nr_t* carrier, const srsran_sch_cfg_nr_t* cf
   return cinit;
 }
 
+// Computes the grid index of each PUSCH resource element, in the same order as srsran_pusch_nr_cp
+static int pusch_nr_re_idx(const srsran_pusch_nr_t*     q,
+                           const srsran_sch_cfg_nr_t*   cfg,
+                           const srsran_sch_grant_nr_t* grant,
+                           uint32_t*                    re_idx)
+{
+  uint32_t count = 0;
+
+  for (uint32_t l = grant->S; l < grant->S + grant->L; l++) {
+    // Initialise reserved RE mask to all false
+    bool rvd_mask[SRSRAN_NRE * SRSRAN_MAX_PRB_NR] = {};
+
+    // Reserve DMRS
+    if (srsran_re_pattern_to_symbol_mask(&q->dmrs_re_pattern, l, rvd_mask) < SRSRAN_SUCCESS) {
+      ERROR("Error generating DMRS reserved RE mask");
+      return SRSRAN_ERROR;
+    }
+
+    // Reserve RE from configuration
+    if (srsran_re_pattern_list_to_symbol_mask(&cfg->rvd_re, l, rvd_mask) < SRSRAN_SUCCESS) {
+      ERROR("Error generating reserved RE mask");
+      return SRSRAN_ERROR;
+    }
+
+    for (uint32_t rb = 0; rb < q->carrier.nof_prb; rb++) {
+      // Skip PRB if not available in grant
+      if (!grant->prb_idx[rb]) {
+        continue;
+      }
+
+      uint32_t re_idx0 = (q->carrier.nof_prb * l + rb) * SRSRAN_NRE;
+      for (uint32_t i = 0; i < SRSRAN_NRE; i++) {
+        if (!rvd_mask[rb * SRSRAN_NRE + i]) {
+          re_idx[count++] = re_idx0 + i;
+        }
+      }
+    }
+  }
+
+  return count;
+}
+
+// XORs packed bits with the packed sequence starting at a bit offset
+static void pusch_nr_scramble_packed(const uint8_t* c, uint32_t offset, uint8_t* bits, uint32_t nof_bits)
+{
+  const uint8_t* ptr      = &c[offset / 8];
+  uint32_t       shift    = offset % 8;
+  uint32_t       nof_byte = SRSRAN_CEIL(nof_bits, 8);
+
+  if (shift == 0) {
+    srsran_vec_xor_bbb(bits, ptr, bits, nof_byte);
+    return;
+  }
+
+  for (uint32_t i = 0; i < nof_byte; i++) {
+    bits[i] ^= (uint8_t)((ptr[i] << shift) | (ptr[i + 1] >> (8 - shift)));
+  }
+}
+
+// Encodes, rate matches, scrambles, modulates and maps a single code block
+static int
+pusch_nr_encode_cb(const pusch_nr_cb_job_t* job, srsran_sch_nr_t* sch, uint32_t r, uint8_t* e_packed)
+{
+  uint32_t E       = 0;
+  uint32_t offset  = srsran_sch_nr_cb_offset(job->cfg, r, &E);
+  uint8_t* e       = &job->g[offset];
+  cf_t*    symbols = &job->d[offset / job->cfg->Qm];
+
+  if (srsran_ulsch_nr_encode_cb(sch, job->cfg, job->tb, job->data, job->checksum_tb, r, e) < SRSRAN_SUCCESS) {
+    ERROR("Error encoding CB %d", r);
+    return SRSRAN_ERROR;
+  }
+
+  // Skip block
+  if (E == 0) {
+    return SRSRAN_SUCCESS;
+  }
+
+  // 7.3.1.1 Scrambling, the sequence is shifted to the code block position
+  srsran_bit_pack_vector(e, e_packed, (int)E);
+  pusch_nr_scramble_packed(job->c, offset, e_packed, E);
+
+  // 7.3.1.2 Modulation
+  int nof_symbols = srsran_mod_modulate_bytes(job->table, e_packed, symbols, E);
+  if (nof_symbols < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  // 6.3.1.7 Mapping, code blocks start at a symbol boundary since E is a multiple of Qm
+  const uint32_t* re_idx = &job->re_idx[offset / job->cfg->Qm];
+  for (int i = 0; i < nof_symbols; i++) {
+    job->grid[re_idx[i]] = symbols[i];
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static int
+pusch_nr_encode_cb_range(const pusch_nr_cb_job_t* job, srsran_sch_nr_t* sch, uint32_t first, uint8_t* e_packed)
+{
+  for (uint32_t r = first; r < job->cfg->C; r += job->stride) {
+    if (pusch_nr_encode_cb(job, sch, r, e_packed) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static void* pusch_nr_encode_thread(void* arg)
+{
+  srsran_pusch_nr_coworker_t* h = (srsran_pusch_nr_coworker_t*)arg;
+
+  sem_wait(&h->start);
+  while (!h->quit) {
+    h->ret_status = pusch_nr_encode_cb_range(h->job, &h->sch, h->idx, h->e_packed);
+
+    /* Post finish semaphore */
+    sem_post(&h->finish);
+
+    /* Wait for next job */
+    sem_wait(&h->start);
+  }
+
+  return NULL;
+}
+
+// Single layer UL-SCH without UCI, the code blocks go straight into the resource grid and are shared with the coworkers
+static int pusch_nr_encode_fused(srsran_pusch_nr_t*           q,
+                                 const srsran_sch_cfg_nr_t*   cfg,
+                                 const srsran_sch_grant_nr_t* grant,
+                                 const srsran_sch_tb_t*       tb,
+                                 const uint8_t*               data,
+                                 cf_t*                        grid)
+{
+  srsran_sch_nr_tb_info_t sch_info    = {};
+  uint32_t                checksum_tb = 0;
+  if (srsran_ulsch_nr_encode_prepare(&q->sch, &cfg->sch_cfg, tb, data, &sch_info, &checksum_tb) < SRSRAN_SUCCESS) {
+    ERROR("Error in SCH encoding");
+    return SRSRAN_ERROR;
+  }
+
+  int nof_re = pusch_nr_re_idx(q, cfg, grant, q->re_idx);
+  if (nof_re != tb->nof_re) {
+    ERROR("Unmatched number of RE (%d != %d)", nof_re, tb->nof_re);
+    return SRSRAN_ERROR;
+  }
+
+  uint32_t       nof_bits = tb->nof_re * srsran_mod_bits_x_symbol(tb->mod);
+  uint32_t       cinit    = pusch_nr_cinit(&q->carrier, cfg, grant->rnti, tb->cw_idx);
+  const uint8_t* c        = srsran_sequence_cache_get(&q->scrambling, cinit, nof_bits);
+  if (c == NULL) {
+    ERROR("Error generating scrambling sequence");
+    return SRSRAN_ERROR;
+  }
+
+  // Code block r is encoded by thread r % stride, the caller being thread 0
+  srsran_pusch_nr_coworkers_t* w             = (srsran_pusch_nr_coworkers_t*)q->coworkers;
+  uint32_t                     nof_coworkers = (w == NULL) ? 0 : SRSRAN_MIN(w->nof_coworkers, sch_info.C - 1);
+  pusch_nr_cb_job_t            job           = {.cfg         = &sch_info,
+                                                .tb          = tb,
+                                                .data        = data,
+                                                .checksum_tb = checksum_tb,
+                                                .c           = c,
+                                                .table       = &q->modem_tables[tb->mod],
+                                                .re_idx      = q->re_idx,
+                                                .g           = q->g_ulsch,
+                                                .d           = q->d[tb->cw_idx],
+                                                .grid        = grid,
+                                                .stride      = nof_coworkers + 1};
+
+  for (uint32_t i = 0; i < nof_coworkers; i++) {
+    w->h[i].job = &job;
+    sem_post(&w->h[i].start);
+  }
+
+  int ret = pusch_nr_encode_cb_range(&job, &q->sch, 0, q->b[tb->cw_idx]);
+
+  for (uint32_t i = 0; i < nof_coworkers; i++) {
+    sem_wait(&w->h[i].finish);
+    if (w->h[i].ret_status < SRSRAN_SUCCESS) {
+      ret = SRSRAN_ERROR;
+    }
+  }
+
+  return ret;
+}
+
 // Implements TS 38.212 6.2.7 Data and control multiplexing (for NR-PUSCH)
 static int pusch_nr_gen_mux_uci(srsran_pusch_nr_t* q, const srsran_uci_cfg_nr_t* cfg)
 {
@@ -589,11 +949,15 @@ static int pusch_nr_gen_mux_uci(srsran_pusch_nr_t* q, const srsran_uci_cfg_nr_t*
 
 static inline int pusch_nr_encode_codeword(srsran_pusch_nr_t*           q,
                                            const srsran_sch_cfg_nr_t*   cfg,
+                                           const srsran_sch_grant_nr_t* grant,
                                            const srsran_sch_tb_t*       tb,
                                            const uint8_t*               data,
                                            const srsran_uci_value_nr_t* uci,
-                                           uint16_t                     rnti)
+                                           cf_t*                        grid,
+                                           bool*                        mapped)
 {
+  uint16_t rnti = grant->rnti;
+
   // Early return if TB is not enabled
   if (!tb->enabled) {
     return SRSRAN_SUCCESS;
@@ -637,6 +1001,12 @@ static inline int pusch_nr_encode_codeword(srsran_pusch_nr_t*           q,
     return SRSRAN_ERROR;
   }
 
+  // Without UCI multiplexing the code blocks can be mapped into the grid as they are encoded, if the caller allows it
+  if (grid != NULL && !q->uci_mux && tb->mod != SRSRAN_MOD_BPSK) {
+    *mapped = true;
+    return pusch_nr_encode_fused(q, cfg, grant, tb, data, grid);
+  }
+
   // Encode SCH
   if (srsran_ulsch_nr_encode(&q->sch, &cfg->sch_cfg, tb, data, q->g_ulsch) < SRSRAN_SUCCESS) {
     ERROR("Error in SCH encoding");
@@ -678,7 +1048,7 @@ static inline int pusch_nr_encode_codeword(srsran_pusch_nr_t*           q,
 
   // 7.3.1.1 Scrambling
   uint32_t cinit = pusch_nr_cinit(&q->carrier, cfg, rnti, tb->cw_idx);
-  srsran_sequence_apply_bit(b, q->b[tb->cw_idx], nof_bits, cinit);
+  srsran_sequence_cache_apply_bit(&q->scrambling, b, q->b[tb->cw_idx], nof_bits, cinit);
 
   // Special Scrambling condition
   if (cfg->uci.ack.count <= 2) {
@@ -734,18 +1104,34 @@ int srsran_pusch_nr_encode(srsran_pusch_nr_t*            q,
     return SRSRAN_ERROR;
   }
 
+  // Single codeword and single layer transmissions may be mapped straight into the grid
+  cf_t* grid = NULL;
+  if (grant->nof_layers == 1 && grant->tb[0].enabled && !grant->tb[1].enabled && q->re_idx != NULL) {
+    grid = sf_symbols[0];
+  }
+
   // 6.3.1.1 and 6.3.1.2
   uint32_t nof_cw = 0;
+  bool     mapped = false;
   for (uint32_t tb = 0; tb < SRSRAN_MAX_TB; tb++) {
     nof_cw += grant->tb[tb].enabled ? 1 : 0;
 
-    if (pusch_nr_encode_codeword(q, cfg, &grant->tb[tb], data->payload[tb], &data[0].uci, grant->rnti) <
+    if (pusch_nr_encode_codeword(q, cfg, grant, &grant->tb[tb], data->payload[tb], &data[0].uci, grid, &mapped) <
         SRSRAN_SUCCESS) {
       ERROR("Error encoding TB %d", tb);
       return SRSRAN_ERROR;
     }
   }
 
+  if (mapped) {
+    if (q->meas_time_en) {
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      q->meas_time_us = (uint32_t)t[0].tv_usec;
+    }
+    return SRSRAN_SUCCESS;
+  }
+
   // 6.3.1.3 Layer mapping
   cf_t** x = q->d;
   if (grant->nof_layers > 1) {
@@ -852,7 +1238,8 @@ static inline int pusch_nr_decode_codeword(srsran_pusch_nr_t*         q,
   }
 
   // Descrambling
-  srsran_sequence_apply_c(llr, llr, nof_bits, pusch_nr_cinit(&q->carrier, cfg, rnti, tb->cw_idx));
+  uint32_t cinit = pusch_nr_cinit(&q->carrier, cfg, rnti, tb->cw_idx);
+  srsran_sequence_cache_apply_c(&q->scrambling, llr, llr, nof_bits, cinit);
 
   if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
     DEBUG("b=");
@@ -404,14 +404,16 @@ void srsran_sch_nr_free(srsran_sch_nr_t* q)
   srsran_ldpc_rm_rx_free_c(&q->rx_rm);
 }
 
-static inline int sch_nr_encode(srsran_sch_nr_t*        q,
-                                const srsran_sch_cfg_t* sch_cfg,
-                                const srsran_sch_tb_t*  tb,
-                                const uint8_t*          data,
-                                uint8_t*                e_bits)
+// Checks the encoder and soft-buffer for a transport block and calculates its CRC
+static int sch_nr_encode_prepare(srsran_sch_nr_t*         q,
+                                 const srsran_sch_cfg_t*  sch_cfg,
+                                 const srsran_sch_tb_t*   tb,
+                                 const uint8_t*           data,
+                                 srsran_sch_nr_tb_info_t* cfg,
+                                 uint32_t*                checksum_tb)
 {
   // Pointer protection
-  if (!q || !sch_cfg || !tb || !data || !e_bits) {
+  if (!q || !sch_cfg || !tb || !data || !cfg || !checksum_tb) {
     return SRSRAN_ERROR_INVALID_INPUTS;
   }
 
@@ -420,21 +422,17 @@ static inline int sch_nr_encode(srsran_sch_nr_t*        q,
     return SRSRAN_ERROR;
   }
 
-  const uint8_t* input_ptr  = data;
-  uint8_t*       output_ptr = e_bits;
-
-  srsran_sch_nr_tb_info_t cfg = {};
-  if (srsran_sch_nr_fill_tb_info(&q->carrier, sch_cfg, tb, &cfg) < SRSRAN_SUCCESS) {
+  if (srsran_sch_nr_fill_tb_info(&q->carrier, sch_cfg, tb, cfg) < SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
 
   // Select encoder and CRC
-  srsran_ldpc_encoder_t* encoder = (cfg.bg == BG1) ? q->encoder_bg1[cfg.Z] : q->encoder_bg2[cfg.Z];
-  srsran_crc_t*          crc_tb  = (cfg.L_tb == 24) ? &q->crc_tb_24 : &q->crc_tb_16;
+  srsran_ldpc_encoder_t* encoder = (cfg->bg == BG1) ? q->encoder_bg1[cfg->Z] : q->encoder_bg2[cfg->Z];
+  srsran_crc_t*          crc_tb  = (cfg->L_tb == 24) ? &q->crc_tb_24 : &q->crc_tb_16;
 
   // Check encoder
   if (encoder == NULL) {
-    ERROR("Error: encoder for lifting size Z=%d not found (tbs=%d)", cfg.Z, tb->tbs);
+    ERROR("Error: encoder for lifting size Z=%d not found (tbs=%d)", cfg->Z, tb->tbs);
     return SRSRAN_ERROR;
   }
 
@@ -445,106 +443,154 @@ static inline int sch_nr_encode(srsran_sch_nr_t*        q,
   }
 
   // Soft-buffer number of code-block protection
-  if (tb->softbuffer.tx->max_cb < cfg.C) {
+  if (tb->softbuffer.tx->max_cb < cfg->C) {
     ERROR("Soft-buffer does not have enough code-blocks (max_cb=%d) for a TBS=%d, C=%d.",
           tb->softbuffer.tx->max_cb,
           tb->tbs,
-          cfg.C);
+          cfg->C);
     return SRSRAN_ERROR;
   }
 
-  if (tb->softbuffer.tx->max_cb_size < (encoder->liftN - 2 * cfg.Z)) {
+  if (tb->softbuffer.tx->max_cb_size < (encoder->liftN - 2 * cfg->Z)) {
     ERROR("Soft-buffer code-block maximum size insufficient (max_cb_size=%d) for a TBS=%d, requires %d.",
           tb->softbuffer.tx->max_cb_size,
           tb->tbs,
-          (encoder->liftN - 2 * cfg.Z));
+          (encoder->liftN - 2 * cfg->Z));
     return SRSRAN_ERROR;
   }
 
   // Calculate TB CRC
-  uint32_t checksum_tb = srsran_crc_checksum_byte(crc_tb, data, tb->tbs);
+  *checksum_tb = srsran_crc_checksum_byte(crc_tb, data, tb->tbs);
   if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
     DEBUG("tb=");
     srsran_vec_fprint_byte(stdout, data, tb->tbs / 8);
   }
 
-  // For each code block...
-  uint32_t j = 0;
-  for (uint32_t r = 0; r < cfg.C; r++) {
-    // Select rate matching circular buffer
-    uint8_t* rm_buffer = tb->softbuffer.tx->buffer_b[r];
-    if (rm_buffer == NULL) {
-      ERROR("Error: soft-buffer provided NULL buffer for cb_idx=%d", r);
-      return SRSRAN_ERROR;
-    }
-
-    // If data provided, encode and store in RM circular buffer
-    if (data != NULL) {
-      uint32_t cb_len = cfg.Kp - cfg.L_cb;
+  return SRSRAN_SUCCESS;
+}
 
-      // If it is the last segment...
-      if (r == cfg.C - 1) {
-        cb_len -= cfg.L_tb;
+// Encodes code block r into its soft-buffer and rate matches it into E bits, it only uses the transport block data of
+// the code block so different code blocks can be encoded concurrently with different SCH objects
+static int sch_nr_encode_cb(srsran_sch_nr_t*               q,
+                            const srsran_sch_nr_tb_info_t* cfg,
+                            const srsran_sch_tb_t*         tb,
+                            const uint8_t*                 data,
+                            uint32_t                       checksum_tb,
+                            uint32_t                       r,
+                            uint32_t                       E,
+                            uint8_t*                       output_ptr)
+{
+  srsran_ldpc_encoder_t* encoder = (cfg->bg == BG1) ? q->encoder_bg1[cfg->Z] : q->encoder_bg2[cfg->Z];
+  if (encoder == NULL) {
+    ERROR("Error: encoder for lifting size Z=%d not found (tbs=%d)", cfg->Z, tb->tbs);
+    return SRSRAN_ERROR;
+  }
 
-        // Copy payload without TB CRC
-        srsran_bit_unpack_vector(input_ptr, q->temp_cb, (int)cb_len);
+  // Select rate matching circular buffer
+  uint8_t* rm_buffer = tb->softbuffer.tx->buffer_b[r];
+  if (rm_buffer == NULL) {
+    ERROR("Error: soft-buffer provided NULL buffer for cb_idx=%d", r);
+    return SRSRAN_ERROR;
+  }
 
-        // Append TB CRC
-        uint8_t* ptr = &q->temp_cb[cb_len];
-        srsran_bit_unpack(checksum_tb, &ptr, cfg.L_tb);
-        SCH_INFO_TX("CB %d: appending TB CRC=%06x", r, checksum_tb);
-      } else {
-        // Copy payload
-        srsran_bit_unpack_vector(input_ptr, q->temp_cb, (int)cb_len);
-      }
+  // If data provided, encode and store in RM circular buffer
+  if (data != NULL) {
+    uint32_t       cb_len    = cfg->Kp - cfg->L_cb;
+    const uint8_t* input_ptr = &data[r * (cb_len / 8)];
 
-      if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
-        DEBUG("cb%d=", r);
-        srsran_vec_fprint_byte(stdout, input_ptr, cb_len / 8);
-      }
+    // If it is the last segment...
+    if (r == cfg->C - 1) {
+      cb_len -= cfg->L_tb;
 
-      input_ptr += cb_len / 8;
+      // Copy payload without TB CRC
+      srsran_bit_unpack_vector(input_ptr, q->temp_cb, (int)cb_len);
 
-      // Attach code block CRC if required
-      if (cfg.L_cb) {
-        srsran_crc_attach(&q->crc_cb, q->temp_cb, (int)(cfg.Kp - cfg.L_cb));
-        SCH_INFO_TX("CB %d: CRC=%06x", r, (uint32_t)srsran_crc_checksum_get(&q->crc_cb));
-      }
+      // Append TB CRC
+      uint8_t* ptr = &q->temp_cb[cb_len];
+      srsran_bit_unpack(checksum_tb, &ptr, cfg->L_tb);
+      SCH_INFO_TX("CB %d: appending TB CRC=%06x", r, checksum_tb);
+    } else {
+      // Copy payload
+      srsran_bit_unpack_vector(input_ptr, q->temp_cb, (int)cb_len);
+    }
 
-      // Insert filler bits
-      for (uint32_t i = cfg.Kp; i < cfg.Kr; i++) {
-        q->temp_cb[i] = FILLER_BIT;
-      }
+    if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
+      DEBUG("cb%d=", r);
+      srsran_vec_fprint_byte(stdout, input_ptr, cb_len / 8);
+    }
 
-      // Encode code block
-      srsran_ldpc_encoder_encode(encoder, q->temp_cb, rm_buffer, cfg.Kr);
+    // Attach code block CRC if required
+    if (cfg->L_cb) {
+      srsran_crc_attach(&q->crc_cb, q->temp_cb, (int)(cfg->Kp - cfg->L_cb));
+      SCH_INFO_TX("CB %d: CRC=%06x", r, (uint32_t)srsran_crc_checksum_get(&q->crc_cb));
+    }
 
-      if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
-        DEBUG("encoded=");
-        srsran_vec_fprint_b(stdout, rm_buffer, encoder->liftN - 2 * encoder->ls);
-      }
+    // Insert filler bits
+    for (uint32_t i = cfg->Kp; i < cfg->Kr; i++) {
+      q->temp_cb[i] = FILLER_BIT;
     }
 
-    // Skip block
-    if (!cfg.mask[r]) {
-      continue;
+    // Encode code block
+    srsran_ldpc_encoder_encode(encoder, q->temp_cb, rm_buffer, cfg->Kr);
+
+    if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
+      DEBUG("encoded=");
+      srsran_vec_fprint_b(stdout, rm_buffer, encoder->liftN - 2 * encoder->ls);
     }
+  }
 
-    // Select rate matching output sequence number of bits
-    uint32_t E = sch_nr_get_E(&cfg, j);
-    j++;
+  // Skip block
+  if (E == 0) {
+    return SRSRAN_SUCCESS;
+  }
 
-    // LDPC Rate matching
-    SCH_INFO_TX("RM CB %d: E=%d; F=%d; BG=%d; Z=%d; RV=%d; Qm=%d; Nref=%d;",
-                r,
-                E,
-                cfg.F,
-                cfg.bg == BG1 ? 1 : 2,
-                cfg.Z,
-                tb->rv,
-                cfg.Qm,
-                cfg.Nref);
-    srsran_ldpc_rm_tx(&q->tx_rm, rm_buffer, output_ptr, E, cfg.bg, cfg.Z, tb->rv, tb->mod, cfg.Nref);
+  // LDPC Rate matching
+  SCH_INFO_TX("RM CB %d: E=%d; F=%d; BG=%d; Z=%d; RV=%d; Qm=%d; Nref=%d;",
+              r,
+              E,
+              cfg->F,
+              cfg->bg == BG1 ? 1 : 2,
+              cfg->Z,
+              tb->rv,
+              cfg->Qm,
+              cfg->Nref);
+  srsran_ldpc_rm_tx(&q->tx_rm, rm_buffer, output_ptr, E, cfg->bg, cfg->Z, tb->rv, tb->mod, cfg->Nref);
+
+  return SRSRAN_SUCCESS;
+}
+
+static inline int sch_nr_encode(srsran_sch_nr_t*        q,
+                                const srsran_sch_cfg_t* sch_cfg,
+                                const srsran_sch_tb_t*  tb,
+                                const uint8_t*          data,
+                                uint8_t*                e_bits)
+{
+  // Pointer protection
+  if (!q || !sch_cfg || !tb || !data || !e_bits) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint8_t* output_ptr = e_bits;
+
+  srsran_sch_nr_tb_info_t cfg         = {};
+  uint32_t                checksum_tb = 0;
+  if (sch_nr_encode_prepare(q, sch_cfg, tb, data, &cfg, &checksum_tb) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  // For each code block...
+  uint32_t j = 0;
+  for (uint32_t r = 0; r < cfg.C; r++) {
+    // Select rate matching output sequence number of bits, zero if the block is not transmitted
+    uint32_t E = 0;
+    if (cfg.mask[r]) {
+      E = sch_nr_get_E(&cfg, j);
+      j++;
+    }
+
+    if (sch_nr_encode_cb(q, &cfg, tb, data, checksum_tb, r, E, output_ptr) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
     output_ptr += E;
   }
 
@@ -776,6 +822,54 @@ int srsran_ulsch_nr_encode(srsran_sch_nr_t*        q,
   return sch_nr_encode(q, pdsch_cfg, tb, data, e_bits);
 }
 
+int srsran_ulsch_nr_encode_prepare(srsran_sch_nr_t*         q,
+                                   const srsran_sch_cfg_t*  sch_cfg,
+                                   const srsran_sch_tb_t*   tb,
+                                   const uint8_t*           data,
+                                   srsran_sch_nr_tb_info_t* cfg,
+                                   uint32_t*                checksum_tb)
+{
+  return sch_nr_encode_prepare(q, sch_cfg, tb, data, cfg, checksum_tb);
+}
+
+int srsran_ulsch_nr_encode_cb(srsran_sch_nr_t*               q,
+                              const srsran_sch_nr_tb_info_t* cfg,
+                              const srsran_sch_tb_t*         tb,
+                              const uint8_t*                 data,
+                              uint32_t                       checksum_tb,
+                              uint32_t                       r,
+                              uint8_t*                       e_bits)
+{
+  if (!q || !cfg || !tb || !e_bits || r >= cfg->C) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t E = 0;
+  srsran_sch_nr_cb_offset(cfg, r, &E);
+
+  return sch_nr_encode_cb(q, cfg, tb, data, checksum_tb, r, E, e_bits);
+}
+
+uint32_t srsran_sch_nr_cb_offset(const srsran_sch_nr_tb_info_t* cfg, uint32_t r, uint32_t* E)
+{
+  // Transmitted code blocks before r
+  uint32_t j = 0;
+  for (uint32_t i = 0; i < r; i++) {
+    j += cfg->mask[i] ? 1 : 0;
+  }
+
+  uint32_t offset = 0;
+  for (uint32_t i = 0; i < j; i++) {
+    offset += sch_nr_get_E(cfg, i);
+  }
+
+  if (E != NULL) {
+    *E = cfg->mask[r] ? sch_nr_get_E(cfg, j) : 0;
+  }
+
+  return offset;
+}
+
 int srsran_ulsch_nr_decode(srsran_sch_nr_t*        q,
                            const srsran_sch_cfg_t* sch_cfg,
                            const srsran_sch_tb_t*  tb,
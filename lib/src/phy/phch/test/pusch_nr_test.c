@@ -35,6 +35,7 @@ static srsran_sch_cfg_nr_t pusch_cfg    = {};
 static uint16_t            rnti         = 0x1234;
 static uint32_t            nof_ack_bits = 0;
 static uint32_t            nof_csi_bits = 0;
+static uint32_t            nof_threads  = 0;
 
 void usage(char* prog)
 {
@@ -46,13 +47,14 @@ void usage(char* prog)
   printf("\t-L Provide number of layers [Default %d]\n", carrier.max_mimo_layers);
   printf("\t-A Provide a number of HARQ-ACK bits [Default %d]\n", nof_ack_bits);
   printf("\t-C Provide a number of CSI bits [Default %d]\n", nof_csi_bits);
+  printf("\t-W Provide a number of UL-SCH encoder helper threads [Default %d]\n", nof_threads);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 int parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "pmTLACv")) != -1) {
+  while ((opt = getopt(argc, argv, "pmTLACWv")) != -1) {
     switch (opt) {
       case 'p':
         n_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -72,6 +74,9 @@ int parse_args(int argc, char** argv)
       case 'C':
         nof_csi_bits = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 'W':
+        nof_threads = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -106,6 +111,7 @@ int main(int argc, char** argv)
   srsran_pusch_nr_args_t pusch_args = {};
   pusch_args.sch.disable_simd       = false;
   pusch_args.measure_evm            = true;
+  pusch_args.nof_encoder_threads    = nof_threads;
 
   if (srsran_pusch_nr_init_ue(&pusch_tx, &pusch_args) < SRSRAN_SUCCESS) {
     ERROR("Error initiating PUSCH for Tx");
@@ -66,6 +66,10 @@ static srsran_rf_plugin_t plugin_zmq   = {"", NULL, &srsran_rf_dev_zmq};
 #include "rf_file_imp.h"
 static srsran_rf_plugin_t plugin_file = {"", NULL, &srsran_rf_dev_file};
 
+/* Define implementation for shared-memory RF */
+#include "rf_shm_imp.h"
+static srsran_rf_plugin_t plugin_shm = {"", NULL, &srsran_rf_dev_shm};
+
 /* Define implementation for Sidekiq */
 #ifdef ENABLE_SIDEKIQ
 #ifdef ENABLE_RF_PLUGINS
@@ -118,4 +122,5 @@ static srsran_rf_plugin_t* rf_plugins[] = {
     &plugin_dummy,
 #endif
     &plugin_file,
+    &plugin_shm,
     NULL};
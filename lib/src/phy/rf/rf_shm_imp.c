@@ -0,0 +1,593 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp.h"
+#include "rf_helper.h"
+#include "rf_plugin.h"
+#include "rf_shm_imp_trx.h"
+#include <math.h>
+#include <pthread.h>
+#include <srsran/phy/common/phy_common.h>
+#include <srsran/phy/common/timestamp.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+typedef struct {
+  // Common attributes
+  srsran_rf_info_t info;
+  uint32_t         nof_channels;
+
+  // RF State
+  double   srate;
+  double   rx_gain;
+  double   tx_gain;
+  bool     tx_enabled[SRSRAN_MAX_CHANNELS]; // Channels with a tx_port, the others do not transmit
+  uint32_t nof_tx_enabled;
+  bool     srate_mismatch_reported;
+  char     id[RF_PARAM_LEN];
+  uint64_t next_rx_ts;
+
+  // Shared-memory rings
+  rf_shm_tx_t transmitter[SRSRAN_MAX_CHANNELS];
+  rf_shm_rx_t receiver[SRSRAN_MAX_CHANNELS];
+
+  srsran_rf_error_handler_t error_handler;
+  void*                     error_handler_arg;
+
+  pthread_mutex_t tx_config_mutex;
+  pthread_mutex_t rx_config_mutex;
+} rf_shm_handler_t;
+
+/*
+ * Static Atributes
+ */
+const char shm_devname[4] = "shm";
+
+/*
+ * Static methods
+ */
+
+void rf_shm_info(char* id, const char* format, ...)
+{
+#if VERBOSE
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  va_list args;
+  va_start(args, format);
+  printf("[%s@%02ld.%06ld] ", id ? id : "shm", t.tv_sec % 10, t.tv_usec);
+  vprintf(format, args);
+  va_end(args);
+#else  /* VERBOSE */
+  // Do nothing
+#endif /* VERBOSE */
+}
+
+void rf_shm_error(char* id, const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+}
+
+static void rf_shm_report(rf_shm_handler_t* handler, int type, uint32_t opt)
+{
+  if (handler->error_handler) {
+    srsran_rf_error_t error = {};
+    error.type              = type;
+    error.opt               = (int)opt;
+    handler->error_handler(handler->error_handler_arg, error);
+  }
+}
+
+static bool parse_bool(char* args, const char* name, int channel_index, bool* value)
+{
+  char tmp[RF_PARAM_LEN] = {};
+  if (parse_string(args, name, channel_index, tmp) != SRSRAN_SUCCESS) {
+    return false;
+  }
+  *value = strncmp(tmp, "true", RF_PARAM_LEN) == 0 || strncmp(tmp, "yes", RF_PARAM_LEN) == 0;
+  return true;
+}
+
+/*
+ * Public methods
+ */
+
+void rf_shm_suppress_stdout(void* h)
+{
+  // do nothing
+}
+
+void rf_shm_register_error_handler(void* h, srsran_rf_error_handler_t new_handler, void* arg)
+{
+  if (h) {
+    rf_shm_handler_t* handler  = (rf_shm_handler_t*)h;
+    handler->error_handler     = new_handler;
+    handler->error_handler_arg = arg;
+  }
+}
+
+const char* rf_shm_devname(void* h)
+{
+  return shm_devname;
+}
+
+int rf_shm_start_rx_stream(void* h, bool now)
+{
+  return SRSRAN_SUCCESS;
+}
+
+int rf_shm_stop_rx_stream(void* h)
+{
+  return SRSRAN_SUCCESS;
+}
+
+void rf_shm_flush_buffer(void* h)
+{
+  // Readers resynchronize to the live stream on their next read
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    for (uint32_t i = 0; i < handler->nof_channels; i++) {
+      handler->receiver[i].synced = false;
+    }
+  }
+}
+
+bool rf_shm_has_rssi(void* h)
+{
+  return false;
+}
+
+float rf_shm_get_rssi(void* h)
+{
+  return 0.0;
+}
+
+int rf_shm_open(char* args, void** h)
+{
+  return rf_shm_open_multi(args, h, 1);
+}
+
+int rf_shm_open_multi(char* args, void** h, uint32_t nof_channels)
+{
+  int ret = SRSRAN_ERROR;
+  if (h && nof_channels <= SRSRAN_MAX_CHANNELS) {
+    *h = NULL;
+
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)malloc(sizeof(rf_shm_handler_t));
+    if (!handler) {
+      perror("malloc");
+      return SRSRAN_ERROR;
+    }
+    bzero(handler, sizeof(rf_shm_handler_t));
+    *h                        = handler;
+    handler->srate            = 1.92e6;
+    handler->info.max_rx_gain = SHM_MAX_GAIN_DB;
+    handler->info.min_rx_gain = SHM_MIN_GAIN_DB;
+    handler->info.max_tx_gain = SHM_MAX_GAIN_DB;
+    handler->info.min_tx_gain = SHM_MIN_GAIN_DB;
+    handler->nof_channels     = nof_channels;
+    strcpy(handler->id, "shm\0");
+
+    if (pthread_mutex_init(&handler->tx_config_mutex, NULL)) {
+      perror("Mutex init");
+    }
+    if (pthread_mutex_init(&handler->rx_config_mutex, NULL)) {
+      perror("Mutex init");
+    }
+
+    if (!args || !strlen(args)) {
+      fprintf(stderr,
+              "[shm] Error: No device 'args' option has been set. Please set at least rx_port or tx_port to the name "
+              "of a shared-memory segment (e.g. rx_port=/srsran_dl)\n");
+      goto clean_exit;
+    }
+
+    // id
+    parse_string(args, "id", -1, handler->id);
+
+    rf_shm_opts_t opts  = {};
+    opts.id             = handler->id;
+    opts.ring_samples   = SHM_RING_DEFAULT_SAMPLES;
+    opts.trx_timeout_ms = SHM_TIMEOUT_MS;
+    parse_uint32(args, "ring_samples", -1, &opts.ring_samples);
+
+    for (uint32_t i = 0; i < handler->nof_channels; i++) {
+      // rx_port / tx_port are segment names, e.g. /srsran_dl
+      char rx_port[RF_PARAM_LEN] = {};
+      parse_string(args, "rx_port", i, rx_port);
+      char tx_port[RF_PARAM_LEN] = {};
+      parse_string(args, "tx_port", i, tx_port);
+
+      parse_bool(args, "fail_on_disconnect", i, &opts.fail_on_disconnect);
+      parse_uint32(args, "trx_timeout_ms", i, &opts.trx_timeout_ms);
+      parse_bool(args, "log_trx_timeout", i, &opts.log_trx_timeout);
+
+      // initialize transmitter
+      if (strlen(tx_port) != 0) {
+        if (rf_shm_tx_open(&handler->transmitter[i], opts, tx_port) != SRSRAN_SUCCESS) {
+          fprintf(stderr, "[shm] Error: opening transmitter\n");
+          goto clean_exit;
+        }
+        handler->tx_enabled[i] = true;
+        handler->nof_tx_enabled++;
+      } else {
+        fprintf(stdout, "[shm] %s Tx port not specified for channel %d. Disabling transmitter.\n", handler->id, i);
+      }
+
+      // initialize receiver
+      if (strlen(rx_port) != 0) {
+        if (rf_shm_rx_open(&handler->receiver[i], opts, rx_port) != SRSRAN_SUCCESS) {
+          fprintf(stderr, "[shm] Error: opening receiver\n");
+          goto clean_exit;
+        }
+      } else {
+        fprintf(stdout, "[shm] %s Rx port not specified. Disabling receiver.\n", handler->id);
+      }
+
+      if (!handler->transmitter[i].running && !handler->receiver[i].running) {
+        fprintf(stderr, "[shm] Error: Neither Tx port nor Rx port specified.\n");
+        goto clean_exit;
+      }
+    }
+
+    ret = SRSRAN_SUCCESS;
+
+  clean_exit:
+    if (ret) {
+      rf_shm_close(handler);
+      *h = NULL;
+    }
+  }
+  return ret;
+}
+
+int rf_shm_close(void* h)
+{
+  rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+  if (!handler) {
+    return SRSRAN_ERROR;
+  }
+
+  rf_shm_info(handler->id, "Closing ...\n");
+
+  // Segments are left in /dev/shm so other processes keep working, remove them with rm /dev/shm/<name>
+  for (uint32_t i = 0; i < handler->nof_channels; i++) {
+    rf_shm_tx_close(&handler->transmitter[i]);
+    rf_shm_rx_close(&handler->receiver[i]);
+  }
+
+  pthread_mutex_destroy(&handler->tx_config_mutex);
+  pthread_mutex_destroy(&handler->rx_config_mutex);
+
+  free(handler);
+
+  return SRSRAN_SUCCESS;
+}
+
+double rf_shm_set_rx_srate(void* h, double srate)
+{
+  double ret = 0.0;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->rx_config_mutex);
+    handler->srate                   = srate;
+    handler->srate_mismatch_reported = false;
+    pthread_mutex_unlock(&handler->rx_config_mutex);
+    ret = srate;
+  }
+  return ret;
+}
+
+double rf_shm_set_tx_srate(void* h, double srate)
+{
+  double ret = 0.0;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->tx_config_mutex);
+    handler->srate = srate;
+    for (uint32_t i = 0; i < handler->nof_channels; i++) {
+      // Readers use it to pace their polling and to detect rate mismatches
+      rf_shm_tx_set_srate(&handler->transmitter[i], srate);
+    }
+    pthread_mutex_unlock(&handler->tx_config_mutex);
+    ret = srate;
+  }
+  return ret;
+}
+
+int rf_shm_set_rx_gain(void* h, double gain)
+{
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->rx_config_mutex);
+    handler->rx_gain = gain;
+    pthread_mutex_unlock(&handler->rx_config_mutex);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int rf_shm_set_rx_gain_ch(void* h, uint32_t ch, double gain)
+{
+  return rf_shm_set_rx_gain(h, gain);
+}
+
+int rf_shm_set_tx_gain(void* h, double gain)
+{
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->tx_config_mutex);
+    handler->tx_gain = gain;
+    pthread_mutex_unlock(&handler->tx_config_mutex);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int rf_shm_set_tx_gain_ch(void* h, uint32_t ch, double gain)
+{
+  return rf_shm_set_tx_gain(h, gain);
+}
+
+double rf_shm_get_rx_gain(void* h)
+{
+  double ret = 0.0;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->rx_config_mutex);
+    ret = handler->rx_gain;
+    pthread_mutex_unlock(&handler->rx_config_mutex);
+  }
+  return ret;
+}
+
+double rf_shm_get_tx_gain(void* h)
+{
+  double ret = NAN;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    pthread_mutex_lock(&handler->tx_config_mutex);
+    ret = handler->tx_gain;
+    pthread_mutex_unlock(&handler->tx_config_mutex);
+  }
+  return ret;
+}
+
+srsran_rf_info_t* rf_shm_get_info(void* h)
+{
+  srsran_rf_info_t* info = NULL;
+  if (h) {
+    rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+    info                      = &handler->info;
+  }
+  return info;
+}
+
+double rf_shm_set_rx_freq(void* h, uint32_t ch, double freq)
+{
+  // Segments are selected by name, the frequency is only informative
+  return freq;
+}
+
+double rf_shm_set_tx_freq(void* h, uint32_t ch, double freq)
+{
+  return freq;
+}
+
+void rf_shm_get_time(void* h, time_t* secs, double* frac_secs)
+{
+  if (h) {
+    rf_shm_handler_t*  handler = (rf_shm_handler_t*)h;
+    srsran_timestamp_t ts      = {};
+    srsran_timestamp_init_uint64(&ts, handler->next_rx_ts, handler->srate);
+    if (secs) {
+      *secs = ts.full_secs;
+    }
+    if (frac_secs) {
+      *frac_secs = ts.frac_secs;
+    }
+  }
+}
+
+int rf_shm_recv_with_time(void* h, void* data, uint32_t nsamples, bool blocking, time_t* secs, double* frac_secs)
+{
+  return rf_shm_recv_with_time_multi(h, &data, nsamples, blocking, secs, frac_secs);
+}
+
+int rf_shm_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool blocking, time_t* secs, double* frac_secs)
+{
+  if (!h) {
+    return SRSRAN_ERROR;
+  }
+  rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+
+  pthread_mutex_lock(&handler->rx_config_mutex);
+  double srate = handler->srate;
+  pthread_mutex_unlock(&handler->rx_config_mutex);
+
+  // Timestamps come from the ring of the first running receiver. Every channel keeps its own read index, so channels
+  // fed by different writers are not time aligned
+  uint64_t rx_ts  = handler->next_rx_ts;
+  bool     has_ts = false;
+  for (uint32_t c = 0; c < handler->nof_channels; c++) {
+    rf_shm_rx_t* rx     = &handler->receiver[c];
+    cf_t*        buffer = data ? (cf_t*)data[c] : NULL;
+
+    if (!rf_shm_rx_is_running(rx)) {
+      if (buffer) {
+        srsran_vec_cf_zero(buffer, nsamples);
+      }
+      continue;
+    }
+
+    double ring_srate = rf_shm_rx_get_srate(rx);
+    if (ring_srate > 0.0 && ring_srate != srate && !handler->srate_mismatch_reported) {
+      fprintf(stderr,
+              "[shm] Warning: segment %s carries %.2f MHz but %.2f MHz is configured\n",
+              rx->ring.name,
+              ring_srate / 1e6,
+              srate / 1e6);
+      handler->srate_mismatch_reported = true;
+    }
+
+    uint64_t ts       = 0;
+    bool     overflow = false;
+    int      n        = rf_shm_rx_baseband(rx, buffer, nsamples, &ts, &overflow);
+    while (n == SRSRAN_ERROR_TIMEOUT) {
+      if (rx->log_trx_timeout) {
+        fprintf(stderr, "Error: timeout receiving samples after %dms\n", rx->trx_timeout_ms);
+      }
+      // Writer stalled or gone, either keep waiting, or fail
+      if (rx->fail_on_disconnect) {
+        return SRSRAN_ERROR;
+      }
+      n = rf_shm_rx_baseband(rx, buffer, nsamples, &ts, &overflow);
+    }
+    if (n < SRSRAN_SUCCESS) {
+      fprintf(stderr, "Error: receiving data.\n");
+      return SRSRAN_ERROR;
+    }
+
+    if (overflow) {
+      rf_shm_report(handler, SRSRAN_RF_ERROR_OVERFLOW, c);
+    }
+
+    if (!has_ts) {
+      rx_ts  = ts;
+      has_ts = true;
+    }
+  }
+
+  // set timestamp for this reception
+  if (secs != NULL && frac_secs != NULL) {
+    srsran_timestamp_t ts = {};
+    srsran_timestamp_init_uint64(&ts, rx_ts, srate);
+    *secs      = ts.full_secs;
+    *frac_secs = ts.frac_secs;
+  }
+  handler->next_rx_ts = rx_ts + nsamples;
+
+  return (int)nsamples;
+}
+
+int rf_shm_send_timed(void*  h,
+                      void*  data,
+                      int    nsamples,
+                      time_t secs,
+                      double frac_secs,
+                      bool   has_time_spec,
+                      bool   blocking,
+                      bool   is_start_of_burst,
+                      bool   is_end_of_burst)
+{
+  void* _data[SRSRAN_MAX_CHANNELS] = {data};
+
+  return rf_shm_send_timed_multi(
+      h, _data, nsamples, secs, frac_secs, has_time_spec, blocking, is_start_of_burst, is_end_of_burst);
+}
+
+int rf_shm_send_timed_multi(void*  h,
+                            void*  data[4],
+                            int    nsamples,
+                            time_t secs,
+                            double frac_secs,
+                            bool   has_time_spec,
+                            bool   blocking,
+                            bool   is_start_of_burst,
+                            bool   is_end_of_burst)
+{
+  if (!h || !data || nsamples <= 0) {
+    return SRSRAN_ERROR;
+  }
+  rf_shm_handler_t* handler = (rf_shm_handler_t*)h;
+
+  // Transmitting without any tx_port would silently drop every sample
+  if (handler->nof_tx_enabled == 0) {
+    return SRSRAN_ERROR;
+  }
+
+  pthread_mutex_lock(&handler->tx_config_mutex);
+  double srate = handler->srate;
+  pthread_mutex_unlock(&handler->tx_config_mutex);
+
+  for (uint32_t c = 0; c < handler->nof_channels; c++) {
+    // Channels without a tx_port are skipped, the others still transmit
+    rf_shm_tx_t* tx = &handler->transmitter[c];
+    if (!handler->tx_enabled[c] || !rf_shm_tx_is_running(tx)) {
+      continue;
+    }
+
+    uint32_t skip = 0;
+    if (has_time_spec) {
+      srsran_timestamp_t ts = {};
+      srsran_timestamp_init(&ts, secs, frac_secs);
+      int64_t gap = rf_shm_tx_align(tx, srsran_timestamp_uint64(&ts, srate));
+
+      // Samples already in the ring can not be replaced, drop the late part of the burst
+      if (gap < 0) {
+        rf_shm_report(handler, SRSRAN_RF_ERROR_LATE, c);
+        skip = (uint32_t)SRSRAN_MIN(-gap, (int64_t)nsamples);
+      }
+    }
+
+    if (skip < (uint32_t)nsamples) {
+      cf_t* buffer = (c < 4 && data[c]) ? &((cf_t*)data[c])[skip] : NULL;
+      if (rf_shm_tx_baseband(tx, buffer, (uint32_t)nsamples - skip) < SRSRAN_SUCCESS) {
+        return SRSRAN_ERROR;
+      }
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+rf_dev_t srsran_rf_dev_shm = {"shm",
+                              rf_shm_devname,
+                              rf_shm_start_rx_stream,
+                              rf_shm_stop_rx_stream,
+                              rf_shm_flush_buffer,
+                              rf_shm_has_rssi,
+                              rf_shm_get_rssi,
+                              rf_shm_suppress_stdout,
+                              rf_shm_register_error_handler,
+                              rf_shm_open,
+                              .srsran_rf_open_multi = rf_shm_open_multi,
+                              rf_shm_close,
+                              rf_shm_set_rx_srate,
+                              rf_shm_set_rx_gain,
+                              rf_shm_set_rx_gain_ch,
+                              rf_shm_set_tx_gain,
+                              rf_shm_set_tx_gain_ch,
+                              rf_shm_get_rx_gain,
+                              rf_shm_get_tx_gain,
+                              rf_shm_get_info,
+                              rf_shm_set_rx_freq,
+                              rf_shm_set_tx_srate,
+                              rf_shm_set_tx_freq,
+                              rf_shm_get_time,
+                              NULL,
+                              rf_shm_recv_with_time,
+                              rf_shm_recv_with_time_multi,
+                              rf_shm_send_timed,
+                              .srsran_rf_send_timed_multi = rf_shm_send_timed_multi};
@@ -0,0 +1,388 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp_trx.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SHM_POLL_MIN_US (10)
+#define SHM_POLL_MAX_US (1000)
+
+/*
+ * Shared segment
+ */
+static int rf_shm_ring_open(rf_shm_ring_t* r, const char* name, uint32_t ring_samples, char* id)
+{
+  bzero(r, sizeof(rf_shm_ring_t));
+  r->fd = -1;
+
+  if (name == NULL || name[0] != '/') {
+    rf_shm_error(id, "[shm] Error: segment name '%s' must start with '/'\n", name ? name : "");
+    return SRSRAN_ERROR;
+  }
+  if (ring_samples == 0 || (ring_samples & (ring_samples - 1)) != 0) {
+    rf_shm_error(id, "[shm] Error: ring size %d is not a power of two\n", ring_samples);
+    return SRSRAN_ERROR;
+  }
+  strncpy(r->name, name, RF_PARAM_LEN - 1);
+
+  // Only the end creating the segment sizes it, the others wait for it. Sizing it from every end would let a late
+  // end shrink the segment under the mapping of an earlier one
+  bool creator = true;
+  r->fd        = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0666);
+  if (r->fd < 0 && errno == EEXIST) {
+    creator = false;
+    r->fd   = shm_open(name, O_RDWR, 0666);
+  }
+  if (r->fd < 0) {
+    rf_shm_error(id, "[shm] Error: opening segment %s: %s\n", name, strerror(errno));
+    return SRSRAN_ERROR;
+  }
+  if (creator && ftruncate(r->fd, sizeof(rf_shm_ring_header_t) + (size_t)ring_samples * sizeof(cf_t)) < 0) {
+    rf_shm_error(id, "[shm] Error: sizing segment %s: %s\n", name, strerror(errno));
+    return SRSRAN_ERROR;
+  }
+
+  // Later ends inherit the capacity of the creator
+  struct stat st = {};
+  for (uint32_t waited_ms = 0;; waited_ms++) {
+    if (fstat(r->fd, &st) < 0) {
+      rf_shm_error(id, "[shm] Error: reading segment %s size: %s\n", name, strerror(errno));
+      return SRSRAN_ERROR;
+    }
+    if (st.st_size > 0) {
+      break;
+    }
+    if (waited_ms >= SHM_INIT_TIMEOUT_MS) {
+      rf_shm_error(id, "[shm] Error: segment %s was never sized\n", name);
+      return SRSRAN_ERROR;
+    }
+    usleep(1000);
+  }
+  r->map_size = (size_t)st.st_size;
+  if (r->map_size < sizeof(rf_shm_ring_header_t) + sizeof(cf_t)) {
+    rf_shm_error(id, "[shm] Error: segment %s is too small (%zu B)\n", name, r->map_size);
+    return SRSRAN_ERROR;
+  }
+
+  void* ptr = mmap(NULL, r->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, r->fd, 0);
+  if (ptr == MAP_FAILED) {
+    rf_shm_error(id, "[shm] Error: mapping segment %s: %s\n", name, strerror(errno));
+    return SRSRAN_ERROR;
+  }
+  r->header  = (rf_shm_ring_header_t*)ptr;
+  r->samples = (cf_t*)(r->header + 1);
+
+  // The first end to map the segment initializes the header, the others wait for it
+  rf_shm_ring_header_t* h        = r->header;
+  uint32_t              expected = 0;
+  if (__atomic_compare_exchange_n(&h->state, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    size_t   capacity    = (r->map_size - sizeof(rf_shm_ring_header_t)) / sizeof(cf_t);
+    uint32_t nof_samples = 1;
+    while ((size_t)nof_samples * 2 <= capacity && nof_samples < (1U << 31)) {
+      nof_samples *= 2;
+    }
+    h->magic       = SHM_RING_MAGIC;
+    h->version     = SHM_RING_VERSION;
+    h->nof_samples = nof_samples;
+    h->srate       = 0.0;
+    __atomic_store_n(&h->write_ts, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&h->state, 2, __ATOMIC_RELEASE);
+    rf_shm_info(id, "Created segment %s with %d samples\n", name, nof_samples);
+  } else {
+    uint32_t waited_ms = 0;
+    while (__atomic_load_n(&h->state, __ATOMIC_ACQUIRE) != 2) {
+      if (waited_ms++ >= SHM_INIT_TIMEOUT_MS) {
+        rf_shm_error(id, "[shm] Error: segment %s was never initialized\n", name);
+        return SRSRAN_ERROR;
+      }
+      usleep(1000);
+    }
+  }
+
+  if (h->magic != SHM_RING_MAGIC || h->version != SHM_RING_VERSION || h->nof_samples == 0 ||
+      (h->nof_samples & (h->nof_samples - 1)) != 0 ||
+      sizeof(rf_shm_ring_header_t) + (size_t)h->nof_samples * sizeof(cf_t) > r->map_size) {
+    rf_shm_error(id, "[shm] Error: segment %s has an incompatible layout\n", name);
+    return SRSRAN_ERROR;
+  }
+
+  r->mask      = h->nof_samples - 1;
+  r->max_chunk = h->nof_samples / 4;
+  return SRSRAN_SUCCESS;
+}
+
+static void rf_shm_ring_close(rf_shm_ring_t* r)
+{
+  if (r->header) {
+    munmap(r->header, r->map_size);
+    r->header  = NULL;
+    r->samples = NULL;
+  }
+  if (r->fd >= 0) {
+    close(r->fd);
+    r->fd = -1;
+  }
+}
+
+/*
+ * Transmitter
+ */
+int rf_shm_tx_open(rf_shm_tx_t* q, rf_shm_opts_t opts, const char* name)
+{
+  int ret = SRSRAN_ERROR;
+
+  if (q) {
+    bzero(q, sizeof(rf_shm_tx_t));
+    strncpy(q->id, opts.id, SHM_ID_STRLEN - 1);
+
+    rf_shm_info(q->id, "Opening transmitter: %s\n", name);
+
+    if (rf_shm_ring_open(&q->ring, name, opts.ring_samples, q->id) != SRSRAN_SUCCESS) {
+      rf_shm_ring_close(&q->ring);
+      return ret;
+    }
+
+    // Only one writer per segment, take over the segment if the previous writer died without closing it
+    uint32_t pid      = (uint32_t)getpid();
+    uint32_t expected = 0;
+    if (!__atomic_compare_exchange_n(
+            &q->ring.header->writer_pid, &expected, pid, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      bool stale = kill((pid_t)expected, 0) < 0 && errno == ESRCH;
+      if (!stale || !__atomic_compare_exchange_n(
+                        &q->ring.header->writer_pid, &expected, pid, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        fprintf(stderr, "[shm] Error: segment %s already has a writer (pid %d)\n", name, expected);
+        rf_shm_ring_close(&q->ring);
+        return ret;
+      }
+    }
+
+    q->running = true;
+    ret        = SRSRAN_SUCCESS;
+  }
+
+  return ret;
+}
+
+void rf_shm_tx_set_srate(rf_shm_tx_t* q, double srate)
+{
+  if (q && q->running) {
+    q->srate              = srate;
+    q->ring.header->srate = srate;
+  }
+}
+
+uint64_t rf_shm_tx_get_nsamples(rf_shm_tx_t* q)
+{
+  // Single writer, nobody else moves write_ts
+  return __atomic_load_n(&q->ring.header->write_ts, __ATOMIC_RELAXED);
+}
+
+static void rf_shm_tx_write(rf_shm_tx_t* q, const cf_t* buffer, uint32_t nsamples)
+{
+  rf_shm_ring_t* r  = &q->ring;
+  uint64_t       ts = rf_shm_tx_get_nsamples(q);
+
+  // Publish in chunks, so a reader never loses more than one chunk while copying
+  for (uint32_t offset = 0; offset < nsamples;) {
+    uint32_t n     = SRSRAN_MIN(nsamples - offset, r->max_chunk);
+    uint32_t idx   = (uint32_t)(ts & r->mask);
+    uint32_t first = SRSRAN_MIN(n, r->mask + 1 - idx);
+
+    if (buffer) {
+      memcpy(&r->samples[idx], &buffer[offset], first * sizeof(cf_t));
+      memcpy(&r->samples[0], &buffer[offset + first], (n - first) * sizeof(cf_t));
+    } else {
+      srsran_vec_cf_zero(&r->samples[idx], first);
+      srsran_vec_cf_zero(&r->samples[0], n - first);
+    }
+
+    ts += n;
+    offset += n;
+    __atomic_store_n(&r->header->write_ts, ts, __ATOMIC_RELEASE);
+  }
+}
+
+int64_t rf_shm_tx_align(rf_shm_tx_t* q, uint64_t ts)
+{
+  int64_t gap = (int64_t)(ts - rf_shm_tx_get_nsamples(q));
+
+  if (gap > 0) {
+    // Filling more than the ring is pointless, jump ahead and let readers resync
+    uint32_t capacity = q->ring.mask + 1;
+    if (gap > capacity) {
+      __atomic_store_n(&q->ring.header->write_ts, ts - capacity, __ATOMIC_RELEASE);
+    }
+    rf_shm_tx_write(q, NULL, (uint32_t)SRSRAN_MIN(gap, capacity));
+  }
+
+  return gap;
+}
+
+int rf_shm_tx_baseband(rf_shm_tx_t* q, const cf_t* buffer, uint32_t nsamples)
+{
+  if (!q->running) {
+    return SRSRAN_ERROR;
+  }
+  rf_shm_tx_write(q, buffer, nsamples);
+  return (int)nsamples;
+}
+
+int rf_shm_tx_zeros(rf_shm_tx_t* q, uint32_t nsamples)
+{
+  return rf_shm_tx_baseband(q, NULL, nsamples);
+}
+
+bool rf_shm_tx_is_running(rf_shm_tx_t* q)
+{
+  return q != NULL && q->running;
+}
+
+void rf_shm_tx_close(rf_shm_tx_t* q)
+{
+  if (q->running) {
+    __atomic_store_n(&q->ring.header->writer_pid, 0, __ATOMIC_RELEASE);
+  }
+  q->running = false;
+  rf_shm_ring_close(&q->ring);
+}
+
+/*
+ * Receiver
+ */
+int rf_shm_rx_open(rf_shm_rx_t* q, rf_shm_opts_t opts, const char* name)
+{
+  int ret = SRSRAN_ERROR;
+
+  if (q) {
+    bzero(q, sizeof(rf_shm_rx_t));
+    strncpy(q->id, opts.id, SHM_ID_STRLEN - 1);
+    q->fail_on_disconnect = opts.fail_on_disconnect;
+    q->trx_timeout_ms     = opts.trx_timeout_ms;
+    q->log_trx_timeout    = opts.log_trx_timeout;
+
+    rf_shm_info(q->id, "Opening receiver: %s\n", name);
+
+    if (rf_shm_ring_open(&q->ring, name, opts.ring_samples, q->id) != SRSRAN_SUCCESS) {
+      rf_shm_ring_close(&q->ring);
+      return ret;
+    }
+    __atomic_add_fetch(&q->ring.header->nof_readers, 1, __ATOMIC_RELAXED);
+
+    q->running = true;
+    ret        = SRSRAN_SUCCESS;
+  }
+
+  return ret;
+}
+
+double rf_shm_rx_get_srate(rf_shm_rx_t* q)
+{
+  return q->running ? q->ring.header->srate : 0.0;
+}
+
+int rf_shm_rx_baseband(rf_shm_rx_t* q, cf_t* buffer, uint32_t nsamples, uint64_t* ts, bool* overflow)
+{
+  if (!q->running) {
+    return SRSRAN_ERROR;
+  }
+
+  rf_shm_ring_t* r        = &q->ring;
+  uint32_t       capacity = r->mask + 1;
+  uint64_t       max_lag  = capacity - r->max_chunk;
+  if (nsamples > capacity / 2) {
+    fprintf(stderr, "[shm] Error: reading %d samples from a ring of %d samples\n", nsamples, capacity);
+    return SRSRAN_ERROR;
+  }
+
+  *overflow          = false;
+  uint32_t waited_us = 0;
+  while (true) {
+    uint64_t write_ts = __atomic_load_n(&r->header->write_ts, __ATOMIC_ACQUIRE);
+
+    // Join the live stream on the first read, and again if the segment was recreated
+    if (!q->synced || (int64_t)(write_ts - q->read_ts) < 0) {
+      q->read_ts = write_ts;
+      q->synced  = true;
+    }
+
+    // Fell behind, the oldest samples may be overwritten by the next chunk
+    if (write_ts - q->read_ts > max_lag) {
+      q->read_ts = write_ts - nsamples;
+      q->nof_overflows++;
+      *overflow = true;
+    }
+
+    if (write_ts - q->read_ts >= nsamples) {
+      if (buffer) {
+        uint32_t idx   = (uint32_t)(q->read_ts & r->mask);
+        uint32_t first = SRSRAN_MIN(nsamples, capacity - idx);
+        memcpy(buffer, &r->samples[idx], first * sizeof(cf_t));
+        memcpy(&buffer[first], &r->samples[0], (nsamples - first) * sizeof(cf_t));
+
+        // The writer may have lapped the copy, retry from the resynced position
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&r->header->write_ts, __ATOMIC_RELAXED) - q->read_ts > max_lag) {
+          continue;
+        }
+      }
+
+      *ts = q->read_ts;
+      q->read_ts += nsamples;
+      return (int)nsamples;
+    }
+
+    if (q->trx_timeout_ms && waited_us >= q->trx_timeout_ms * 1000U) {
+      return SRSRAN_ERROR_TIMEOUT;
+    }
+
+    // Sleep roughly until the missing samples are due
+    uint64_t missing  = nsamples - (write_ts - q->read_ts);
+    double   srate    = r->header->srate;
+    uint32_t sleep_us = SHM_POLL_MAX_US;
+    if (srate > 0.0) {
+      sleep_us = (uint32_t)SRSRAN_MIN((double)SHM_POLL_MAX_US, missing * 1e6 / srate);
+    }
+    sleep_us = SRSRAN_MAX(sleep_us, SHM_POLL_MIN_US);
+    usleep(sleep_us);
+    waited_us += sleep_us;
+  }
+}
+
+bool rf_shm_rx_is_running(rf_shm_rx_t* q)
+{
+  return q != NULL && q->running;
+}
+
+void rf_shm_rx_close(rf_shm_rx_t* q)
+{
+  if (q->running) {
+    __atomic_sub_fetch(&q->ring.header->nof_readers, 1, __ATOMIC_RELAXED);
+  }
+  q->running = false;
+  rf_shm_ring_close(&q->ring);
+}
@@ -0,0 +1,147 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_RF_SHM_IMP_TRX_H
+#define SRSRAN_RF_SHM_IMP_TRX_H
+
+#include <srsran/config.h>
+#include <srsran/phy/rf/rf.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Definitions */
+#define VERBOSE (0)
+#define SHM_RING_MAGIC (0x53484d31) // "SHM1"
+#define SHM_RING_VERSION (1)
+#define SHM_RING_DEFAULT_SAMPLES (1U << 22) // ~180 ms at 23.04 MHz
+#define SHM_TIMEOUT_MS (2000)
+#define SHM_INIT_TIMEOUT_MS (1000)
+#define SHM_MAX_GAIN_DB (30.0f)
+#define SHM_MIN_GAIN_DB (0.0f)
+#define SHM_ID_STRLEN 16
+
+/**
+ * Header at the start of every shared-memory segment. The sample ring follows the header. All counters are sample
+ * indexes since the ring was created, the timestamp of a sample is its index divided by the sampling rate.
+ *
+ * A single writer appends samples and publishes them by advancing write_ts. Any number of readers poll write_ts and
+ * copy out samples from their own read index, without any coordination between them.
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t state;       ///< 0: uninitialized, 1: initializing, 2: ready
+  uint32_t nof_samples; ///< Ring capacity, power of two
+  uint32_t writer_pid; ///< Process owning the write side, 0 if none
+  uint32_t nof_readers;
+  double   srate;    ///< Sampling rate announced by the writer, 0 if unknown
+  uint64_t write_ts; ///< Index of the next sample to be written
+  uint8_t  reserved[24];
+} rf_shm_ring_header_t;
+
+typedef struct {
+  char                  name[RF_PARAM_LEN];
+  int                   fd;
+  size_t                map_size;
+  rf_shm_ring_header_t* header;
+  cf_t*                 samples;
+  uint32_t              mask;
+  uint32_t              max_chunk; ///< Largest write before publishing, bounds what a reader can lose while copying
+} rf_shm_ring_t;
+
+typedef struct {
+  char          id[SHM_ID_STRLEN];
+  rf_shm_ring_t ring;
+  bool          running;
+  double        srate;
+} rf_shm_tx_t;
+
+typedef struct {
+  char          id[SHM_ID_STRLEN];
+  rf_shm_ring_t ring;
+  bool          running;
+  uint64_t      read_ts;
+  bool          synced;
+  uint64_t      nof_overflows;
+  bool          fail_on_disconnect;
+  uint32_t      trx_timeout_ms;
+  bool          log_trx_timeout;
+} rf_shm_rx_t;
+
+typedef struct {
+  const char* id;
+  uint32_t    ring_samples; ///< Capacity used when this end creates the segment
+  bool        fail_on_disconnect;
+  uint32_t    trx_timeout_ms;
+  bool        log_trx_timeout;
+} rf_shm_opts_t;
+
+/*
+ * Common functions
+ */
+SRSRAN_API void rf_shm_info(char* id, const char* format, ...);
+
+SRSRAN_API void rf_shm_error(char* id, const char* format, ...);
+
+/*
+ * Transmitter functions
+ */
+SRSRAN_API int rf_shm_tx_open(rf_shm_tx_t* q, rf_shm_opts_t opts, const char* name);
+
+SRSRAN_API void rf_shm_tx_set_srate(rf_shm_tx_t* q, double srate);
+
+SRSRAN_API int64_t rf_shm_tx_align(rf_shm_tx_t* q, uint64_t ts);
+
+SRSRAN_API int rf_shm_tx_baseband(rf_shm_tx_t* q, const cf_t* buffer, uint32_t nsamples);
+
+SRSRAN_API int rf_shm_tx_zeros(rf_shm_tx_t* q, uint32_t nsamples);
+
+SRSRAN_API uint64_t rf_shm_tx_get_nsamples(rf_shm_tx_t* q);
+
+SRSRAN_API void rf_shm_tx_close(rf_shm_tx_t* q);
+
+SRSRAN_API bool rf_shm_tx_is_running(rf_shm_tx_t* q);
+
+/*
+ * Receiver functions
+ */
+SRSRAN_API int rf_shm_rx_open(rf_shm_rx_t* q, rf_shm_opts_t opts, const char* name);
+
+/**
+ * @brief Copies the next nsamples of the ring into buffer
+ * @param q Receiver
+ * @param buffer Destination, NULL discards the samples
+ * @param nsamples Number of samples, at most half the ring capacity
+ * @param ts Returns the index of the first sample copied
+ * @param overflow Set to true if the reader fell behind the writer and samples were skipped
+ * @return nsamples, SRSRAN_ERROR_TIMEOUT if the writer stalled, SRSRAN_ERROR otherwise
+ */
+SRSRAN_API int rf_shm_rx_baseband(rf_shm_rx_t* q, cf_t* buffer, uint32_t nsamples, uint64_t* ts, bool* overflow);
+
+SRSRAN_API double rf_shm_rx_get_srate(rf_shm_rx_t* q);
+
+SRSRAN_API void rf_shm_rx_close(rf_shm_rx_t* q);
+
+SRSRAN_API bool rf_shm_rx_is_running(rf_shm_rx_t* q);
+
+#endif // SRSRAN_RF_SHM_IMP_TRX_H
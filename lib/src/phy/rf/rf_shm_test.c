@@ -0,0 +1,293 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/common/timestamp.h"
+#include "srsran/phy/rf/rf.h"
+#include "srsran/phy/utils/debug.h"
+#include <complex.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define SEGMENT_NAME "/srsran_rf_shm_test"
+#define RX_SEGMENT_NAME "/srsran_rf_shm_test_rx"
+#define SRATE (1.92e6)
+#define SF_LEN (1920)
+#define NUM_SF (200)
+#define NOF_READERS (2)
+#define TX_OFFSET_MS (4)
+
+static cf_t tx_buffer[SF_LEN];
+static cf_t rx_buffer[NOF_READERS][SF_LEN];
+
+static srsran_rf_t writer_radio;
+static srsran_rf_t reader_radio[NOF_READERS];
+
+static volatile bool     writer_timed = false;
+static volatile uint32_t nof_overflows[NOF_READERS];
+
+static void overflow_handler(void* arg, srsran_rf_error_t error)
+{
+  if (error.type == SRSRAN_RF_ERROR_OVERFLOW) {
+    nof_overflows[(intptr_t)arg]++;
+  }
+}
+
+// Every sample carries its own index, so readers can check content and timestamp at once
+static void* writer_thread_function(void* args)
+{
+  // Give the readers time to join the stream
+  usleep(100000);
+
+  for (uint32_t sf = 0; sf < NUM_SF; sf++) {
+    uint64_t first = (uint64_t)sf * SF_LEN;
+    if (writer_timed) {
+      // Leave one subframe gap every other subframe, the ring fills it with zeros
+      first = (uint64_t)sf * 2 * SF_LEN;
+    }
+    for (uint32_t i = 0; i < SF_LEN; i++) {
+      tx_buffer[i] = (float)(first + i);
+    }
+
+    int ret = SRSRAN_ERROR;
+    if (writer_timed) {
+      srsran_timestamp_t ts = {};
+      srsran_timestamp_init_uint64(&ts, first, SRATE);
+      ret = srsran_rf_send_timed(&writer_radio, tx_buffer, SF_LEN, ts.full_secs, ts.frac_secs);
+    } else {
+      ret = srsran_rf_send(&writer_radio, tx_buffer, SF_LEN, true);
+    }
+    if (ret != SRSRAN_SUCCESS) {
+      fprintf(stderr, "Error sending data\n");
+      exit(-1);
+    }
+
+    // Roughly real time
+    usleep(1000);
+  }
+
+  return NULL;
+}
+
+static int run_test(bool timed)
+{
+  int ret = SRSRAN_ERROR;
+
+  // Argument parsing consumes the string, every device gets its own copy
+  const char* writer_args = "tx_port=" SEGMENT_NAME ",ring_samples=65536";
+  const char* reader_args = "rx_port=" SEGMENT_NAME ",fail_on_disconnect=true,trx_timeout_ms=1000";
+  char        rf_args[RF_PARAM_LEN] = {};
+
+  strncpy(rf_args, writer_args, RF_PARAM_LEN - 1);
+  if (srsran_rf_open_devname(&writer_radio, "shm", rf_args, 1)) {
+    fprintf(stderr, "Error opening writer\n");
+    return SRSRAN_ERROR;
+  }
+  srsran_rf_set_tx_srate(&writer_radio, SRATE);
+
+  for (intptr_t r = 0; r < NOF_READERS; r++) {
+    strncpy(rf_args, reader_args, RF_PARAM_LEN - 1);
+    if (srsran_rf_open_devname(&reader_radio[r], "shm", rf_args, 1)) {
+      fprintf(stderr, "Error opening reader %d\n", (int)r);
+      return SRSRAN_ERROR;
+    }
+    srsran_rf_set_rx_srate(&reader_radio[r], SRATE);
+    srsran_rf_register_error_handler(&reader_radio[r], overflow_handler, (void*)r);
+    nof_overflows[r] = 0;
+  }
+
+  // A second writer on the same segment must be rejected
+  srsran_rf_t other_writer;
+  strncpy(rf_args, writer_args, RF_PARAM_LEN - 1);
+  if (srsran_rf_open_devname(&other_writer, "shm", rf_args, 1) == SRSRAN_SUCCESS) {
+    fprintf(stderr, "Second writer was not rejected\n");
+    return SRSRAN_ERROR;
+  }
+
+  writer_timed = timed;
+  pthread_t writer_thread;
+  if (pthread_create(&writer_thread, NULL, writer_thread_function, NULL)) {
+    perror("pthread_create");
+    return SRSRAN_ERROR;
+  }
+
+  // Both readers consume the same stream independently, half of it is enough
+  uint64_t expected[NOF_READERS] = {};
+  for (uint32_t sf = 0; sf < NUM_SF / 2; sf++) {
+    for (uint32_t r = 0; r < NOF_READERS; r++) {
+      srsran_timestamp_t ts = {};
+      int n = srsran_rf_recv_with_time(&reader_radio[r], rx_buffer[r], SF_LEN, true, &ts.full_secs, &ts.frac_secs);
+      if (n != SF_LEN) {
+        fprintf(stderr, "Reader %d: received %d samples\n", r, n);
+        goto exit;
+      }
+
+      uint64_t first = srsran_timestamp_uint64(&ts, SRATE);
+      if (sf > 0 && first != expected[r] && nof_overflows[r] == 0) {
+        fprintf(stderr, "Reader %d: timestamp %ld, expected %ld\n", r, (long)first, (long)expected[r]);
+        goto exit;
+      }
+      expected[r] = first + SF_LEN;
+
+      for (uint32_t i = 0; i < SF_LEN; i++) {
+        uint64_t idx = first + i;
+        // In timed mode, odd subframes are the zero gaps inserted by the ring
+        float value = (timed && (idx / SF_LEN) % 2) ? 0.0f : (float)idx;
+        if (crealf(rx_buffer[r][i]) != value || cimagf(rx_buffer[r][i]) != 0.0f) {
+          fprintf(stderr,
+                  "Reader %d: sample %ld is %f, expected %f\n",
+                  r,
+                  (long)idx,
+                  crealf(rx_buffer[r][i]),
+                  value);
+          goto exit;
+        }
+      }
+    }
+  }
+
+  printf("%s test: readers received %d subframes, %d and %d overflows\n",
+         timed ? "timed" : "untimed",
+         NUM_SF / 2,
+         nof_overflows[0],
+         nof_overflows[1]);
+  ret = SRSRAN_SUCCESS;
+
+exit:
+  pthread_join(writer_thread, NULL);
+  srsran_rf_close(&writer_radio);
+  for (uint32_t r = 0; r < NOF_READERS; r++) {
+    srsran_rf_close(&reader_radio[r]);
+  }
+  shm_unlink(SEGMENT_NAME);
+  return ret;
+}
+
+// Sends on two channels of a device that only has a tx_port on the first one, the second one only receives
+static void* partial_writer_thread_function(void* args)
+{
+  // Give the reader time to join the stream
+  usleep(100000);
+
+  void* data[2] = {tx_buffer, tx_buffer};
+  for (uint32_t sf = 0; sf < NUM_SF / 10; sf++) {
+    for (uint32_t i = 0; i < SF_LEN; i++) {
+      tx_buffer[i] = (float)(sf * SF_LEN + i);
+    }
+    if (srsran_rf_send_multi(&writer_radio, data, SF_LEN, true, true, true) != SRSRAN_SUCCESS) {
+      fprintf(stderr, "Error sending data\n");
+      exit(-1);
+    }
+    usleep(1000);
+  }
+
+  return NULL;
+}
+
+static int run_partial_tx_test()
+{
+  int  ret                   = SRSRAN_ERROR;
+  char rf_args[RF_PARAM_LEN] = {};
+
+  strncpy(rf_args, "tx_port0=" SEGMENT_NAME ",rx_port1=" RX_SEGMENT_NAME ",ring_samples=65536", RF_PARAM_LEN - 1);
+  if (srsran_rf_open_devname(&writer_radio, "shm", rf_args, 2)) {
+    fprintf(stderr, "Error opening writer\n");
+    return SRSRAN_ERROR;
+  }
+  srsran_rf_set_tx_srate(&writer_radio, SRATE);
+
+  strncpy(rf_args, "rx_port=" SEGMENT_NAME ",fail_on_disconnect=true,trx_timeout_ms=1000", RF_PARAM_LEN - 1);
+  if (srsran_rf_open_devname(&reader_radio[0], "shm", rf_args, 1)) {
+    fprintf(stderr, "Error opening reader\n");
+    return SRSRAN_ERROR;
+  }
+  srsran_rf_set_rx_srate(&reader_radio[0], SRATE);
+
+  // A device without any tx_port must not report the samples as sent
+  pthread_t writer_thread;
+  bool      writer_started = false;
+  if (srsran_rf_send(&reader_radio[0], tx_buffer, SF_LEN, true) == SRSRAN_SUCCESS) {
+    fprintf(stderr, "Sending without tx_port succeeded\n");
+    goto exit;
+  }
+
+  if (pthread_create(&writer_thread, NULL, partial_writer_thread_function, NULL)) {
+    perror("pthread_create");
+    goto exit;
+  }
+  writer_started = true;
+
+  // The channel with a tx_port transmits even though the second one has none
+  srsran_timestamp_t ts = {};
+  int n = srsran_rf_recv_with_time(&reader_radio[0], rx_buffer[0], SF_LEN, true, &ts.full_secs, &ts.frac_secs);
+  if (n != SF_LEN) {
+    fprintf(stderr, "Partial tx: received %d samples\n", n);
+    goto exit;
+  }
+  uint64_t first = srsran_timestamp_uint64(&ts, SRATE);
+  for (uint32_t i = 0; i < SF_LEN; i++) {
+    if (crealf(rx_buffer[0][i]) != (float)(first + i)) {
+      fprintf(stderr, "Partial tx: sample %ld is %f\n", (long)(first + i), crealf(rx_buffer[0][i]));
+      goto exit;
+    }
+  }
+
+  printf("partial tx test: reader received samples of the channel with a tx_port\n");
+  ret = SRSRAN_SUCCESS;
+
+exit:
+  if (writer_started) {
+    pthread_join(writer_thread, NULL);
+  }
+  srsran_rf_close(&writer_radio);
+  srsran_rf_close(&reader_radio[0]);
+  shm_unlink(SEGMENT_NAME);
+  shm_unlink(RX_SEGMENT_NAME);
+  return ret;
+}
+
+int main()
+{
+  shm_unlink(SEGMENT_NAME);
+  shm_unlink(RX_SEGMENT_NAME);
+
+  if (run_test(false) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Untimed shared-memory test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  if (run_test(true) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Timed shared-memory test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  if (run_partial_tx_test() != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Partial transmitter shared-memory test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  fprintf(stdout, "Test passed!\n");
+
+  return SRSRAN_SUCCESS;
+}
@@ -436,6 +436,101 @@ float compute_peak_sidelobe(srsran_pss_t* q, uint32_t corr_peak_pos, uint32_t co
   return q->conv_output_avg[corr_peak_pos] / side_lobe_value;
 }
 
+/* Finds the peak of the correlation stored in conv_output and returns its position in the input buffer
+ */
+static int pss_find_peak(srsran_pss_t* q, uint32_t conv_output_len, float* corr_peak_value)
+{
+  uint32_t corr_peak_pos;
+
+  // Compute modulus square
+  srsran_vec_abs_square_cf(q->conv_output, q->conv_output_abs, conv_output_len - 1);
+
+  // If enabled, average the absolute value from previous calls
+  if (q->ema_alpha < 1.0 && q->ema_alpha > 0.0) {
+    srsran_vec_sc_prod_fff(q->conv_output_abs, q->ema_alpha, q->conv_output_abs, conv_output_len - 1);
+    srsran_vec_sc_prod_fff(q->conv_output_avg, 1 - q->ema_alpha, q->conv_output_avg, conv_output_len - 1);
+
+    srsran_vec_sum_fff(q->conv_output_abs, q->conv_output_avg, q->conv_output_avg, conv_output_len - 1);
+  } else {
+    memcpy(q->conv_output_avg, q->conv_output_abs, sizeof(float) * (conv_output_len - 1));
+  }
+
+  /* Find maximum of the absolute value of the correlation */
+  corr_peak_pos = srsran_vec_max_fi(q->conv_output_avg, conv_output_len - 1);
+
+  // save absolute value
+  q->peak_value = q->conv_output_avg[corr_peak_pos];
+
+#ifdef SRSRAN_PSS_RETURN_PSR
+  if (corr_peak_value) {
+    *corr_peak_value = compute_peak_sidelobe(q, corr_peak_pos, conv_output_len);
+  }
+#else
+  if (corr_peak_value) {
+    *corr_peak_value = q->conv_output_avg[corr_peak_pos];
+  }
+#endif
+
+  if (q->decimate > 1) {
+    int decimation_correction = (q->filter.num_taps - 2);
+    corr_peak_pos             = corr_peak_pos - decimation_correction;
+    corr_peak_pos             = corr_peak_pos * q->decimate;
+  }
+
+  if (q->frame_size >= q->fft_size) {
+    return (int)corr_peak_pos;
+  } else {
+    return (int)corr_peak_pos + q->fft_size;
+  }
+}
+
+/** Transforms an input block into the frequency domain for the FFT-based PSS correlation.
+ * The returned spectrum can be correlated by srsran_pss_find_pss_fft() against every N_id_2 and by every PSS
+ * object with the same frame size, FFT size and decimation, so that a block is transformed only once for all the
+ * N_id_2 and integer CFO hypotheses. It stays valid until the next call with this object.
+ *
+ * Returns NULL if the object correlates in the time domain (frame size shorter than the FFT size).
+ */
+const cf_t* srsran_pss_input_fft(srsran_pss_t* q, const cf_t* input)
+{
+  if (q == NULL || input == NULL || q->frame_size < q->fft_size) {
+    return NULL;
+  }
+
+  memcpy(q->tmp_input, input, (q->frame_size * q->decimate) * sizeof(cf_t));
+  const cf_t* conv_input = q->tmp_input;
+  if (q->decimate > 1) {
+    srsran_filt_decim_cc_execute(&(q->filter),
+                                 q->tmp_input,
+                                 q->filter.downsampled_input,
+                                 q->filter.filter_output,
+                                 (q->frame_size * q->decimate));
+    conv_input = q->filter.filter_output;
+  }
+
+  srsran_dft_run_c(&q->conv_fft.input_plan, conv_input, q->conv_fft.input_fft);
+  return q->conv_fft.input_fft;
+}
+
+/** Same as srsran_pss_find_pss() on a block already transformed by srsran_pss_input_fft().
+ */
+int srsran_pss_find_pss_fft(srsran_pss_t* q, const cf_t* input_fft, float* corr_peak_value)
+{
+  if (q == NULL || input_fft == NULL || q->frame_size < q->fft_size) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (!srsran_N_id_2_isvalid(q->N_id_2)) {
+    ERROR("Error finding PSS peak, Must set N_id_2 first");
+    return SRSRAN_ERROR;
+  }
+
+  srsran_vec_prod_ccc(input_fft, q->pss_signal_freq_full[q->N_id_2], q->conv_fft.output_fft, q->conv_fft.output_len);
+  srsran_dft_run_c(&q->conv_fft.output_plan, q->conv_fft.output_fft, q->conv_output);
+
+  return pss_find_peak(q, q->conv_fft.output_len - 1, corr_peak_value);
+}
+
 /** Performs time-domain PSS correlation.
  * Returns the index of the PSS correlation peak in a subframe.
  * The frame starts at corr_peak_pos-subframe_size/2.
@@ -448,7 +543,6 @@ int srsran_pss_find_pss(srsran_pss_t* q, const cf_t* input, float* corr_peak_val
   int ret = SRSRAN_ERROR_INVALID_INPUTS;
 
   if (q != NULL && input != NULL) {
-    uint32_t corr_peak_pos;
     uint32_t conv_output_len;
 
     if (!srsran_N_id_2_isvalid(q->N_id_2)) {
@@ -464,20 +558,7 @@ int srsran_pss_find_pss(srsran_pss_t* q, const cf_t* input, float* corr_peak_val
      */
     if (q->frame_size >= q->fft_size) {
 #ifdef CONVOLUTION_FFT
-      memcpy(q->tmp_input, input, (q->frame_size * q->decimate) * sizeof(cf_t));
-      if (q->decimate > 1) {
-        srsran_filt_decim_cc_execute(&(q->filter),
-                                     q->tmp_input,
-                                     q->filter.downsampled_input,
-                                     q->filter.filter_output,
-                                     (q->frame_size * q->decimate));
-        conv_output_len = srsran_conv_fft_cc_run_opt(
-            &q->conv_fft, q->filter.filter_output, q->pss_signal_freq_full[q->N_id_2], q->conv_output);
-      } else {
-        conv_output_len =
-            srsran_conv_fft_cc_run_opt(&q->conv_fft, q->tmp_input, q->pss_signal_freq_full[q->N_id_2], q->conv_output);
-      }
-
+      return srsran_pss_find_pss_fft(q, srsran_pss_input_fft(q, input), corr_peak_value);
 #else
       conv_output_len =
           srsran_conv_cc(input, q->pss_signal_time[q->N_id_2], q->conv_output, q->frame_size, q->fft_size);
@@ -489,46 +570,7 @@ int srsran_pss_find_pss(srsran_pss_t* q, const cf_t* input, float* corr_peak_val
       conv_output_len = q->frame_size;
     }
 
-    // Compute modulus square
-    srsran_vec_abs_square_cf(q->conv_output, q->conv_output_abs, conv_output_len - 1);
-
-    // If enabled, average the absolute value from previous calls
-    if (q->ema_alpha < 1.0 && q->ema_alpha > 0.0) {
-      srsran_vec_sc_prod_fff(q->conv_output_abs, q->ema_alpha, q->conv_output_abs, conv_output_len - 1);
-      srsran_vec_sc_prod_fff(q->conv_output_avg, 1 - q->ema_alpha, q->conv_output_avg, conv_output_len - 1);
-
-      srsran_vec_sum_fff(q->conv_output_abs, q->conv_output_avg, q->conv_output_avg, conv_output_len - 1);
-    } else {
-      memcpy(q->conv_output_avg, q->conv_output_abs, sizeof(float) * (conv_output_len - 1));
-    }
-
-    /* Find maximum of the absolute value of the correlation */
-    corr_peak_pos = srsran_vec_max_fi(q->conv_output_avg, conv_output_len - 1);
-
-    // save absolute value
-    q->peak_value = q->conv_output_avg[corr_peak_pos];
-
-#ifdef SRSRAN_PSS_RETURN_PSR
-    if (corr_peak_value) {
-      *corr_peak_value = compute_peak_sidelobe(q, corr_peak_pos, conv_output_len);
-    }
-#else
-    if (corr_peak_value) {
-      *corr_peak_value = q->conv_output_avg[corr_peak_pos];
-    }
-#endif
-
-    if (q->decimate > 1) {
-      int decimation_correction = (q->filter.num_taps - 2);
-      corr_peak_pos             = corr_peak_pos - decimation_correction;
-      corr_peak_pos             = corr_peak_pos * q->decimate;
-    }
-
-    if (q->frame_size >= q->fft_size) {
-      ret = (int)corr_peak_pos;
-    } else {
-      ret = (int)corr_peak_pos + q->fft_size;
-    }
+    ret = pss_find_peak(q, conv_output_len, corr_peak_value);
   }
   return ret;
 }
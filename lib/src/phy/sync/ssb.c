@@ -48,6 +48,22 @@
  */
 #define SSB_PBCH_DMRS_DEFAULT_CORR_THR 0.5f
 
+/*
+ * Default NR-PBCH DMRS correlation margin, hypotheses below this fraction of the best correlation are not decoded
+ */
+#define SSB_PBCH_DMRS_DEFAULT_MARGIN 0.5f
+
+/*
+ * Default maximum number of NR-PBCH hypotheses decoded for a single SSB, only the best one so that windows without a
+ * cell never cost more than one decode. Callers can opt into more through the SSB arguments.
+ */
+#define SSB_PBCH_DEFAULT_MAX_DECODES 1
+
+/*
+ * Number of NR-PBCH hypotheses, half frame and up to 3 LSB of the SSB candidate index
+ */
+#define SSB_PBCH_NOF_HYPOTHESES (2 * 8)
+
 static int ssb_init_corr(srsran_ssb_t* q)
 {
   // Initialise correlation only if it is enabled
@@ -72,6 +88,14 @@ static int ssb_init_corr(srsran_ssb_t* q)
   }
   srsran_vec_cf_zero(q->sf_buffer, q->max_ssb_sz + q->max_sf_sz);
 
+  // Pre-screen never spans more than a correlation input, the power buffer holds both ends of the CP
+  q->prescreen_prod = srsran_vec_cf_malloc(q->max_corr_sz);
+  q->prescreen_pwr  = srsran_vec_f_malloc(2 * q->max_corr_sz);
+  if (q->prescreen_prod == NULL || q->prescreen_pwr == NULL) {
+    ERROR("Malloc");
+    return SRSRAN_ERROR;
+  }
+
   return SRSRAN_SUCCESS;
 }
 
@@ -107,6 +131,9 @@ int srsran_ssb_init(srsran_ssb_t* q, const srsran_ssb_args_t* args)
   // Check if the maximum sampling rate is in range, force default otherwise
   q->args.max_srate_hz  = (!isnormal(q->args.max_srate_hz)) ? SRSRAN_SSB_DEFAULT_MAX_SRATE_HZ : q->args.max_srate_hz;
   q->args.pbch_dmrs_thr = (!isnormal(q->args.pbch_dmrs_thr)) ? SSB_PBCH_DMRS_DEFAULT_CORR_THR : q->args.pbch_dmrs_thr;
+  q->args.pbch_dmrs_margin =
+      (!isnormal(q->args.pbch_dmrs_margin)) ? SSB_PBCH_DMRS_DEFAULT_MARGIN : q->args.pbch_dmrs_margin;
+  q->args.pbch_max_decodes = (q->args.pbch_max_decodes == 0) ? SSB_PBCH_DEFAULT_MAX_DECODES : q->args.pbch_max_decodes;
 
   q->scs_hz        = (float)SRSRAN_SUBC_SPACING_NR(q->args.min_scs);
   q->max_sf_sz     = (uint32_t)round(1e-3 * q->args.max_srate_hz);
@@ -165,6 +192,14 @@ void srsran_ssb_free(srsran_ssb_t* q)
     free(q->sf_buffer);
   }
 
+  if (q->prescreen_prod != NULL) {
+    free(q->prescreen_prod);
+  }
+
+  if (q->prescreen_pwr != NULL) {
+    free(q->prescreen_pwr);
+  }
+
   srsran_dft_plan_free(&q->ifft);
   srsran_dft_plan_free(&q->fft);
   srsran_dft_plan_free(&q->fft_corr);
@@ -850,18 +885,73 @@ static void ssb_vec_prod_conj_circ_shift(const cf_t* a, const cf_t* b, cf_t* c,
   srsran_vec_prod_conj_ccc(a, b, c, n);
 }
 
+// Screens the PSS candidates of a correlation window with the normalised CP autocorrelation at one symbol lag. It
+// returns true if any CP starting in the window reaches the threshold, or if the window cannot be screened
+static bool ssb_pss_prescreen(srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples, uint32_t t_offset)
+{
+  uint32_t N  = q->symbol_sz;
+  uint32_t cp = q->cp_sz;
+  if (cp == 0 || nof_samples < N + cp) {
+    return true;
+  }
+
+  // The correlation peak marks the end of the PSS CP, so the CP starts up to one CP before the window
+  uint32_t d0 = (t_offset > cp) ? t_offset - cp : 0;
+  uint32_t d1 = SRSRAN_MIN(t_offset + q->corr_window, nof_samples - N - cp + 1);
+  if (d1 <= d0) {
+    return true;
+  }
+  uint32_t nof_pos = d1 - d0;
+  uint32_t len     = nof_pos + cp - 1;
+
+  // Products between the CP and the symbol tail, and the power of both
+  srsran_vec_prod_conj_ccc(&in[d0], &in[d0 + N], q->prescreen_prod, len);
+  srsran_vec_abs_square_cf(&in[d0], q->prescreen_pwr, len);
+  srsran_vec_abs_square_cf(&in[d0 + N], &q->prescreen_pwr[len], len);
+  srsran_vec_sum_fff(q->prescreen_pwr, &q->prescreen_pwr[len], q->prescreen_pwr, len);
+
+  // Running sums over one CP, in double precision as samples are added and removed over the whole window
+  float          thr  = q->args.pss_prescreen_thr;
+  double complex corr = 0.0;
+  double         pwr  = 0.0;
+  for (uint32_t i = 0; i < cp - 1; i++) {
+    corr += q->prescreen_prod[i];
+    pwr += q->prescreen_pwr[i];
+  }
+  for (uint32_t i = 0; i < nof_pos; i++) {
+    corr += q->prescreen_prod[i + cp - 1];
+    pwr += q->prescreen_pwr[i + cp - 1];
+
+    // Normalised correlation 2|corr|/pwr is 1 for a noiseless OFDM symbol, compared without square root
+    double corr_sq = creal(corr) * creal(corr) + cimag(corr) * cimag(corr);
+    if (pwr > 0.0 && 4.0 * corr_sq >= thr * thr * pwr * pwr) {
+      return true;
+    }
+
+    corr -= q->prescreen_prod[i];
+    pwr -= q->prescreen_pwr[i];
+  }
+
+  return false;
+}
+
 static int ssb_pss_search(srsran_ssb_t* q,
                           const cf_t*   in,
                           uint32_t      nof_samples,
                           uint32_t*     found_N_id_2,
                           uint32_t*     found_delay,
-                          float*        coarse_cfo_hz)
+                          float*        coarse_cfo_hz,
+                          bool*         found)
 {
   // verify it is initialised
   if (q->corr_sz == 0) {
     return SRSRAN_ERROR;
   }
 
+  // Without pre-screen every window is correlated
+  bool prescreen = isnormal(q->args.pss_prescreen_thr);
+  *found         = !prescreen;
+
   // Calculate correlation CFO coarse precision
   double coarse_cfo_ref_hz = (q->cfg.srate_hz / q->corr_sz);
 
@@ -880,6 +970,17 @@ static int ssb_pss_search(srsran_ssb_t* q,
   // Delay in correlation window
   uint32_t t_offset = 0;
   while ((t_offset + q->symbol_sz) < nof_samples) {
+    // Skip the correlation if the pre-screen finds no OFDM symbol in the window
+    if (prescreen) {
+      q->prescreen_metrics.nof_windows++;
+      if (!ssb_pss_prescreen(q, in, nof_samples, t_offset)) {
+        t_offset += q->corr_window;
+        continue;
+      }
+      q->prescreen_metrics.nof_hits++;
+      *found = true;
+    }
+
     // Number of samples taken in this iteration
     uint32_t n = q->corr_sz;
 
@@ -936,6 +1037,11 @@ static int ssb_pss_search(srsran_ssb_t* q,
     t_offset += q->corr_window;
   }
 
+  // Nothing to refine if every window was rejected
+  if (!*found) {
+    return SRSRAN_SUCCESS;
+  }
+
   // From the best sequence correlate in frequency domain
   {
     // Reset best correlation
@@ -1010,11 +1116,17 @@ int srsran_ssb_csi_search(srsran_ssb_t*                  q,
   uint32_t N_id_2        = 0;
   uint32_t t_offset      = 0;
   float    coarse_cfo_hz = 0.0f;
-  if (ssb_pss_search(q, in, nof_samples, &N_id_2, &t_offset, &coarse_cfo_hz) < SRSRAN_SUCCESS) {
+  bool     pss_found     = false;
+  if (ssb_pss_search(q, in, nof_samples, &N_id_2, &t_offset, &coarse_cfo_hz, &pss_found) < SRSRAN_SUCCESS) {
     ERROR("Error searching for N_id_2");
     return SRSRAN_ERROR;
   }
 
+  // The pre-screen rejected every window, there is nothing to demodulate
+  if (!pss_found) {
+    return SRSRAN_SUCCESS;
+  }
+
   // Remove CP offset prior demodulation
   if (t_offset >= q->cp_sz) {
     t_offset -= q->cp_sz;
@@ -1096,12 +1208,70 @@ int srsran_ssb_csi_measure(srsran_ssb_t*                  q,
   return SRSRAN_SUCCESS;
 }
 
-static int ssb_select_pbch(srsran_ssb_t*            q,
-                           uint32_t                 N_id,
-                           const cf_t               ssb_grid[SRSRAN_SSB_NOF_RE],
-                           uint32_t*                found_n_hf,
-                           uint32_t*                found_ssb_idx_4lsb,
-                           srsran_dmrs_pbch_meas_t* pbch_meas)
+int srsran_ssb_csi_measure_offset(srsran_ssb_t*                  q,
+                                  const uint32_t*                N_id,
+                                  uint32_t                       nof_N_id,
+                                  const cf_t*                    in,
+                                  uint32_t                       nof_samples,
+                                  uint32_t                       t_offset,
+                                  srsran_csi_trs_measurements_t* meas)
+{
+  // Verify inputs
+  if (q == NULL || N_id == NULL || in == NULL || meas == NULL || !isnormal(q->scs_hz)) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  for (uint32_t i = 0; i < nof_N_id; i++) {
+    if (N_id[i] >= SRSRAN_NOF_NID_NR) {
+      return SRSRAN_ERROR_INVALID_INPUTS;
+    }
+  }
+
+  if (!q->args.enable_measure) {
+    ERROR("SSB is not configured to measure");
+    return SRSRAN_ERROR;
+  }
+
+  // Make sure the SSB is within the input buffer
+  if (t_offset + q->ssb_sz > nof_samples) {
+    ERROR("SSB at %d exceeds the buffer (%d/%d)", t_offset, t_offset + q->ssb_sz, nof_samples);
+    return SRSRAN_ERROR;
+  }
+
+  // Demodulate
+  cf_t ssb_grid[SRSRAN_SSB_NOF_RE] = {};
+  if (ssb_demodulate(q, in, t_offset, 0.0f, ssb_grid) < SRSRAN_SUCCESS) {
+    ERROR("Error demodulating");
+    return SRSRAN_ERROR;
+  }
+
+  // Actual measurement of every cell from the same grid
+  for (uint32_t i = 0; i < nof_N_id; i++) {
+    if (ssb_measure(q, ssb_grid, N_id[i], &meas[i])) {
+      ERROR("Error measuring");
+      return SRSRAN_ERROR;
+    }
+
+    // Add delay to measure
+    meas[i].delay_us += (float)(1e6 * t_offset / q->cfg.srate_hz);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+// NR-PBCH hypothesis, the parameters guessed from the DMRS and the resulting measurement
+typedef struct {
+  uint32_t                n_hf;
+  uint32_t                ssb_idx;
+  srsran_dmrs_pbch_meas_t meas;
+} ssb_pbch_hypothesis_t;
+
+// Measures the DMRS of every PBCH hypothesis and sorts them by descending correlation
+static int ssb_rank_pbch(srsran_ssb_t*         q,
+                         uint32_t              N_id,
+                         const cf_t            ssb_grid[SRSRAN_SSB_NOF_RE],
+                         ssb_pbch_hypothesis_t hypotheses[SSB_PBCH_NOF_HYPOTHESES],
+                         uint32_t*             nof_hypotheses)
 {
   // Prepare PBCH DMRS configuration
   srsran_dmrs_pbch_cfg_t pbch_dmrs_cfg = {};
@@ -1112,12 +1282,8 @@ static int ssb_select_pbch(srsran_ssb_t*            q,
   pbch_dmrs_cfg.beta                   = 0.0f;
   pbch_dmrs_cfg.scs                    = q->cfg.scs;
 
-  // Initialise best values
-  srsran_dmrs_pbch_meas_t best_meas    = {};
-  uint32_t                best_n_hf    = 0;
-  uint32_t                best_ssb_idx = 0;
-
-  // Iterate over all the parameters to guess and select the most suitable
+  // Iterate over all the parameters to guess, inserting each one in order
+  uint32_t count = 0;
   for (uint32_t n_hf = 0; n_hf < 2; n_hf++) {
     for (uint32_t ssb_idx = 0; ssb_idx < SRSRAN_MIN(8, q->Lmax); ssb_idx++) {
       // Set parameters
@@ -1131,19 +1297,20 @@ static int ssb_select_pbch(srsran_ssb_t*            q,
         return SRSRAN_ERROR;
       }
 
-      // Select the result with highest correlation (most suitable)
-      if (meas.corr > best_meas.corr) {
-        best_meas    = meas;
-        best_n_hf    = n_hf;
-        best_ssb_idx = ssb_idx;
+      // Ties keep the measuring order, so the first hypothesis is the one with highest correlation as before
+      uint32_t pos = count;
+      while (pos > 0 && hypotheses[pos - 1].meas.corr < meas.corr) {
+        hypotheses[pos] = hypotheses[pos - 1];
+        pos--;
       }
+      hypotheses[pos].n_hf    = n_hf;
+      hypotheses[pos].ssb_idx = ssb_idx;
+      hypotheses[pos].meas    = meas;
+      count++;
     }
   }
 
-  // Save findings
-  *found_n_hf         = best_n_hf;
-  *found_ssb_idx_4lsb = best_ssb_idx;
-  *pbch_meas          = best_meas;
+  *nof_hypotheses = count;
 
   return SRSRAN_SUCCESS;
 }
@@ -1188,6 +1355,50 @@ static int ssb_decode_pbch(srsran_ssb_t*         q,
   return SRSRAN_SUCCESS;
 }
 
+// Decodes the ranked hypotheses best-first and stops at the first CRC match. Hypotheses below the DMRS threshold or
+// too far from the best correlation are not decoded. The selected hypothesis is the decoded one, or the best if none
+// matches, in which case the message is left cleared with the CRC unmatched
+static int ssb_decode_pbch_ranked(srsran_ssb_t*                q,
+                                  uint32_t                     N_id,
+                                  const cf_t                   ssb_grid[SRSRAN_SSB_NOF_RE],
+                                  const ssb_pbch_hypothesis_t* hypotheses,
+                                  uint32_t                     nof_hypotheses,
+                                  uint32_t*                    selected,
+                                  srsran_pbch_msg_nr_t*        msg)
+{
+  *selected = 0;
+
+  // Set the PBCH message default value (CRC unmatched), kept if no hypothesis is decoded successfully
+  SRSRAN_MEM_ZERO(msg, srsran_pbch_msg_nr_t, 1);
+
+  if (nof_hypotheses == 0) {
+    return SRSRAN_SUCCESS;
+  }
+
+  float min_corr = SRSRAN_MAX(q->args.pbch_dmrs_thr, hypotheses[0].meas.corr * q->args.pbch_dmrs_margin);
+  for (uint32_t i = 0; i < SRSRAN_MIN(nof_hypotheses, q->args.pbch_max_decodes); i++) {
+    // Hypotheses are sorted, none of the remaining ones can reach the minimum
+    if (hypotheses[i].meas.corr < min_corr) {
+      break;
+    }
+
+    if (ssb_decode_pbch(q, N_id, hypotheses[i].n_hf, hypotheses[i].ssb_idx, ssb_grid, msg) < SRSRAN_SUCCESS) {
+      ERROR("Error decoding PBCH");
+      return SRSRAN_ERROR;
+    }
+
+    if (msg->crc) {
+      *selected = i;
+      return SRSRAN_SUCCESS;
+    }
+  }
+
+  // None of the decoded hypotheses matched the CRC, do not leak the payload of the last attempt
+  SRSRAN_MEM_ZERO(msg, srsran_pbch_msg_nr_t, 1);
+
+  return SRSRAN_SUCCESS;
+}
+
 int srsran_ssb_decode_grid(srsran_ssb_t*         q,
                            uint32_t              N_id,
                            uint32_t              n_hf,
@@ -1288,11 +1499,17 @@ int srsran_ssb_search(srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples, srs
   uint32_t N_id_2        = 0;
   uint32_t t_offset      = 0;
   float    coarse_cfo_hz = 0.0f;
-  if (ssb_pss_search(q, in, nof_samples, &N_id_2, &t_offset, &coarse_cfo_hz) < SRSRAN_SUCCESS) {
+  bool     pss_found     = false;
+  if (ssb_pss_search(q, in, nof_samples, &N_id_2, &t_offset, &coarse_cfo_hz, &pss_found) < SRSRAN_SUCCESS) {
     ERROR("Error searching for N_id_2");
     return SRSRAN_ERROR;
   }
 
+  // The pre-screen rejected every window, there is nothing to demodulate
+  if (!pss_found) {
+    return SRSRAN_SUCCESS;
+  }
+
   // Remove CP offset prior demodulation
   if (t_offset >= q->cp_sz) {
     t_offset -= q->cp_sz;
@@ -1323,23 +1540,18 @@ int srsran_ssb_search(srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples, srs
   // Select N_id
   uint32_t N_id = SRSRAN_NID_NR(N_id_1, N_id_2);
 
-  // Select the most suitable SSB candidate
-  uint32_t                n_hf      = 0;
-  uint32_t                ssb_idx   = 0;
-  srsran_dmrs_pbch_meas_t pbch_meas = {};
-  if (ssb_select_pbch(q, N_id, ssb_grid, &n_hf, &ssb_idx, &pbch_meas) < SRSRAN_SUCCESS) {
+  // Rank the SSB candidates by PBCH DMRS correlation
+  ssb_pbch_hypothesis_t hypotheses[SSB_PBCH_NOF_HYPOTHESES];
+  uint32_t              nof_hypotheses = 0;
+  if (ssb_rank_pbch(q, N_id, ssb_grid, hypotheses, &nof_hypotheses) < SRSRAN_SUCCESS) {
     ERROR("Error selecting PBCH");
     return SRSRAN_ERROR;
   }
 
-  // Avoid decoding if the selected PBCH DMRS do not reach the minimum threshold
-  if (pbch_meas.corr < q->args.pbch_dmrs_thr) {
-    return SRSRAN_SUCCESS;
-  }
-
-  // Decode PBCH
+  // Decode PBCH, starting from the most suitable SSB candidate
+  uint32_t             selected = 0;
   srsran_pbch_msg_nr_t pbch_msg = {};
-  if (ssb_decode_pbch(q, N_id, n_hf, ssb_idx, ssb_grid, &pbch_msg) < SRSRAN_SUCCESS) {
+  if (ssb_decode_pbch_ranked(q, N_id, ssb_grid, hypotheses, nof_hypotheses, &selected, &pbch_msg) < SRSRAN_SUCCESS) {
     ERROR("Error decoding PBCH");
     return SRSRAN_ERROR;
   }
@@ -1492,29 +1704,29 @@ int srsran_ssb_find(srsran_ssb_t*                  q,
     return SRSRAN_ERROR;
   }
 
-  // Select the most suitable SSB candidate
-  uint32_t                n_hf      = 0;
-  uint32_t                ssb_idx   = 0; // SSB candidate index
-  srsran_dmrs_pbch_meas_t pbch_meas = {};
-  if (ssb_select_pbch(q, N_id, ssb_grid, &n_hf, &ssb_idx, &pbch_meas) < SRSRAN_SUCCESS) {
+  // Rank the SSB candidates by PBCH DMRS correlation
+  ssb_pbch_hypothesis_t hypotheses[SSB_PBCH_NOF_HYPOTHESES];
+  uint32_t              nof_hypotheses = 0;
+  if (ssb_rank_pbch(q, N_id, ssb_grid, hypotheses, &nof_hypotheses) < SRSRAN_SUCCESS) {
     ERROR("Error selecting PBCH");
     return SRSRAN_ERROR;
   }
 
-  // Avoid decoding if the selected PBCH DMRS do not reach the minimum threshold
-  if (pbch_meas.corr < q->args.pbch_dmrs_thr) {
+  // Avoid decoding if the most suitable PBCH DMRS do not reach the minimum threshold
+  if (nof_hypotheses == 0 || hypotheses[0].meas.corr < q->args.pbch_dmrs_thr) {
     return SRSRAN_SUCCESS;
   }
 
-  // Calculate the SSB offset in the subframe
-  uint32_t ssb_offset = srsran_ssb_candidate_sf_offset(q, ssb_idx);
-
-  // Compute PBCH channel estimates
-  if (ssb_decode_pbch(q, N_id, n_hf, ssb_idx, ssb_grid, pbch_msg) < SRSRAN_SUCCESS) {
+  // Decode PBCH, starting from the most suitable SSB candidate
+  uint32_t selected = 0;
+  if (ssb_decode_pbch_ranked(q, N_id, ssb_grid, hypotheses, nof_hypotheses, &selected, pbch_msg) < SRSRAN_SUCCESS) {
     ERROR("Error decoding PBCH");
     return SRSRAN_ERROR;
   }
 
+  // Calculate the SSB offset in the subframe
+  uint32_t ssb_offset = srsran_ssb_candidate_sf_offset(q, hypotheses[selected].ssb_idx);
+
   // SSB delay in SF
   float ssb_delay_us = (float)(1e6 * (((double)t_offset - (double)q->ssb_sz - (double)ssb_offset) / q->cfg.srate_hz));
 
@@ -1567,6 +1779,16 @@ int srsran_ssb_track(srsran_ssb_t*                  q,
   return SRSRAN_SUCCESS;
 }
 
+void srsran_ssb_get_prescreen_metrics(srsran_ssb_t* q, srsran_ssb_prescreen_metrics_t* metrics)
+{
+  if (q == NULL || metrics == NULL) {
+    return;
+  }
+
+  *metrics = q->prescreen_metrics;
+  SRSRAN_MEM_ZERO(&q->prescreen_metrics, srsran_ssb_prescreen_metrics_t, 1);
+}
+
 uint32_t srsran_ssb_candidate_sf_idx(const srsran_ssb_t* q, uint32_t ssb_idx, bool half_frame)
 {
   if (q == NULL) {
@@ -595,9 +595,18 @@ static int cfo_i_estimate(srsran_sync_t* q, const cf_t* input, int find_offset,
   float         max_peak_value = -99;
   int           max_cfo_i      = 0;
   srsran_pss_t* pss_obj[3]     = {&q->pss_i[0], &q->pss, &q->pss_i[1]};
+
+  // The hypotheses correlate the same block, transform it only once if all of them use the same sizes
+  const cf_t* input_fft = NULL;
+  if (q->pss.decimate == q->pss_i[0].decimate && q->pss.frame_size == q->pss_i[0].frame_size &&
+      q->pss.fft_size == q->pss_i[0].fft_size) {
+    input_fft = srsran_pss_input_fft(&q->pss, &input[find_offset]);
+  }
+
   for (int cfo = 0; cfo < 3; cfo++) {
     srsran_pss_set_N_id_2(pss_obj[cfo], q->N_id_2);
-    int p = srsran_pss_find_pss(pss_obj[cfo], &input[find_offset], &peak_value);
+    int p = input_fft != NULL ? srsran_pss_find_pss_fft(pss_obj[cfo], input_fft, &peak_value)
+                              : srsran_pss_find_pss(pss_obj[cfo], &input[find_offset], &peak_value);
     if (p < 0) {
       return -1;
     }
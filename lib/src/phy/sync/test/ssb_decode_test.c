@@ -26,6 +26,7 @@
 #include "srsran/phy/utils/vector.h"
 #include <complex.h>
 #include <getopt.h>
+#include <inttypes.h>
 #include <srsran/phy/utils/random.h>
 #include <stdlib.h>
 
@@ -46,6 +47,9 @@ static int32_t delay_n       = 1;
 static float   cfo_hz        = 1000.0f;
 static float   n0_dB         = -10.0f;
 
+// SSB parameters
+static float prescreen_thr = 0.0f; // PSS search pre-screen threshold, disabled by default
+
 // Test context
 static srsran_random_t       random_gen = NULL;
 static srsran_channel_awgn_t awgn       = {};
@@ -61,13 +65,14 @@ static void usage(char* prog)
   printf("\t-S cell/carrier subcarrier spacing [default, %s kHz]\n", srsran_subcarrier_spacing_to_str(carrier_scs));
   printf("\t-F cell/carrier center frequency in Hz [default, %.3f MHz]\n", carrier_freq_hz / 1e6);
   printf("\t-P SSB pattern [default, %s]\n", srsran_ssb_pattern_to_str(ssb_pattern));
+  printf("\t-T PSS search pre-screen threshold [default, %.1f]\n", prescreen_thr);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 static void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "SsFfPv")) != -1) {
+  while ((opt = getopt(argc, argv, "SsFfPTv")) != -1) {
     switch (opt) {
       case 's':
         ssb_scs = srsran_subcarrier_spacing_from_str(argv[optind]);
@@ -92,6 +97,9 @@ static void parse_args(int argc, char** argv)
       case 'P':
         ssb_pattern = srsran_ssb_pattern_fom_str(argv[optind]);
         break;
+      case 'T':
+        prescreen_thr = strtof(argv[optind], NULL);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -221,6 +229,16 @@ static int test_case_true(srsran_ssb_t* ssb)
        (double)t_decode_usec / (double)(count),
        (double)t_search_usec / (double)(count));
 
+  // Every search must have correlated at least the window with the SSB
+  srsran_ssb_prescreen_metrics_t prescreen_metrics = {};
+  srsran_ssb_get_prescreen_metrics(ssb, &prescreen_metrics);
+  INFO("test_case_true - pre-screen %" PRIu64 "/%" PRIu64 " windows",
+       prescreen_metrics.nof_hits,
+       prescreen_metrics.nof_windows);
+  if (isnormal(prescreen_thr)) {
+    TESTASSERT(prescreen_metrics.nof_hits >= count);
+  }
+
   return SRSRAN_SUCCESS;
 }
 
@@ -292,6 +310,78 @@ static int test_case_false(srsran_ssb_t* ssb)
        (double)t_decode_usec / (double)(count),
        (double)t_search_usec / (double)(count));
 
+  // Noise alone must be rejected by the pre-screen in some windows, otherwise it is not saving any correlation
+  srsran_ssb_prescreen_metrics_t prescreen_metrics = {};
+  srsran_ssb_get_prescreen_metrics(ssb, &prescreen_metrics);
+  INFO("test_case_false - pre-screen %" PRIu64 "/%" PRIu64 " windows",
+       prescreen_metrics.nof_hits,
+       prescreen_metrics.nof_windows);
+  if (isnormal(prescreen_thr)) {
+    TESTASSERT(prescreen_metrics.nof_hits < prescreen_metrics.nof_windows);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static int test_case_max_decodes()
+{
+  // Decode only the best hypothesis, with a threshold low enough to attempt decoding noise
+  srsran_ssb_t      ssb      = {};
+  srsran_ssb_args_t ssb_args = {};
+  ssb_args.enable_encode     = true;
+  ssb_args.enable_decode     = true;
+  ssb_args.enable_search     = true;
+  ssb_args.pbch_dmrs_thr     = 1e-3f;
+  ssb_args.pbch_max_decodes  = 1;
+  TESTASSERT(srsran_ssb_init(&ssb, &ssb_args) == SRSRAN_SUCCESS);
+
+  // SSB configuration
+  srsran_ssb_cfg_t ssb_cfg = {};
+  ssb_cfg.srate_hz         = srate_hz;
+  ssb_cfg.center_freq_hz   = carrier_freq_hz;
+  ssb_cfg.ssb_freq_hz      = ssb_freq_hz;
+  ssb_cfg.scs              = ssb_scs;
+  ssb_cfg.pattern          = ssb_pattern;
+  TESTASSERT(srsran_ssb_set_cfg(&ssb, &ssb_cfg) == SRSRAN_SUCCESS);
+
+  uint32_t                   sf_len     = (uint32_t)round(srate_hz / 1000.0);
+  const srsran_pbch_msg_nr_t pbch_msg_0 = {};
+
+  for (uint32_t pci = 0; pci < SRSRAN_NOF_NID_NR; pci += SSB_DECODE_TEST_PCI_STRIDE) {
+    // Build PBCH message and add the first SSB in the half-frame
+    srsran_pbch_msg_nr_t pbch_msg_tx = {};
+    gen_pbch_msg(&pbch_msg_tx, 0);
+    srsran_vec_cf_zero(buffer, hf_len);
+    TESTASSERT(srsran_ssb_add(&ssb, pci, &pbch_msg_tx, buffer, buffer) == SRSRAN_SUCCESS);
+    run_channel();
+
+    // The best hypothesis must decode the transmitted message
+    uint32_t nof_found = 0;
+    for (uint32_t sf = 0; sf < hf_len / sf_len; sf++) {
+      srsran_csi_trs_measurements_t meas        = {};
+      srsran_pbch_msg_nr_t          pbch_msg_rx = {};
+      TESTASSERT(srsran_ssb_find(&ssb, &buffer[sf * sf_len], pci, &meas, &pbch_msg_rx) == SRSRAN_SUCCESS);
+      if (pbch_msg_rx.crc) {
+        TESTASSERT(memcmp(&pbch_msg_rx, &pbch_msg_tx, sizeof(srsran_pbch_msg_nr_t)) == 0);
+        nof_found++;
+      }
+    }
+    INFO("test_case_max_decodes - found pci=%d %d times", pci, nof_found);
+    TESTASSERT(nof_found > 0);
+
+    // Noise alone is decoded and fails, the message must be left cleared
+    srsran_vec_cf_zero(buffer, hf_len);
+    srsran_channel_awgn_run_c(&awgn, buffer, buffer, hf_len);
+    for (uint32_t sf = 0; sf < hf_len / sf_len; sf++) {
+      srsran_csi_trs_measurements_t meas        = {};
+      srsran_pbch_msg_nr_t          pbch_msg_rx = {};
+      TESTASSERT(srsran_ssb_find(&ssb, &buffer[sf * sf_len], pci, &meas, &pbch_msg_rx) == SRSRAN_SUCCESS);
+      TESTASSERT(memcmp(&pbch_msg_rx, &pbch_msg_0, sizeof(srsran_pbch_msg_nr_t)) == 0);
+    }
+  }
+
+  srsran_ssb_free(&ssb);
+
   return SRSRAN_SUCCESS;
 }
 
@@ -310,6 +400,7 @@ int main(int argc, char** argv)
   ssb_args.enable_encode     = true;
   ssb_args.enable_decode     = true;
   ssb_args.enable_search     = true;
+  ssb_args.pss_prescreen_thr = prescreen_thr;
 
   if (buffer == NULL) {
     ERROR("Malloc");
@@ -341,6 +432,11 @@ int main(int argc, char** argv)
     goto clean_exit;
   }
 
+  if (test_case_max_decodes() != SRSRAN_SUCCESS) {
+    ERROR("test case failed");
+    goto clean_exit;
+  }
+
   ret = SRSRAN_SUCCESS;
 
 clean_exit:
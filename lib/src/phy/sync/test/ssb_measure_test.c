@@ -195,6 +195,18 @@ static int test_case_1(srsran_ssb_t* ssb)
 
     // Assert measurements
     TESTASSERT(assert_measure(&meas) == SRSRAN_SUCCESS);
+
+    // Measure the transmitted and another PCI at the position found by the search
+    uint32_t t_offset = (uint32_t)SRSRAN_MAX(roundf(meas_search.delay_us * 1e-6f * srate_hz), 0);
+
+    uint32_t                      pci_offset[2]  = {pci, (pci + 1) % SRSRAN_NOF_NID_NR};
+    srsran_csi_trs_measurements_t meas_offset[2] = {};
+    TESTASSERT(srsran_ssb_csi_measure_offset(ssb, pci_offset, 2, buffer, sf_len, t_offset, meas_offset) ==
+               SRSRAN_SUCCESS);
+    TESTASSERT(fabsf(meas_offset[0].rsrp_dB - meas.rsrp_dB) < RSRP_MAX_ERROR);
+    TESTASSERT(fabsf(meas_offset[0].snr_dB + n0_dB) < SNR_MAX_ERROR);
+    TESTASSERT(fabsf(meas_offset[0].delay_us - meas_search.delay_us) < 1e6f / srate_hz);
+    TESTASSERT(meas_offset[1].snr_dB < meas_offset[0].snr_dB - SNR_MAX_ERROR);
   }
 
   INFO("test_case_1 - %.1f usec/encode; %.1f usec/search; Max srate %.1f MSps; %.1f usec/measurement",
@@ -34,23 +34,25 @@
 int         cell_id = -1, offset = 0;
 srsran_cp_t cp      = SRSRAN_CP_NORM;
 uint32_t    nof_prb = 6;
+bool        cfo_i   = false;
 
 #define FLEN SRSRAN_SF_LEN(fft_size)
 
 void usage(char* prog)
 {
-  printf("Usage: %s [cpoev]\n", prog);
+  printf("Usage: %s [cpoeiv]\n", prog);
   printf("\t-c cell_id [Default check for all]\n");
   printf("\t-p nof_prb [Default %d]\n", nof_prb);
   printf("\t-o offset [Default %d]\n", offset);
   printf("\t-e extended CP [Default normal]\n");
+  printf("\t-i enable integer CFO estimation [Default disabled]\n");
   printf("\t-v srsran_verbose\n");
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "cpoev")) != -1) {
+  while ((opt = getopt(argc, argv, "cpoeiv")) != -1) {
     switch (opt) {
       case 'c':
         cell_id = (int)strtol(argv[optind], NULL, 10);
@@ -64,6 +66,9 @@ void parse_args(int argc, char** argv)
       case 'e':
         cp = SRSRAN_CP_EXT;
         break;
+      case 'i':
+        cfo_i = true;
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -122,6 +127,7 @@ int main(int argc, char** argv)
   /* Set a very high threshold to make sure the correlation is ok */
   srsran_sync_set_threshold(&syncobj, 5.0);
   srsran_sync_set_sss_algorithm(&syncobj, SSS_PARTIAL_3);
+  srsran_sync_set_cfo_i_enable(&syncobj, cfo_i);
 
   if (cell_id == -1) {
     cid     = 0;
@@ -169,6 +175,10 @@ int main(int argc, char** argv)
         printf("ns != find_ns\n");
         exit(-1);
       }
+      if (cfo_i && srsran_sync_get_cur_pss_obj(&syncobj) != &syncobj.pss) {
+        printf("Integer CFO should be 0\n");
+        exit(-1);
+      }
       if (srsran_sync_get_cp(&syncobj) != cp) {
         printf("Detected CP should be %s\n", SRSRAN_CP_ISNORM(cp) ? "Normal" : "Extended");
         exit(-1);
@@ -0,0 +1,255 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/phy/ch_estimation/dmrs_pucch.h"
+#include "srsran/phy/ue/ue_ul_nr.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static srsran_carrier_nr_t carrier   = SRSRAN_DEFAULT_CARRIER_NR;
+static uint32_t            nof_prb   = 25;
+static uint32_t            nof_slots = 25;
+
+// Uncached format 1 path, DMRS and PUCCH in the resource grid and one IFFT per slot
+static srsran_pucch_nr_t ref_pucch = {};
+static srsran_ofdm_t     ref_ifft  = {};
+static cf_t*             ref_grid  = NULL;
+static cf_t*             ref_out   = NULL;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [Psv]\n", prog);
+  printf("\t-P Number of PRB [Default %d]\n", nof_prb);
+  printf("\t-s Number of slots [Default %d]\n", nof_slots);
+  printf("\t-v [set srsran_verbose to debug, default none]\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "Psv")) != -1) {
+    switch (opt) {
+      case 'P':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        nof_slots = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static int ref_set_carrier(const srsran_carrier_nr_t* c)
+{
+  TESTASSERT(srsran_pucch_nr_set_carrier(&ref_pucch, c) == SRSRAN_SUCCESS);
+
+  srsran_ofdm_cfg_t fft_cfg     = {};
+  fft_cfg.nof_prb               = c->nof_prb;
+  fft_cfg.symbol_sz             = srsran_min_symbol_sz_rb(c->nof_prb);
+  fft_cfg.keep_dc               = true;
+  fft_cfg.phase_compensation_hz = c->ul_center_frequency_hz;
+  fft_cfg.in_buffer             = ref_grid;
+  fft_cfg.out_buffer            = ref_out;
+  TESTASSERT(srsran_ofdm_tx_init_cfg(&ref_ifft, &fft_cfg) == SRSRAN_SUCCESS);
+
+  return SRSRAN_SUCCESS;
+}
+
+static int ref_encode(const srsran_slot_cfg_t*            slot,
+                      const srsran_pucch_nr_common_cfg_t* cfg,
+                      const srsran_pucch_nr_resource_t*   resource,
+                      const srsran_uci_data_nr_t*         uci_data)
+{
+  // Format 1 bits, ACK if any, otherwise b(0) = 0 for a positive SR
+  uint8_t  b[SRSRAN_PUCCH_NR_FORMAT1_MAX_NOF_BITS] = {};
+  uint32_t nof_bits                                = uci_data->cfg.ack.count;
+  for (uint32_t i = 0; i < nof_bits; i++) {
+    b[i] = uci_data->value.ack[i];
+  }
+  if (nof_bits == 0) {
+    nof_bits = 1;
+  }
+
+  srsran_vec_cf_zero(ref_grid, SRSRAN_SLOT_LEN_RE_NR(carrier.nof_prb));
+  TESTASSERT(srsran_dmrs_pucch_format1_put(&ref_pucch, &carrier, cfg, slot, resource, ref_grid) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_pucch_nr_format1_encode(&ref_pucch, cfg, slot, resource, b, nof_bits, ref_grid) ==
+             SRSRAN_SUCCESS);
+  srsran_ofdm_tx_sf(&ref_ifft);
+
+  // Normalise to peak as the UE uplink does
+  uint32_t max_idx  = srsran_vec_max_abs_ci(ref_out, ref_ifft.sf_sz);
+  float    max_peak = cabsf(ref_out[max_idx]);
+  TESTASSERT(isnormal(max_peak));
+  srsran_vec_sc_prod_cfc(ref_out, 0.99f / max_peak, ref_out, ref_ifft.sf_sz);
+
+  return SRSRAN_SUCCESS;
+}
+
+static int test_pucch_format1(srsran_ue_ul_nr_t* ue_ul, const cf_t* ue_out, bool backwards)
+{
+  srsran_pucch_nr_common_cfg_t cfg = {};
+
+  // Resources sharing slots, so they compete for the cache entries. The last one only differs from the first in its
+  // orthogonal cover code
+  srsran_pucch_nr_resource_t resources[5] = {};
+  for (uint32_t i = 0; i < 4; i++) {
+    resources[i].format               = SRSRAN_PUCCH_NR_FORMAT_1;
+    resources[i].starting_prb         = (i * 7) % carrier.nof_prb;
+    resources[i].nof_symbols          = SRSRAN_PUCCH_NR_FORMAT1_MAX_NSYMB - 3 * i;
+    resources[i].start_symbol_idx     = SRSRAN_NSYMB_PER_SLOT_NR - resources[i].nof_symbols;
+    resources[i].initial_cyclic_shift = (3 * i) % (SRSRAN_PUCCH_NR_FORMAT1_MAX_CS + 1);
+    resources[i].time_domain_occ      = i % 2;
+  }
+  resources[3].intra_slot_hopping = true;
+  resources[3].second_hop_prb     = carrier.nof_prb - 1;
+  resources[4]                    = resources[0];
+  resources[4].time_domain_occ    = 1;
+
+  // One and two ACK bits, and a positive SR alone
+  srsran_uci_data_nr_t uci[7] = {};
+  for (uint32_t i = 0; i < 2; i++) {
+    uci[i].cfg.ack.count = 1;
+    uci[i].value.ack[0]  = i;
+  }
+  for (uint32_t i = 0; i < 4; i++) {
+    uci[2 + i].cfg.ack.count = 2;
+    uci[2 + i].value.ack[0]  = i & 1U;
+    uci[2 + i].value.ack[1]  = (i >> 1U) & 1U;
+  }
+  uci[6].cfg.o_sr = 1;
+  uci[6].value.sr = 1;
+
+  // Slots beyond the radio frame reuse the waveforms of their slot in the frame. Going backwards starts with the slots
+  // still in the cache
+  for (uint32_t i = 0; i < nof_slots; i++) {
+    srsran_slot_cfg_t slot = {.idx = backwards ? nof_slots - 1 - i : i};
+    for (uint32_t r = 0; r < 5; r++) {
+      for (uint32_t u = 0; u < 7; u++) {
+        TESTASSERT(srsran_ue_ul_nr_encode_pucch(ue_ul, &slot, &cfg, &resources[r], &uci[u]) == SRSRAN_SUCCESS);
+        TESTASSERT(ref_encode(&slot, &cfg, &resources[r], &uci[u]) == SRSRAN_SUCCESS);
+
+        for (uint32_t j = 0; j < ref_ifft.sf_sz; j++) {
+          if (cabsf(ue_out[j] - ref_out[j]) > 1e-3f) {
+            ERROR("Slot %d, resource %d, UCI %d differs at sample %d: %+.4f%+.4fi != %+.4f%+.4fi",
+                  slot.idx,
+                  r,
+                  u,
+                  j,
+                  crealf(ue_out[j]),
+                  cimagf(ue_out[j]),
+                  crealf(ref_out[j]),
+                  cimagf(ref_out[j]));
+            return SRSRAN_ERROR;
+          }
+        }
+      }
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  int                    ret      = SRSRAN_ERROR;
+  srsran_ue_ul_nr_t      ue_ul    = {};
+  srsran_ue_ul_nr_args_t args     = {};
+  srsran_pucch_nr_args_t ref_args = {};
+  cf_t*                  ue_out   = NULL;
+
+  parse_args(argc, argv);
+  carrier.nof_prb = nof_prb;
+
+  ue_out   = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB_NR(nof_prb));
+  ref_grid = srsran_vec_cf_malloc(SRSRAN_SLOT_LEN_RE_NR(nof_prb));
+  ref_out  = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB_NR(nof_prb));
+  if (ue_out == NULL || ref_grid == NULL || ref_out == NULL) {
+    ERROR("Malloc");
+    goto clean_exit;
+  }
+
+  args.nof_max_prb       = nof_prb;
+  args.pusch.max_prb     = nof_prb;
+  args.pusch.max_layers  = 1;
+  args.pucch.max_nof_prb = nof_prb;
+  ref_args.max_nof_prb   = nof_prb;
+  if (srsran_ue_ul_nr_init(&ue_ul, ue_out, &args) < SRSRAN_SUCCESS ||
+      srsran_pucch_nr_init(&ref_pucch, &ref_args) < SRSRAN_SUCCESS) {
+    ERROR("Init");
+    goto clean_exit;
+  }
+
+  if (srsran_ue_ul_nr_set_carrier(&ue_ul, &carrier) < SRSRAN_SUCCESS || ref_set_carrier(&carrier) < SRSRAN_SUCCESS) {
+    ERROR("Setting carrier");
+    goto clean_exit;
+  }
+  if (test_pucch_format1(&ue_ul, ue_out, false) < SRSRAN_SUCCESS) {
+    ERROR("Failed PUCCH format 1");
+    goto clean_exit;
+  }
+
+  // Another cell and centre frequency change the sequences and the phase compensation, cached waveforms are stale
+  carrier.pci                    = 1;
+  carrier.ul_center_frequency_hz = carrier.ul_center_frequency_hz + 15e6;
+  if (srsran_ue_ul_nr_set_carrier(&ue_ul, &carrier) < SRSRAN_SUCCESS || ref_set_carrier(&carrier) < SRSRAN_SUCCESS) {
+    ERROR("Setting carrier");
+    goto clean_exit;
+  }
+  if (test_pucch_format1(&ue_ul, ue_out, true) < SRSRAN_SUCCESS) {
+    ERROR("Failed PUCCH format 1 after carrier change");
+    goto clean_exit;
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_ue_ul_nr_free(&ue_ul);
+  srsran_pucch_nr_free(&ref_pucch);
+  srsran_ofdm_tx_free(&ref_ifft);
+  if (ue_out) {
+    free(ue_out);
+  }
+  if (ref_grid) {
+    free(ref_grid);
+  }
+  if (ref_out) {
+    free(ref_out);
+  }
+
+  if (ret == SRSRAN_SUCCESS) {
+    printf("Test passed!\n");
+  } else {
+    printf("Test failed!\n");
+  }
+
+  return ret;
+}
@@ -77,6 +77,11 @@ int srsran_ue_ul_nr_set_carrier(srsran_ue_ul_nr_t* q, const srsran_carrier_nr_t*
 
   q->carrier = *carrier;
 
+  // Cached waveforms depend on the carrier and the OFDM modulator
+  for (uint32_t i = 0; i < SRSRAN_UE_UL_NR_PUCCH_WAVEFORM_NOF_ENTRIES; i++) {
+    q->pucch_waveforms[i].valid = false;
+  }
+
   srsran_ofdm_cfg_t fft_cfg     = {};
   fft_cfg.nof_prb               = carrier->nof_prb;
   fft_cfg.symbol_sz             = srsran_min_symbol_sz_rb(carrier->nof_prb);
@@ -114,6 +119,22 @@ void srsran_ue_ul_nr_set_freq_offset(srsran_ue_ul_nr_t* q, float freq_offset_hz)
   q->freq_offset_hz = -freq_offset_hz;
 }
 
+static void ue_ul_nr_normalise(srsran_ue_ul_nr_t* q)
+{
+  // Normalise to peak
+  uint32_t max_idx  = srsran_vec_max_abs_ci(q->ifft.cfg.out_buffer, q->ifft.sf_sz);
+  float    max_peak = cabsf(q->ifft.cfg.out_buffer[max_idx]);
+  if (isnormal(max_peak)) {
+    srsran_vec_sc_prod_cfc(q->ifft.cfg.out_buffer, 0.99f / max_peak, q->ifft.cfg.out_buffer, q->ifft.sf_sz);
+  }
+
+  // Apply frequency offset
+  if (isnormal(q->freq_offset_hz)) {
+    srsran_vec_apply_cfo(
+        q->ifft.cfg.out_buffer, -q->freq_offset_hz / (1000.0f * q->ifft.sf_sz), q->ifft.cfg.out_buffer, q->ifft.sf_sz);
+  }
+}
+
 int srsran_ue_ul_nr_encode_pusch(srsran_ue_ul_nr_t*            q,
                                  const srsran_slot_cfg_t*      slot_cfg,
                                  const srsran_sch_cfg_nr_t*    pusch_cfg,
@@ -142,18 +163,7 @@ int srsran_ue_ul_nr_encode_pusch(srsran_ue_ul_nr_t*            q,
   // Generate signal
   srsran_ofdm_tx_sf(&q->ifft);
 
-  // Normalise to peak
-  uint32_t max_idx  = srsran_vec_max_abs_ci(q->ifft.cfg.out_buffer, q->ifft.sf_sz);
-  float    max_peak = cabsf(q->ifft.cfg.out_buffer[max_idx]);
-  if (isnormal(max_peak)) {
-    srsran_vec_sc_prod_cfc(q->ifft.cfg.out_buffer, 0.99f / max_peak, q->ifft.cfg.out_buffer, q->ifft.sf_sz);
-  }
-
-  // Apply frequency offset
-  if (isnormal(q->freq_offset_hz)) {
-    srsran_vec_apply_cfo(
-        q->ifft.cfg.out_buffer, -q->freq_offset_hz / (1000.0f * q->ifft.sf_sz), q->ifft.cfg.out_buffer, q->ifft.sf_sz);
-  }
+  ue_ul_nr_normalise(q);
 
   return SRSRAN_SUCCESS;
 }
@@ -166,14 +176,9 @@ static int ue_ul_nr_encode_pucch_format0(srsran_ue_ul_nr_t*                q,
   return SRSRAN_ERROR;
 }
 
-static int ue_ul_nr_encode_pucch_format1(srsran_ue_ul_nr_t*                  q,
-                                         const srsran_slot_cfg_t*            slot,
-                                         const srsran_pucch_nr_common_cfg_t* cfg,
-                                         const srsran_pucch_nr_resource_t*   resource,
-                                         const srsran_uci_data_nr_t*         uci_data)
+static uint32_t ue_ul_nr_pucch_format1_bits(const srsran_uci_data_nr_t* uci_data,
+                                            uint8_t                     b[SRSRAN_PUCCH_NR_FORMAT1_MAX_NOF_BITS])
 {
-  uint8_t b[SRSRAN_PUCCH_NR_FORMAT1_MAX_NOF_BITS] = {};
-
   // Set ACK bits
   uint32_t nof_bits = SRSRAN_MIN(SRSRAN_PUCCH_NR_FORMAT1_MAX_NOF_BITS, uci_data->cfg.ack.count);
   for (uint32_t i = 0; i < nof_bits; i++) {
@@ -188,11 +193,134 @@ static int ue_ul_nr_encode_pucch_format1(srsran_ue_ul_nr_t*                  q,
     nof_bits = 1;
   }
 
+  return nof_bits;
+}
+
+static bool ue_ul_nr_pucch_waveform_match(const srsran_ue_ul_nr_pucch_waveform_t* w,
+                                          uint32_t                                n_slot,
+                                          const srsran_pucch_nr_common_cfg_t*     cfg,
+                                          const srsran_pucch_nr_resource_t*       resource)
+{
+  // Only the parameters used by the format 1 sequence, DMRS and mapping are compared
+  return w->valid && w->n_slot == n_slot && w->cfg.group_hopping == cfg->group_hopping &&
+         w->cfg.hopping_id_present == cfg->hopping_id_present &&
+         (!cfg->hopping_id_present || w->cfg.hopping_id == cfg->hopping_id) &&
+         w->resource.starting_prb == resource->starting_prb &&
+         w->resource.intra_slot_hopping == resource->intra_slot_hopping &&
+         (!resource->intra_slot_hopping || w->resource.second_hop_prb == resource->second_hop_prb) &&
+         w->resource.nof_symbols == resource->nof_symbols &&
+         w->resource.start_symbol_idx == resource->start_symbol_idx &&
+         w->resource.initial_cyclic_shift == resource->initial_cyclic_shift &&
+         w->resource.time_domain_occ == resource->time_domain_occ;
+}
+
+// Generates the DMRS and data waveforms of a format 1 resource, each of them takes one IFFT
+static int ue_ul_nr_pucch_waveform_gen(srsran_ue_ul_nr_t*                  q,
+                                       srsran_ue_ul_nr_pucch_waveform_t*   w,
+                                       const srsran_slot_cfg_t*            slot,
+                                       const srsran_pucch_nr_common_cfg_t* cfg,
+                                       const srsran_pucch_nr_resource_t*   resource)
+{
+  uint32_t nof_re = SRSRAN_SLOT_LEN_RE_NR(q->carrier.nof_prb);
+
+  srsran_vec_cf_zero(q->sf_symbols[0], nof_re);
   if (srsran_dmrs_pucch_format1_put(&q->pucch, &q->carrier, cfg, slot, resource, q->sf_symbols[0])) {
     return SRSRAN_ERROR;
   }
+  srsran_ofdm_tx_sf(&q->ifft);
+  srsran_vec_cf_copy(w->dmrs, q->ifft.cfg.out_buffer, q->ifft.sf_sz);
 
-  return srsran_pucch_nr_format1_encode(&q->pucch, cfg, slot, resource, b, nof_bits, q->sf_symbols[0]);
+  uint8_t b[SRSRAN_PUCCH_NR_FORMAT1_MAX_NOF_BITS] = {};
+  srsran_vec_cf_zero(q->sf_symbols[0], nof_re);
+  if (srsran_pucch_nr_format1_encode(&q->pucch, cfg, slot, resource, b, 1, q->sf_symbols[0]) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  srsran_ofdm_tx_sf(&q->ifft);
+  srsran_vec_cf_copy(w->data, q->ifft.cfg.out_buffer, q->ifft.sf_sz);
+  srsran_mod_modulate(&q->pucch.bpsk, b, &w->d_ref, 1);
+
+  return SRSRAN_SUCCESS;
+}
+
+static srsran_ue_ul_nr_pucch_waveform_t* ue_ul_nr_pucch_waveform_get(srsran_ue_ul_nr_t*                  q,
+                                                                     const srsran_slot_cfg_t*            slot,
+                                                                     const srsran_pucch_nr_common_cfg_t* cfg,
+                                                                     const srsran_pucch_nr_resource_t*   resource)
+{
+  uint32_t                          n_slot = SRSRAN_SLOT_NR_MOD(q->carrier.scs, slot->idx);
+  srsran_ue_ul_nr_pucch_waveform_t* w      = &q->pucch_waveforms[0];
+
+  // Look up the waveform, otherwise replace the least recently used entry
+  for (uint32_t i = 0; i < SRSRAN_UE_UL_NR_PUCCH_WAVEFORM_NOF_ENTRIES; i++) {
+    srsran_ue_ul_nr_pucch_waveform_t* e = &q->pucch_waveforms[i];
+    if (ue_ul_nr_pucch_waveform_match(e, n_slot, cfg, resource)) {
+      e->last_use = ++q->pucch_waveform_count;
+      return e;
+    }
+    if (!e->valid || (w->valid && e->last_use < w->last_use)) {
+      w = e;
+    }
+  }
+
+  if (w->dmrs == NULL) {
+    w->dmrs = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB_NR(q->max_prb));
+    w->data = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB_NR(q->max_prb));
+    if (w->dmrs == NULL || w->data == NULL) {
+      ERROR("Malloc");
+      // Release both buffers so a later call retries the allocation instead of using a half-allocated entry
+      free(w->dmrs);
+      free(w->data);
+      w->dmrs = NULL;
+      w->data = NULL;
+      return NULL;
+    }
+  }
+
+  w->valid = false;
+  if (ue_ul_nr_pucch_waveform_gen(q, w, slot, cfg, resource) < SRSRAN_SUCCESS) {
+    return NULL;
+  }
+  w->valid    = true;
+  w->n_slot   = n_slot;
+  w->cfg      = *cfg;
+  w->resource = *resource;
+  w->last_use = ++q->pucch_waveform_count;
+
+  return w;
+}
+
+static int ue_ul_nr_encode_pucch_format1(srsran_ue_ul_nr_t*                  q,
+                                         const srsran_slot_cfg_t*            slot,
+                                         const srsran_pucch_nr_common_cfg_t* cfg,
+                                         const srsran_pucch_nr_resource_t*   resource,
+                                         const srsran_uci_data_nr_t*         uci_data)
+{
+  if (srsran_pucch_nr_cfg_resource_valid(resource) < SRSRAN_SUCCESS) {
+    ERROR("Invalid PUCCH format 1 resource");
+    return SRSRAN_ERROR;
+  }
+
+  const srsran_ue_ul_nr_pucch_waveform_t* w = ue_ul_nr_pucch_waveform_get(q, slot, cfg, resource);
+  if (w == NULL) {
+    ERROR("Error generating PUCCH format 1 waveform");
+    return SRSRAN_ERROR;
+  }
+
+  // Modulate d as the format 1 encoder does, the waveform is linear in d
+  uint8_t  b[SRSRAN_PUCCH_NR_FORMAT1_MAX_NOF_BITS] = {};
+  uint32_t nof_bits                                = ue_ul_nr_pucch_format1_bits(uci_data, b);
+  cf_t     d                                       = 0;
+  if (nof_bits == 1) {
+    srsran_mod_modulate(&q->pucch.bpsk, b, &d, 1);
+  } else {
+    srsran_mod_modulate(&q->pucch.qpsk, b, &d, 2);
+  }
+
+  // Constellation symbols have unit power
+  srsran_vec_sc_prod_ccc(w->data, d * conjf(w->d_ref), q->ifft.cfg.out_buffer, q->ifft.sf_sz);
+  srsran_vec_sum_ccc(q->ifft.cfg.out_buffer, w->dmrs, q->ifft.cfg.out_buffer, q->ifft.sf_sz);
+
+  return SRSRAN_SUCCESS;
 }
 
 int srsran_ue_ul_nr_encode_pucch(srsran_ue_ul_nr_t*                  q,
@@ -206,6 +334,17 @@ int srsran_ue_ul_nr_encode_pucch(srsran_ue_ul_nr_t*                  q,
     return SRSRAN_ERROR_INVALID_INPUTS;
   }
 
+  // Format 1 is combined from its cached time-domain waveforms, it does not need the resource grid nor the IFFT
+  if (resource->format == SRSRAN_PUCCH_NR_FORMAT_1) {
+    if (ue_ul_nr_encode_pucch_format1(q, slot_cfg, cfg, resource, uci_data) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+
+    ue_ul_nr_normalise(q);
+
+    return SRSRAN_SUCCESS;
+  }
+
   // Fill with zeros the whole resource grid
   srsran_vec_cf_zero(q->sf_symbols[0], SRSRAN_SLOT_LEN_RE_NR(q->carrier.nof_prb));
 
@@ -216,11 +355,6 @@ int srsran_ue_ul_nr_encode_pucch(srsran_ue_ul_nr_t*                  q,
         return SRSRAN_ERROR;
       }
       break;
-    case SRSRAN_PUCCH_NR_FORMAT_1:
-      if (ue_ul_nr_encode_pucch_format1(q, slot_cfg, cfg, resource, uci_data) < SRSRAN_SUCCESS) {
-        return SRSRAN_ERROR;
-      }
-      break;
     case SRSRAN_PUCCH_NR_FORMAT_2:
       if (srsran_dmrs_pucch_format2_put(&q->pucch, &q->carrier, cfg, slot_cfg, resource, q->sf_symbols[0])) {
         return SRSRAN_ERROR;
@@ -244,18 +378,7 @@ int srsran_ue_ul_nr_encode_pucch(srsran_ue_ul_nr_t*                  q,
   // Generate signal
   srsran_ofdm_tx_sf(&q->ifft);
 
-  // Normalise to peak
-  uint32_t max_idx  = srsran_vec_max_abs_ci(q->ifft.cfg.out_buffer, q->ifft.sf_sz);
-  float    max_peak = cabsf(q->ifft.cfg.out_buffer[max_idx]);
-  if (isnormal(max_peak)) {
-    srsran_vec_sc_prod_cfc(q->ifft.cfg.out_buffer, 0.99f / max_peak, q->ifft.cfg.out_buffer, q->ifft.sf_sz);
-  }
-
-  // Apply frequency offset
-  if (isnormal(q->freq_offset_hz)) {
-    srsran_vec_apply_cfo(
-        q->ifft.cfg.out_buffer, -q->freq_offset_hz / (1000.0f * q->ifft.sf_sz), q->ifft.cfg.out_buffer, q->ifft.sf_sz);
-  }
+  ue_ul_nr_normalise(q);
 
   return SRSRAN_SUCCESS;
 }
@@ -269,6 +392,14 @@ void srsran_ue_ul_nr_free(srsran_ue_ul_nr_t* q)
   if (q->sf_symbols[0] != NULL) {
     free(q->sf_symbols[0]);
   }
+  for (uint32_t i = 0; i < SRSRAN_UE_UL_NR_PUCCH_WAVEFORM_NOF_ENTRIES; i++) {
+    if (q->pucch_waveforms[i].dmrs != NULL) {
+      free(q->pucch_waveforms[i].dmrs);
+    }
+    if (q->pucch_waveforms[i].data != NULL) {
+      free(q->pucch_waveforms[i].data);
+    }
+  }
   srsran_pucch_nr_free(&q->pucch);
   srsran_pusch_nr_free(&q->pusch);
   srsran_dmrs_sch_free(&q->dmrs);
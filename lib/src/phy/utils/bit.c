@@ -35,23 +35,52 @@
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/vector.h"
 
+/*
+ * Lanes past the last bit have a zero mask and produce zero bits. Output offsets that are not a multiple of 8 shift the
+ * group words through a carry, so the kernels only write whole bytes.
+ */
+#define BIT_INTERLEAVER_GROUP 64
+#define BIT_INTERLEAVER_BATCH 8
+
 void srsran_bit_interleaver_init(srsran_bit_interleaver_t* q, uint16_t* interleaver, uint32_t nof_bits)
 {
   static const uint8_t mask[] = {0x80, 0x40, 0x20, 0x10, 0x8, 0x4, 0x2, 0x1};
 
   bzero(q, sizeof(srsran_bit_interleaver_t));
 
+  q->nof_groups      = SRSRAN_CEIL(nof_bits, BIT_INTERLEAVER_GROUP);
+  uint32_t nof_lanes = SRSRAN_CEIL(q->nof_groups, BIT_INTERLEAVER_BATCH) * BIT_INTERLEAVER_BATCH * BIT_INTERLEAVER_GROUP;
+
   q->interleaver = srsran_vec_u16_malloc(nof_bits);
   q->byte_idx    = srsran_vec_u16_malloc(nof_bits);
   q->bit_mask    = srsran_vec_u8_malloc(nof_bits);
+  q->lane_idx    = srsran_vec_u16_malloc(nof_lanes);
+  q->lane_mask   = srsran_vec_u8_malloc(nof_lanes);
+  q->byte_lo     = srsran_vec_u8_malloc(nof_lanes);
+  q->byte_win    = srsran_vec_u8_malloc(nof_lanes);
   q->nof_bits    = nof_bits;
 
-  for (int i = 0; i < nof_bits; i++) {
+  for (uint32_t i = 0; i < nof_bits; i++) {
     uint16_t i_px     = interleaver[i];
     q->interleaver[i] = i_px;
-    q->byte_idx[i]    = (uint16_t)(interleaver[i] / 8);
+    q->byte_idx[i]    = (uint16_t)(i_px / 8);
     q->bit_mask[i]    = (uint8_t)(mask[i_px % 8]);
+    q->nof_bytes      = SRSRAN_MAX(q->nof_bytes, i_px / 8 + 1U);
+  }
+
+  for (uint32_t i = 0; i < nof_lanes; i++) {
+    // Lane i of the program holds output bit i ^ 63, the lane order within a group is reversed
+    uint32_t j        = i ^ (BIT_INTERLEAVER_GROUP - 1);
+    uint16_t lane_idx = j < nof_bits ? q->byte_idx[j] : 0;
+    q->lane_idx[i]    = lane_idx;
+    q->lane_mask[i]   = j < nof_bits ? q->bit_mask[j] : 0;
+    q->byte_lo[i]     = (uint8_t)(lane_idx % 128);
+    q->byte_win[i]    = (uint8_t)(lane_idx / 128);
   }
+
+#ifdef LV_HAVE_AVX512
+  q->vbmi = __builtin_cpu_supports("avx512vbmi");
+#endif /* LV_HAVE_AVX512 */
 }
 
 void srsran_bit_interleaver_free(srsran_bit_interleaver_t* q)
@@ -68,10 +97,127 @@ void srsran_bit_interleaver_free(srsran_bit_interleaver_t* q)
     free(q->bit_mask);
   }
 
+  if (q->lane_idx) {
+    free(q->lane_idx);
+  }
+
+  if (q->lane_mask) {
+    free(q->lane_mask);
+  }
+
+  if (q->byte_lo) {
+    free(q->byte_lo);
+  }
+
+  if (q->byte_win) {
+    free(q->byte_win);
+  }
+
   bzero(q, sizeof(srsran_bit_interleaver_t));
 }
 
-void srsran_bit_interleaver_run(srsran_bit_interleaver_t* q, uint8_t* input, uint8_t* output, uint16_t w_offset)
+#ifdef LV_HAVE_AVX512
+// Gathers from 128-byte input windows with vpermi2b, each lane keeps the byte of its own window. The windows are the
+// outer loop so each one is loaded once per batch, the lanes are padded so a whole batch can always be computed.
+__attribute__((target("avx512f,avx512bw,avx512vbmi"))) static void
+bit_interleaver_batch_vbmi(const srsran_bit_interleaver_t* q, const uint8_t* input, uint32_t g, uint64_t* v)
+{
+  const uint8_t* byte_lo   = &q->byte_lo[g * BIT_INTERLEAVER_GROUP];
+  const uint8_t* byte_win  = &q->byte_win[g * BIT_INTERLEAVER_GROUP];
+  const uint8_t* lane_mask = &q->lane_mask[g * BIT_INTERLEAVER_GROUP];
+  __m512i        r[BIT_INTERLEAVER_BATCH];
+  for (uint32_t i = 0; i < BIT_INTERLEAVER_BATCH; i++) {
+    r[i] = _mm512_setzero_si512();
+  }
+
+  for (uint32_t lo = 0, w = 0; lo < q->nof_bytes; lo += 128, w++) {
+    // The last window is loaded with masks so the input is never over-read
+    uint32_t  n0  = SRSRAN_MIN(q->nof_bytes - lo, 64);
+    uint32_t  n1  = q->nof_bytes - lo > 64 ? SRSRAN_MIN(q->nof_bytes - lo - 64, 64) : 0;
+    __mmask64 k0  = n0 == 64 ? ~0ULL : (1ULL << n0) - 1;
+    __mmask64 k1  = n1 == 64 ? ~0ULL : (1ULL << n1) - 1;
+    __m512i   a   = _mm512_maskz_loadu_epi8(k0, &input[lo]);
+    __m512i   b   = _mm512_maskz_loadu_epi8(k1, &input[lo + 64]);
+    __m512i   w_v = _mm512_set1_epi8((char)w);
+
+    for (uint32_t i = 0; i < BIT_INTERLEAVER_BATCH; i++) {
+      __m512i   idx = _mm512_loadu_si512(&byte_lo[i * BIT_INTERLEAVER_GROUP]);
+      __mmask64 sel = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(&byte_win[i * BIT_INTERLEAVER_GROUP]), w_v);
+      r[i]          = _mm512_mask_mov_epi8(r[i], sel, _mm512_permutex2var_epi8(a, idx, b));
+    }
+  }
+
+  for (uint32_t i = 0; i < BIT_INTERLEAVER_BATCH; i++) {
+    v[i] = (uint64_t)_mm512_test_epi8_mask(r[i], _mm512_loadu_si512(&lane_mask[i * BIT_INTERLEAVER_GROUP]));
+  }
+}
+#endif /* LV_HAVE_AVX512 */
+
+// Computes the words of n groups starting at group g, v must hold a whole batch
+static inline void
+bit_interleaver_groups(const srsran_bit_interleaver_t* q, const uint8_t* input, uint32_t g, uint32_t n, uint64_t* v)
+{
+#ifdef LV_HAVE_AVX512
+  if (q->vbmi) {
+    bit_interleaver_batch_vbmi(q, input, g, v);
+    return;
+  }
+#endif /* LV_HAVE_AVX512 */
+
+  for (uint32_t i = 0; i < n; i++) {
+    const uint16_t* lane_idx  = &q->lane_idx[(g + i) * BIT_INTERLEAVER_GROUP];
+    const uint8_t*  lane_mask = &q->lane_mask[(g + i) * BIT_INTERLEAVER_GROUP];
+    uint64_t        word      = 0;
+
+#ifdef LV_HAVE_SSE
+    for (uint32_t k = 0; k < BIT_INTERLEAVER_GROUP; k += 16) {
+      const uint16_t* b  = &lane_idx[k];
+      __m128i         in = _mm_cvtsi32_si128(input[b[0]]);
+      in                 = _mm_insert_epi8(in, input[b[1]], 1);
+      in                 = _mm_insert_epi8(in, input[b[2]], 2);
+      in                 = _mm_insert_epi8(in, input[b[3]], 3);
+      in                 = _mm_insert_epi8(in, input[b[4]], 4);
+      in                 = _mm_insert_epi8(in, input[b[5]], 5);
+      in                 = _mm_insert_epi8(in, input[b[6]], 6);
+      in                 = _mm_insert_epi8(in, input[b[7]], 7);
+      in                 = _mm_insert_epi8(in, input[b[8]], 8);
+      in                 = _mm_insert_epi8(in, input[b[9]], 9);
+      in                 = _mm_insert_epi8(in, input[b[10]], 10);
+      in                 = _mm_insert_epi8(in, input[b[11]], 11);
+      in                 = _mm_insert_epi8(in, input[b[12]], 12);
+      in                 = _mm_insert_epi8(in, input[b[13]], 13);
+      in                 = _mm_insert_epi8(in, input[b[14]], 14);
+      in                 = _mm_insert_epi8(in, input[b[15]], 15);
+
+      __m128i m = _mm_loadu_si128((__m128i*)&lane_mask[k]);
+      __m128i z = _mm_cmpeq_epi8(_mm_and_si128(in, m), _mm_setzero_si128());
+      word |= (uint64_t)(~_mm_movemask_epi8(z) & 0xffff) << k;
+    }
+#else  /* LV_HAVE_SSE */
+    for (uint32_t k = 0; k < BIT_INTERLEAVER_GROUP; k++) {
+      word |= (uint64_t)((input[lane_idx[k]] & lane_mask[k]) != 0) << k;
+    }
+#endif /* LV_HAVE_SSE */
+
+    v[i] = word;
+  }
+}
+
+// Writes the n most significant bits of v, keeping the remaining bits of the last byte
+static inline void bit_interleaver_store(uint8_t* output, uint64_t v, uint32_t n)
+{
+  for (; n >= 8; n -= 8) {
+    *(output++) = (uint8_t)(v >> 56);
+    v <<= 8;
+  }
+  if (n > 0) {
+    uint8_t keep = (uint8_t)(0xff >> n);
+    *output      = (uint8_t)((*output & keep) | ((v >> 56) & ~keep));
+  }
+}
+
+// Byte-wise gather, only valid for a zero output offset and for an offset of 4 with a whole number of output bytes
+static void bit_interleaver_run_bytes(srsran_bit_interleaver_t* q, uint8_t* input, uint8_t* output, uint16_t w_offset)
 {
   static const uint8_t mask[]     = {0x80, 0x40, 0x20, 0x10, 0x8, 0x4, 0x2, 0x1};
   uint16_t*            byte_idx   = q->byte_idx;
@@ -162,41 +308,52 @@ void srsran_bit_interleaver_run(srsran_bit_interleaver_t* q, uint8_t* input, uin
       output[q->nof_bits / 8] &= ~(mask[j]);
     }
   }
+}
 
-#if 0
-  /* THIS PIECE OF CODE IS FOR CHECKING SIMD BEHAVIOUR. DO NOT ENABLE. */
-  uint8_t *output2 = malloc(q->nof_bits/8);
-  for (i=st;i<q->nof_bits/8;i++) {
-
-    uint16_t i_p0 = q->interleaver[i*8+0-w_offset_p];
-    uint16_t i_p1 = q->interleaver[i*8+1-w_offset_p];
-    uint16_t i_p2 = q->interleaver[i*8+2-w_offset_p];
-    uint16_t i_p3 = q->interleaver[i*8+3-w_offset_p];
-    uint16_t i_p4 = q->interleaver[i*8+4-w_offset_p];
-    uint16_t i_p5 = q->interleaver[i*8+5-w_offset_p];
-    uint16_t i_p6 = q->interleaver[i*8+6-w_offset_p];
-    uint16_t i_p7 = q->interleaver[i*8+7-w_offset_p];
+void srsran_bit_interleaver_run(srsran_bit_interleaver_t* q, uint8_t* input, uint8_t* output, uint16_t w_offset)
+{
+  // Without VBMI the byte-wise gather is faster than the group program, which is kept for the offsets it cannot handle
+  if (!q->vbmi && (w_offset == 0 || (w_offset == 4 && q->nof_bits % 8 == 0))) {
+    bit_interleaver_run_bytes(q, input, output, w_offset);
+    return;
+  }
 
-    uint8_t out0  = (input[i_p0/8] & mask[i_p0%8])?mask[0]:(uint8_t)0;
-    uint8_t out1  = (input[i_p1/8] & mask[i_p1%8])?mask[1]:(uint8_t)0;
-    uint8_t out2  = (input[i_p2/8] & mask[i_p2%8])?mask[2]:(uint8_t)0;
-    uint8_t out3  = (input[i_p3/8] & mask[i_p3%8])?mask[3]:(uint8_t)0;
-    uint8_t out4  = (input[i_p4/8] & mask[i_p4%8])?mask[4]:(uint8_t)0;
-    uint8_t out5  = (input[i_p5/8] & mask[i_p5%8])?mask[5]:(uint8_t)0;
-    uint8_t out6  = (input[i_p6/8] & mask[i_p6%8])?mask[6]:(uint8_t)0;
-    uint8_t out7  = (input[i_p7/8] & mask[i_p7%8])?mask[7]:(uint8_t)0;
+  uint32_t nof_full = q->nof_bits / BIT_INTERLEAVER_GROUP;
+  uint32_t s        = w_offset % 8;
+  uint64_t v[BIT_INTERLEAVER_BATCH];
+  output += w_offset / 8;
 
-    output2[i] = out0 | out1 | out2 | out3 | out4 | out5 | out6 | out7;
+  // The first s bits of the first output byte are kept, they go out with the first group
+  uint64_t carry = (uint64_t)(output[0] & (uint8_t)~(0xff >> s)) << 56;
+
+  for (uint32_t g = 0; g < nof_full; g += BIT_INTERLEAVER_BATCH) {
+    uint32_t n = SRSRAN_MIN(nof_full - g, BIT_INTERLEAVER_BATCH);
+    bit_interleaver_groups(q, input, g, n, v);
+
+    for (uint32_t i = 0; i < n; i++) {
+      uint64_t chunk = carry | (v[i] >> s);
+      carry          = s ? v[i] << (64 - s) : 0;
+      for (uint32_t k = 0; k < 8; k++) {
+        output[k] = (uint8_t)(chunk >> (56 - 8 * k));
+      }
+      output += 8;
+    }
   }
 
-  for(i = st; i < q->nof_bits/8; i++) {
-    if (true || output[i] != output2[i]) {
-      printf("%05d/%05d %02X %02X\n", i, q->nof_bits/8, output[i], output2[i]);
+  // Remaining bits, the zero lanes past the last bit are not written
+  uint32_t n = s + q->nof_bits % BIT_INTERLEAVER_GROUP;
+  if (nof_full < q->nof_groups) {
+    bit_interleaver_groups(q, input, nof_full, 1, v);
+    if (n > 64) {
+      bit_interleaver_store(output, carry | (v[0] >> s), 64);
+      output += 8;
+      carry = v[0] << (64 - s);
+      n -= 64;
+    } else {
+      carry |= v[0] >> s;
     }
-    //output[i] = output2[i];
   }
-  free(output2);
-#endif
+  bit_interleaver_store(output, carry, n);
 }
 
 void srsran_bit_interleave_i(uint8_t* input, uint8_t* output, uint32_t* interleaver, uint32_t nof_bits)
@@ -0,0 +1,220 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ * Checks the packed bit interleaver against a bit by bit reference for random permutations of the turbo coder and
+ * rate matcher sizes at every output offset, and measures its throughput.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "srsran/srsran.h"
+
+static uint32_t nof_reps  = 1000;
+static uint32_t bench_len = 6144; // Largest LTE turbo code block
+static uint32_t seed      = 1;
+
+static volatile uint8_t bench_sink = 0;
+
+// Turbo coder sizes, systematic (K + 4) and parity (2 * (K + 4)) rate matcher sizes and odd lengths
+static const uint32_t test_lens[] = {1, 7, 40, 44, 63, 64, 65, 88, 127, 128, 129, 864, 1028, 2056, 6144, 6148, 12296};
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [Rls]\n", prog);
+  printf("\t-R Number of benchmark repetitions [Default %d]\n", nof_reps);
+  printf("\t-l Benchmark length in bits, 8 to 65536 [Default %d]\n", bench_len);
+  printf("\t-s seed [Default %d, 0=time]\n", seed);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "Rls")) != -1) {
+    switch (opt) {
+      case 'R':
+        nof_reps = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        bench_len = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        seed = (uint32_t)strtoul(argv[optind], NULL, 0);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+
+  // The interleaver indexes are 16 bit and the benchmark reads whole output bytes
+  if (bench_len < 8 || bench_len > UINT16_MAX + 1) {
+    usage(argv[0]);
+    exit(-1);
+  }
+}
+
+static void random_permutation(uint16_t* interleaver, uint32_t nof_bits)
+{
+  for (uint32_t i = 0; i < nof_bits; i++) {
+    interleaver[i] = (uint16_t)i;
+  }
+  for (uint32_t i = nof_bits - 1; i > 0; i--) {
+    uint32_t j     = rand() % (i + 1);
+    uint16_t tmp   = interleaver[i];
+    interleaver[i] = interleaver[j];
+    interleaver[j] = tmp;
+  }
+}
+
+static void interleave_reference(const uint8_t*  input,
+                                 uint8_t*        output,
+                                 const uint16_t* interleaver,
+                                 uint32_t        nof_bits,
+                                 uint32_t        w_offset)
+{
+  for (uint32_t j = 0; j < nof_bits; j++) {
+    uint32_t i_p    = interleaver[j];
+    uint32_t o_p    = j + w_offset;
+    uint8_t  bit    = (input[i_p / 8] >> (7 - i_p % 8)) & 1;
+    output[o_p / 8] = (uint8_t)((output[o_p / 8] & ~(0x80 >> (o_p % 8))) | (bit << (7 - o_p % 8)));
+  }
+}
+
+static int test_len(srsran_bit_interleaver_t* q, uint16_t* interleaver, uint32_t nof_bits, bool vbmi)
+{
+  uint32_t nof_bytes = nof_bits / 8 + 3;
+  uint8_t* input     = srsran_vec_u8_malloc(nof_bytes);
+  uint8_t* output    = srsran_vec_u8_malloc(nof_bytes);
+  uint8_t* expected  = srsran_vec_u8_malloc(nof_bytes);
+  int      ret       = SRSRAN_SUCCESS;
+
+  srsran_bit_interleaver_init(q, interleaver, nof_bits);
+  q->vbmi = q->vbmi && vbmi;
+
+  for (uint32_t w_offset = 0; w_offset < 16 && ret == SRSRAN_SUCCESS; w_offset++) {
+    for (uint32_t i = 0; i < nof_bytes; i++) {
+      input[i]    = (uint8_t)rand();
+      output[i]   = (uint8_t)rand();
+      expected[i] = output[i];
+    }
+
+    interleave_reference(input, expected, interleaver, nof_bits, w_offset);
+    srsran_bit_interleaver_run(q, input, output, (uint16_t)w_offset);
+
+    // Bits outside the output range must be kept too
+    if (memcmp(output, expected, nof_bytes) != 0) {
+      ERROR("Mismatch for %d bits, w_offset=%d, vbmi=%s", nof_bits, w_offset, q->vbmi ? "yes" : "no");
+      ret = SRSRAN_ERROR;
+    }
+  }
+
+  srsran_bit_interleaver_free(q);
+  free(input);
+  free(output);
+  free(expected);
+  return ret;
+}
+
+// Returns the elapsed seconds for nof_reps runs
+static double
+bench(srsran_bit_interleaver_t* q, uint8_t* input, uint8_t* output, uint16_t* interleaver, uint16_t w_offset)
+{
+  struct timeval t[3];
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < nof_reps; r++) {
+    if (q != NULL) {
+      srsran_bit_interleaver_run(q, input, output, w_offset);
+    } else {
+      srsran_bit_interleave(input, output, interleaver, bench_len);
+    }
+    bench_sink ^= output[r % (bench_len / 8)];
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+
+  return t[0].tv_sec + 1e-6 * t[0].tv_usec;
+}
+
+int main(int argc, char** argv)
+{
+  int ret = SRSRAN_SUCCESS;
+
+  parse_args(argc, argv);
+
+  if (!seed) {
+    seed = time(NULL);
+  }
+  srand(seed);
+
+  uint32_t  max_len     = SRSRAN_MAX(bench_len, 12296);
+  uint16_t* interleaver = srsran_vec_u16_malloc(max_len);
+  uint8_t*  input       = srsran_vec_u8_malloc(max_len / 8 + 1);
+  uint8_t*  output      = srsran_vec_u8_malloc(max_len / 8 + 1);
+  if (interleaver == NULL || input == NULL || output == NULL) {
+    perror("malloc");
+    exit(-1);
+  }
+
+  srsran_bit_interleaver_t q;
+  for (uint32_t i = 0; i < sizeof(test_lens) / sizeof(uint32_t) && ret == SRSRAN_SUCCESS; i++) {
+    random_permutation(interleaver, test_lens[i]);
+    if (test_len(&q, interleaver, test_lens[i], false) < SRSRAN_SUCCESS ||
+        test_len(&q, interleaver, test_lens[i], true) < SRSRAN_SUCCESS) {
+      ret = SRSRAN_ERROR;
+    }
+  }
+
+  random_permutation(interleaver, bench_len);
+  for (uint32_t i = 0; i < max_len / 8 + 1; i++) {
+    input[i] = (uint8_t)rand();
+  }
+
+  srsran_bit_interleaver_init(&q, interleaver, bench_len);
+  bool   vbmi   = q.vbmi; // Only benchmark the VBMI kernel when the CPU supports it
+  double t_vbmi = vbmi ? bench(&q, input, output, NULL, 0) : 0.0;
+  q.vbmi        = false;
+  double t_byte = bench(&q, input, output, NULL, 0);
+  double t_prog = bench(&q, input, output, NULL, 1); // Odd offsets always run the group program
+  double t_bit  = bench(NULL, input, output, interleaver, 0);
+  srsran_bit_interleaver_free(&q);
+
+  printf("%d bits: bit-by-bit %.1f Mbps; byte-wise %.1f Mbps; program %.1f Mbps",
+         bench_len,
+         (double)bench_len * nof_reps / t_bit / 1e6,
+         (double)bench_len * nof_reps / t_byte / 1e6,
+         (double)bench_len * nof_reps / t_prog / 1e6);
+  if (vbmi) {
+    printf("; VBMI %.1f Mbps", (double)bench_len * nof_reps / t_vbmi / 1e6);
+  }
+  printf("\n");
+
+  free(interleaver);
+  free(input);
+  free(output);
+
+  printf("%s\n", ret == SRSRAN_SUCCESS ? "Ok" : "Failed");
+  return ret;
+}
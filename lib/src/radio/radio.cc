@@ -22,6 +22,7 @@
 #include "srsran/radio/radio.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/string_helpers.h"
+#include "srsran/common/threads.h"
 #include "srsran/config.h"
 #include "srsran/support/srsran_assert.h"
 #include <list>
@@ -40,6 +41,8 @@ radio::radio()
 
 radio::~radio()
 {
+  rx_pump_stop();
+
   for (srsran_resampler_fft_t& q : interpolators) {
     srsran_resampler_fft_free(&q);
   }
@@ -219,6 +222,27 @@ int radio::init(const rf_args_t& args, phy_interface_radio* phy_)
     }
   }
 
+  // RX pump blocks last up to 1 ms and never exceed SRSRAN_SF_LEN_MAX samples, the ring holds rx_ring_ms of them.
+  // Without decimation the driver writes straight into the slots, and the Rx offset correction may return up to twice
+  // the requested number of samples
+  if (args.rx_ring_ms > 0) {
+    uint32_t nof_slots = args.rx_ring_ms;
+    if (std::isnormal(fix_srate_hz)) {
+      nof_slots *= SRSRAN_CEIL((uint32_t)(fix_srate_hz / 1000), SRSRAN_SF_LEN_MAX);
+    }
+    rx_ring.resize(nof_slots);
+    for (rx_ring_slot_t& slot : rx_ring) {
+      for (uint32_t ch = 0; ch < nof_channels; ch++) {
+        slot.samples[ch].resize(2 * SRSRAN_SF_LEN_MAX);
+      }
+    }
+
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      rx_pump_buffer[ch].resize(2 * SRSRAN_SF_LEN_MAX);
+    }
+    logger.info("RX pump enabled with a ring of %zd blocks", rx_ring.size());
+  }
+
   // Frequency offset
   freq_offset = args.freq_offset;
 
@@ -232,12 +256,16 @@ bool radio::is_init()
 
 void radio::stop()
 {
+  // Signal the RX pump first, so it does not take the stream stop for a failure
+  rx_pump_running = false;
+
   // Stop Rx streams as soon as possible to avoid Overflows
   if (radio_is_streaming) {
     for (srsran_rf_t& rf_device : rf_devices) {
       srsran_rf_stop_rx_stream(&rf_device);
     }
   }
+  rx_pump_stop();
   if (is_initialized) {
     for (srsran_rf_t& rf_device : rf_devices) {
       srsran_rf_close(&rf_device);
@@ -247,9 +275,11 @@ void radio::stop()
 
 void radio::reset()
 {
+  rx_pump_running = false;
   for (srsran_rf_t& rf_device : rf_devices) {
     srsran_rf_stop_rx_stream(&rf_device);
   }
+  rx_pump_stop();
   radio_is_streaming = false;
   usleep(100000);
 }
@@ -289,6 +319,27 @@ bool radio::start_agc(bool tx_gain_same_rx)
 
 bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time)
 {
+  // The pump owns the devices, only read from its ring
+  if (not rx_ring.empty()) {
+    if (not radio_is_streaming) {
+      for (srsran_rf_t& rf_device : rf_devices) {
+        srsran_rf_start_rx_stream(&rf_device, false);
+      }
+      radio_is_streaming = true;
+
+      // Flush buffers to compensate settling time
+      if (rf_devices.size() > 1) {
+        for (srsran_rf_t& rf_device : rf_devices) {
+          srsran_rf_flush_buffer(&rf_device);
+        }
+      }
+    }
+    if (not rx_pump_started and not rx_pump_start()) {
+      return false;
+    }
+    return rx_ring_read(buffer, rxd_time);
+  }
+
   std::unique_lock<std::mutex> lock(rx_mutex);
   bool                         ret = true;
   rf_buffer_t                  buffer_rx;
@@ -405,11 +456,11 @@ bool radio::rx_dev(const uint32_t& device_idx, const rf_buffer_interface& buffer
     return ret > 0;
   }
 
-  // Otherwise, set rest of buffer to zero
+  // Otherwise, set rest of buffer to zero. Unmapped channels were received into the dummy buffers and are discarded
   uint32_t nof_zeros = buffer.get_nof_samples() - nof_samples;
-  for (auto& b : radio_buffers) {
-    if (b != nullptr) {
-      cf_t* ptr = (cf_t*)b;
+  for (uint32_t i = 0; i < SRSRAN_MAX_CHANNELS; i++) {
+    cf_t* ptr = (cf_t*)radio_buffers[i];
+    if (ptr != nullptr and ptr != dummy_buffers[i].data()) {
       srsran_vec_cf_zero(&ptr[nof_samples], nof_zeros);
     }
   }
@@ -417,6 +468,196 @@ bool radio::rx_dev(const uint32_t& device_idx, const rf_buffer_interface& buffer
   return ret > 0;
 }
 
+bool radio::rx_pump_start()
+{
+  // Discard whatever was left in the ring by a previous stream
+  rx_ring_rd.store(rx_ring_wr.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  rx_ring_offset  = 0;
+  rx_pump_running = true;
+  if (not threads_new_rt_prio(&rx_pump_thread, rx_pump_entry, this, rx_pump_prio)) {
+    logger.error("Error starting RX pump thread");
+    rx_pump_running = false;
+    return false;
+  }
+  rx_pump_started = true;
+  return true;
+}
+
+void radio::rx_pump_stop()
+{
+  if (not rx_pump_started) {
+    return;
+  }
+  rx_pump_running = false;
+  pthread_join(rx_pump_thread, nullptr);
+  rx_pump_started = false;
+}
+
+void* radio::rx_pump_entry(void* arg)
+{
+  pthread_setname_np(pthread_self(), "RX_PUMP");
+  static_cast<radio*>(arg)->rx_pump_run();
+  return nullptr;
+}
+
+void radio::rx_pump_run()
+{
+  while (rx_pump_running) {
+    uint32_t wr    = rx_ring_wr.load(std::memory_order_relaxed);
+    uint32_t depth = wr - rx_ring_rd.load(std::memory_order_acquire);
+
+    // A full ring drops the new block instead of stalling the driver, the reader sees the same gap as after an overflow
+    rx_ring_slot_t* slot  = depth < rx_ring.size() ? &rx_ring[wr % rx_ring.size()] : nullptr;
+    bool            valid = false;
+    if (not rx_pump_block(slot, valid)) {
+      if (rx_pump_running) {
+        logger.error("RX pump failed receiving samples");
+      }
+      break;
+    }
+
+    if (slot == nullptr) {
+      {
+        std::lock_guard<std::mutex> lock(metrics_mutex);
+        rf_metrics.rf_ring_o++;
+        rf_metrics.rf_error = true;
+      }
+      logger.info("RX ring overflow");
+      if (phy != nullptr) {
+        phy->radio_overflow();
+      }
+      continue;
+    }
+
+    if (not valid) {
+      continue;
+    }
+
+    uint32_t max_depth = rx_ring_max_depth.load(std::memory_order_relaxed);
+    while (depth + 1 > max_depth and not rx_ring_max_depth.compare_exchange_weak(max_depth, depth + 1)) {
+    }
+
+    rx_ring_wr.store(wr + 1, std::memory_order_release);
+    {
+      // Synchronise with a reader about to wait, so the notification cannot be lost
+      std::lock_guard<std::mutex> lock(rx_ring_mutex);
+    }
+    rx_ring_cvar.notify_one();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(rx_ring_mutex);
+    rx_pump_running = false;
+  }
+  rx_ring_cvar.notify_all();
+}
+
+bool radio::rx_pump_block(rx_ring_slot_t* slot, bool& valid)
+{
+  // As in rx_now, keep receiving without decimation while the decimator changes the rate, the block is then dropped
+  std::unique_lock<std::mutex> lock(rx_mutex, std::defer_lock);
+  uint32_t                     ratio = 1;
+  valid                              = slot != nullptr and not decimator_busy;
+  if (valid) {
+    lock.lock();
+    ratio = SRSRAN_MAX(decimators[0].ratio, 1);
+  }
+  uint32_t epoch    = rx_epoch;
+  double   srate_hz = cur_rx_srate;
+
+  // Blocks of 1 ms with an integer number of decimated samples
+  uint32_t nof_samples = SRSRAN_SF_LEN_MAX;
+  if (std::isnormal(srate_hz)) {
+    nof_samples = SRSRAN_MIN((uint32_t)(srate_hz / 1000), SRSRAN_SF_LEN_MAX);
+  } else {
+    valid = false;
+  }
+  nof_samples -= nof_samples % ratio;
+
+  // Without decimation the block is received straight into the slot, otherwise into the staging buffer
+  bool        direct = valid and ratio == 1;
+  rf_buffer_t buffer_rx;
+  buffer_rx.set_nof_samples(nof_samples);
+  for (uint32_t ch = 0; ch < nof_channels; ch++) {
+    buffer_rx.set(ch, direct ? slot->samples[ch].data() : rx_pump_buffer[ch].data());
+  }
+
+  bool ret = true;
+  for (uint32_t device_idx = 0; device_idx < (uint32_t)rf_devices.size(); device_idx++) {
+    ret &= rx_dev(device_idx, buffer_rx, valid ? slot->time.get_ptr(device_idx) : nullptr);
+  }
+
+  if (not ret or not valid) {
+    return ret;
+  }
+
+  if (not direct) {
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      srsran_resampler_fft_run(&decimators[ch], buffer_rx.get(ch), slot->samples[ch].data(), nof_samples);
+    }
+  }
+  slot->nof_samples = nof_samples / ratio;
+  slot->epoch       = epoch;
+  slot->srate_hz    = srate_hz / ratio;
+
+  return true;
+}
+
+bool radio::rx_ring_read(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time)
+{
+  uint32_t nof_samples = buffer.get_nof_samples();
+  uint32_t count       = 0;
+
+  while (count < nof_samples) {
+    uint32_t rd = rx_ring_rd.load(std::memory_order_relaxed);
+    if (rd == rx_ring_wr.load(std::memory_order_acquire)) {
+      std::unique_lock<std::mutex> lock(rx_ring_mutex);
+      rx_ring_cvar.wait(lock, [this, rd]() {
+        return rd != rx_ring_wr.load(std::memory_order_acquire) or not rx_pump_running;
+      });
+      if (rd == rx_ring_wr.load(std::memory_order_acquire)) {
+        return false;
+      }
+    }
+    const rx_ring_slot_t& slot = rx_ring[rd % rx_ring.size()];
+
+    // Blocks received before the last rate or frequency change are dropped, restart the read
+    if (slot.epoch != rx_epoch) {
+      rx_ring_offset = 0;
+      rx_ring_rd.store(rd + 1, std::memory_order_release);
+      count = 0;
+      continue;
+    }
+
+    // The read is timestamped with its first sample
+    if (count == 0) {
+      for (uint32_t device_idx = 0; device_idx < (uint32_t)rf_devices.size(); device_idx++) {
+        srsran_timestamp_t* ts = rxd_time.get_ptr(device_idx);
+        if (ts != nullptr) {
+          *ts = slot.time.get(device_idx);
+          srsran_timestamp_add(ts, 0, rx_ring_offset / slot.srate_hz);
+        }
+      }
+    }
+
+    uint32_t n = SRSRAN_MIN(nof_samples - count, slot.nof_samples - rx_ring_offset);
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      if (buffer.get(ch) != nullptr) {
+        srsran_vec_cf_copy(buffer.get(ch) + count, slot.samples[ch].data() + rx_ring_offset, n);
+      }
+    }
+    count += n;
+    rx_ring_offset += n;
+
+    if (rx_ring_offset == slot.nof_samples) {
+      rx_ring_offset = 0;
+      rx_ring_rd.store(rd + 1, std::memory_order_release);
+    }
+  }
+
+  return true;
+}
+
 bool radio::tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_time)
 {
   bool                         ret = true;
@@ -695,6 +936,7 @@ void radio::set_rx_freq(const uint32_t& carrier_idx, const double& freq)
 
           srsran_rf_set_rx_freq(&rf_devices[dm.device_idx], dm.channel_idx, freq + freq_offset);
         }
+        rx_epoch++;
       } else {
         logger.error("set_rx_freq: physical_channel_idx=%d for %d antennas exceeds maximum channels (%d)",
                      device_mapping.carrier_idx,
@@ -761,10 +1003,12 @@ void radio::set_rx_srate(const double& srate)
 
     decimator_busy = false;
   } else {
+    std::unique_lock<std::mutex> lock(rx_mutex);
     for (srsran_rf_t& rf_device : rf_devices) {
       cur_rx_srate = srsran_rf_set_rx_srate(&rf_device, srate);
     }
   }
+  rx_epoch++;
 }
 
 void radio::set_channel_rx_offset(uint32_t ch, int32_t offset_samples)
@@ -1040,8 +1284,10 @@ srsran_rf_info_t* radio::get_info()
 bool radio::get_metrics(rf_metrics_t* metrics)
 {
   std::lock_guard<std::mutex> lock(metrics_mutex);
-  *metrics   = rf_metrics;
-  rf_metrics = {};
+  *metrics               = rf_metrics;
+  metrics->rf_ring_depth = rx_ring_max_depth.exchange(0);
+  metrics->rf_ring_sz    = (uint32_t)rx_ring.size();
+  rf_metrics             = {};
   return true;
 }
 
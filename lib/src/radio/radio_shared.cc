@@ -0,0 +1,561 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/radio/radio_shared.h"
+#include "srsran/common/threads.h"
+#include "srsran/support/srsran_assert.h"
+
+namespace srsran {
+
+/// Default receive ring depth in blocks of 1 ms, if rf_args_t::rx_ring_ms is not set
+static const uint32_t radio_shared_default_ring_ms = 20;
+
+/// Transmit accumulator length in blocks of 1 ms, on top of the lead time
+static const uint32_t radio_shared_tx_window_ms = 2 * SRSRAN_NOF_SF_X_FRAME;
+
+/// Port resampling buffers length in ms, as in radio
+static const uint32_t radio_shared_resamp_buf_sz_ms = 5;
+
+radio_shared::port::port(radio_shared& parent_, uint32_t idx_) :
+  parent(parent_), idx(idx_), logger(srslog::fetch_basic_logger("RF", false))
+{
+  size_t resamp_buf_sz = (size_t)(radio_shared_resamp_buf_sz_ms * parent.srate_hz) / 1000;
+  for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+    rx_buffer[ch].resize(resamp_buf_sz);
+    tx_buffer[ch].resize(resamp_buf_sz);
+  }
+}
+
+radio_shared::port::~port()
+{
+  for (srsran_resampler_fft_t& q : interpolators) {
+    srsran_resampler_fft_free(&q);
+  }
+
+  for (srsran_resampler_fft_t& q : decimators) {
+    srsran_resampler_fft_free(&q);
+  }
+}
+
+int radio_shared::port::init(const rf_args_t& args_, phy_interface_radio* phy_)
+{
+  phy = phy_;
+  return parent.running ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+}
+
+void radio_shared::port::stop()
+{
+  phy = nullptr;
+}
+
+bool radio_shared::port::get_metrics(rf_metrics_t* metrics_)
+{
+  {
+    std::lock_guard<std::mutex> lock(metrics_mutex);
+    *metrics_ = metrics;
+    metrics   = {};
+  }
+
+  // The radio counters are reported once, with the first port
+  if (idx == 0) {
+    rf_metrics_t dev_metrics = {};
+    parent.radio_dev.get_metrics(&dev_metrics);
+    metrics_->rf_o += dev_metrics.rf_o;
+    metrics_->rf_u += dev_metrics.rf_u;
+    metrics_->rf_l += dev_metrics.rf_l;
+    metrics_->rf_error |= dev_metrics.rf_error;
+  }
+  metrics_->rf_ring_sz = (uint32_t)parent.ring.size();
+  return true;
+}
+
+bool radio_shared::port::tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_time)
+{
+  std::lock_guard<std::mutex> lock(tx_mutex);
+  uint32_t                    ratio       = SRSRAN_MAX(interpolators[0].ratio, 1);
+  uint32_t                    nof_samples = buffer.get_nof_samples();
+
+  rf_buffer_t buffer_tx;
+  if (ratio > 1) {
+    // Limit number of samples to the interpolation buffer, as radio does
+    nof_samples = SRSRAN_MIN(nof_samples, (uint32_t)tx_buffer[0].size() / ratio);
+    for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+      if (buffer.get(ch) != nullptr) {
+        srsran_resampler_fft_run(&interpolators[ch], buffer.get(ch), tx_buffer[ch].data(), nof_samples);
+        buffer_tx.set(ch, tx_buffer[ch].data());
+      }
+    }
+  } else {
+    for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+      buffer_tx.set(ch, buffer.get(ch));
+    }
+  }
+
+  uint32_t nof_late = parent.tx_add(buffer_tx, nof_samples * ratio, tx_time.get(0));
+  if (nof_late > 0) {
+    logger.debug("Shared radio port %d: dropped %d late Tx samples", idx, nof_late);
+    std::lock_guard<std::mutex> metrics_lock(metrics_mutex);
+    metrics.rf_l++;
+    metrics.rf_error = true;
+  }
+
+  return true;
+}
+
+bool radio_shared::port::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time)
+{
+  std::lock_guard<std::mutex> lock(rx_mutex);
+  uint32_t                    ratio       = SRSRAN_MAX(decimators[0].ratio, 1);
+  uint32_t                    nof_samples = buffer.get_nof_samples() * ratio;
+
+  // Check decimation buffer protection
+  if (ratio > 1 && nof_samples > rx_buffer[0].size()) {
+    logger.info("Shared radio port %d: Rx number of samples (%d/%d) exceeds buffer size (%zd)",
+                idx,
+                buffer.get_nof_samples(),
+                nof_samples,
+                rx_buffer[0].size());
+    nof_samples = rx_buffer[0].size();
+  }
+
+  rf_buffer_t buffer_rx;
+  buffer_rx.set_nof_samples(nof_samples);
+  for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+    buffer_rx.set(ch, ratio > 1 ? rx_buffer[ch].data() : buffer.get(ch));
+  }
+
+  if (not read_ring(buffer_rx, rxd_time)) {
+    return false;
+  }
+
+  if (ratio > 1) {
+    for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+      if (buffer.get(ch) != nullptr) {
+        srsran_resampler_fft_run(&decimators[ch], buffer_rx.get(ch), buffer.get(ch), nof_samples);
+      }
+    }
+  }
+
+  return true;
+}
+
+bool radio_shared::port::read_ring(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time)
+{
+  const uint64_t ring_sz     = parent.ring.size();
+  uint32_t       nof_samples = buffer.get_nof_samples();
+  uint32_t       count       = 0;
+
+  // A port starts, or restarts after reset, from the next block received
+  if (not rd_sync) {
+    rd_blk    = parent.ring_wr.load(std::memory_order_acquire);
+    rd_offset = 0;
+    rd_sync   = true;
+  }
+
+  while (count < nof_samples) {
+    uint64_t wr = parent.ring_wr.load(std::memory_order_acquire);
+    if (wr == rd_blk) {
+      std::unique_lock<std::mutex> lock(parent.ring_mutex);
+      parent.ring_cvar.wait(lock, [this]() {
+        return parent.ring_wr.load(std::memory_order_acquire) != rd_blk or not parent.running;
+      });
+      wr = parent.ring_wr.load(std::memory_order_acquire);
+      if (wr == rd_blk) {
+        return false;
+      }
+    }
+
+    // The pump overwrote the block, behave as after a radio overflow and restart the read from the newest block
+    if (wr - rd_blk >= ring_sz) {
+      logger.info("Shared radio port %d: Rx ring overflow", idx);
+      {
+        std::lock_guard<std::mutex> lock(metrics_mutex);
+        metrics.rf_ring_o++;
+        metrics.rf_error = true;
+      }
+      phy_interface_radio* p = phy;
+      if (p != nullptr) {
+        p->radio_overflow();
+      }
+      rd_blk    = wr - 1;
+      rd_offset = 0;
+      count     = 0;
+      continue;
+    }
+
+    const ring_block_t& blk = parent.ring[rd_blk % ring_sz];
+
+    // The read is timestamped with its first sample
+    if (count == 0) {
+      rxd_time.copy(blk.time);
+      rxd_time.add(rd_offset / parent.srate_hz);
+    }
+
+    uint32_t n = SRSRAN_MIN(nof_samples - count, parent.block_len - rd_offset);
+    for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+      if (buffer.get(ch) != nullptr) {
+        srsran_vec_cf_copy(buffer.get(ch) + count, blk.samples[ch].data() + rd_offset, n);
+      }
+    }
+
+    // Discard the copy if the pump started overwriting the block meanwhile
+    if (parent.ring_wr.load(std::memory_order_acquire) - rd_blk >= ring_sz) {
+      continue;
+    }
+
+    uint32_t depth = (uint32_t)(parent.ring_wr.load(std::memory_order_relaxed) - rd_blk);
+    {
+      std::lock_guard<std::mutex> lock(metrics_mutex);
+      metrics.rf_ring_depth = SRSRAN_MAX(metrics.rf_ring_depth, depth);
+    }
+
+    count += n;
+    rd_offset += n;
+    if (rd_offset == parent.block_len) {
+      rd_blk++;
+      rd_offset = 0;
+    }
+  }
+
+  return true;
+}
+
+void radio_shared::port::set_tx_freq(const uint32_t& carrier_idx, const double& freq)
+{
+  std::lock_guard<std::mutex> lock(parent.cfg_mutex);
+  parent.radio_dev.set_tx_freq(carrier_idx, freq);
+}
+
+void radio_shared::port::set_rx_freq(const uint32_t& carrier_idx, const double& freq)
+{
+  std::lock_guard<std::mutex> lock(parent.cfg_mutex);
+  parent.radio_dev.set_rx_freq(carrier_idx, freq);
+}
+
+void radio_shared::port::set_tx_gain(const float& gain)
+{
+  std::lock_guard<std::mutex> lock(parent.cfg_mutex);
+  parent.radio_dev.set_tx_gain(gain);
+}
+
+void radio_shared::port::set_rx_gain_th(const float& gain)
+{
+  std::lock_guard<std::mutex> lock(parent.cfg_mutex);
+  parent.radio_dev.set_rx_gain_th(gain);
+}
+
+void radio_shared::port::set_rx_gain(const float& gain)
+{
+  std::lock_guard<std::mutex> lock(parent.cfg_mutex);
+  parent.radio_dev.set_rx_gain(gain);
+}
+
+void radio_shared::port::set_tx_srate(const double& srate)
+{
+  std::lock_guard<std::mutex> lock(tx_mutex);
+  srsran_assert(((uint32_t)parent.srate_hz % (uint32_t)srate) == 0,
+                "The sampling rate ratio is not integer (%.2f MHz / %.2f MHz = %.3f)",
+                parent.srate_hz / 1e6,
+                srate / 1e6,
+                parent.srate_hz / srate);
+  uint32_t ratio = (uint32_t)ceil(parent.srate_hz / srate);
+  for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+    srsran_resampler_fft_init(&interpolators[ch], SRSRAN_RESAMPLER_MODE_INTERPOLATE, ratio);
+  }
+}
+
+void radio_shared::port::set_rx_srate(const double& srate)
+{
+  std::lock_guard<std::mutex> lock(rx_mutex);
+  srsran_assert(((uint32_t)parent.srate_hz % (uint32_t)srate) == 0,
+                "The sampling rate ratio is not integer (%.2f MHz / %.2f MHz = %.3f)",
+                parent.srate_hz / 1e6,
+                srate / 1e6,
+                parent.srate_hz / srate);
+  uint32_t ratio = (uint32_t)ceil(parent.srate_hz / srate);
+  for (uint32_t ch = 0; ch < parent.nof_channels; ch++) {
+    srsran_resampler_fft_init(&decimators[ch], SRSRAN_RESAMPLER_MODE_DECIMATE, ratio);
+  }
+}
+
+void radio_shared::port::set_channel_rx_offset(uint32_t ch, int32_t offset_samples)
+{
+  // The offset aligns a physical device, so it is shared by every port; scale it from the port rate to the device rate
+  uint32_t ratio;
+  {
+    std::lock_guard<std::mutex> lock(rx_mutex);
+    ratio = SRSRAN_MAX(decimators[0].ratio, 1);
+  }
+  std::lock_guard<std::mutex> lock(parent.cfg_mutex);
+  parent.radio_dev.set_channel_rx_offset(ch, offset_samples * (int32_t)ratio);
+}
+
+double radio_shared::port::get_freq_offset()
+{
+  return parent.radio_dev.get_freq_offset();
+}
+
+float radio_shared::port::get_rx_gain()
+{
+  return parent.radio_dev.get_rx_gain();
+}
+
+bool radio_shared::port::is_continuous_tx()
+{
+  return parent.radio_dev.is_continuous_tx();
+}
+
+bool radio_shared::port::get_is_start_of_burst()
+{
+  return parent.radio_dev.get_is_start_of_burst();
+}
+
+bool radio_shared::port::is_init()
+{
+  return parent.running;
+}
+
+void radio_shared::port::reset()
+{
+  std::lock_guard<std::mutex> lock(rx_mutex);
+  rd_sync = false;
+}
+
+srsran_rf_info_t* radio_shared::port::get_info()
+{
+  return parent.radio_dev.get_info();
+}
+
+radio_shared::radio_shared() = default;
+
+radio_shared::~radio_shared()
+{
+  stop();
+}
+
+int radio_shared::init(const rf_args_t& args, uint32_t nof_ports, uint32_t tx_lead_ms)
+{
+  if (nof_ports == 0) {
+    logger.error("Shared radio requires at least one port");
+    return SRSRAN_ERROR;
+  }
+
+  if (not std::isnormal(args.srate_hz)) {
+    logger.error("Shared radio requires a fixed RF sampling rate");
+    return SRSRAN_ERROR;
+  }
+
+  // The pump already decouples the ports from the radio, the radio itself receives in the pump thread
+  rf_args_t dev_args  = args;
+  dev_args.rx_ring_ms = 0;
+  if (radio_dev.init(dev_args, this) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  srate_hz     = args.srate_hz;
+  nof_channels = args.nof_antennas * args.nof_carriers;
+  block_len    = (uint32_t)(srate_hz / 1000);
+  radio_dev.set_rx_srate(srate_hz);
+  radio_dev.set_tx_srate(srate_hz);
+
+  ring.resize(args.rx_ring_ms > 0 ? args.rx_ring_ms : radio_shared_default_ring_ms);
+  for (ring_block_t& blk : ring) {
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      blk.samples[ch].resize(block_len);
+    }
+  }
+
+  tx_lead_blk = tx_lead_ms;
+  tx_blk_used.resize(tx_lead_blk + radio_shared_tx_window_ms);
+  for (uint32_t ch = 0; ch < nof_channels; ch++) {
+    tx_acc[ch].resize(tx_blk_used.size() * block_len);
+    tx_out[ch].resize(block_len);
+  }
+
+  for (uint32_t i = 0; i < nof_ports; i++) {
+    ports.emplace_back(new port(*this, i));
+  }
+
+  running = true;
+  if (not threads_new_rt_prio(&pump_thread, pump_entry, this, 0)) {
+    logger.error("Error starting shared radio pump thread");
+    running = false;
+    return SRSRAN_ERROR;
+  }
+  pump_started = true;
+
+  logger.info("Shared radio with %d ports, Rx ring of %zd ms and Tx lead of %d ms", nof_ports, ring.size(), tx_lead_ms);
+  return SRSRAN_SUCCESS;
+}
+
+void radio_shared::stop()
+{
+  if (not pump_started) {
+    return;
+  }
+  running = false;
+  pthread_join(pump_thread, nullptr);
+  pump_started = false;
+  radio_dev.stop();
+}
+
+void radio_shared::radio_overflow()
+{
+  for (std::unique_ptr<port>& p : ports) {
+    phy_interface_radio* phy = p->phy;
+    if (phy != nullptr) {
+      phy->radio_overflow();
+    }
+  }
+}
+
+void radio_shared::radio_failure()
+{
+  for (std::unique_ptr<port>& p : ports) {
+    phy_interface_radio* phy = p->phy;
+    if (phy != nullptr) {
+      phy->radio_failure();
+    }
+  }
+}
+
+void* radio_shared::pump_entry(void* arg)
+{
+  pthread_setname_np(pthread_self(), "RF_SHARED");
+  static_cast<radio_shared*>(arg)->pump_run();
+  return nullptr;
+}
+
+void radio_shared::pump_run()
+{
+  rf_buffer_t buffer;
+  buffer.set_nof_samples(block_len);
+
+  while (running) {
+    uint64_t      wr  = ring_wr.load(std::memory_order_relaxed);
+    ring_block_t& blk = ring[wr % ring.size()];
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      buffer.set(ch, blk.samples[ch].data());
+    }
+
+    if (not radio_dev.rx_now(buffer, blk.time)) {
+      if (running) {
+        logger.error("Shared radio failed receiving samples");
+      }
+      break;
+    }
+
+    // The first sample received is the origin of the transmit sample indexes
+    if (wr == 0) {
+      base_time.copy(blk.time);
+    }
+
+    ring_wr.store(wr + 1, std::memory_order_release);
+    {
+      // Synchronise with readers about to wait, so the notification cannot be lost
+      std::lock_guard<std::mutex> lock(ring_mutex);
+    }
+    ring_cvar.notify_all();
+
+    // Send the uplink up to the lead time ahead of the end of this block
+    srsran_timestamp_t rx_end = blk.time.get(0);
+    srsran_timestamp_sub(&rx_end, base_time.get(0).full_secs, base_time.get(0).frac_secs);
+    uint64_t rx_end_blk = (uint64_t)llround(srsran_timestamp_real(&rx_end) * srate_hz / block_len) + 1;
+    tx_flush(rx_end_blk + tx_lead_blk);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(ring_mutex);
+    running = false;
+  }
+  ring_cvar.notify_all();
+}
+
+void radio_shared::tx_flush(uint64_t end_blk)
+{
+  while (tx_flush_blk < end_blk) {
+    uint64_t blk  = tx_flush_blk;
+    uint32_t slot = (uint32_t)(blk % tx_blk_used.size());
+    bool     used = false;
+    {
+      std::lock_guard<std::mutex> lock(tx_mutex);
+      used = tx_blk_used[slot];
+      if (used) {
+        for (uint32_t ch = 0; ch < nof_channels; ch++) {
+          srsran_vec_cf_copy(tx_out[ch].data(), &tx_acc[ch][slot * block_len], block_len);
+          srsran_vec_cf_zero(&tx_acc[ch][slot * block_len], block_len);
+        }
+        tx_blk_used[slot] = false;
+      }
+      tx_flush_blk++;
+    }
+
+    // Blocks no port wrote are not sent, the radio fills or ends the burst as for any other gap
+    if (not used) {
+      continue;
+    }
+
+    rf_buffer_t buffer;
+    buffer.set_nof_samples(block_len);
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      buffer.set(ch, tx_out[ch].data());
+    }
+    rf_timestamp_t tx_time;
+    tx_time.copy(base_time);
+    tx_time.add((double)(blk * block_len) / srate_hz);
+    radio_dev.tx(buffer, tx_time);
+  }
+}
+
+uint32_t radio_shared::tx_add(const rf_buffer_interface& buffer, uint32_t nof_samples, const srsran_timestamp_t& tx_time)
+{
+  // Nothing can be aligned before the first block is received
+  if (ring_wr.load(std::memory_order_acquire) == 0) {
+    return nof_samples;
+  }
+
+  srsran_timestamp_t ts = tx_time;
+  srsran_timestamp_sub(&ts, base_time.get(0).full_secs, base_time.get(0).frac_secs);
+  int64_t idx = llround(srsran_timestamp_real(&ts) * srate_hz);
+
+  std::lock_guard<std::mutex> lock(tx_mutex);
+  const int64_t acc_len = (int64_t)tx_blk_used.size() * block_len;
+  const int64_t first   = (int64_t)tx_flush_blk * block_len;
+
+  // Samples whose block was already sent are late, samples beyond the accumulator are dropped too
+  uint32_t nof_late = (uint32_t)SRSRAN_MIN(SRSRAN_MAX(first - idx, (int64_t)0), (int64_t)nof_samples);
+  uint32_t i        = nof_late;
+  while (i < nof_samples and idx + i < first + acc_len) {
+    uint32_t pos = (uint32_t)((idx + i) % acc_len);
+    uint32_t n   = SRSRAN_MIN(nof_samples - i, block_len - pos % block_len);
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      if (buffer.get(ch) != nullptr) {
+        srsran_vec_sum_ccc(buffer.get(ch) + i, &tx_acc[ch][pos], &tx_acc[ch][pos], n);
+      }
+    }
+    tx_blk_used[pos / block_len] = true;
+    i += n;
+  }
+
+  return nof_late;
+}
+
+} // namespace srsran
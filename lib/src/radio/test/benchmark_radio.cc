@@ -58,6 +58,7 @@ static bool        measure_delay   = false;
 static bool        capture         = false;
 static bool        agc_enable      = true;
 static float       rf_gain         = -1.0;
+static uint32_t    rx_ring_ms      = 0;
 
 static pthread_t radio_thread;
 
@@ -79,9 +80,10 @@ static bool fft_plot_enable = false;
 
 void usage(char* prog)
 {
-  printf("Usage: %s [foabcderpstvhmFxw]\n", prog);
+  printf("Usage: %s [foabcderpstvhmFxwR]\n", prog);
   printf("\t-f Carrier frequency in Hz [Default %f]\n", freq);
   printf("\t-g RF gain [Default AGC]\n");
+  printf("\t-R RX pump ring depth in ms, 0 disables the RX pump [Default %d]\n", rx_ring_ms);
   printf("\t-a Arguments for first radio [Default %s]\n", radios_args[0].c_str());
   printf("\t-b Arguments for second radio [Default %s]\n", radios_args[1].c_str());
   printf("\t-c Arguments for third radio [Default %s]\n", radios_args[2].c_str());
@@ -103,7 +105,7 @@ void usage(char* prog)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "foabcderpsStvhmFxywg")) != -1) {
+  while ((opt = getopt(argc, argv, "foabcderpsStvhmFxywgR")) != -1) {
     switch (opt) {
       case 'f':
         freq = strtof(argv[optind], NULL);
@@ -112,6 +114,9 @@ void parse_args(int argc, char** argv)
         rf_gain    = strtof(argv[optind], NULL);
         agc_enable = false;
         break;
+      case 'R':
+        rx_ring_ms = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'o':
         file_pattern = argv[optind];
         break;
@@ -349,6 +354,7 @@ static void* radio_thread_run(void* arg)
     radio_args.rx_gain      = agc_enable ? -1 : rf_gain;
     radio_args.tx_gain      = agc_enable ? -1 : rf_gain;
     radio_args.device_name  = radio_device;
+    radio_args.rx_ring_ms   = rx_ring_ms;
 
     if (radio_h[r]->init(radio_args, &phy) != SRSRAN_SUCCESS) {
       fprintf(stderr, "Error: Calling radio_multi constructor\n");
@@ -546,13 +552,15 @@ static void* radio_thread_run(void* arg)
 
   radio_h[0]->get_metrics(&rf_metrics);
 
-  printf("Finished streaming with %d gaps, %d late timestamps, %d overflows, %d underflow...\n",
+  printf("Finished streaming with %d gaps, %d late timestamps, %d overflows, %d underflow, %d ring overflows...\n",
          nof_gaps,
          rf_metrics.rf_l,
          rf_metrics.rf_o,
-         rf_metrics.rf_u);
+         rf_metrics.rf_u,
+         rf_metrics.rf_ring_o);
 
-  if (nof_gaps == 0 && rf_metrics.rf_l == 0 && rf_metrics.rf_o == 0 && rf_metrics.rf_u == 0) {
+  if (nof_gaps == 0 && rf_metrics.rf_l == 0 && rf_metrics.rf_o == 0 && rf_metrics.rf_u == 0 &&
+      rf_metrics.rf_ring_o == 0) {
     ret = SRSRAN_SUCCESS;
   }
 
@@ -0,0 +1,279 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "cbor_formatter.h"
+#include <cstring>
+
+using namespace srslog;
+
+namespace {
+
+/// Converts the CBOR entries back to the layout of the JSON formatter.
+class cbor_json_decoder
+{
+public:
+  cbor_json_decoder(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+  /// Decodes all the entries of the stream.
+  bool decode(fmt::memory_buffer& out)
+  {
+    while (pos < size) {
+      fmt::memory_buffer entry;
+      if (!decode_entry(entry)) {
+        return false;
+      }
+      if (synced && valid) {
+        out.append(entry.data(), entry.data() + entry.size());
+      }
+    }
+    return true;
+  }
+
+private:
+  /// Maximum nesting depth accepted in an entry.
+  static constexpr unsigned max_depth = 32;
+
+  /// Item header: major type and argument, info holds the additional
+  /// information bits for simple values and floats.
+  struct head_t {
+    uint8_t  major;
+    uint8_t  info;
+    uint64_t arg;
+  };
+
+  bool read_head(head_t& h)
+  {
+    if (pos >= size) {
+      return false;
+    }
+    h.major = data[pos] >> 5;
+    h.info  = data[pos] & 0x1f;
+    ++pos;
+    if (h.info < 24) {
+      h.arg = h.info;
+      return true;
+    }
+    if (h.info > 27) {
+      // Indefinite lengths are not written by the formatter.
+      return false;
+    }
+    unsigned nof_bytes = 1u << (h.info - 24);
+    if (size - pos < nof_bytes) {
+      return false;
+    }
+    h.arg = 0;
+    for (unsigned i = 0; i != nof_bytes; ++i) {
+      h.arg = (h.arg << 8) | data[pos++];
+    }
+    return true;
+  }
+
+  bool read_payload(uint64_t len, const uint8_t*& p)
+  {
+    if (size - pos < len) {
+      return false;
+    }
+    p = data + pos;
+    pos += len;
+    return true;
+  }
+
+  bool decode_entry(fmt::memory_buffer& out)
+  {
+    valid = true;
+
+    head_t h;
+    if (!read_head(h)) {
+      return false;
+    }
+    // Self-described CBOR tag, the encoder restarts its dictionary.
+    if (h.major == 6 && h.arg == 55799) {
+      dict.clear();
+      synced = true;
+      if (!read_head(h)) {
+        return false;
+      }
+    }
+    if (h.major != 5) {
+      return false;
+    }
+
+    fmt::format_to(out, "{{\n");
+    if (!decode_members(h.arg, 2, 0, out)) {
+      return false;
+    }
+    fmt::format_to(out, "}}\n");
+    return true;
+  }
+
+  bool decode_key(fmt::memory_buffer& out)
+  {
+    head_t h;
+    if (!read_head(h)) {
+      return false;
+    }
+    if (h.major == 3) {
+      const uint8_t* p;
+      if (!read_payload(h.arg, p)) {
+        return false;
+      }
+      dict.emplace_back(reinterpret_cast<const char*>(p), h.arg);
+      out.append(dict.back().data(), dict.back().data() + dict.back().size());
+      return true;
+    }
+    if (h.major != 0) {
+      return false;
+    }
+    if (h.arg >= dict.size()) {
+      // Key defined before the start of the stream.
+      valid = false;
+      return true;
+    }
+    out.append(dict[h.arg].data(), dict[h.arg].data() + dict[h.arg].size());
+    return true;
+  }
+
+  bool decode_members(uint64_t nof_members, unsigned indent, unsigned depth, fmt::memory_buffer& out)
+  {
+    for (uint64_t i = 0; i != nof_members; ++i) {
+      put_indent(indent, out);
+      out.push_back('"');
+      if (!decode_key(out)) {
+        return false;
+      }
+      fmt::format_to(out, "\": ");
+      if (!decode_value(indent, depth, out)) {
+        return false;
+      }
+      fmt::format_to(out, "{}\n", i + 1 != nof_members ? "," : "");
+    }
+    return true;
+  }
+
+  bool decode_value(unsigned indent, unsigned depth, fmt::memory_buffer& out)
+  {
+    if (depth == max_depth) {
+      return false;
+    }
+
+    head_t h;
+    if (!read_head(h)) {
+      return false;
+    }
+
+    const uint8_t* p;
+    switch (h.major) {
+      case 0:
+        fmt::format_to(out, "{}", h.arg);
+        return true;
+      case 1:
+        fmt::format_to(out, "-{}", h.arg + 1);
+        return true;
+      case 2:
+        if (!read_payload(h.arg, p)) {
+          return false;
+        }
+        fmt::format_to(out, "\"{:02x}\"", fmt::join(p, p + h.arg, " "));
+        return true;
+      case 3:
+        if (!read_payload(h.arg, p)) {
+          return false;
+        }
+        out.push_back('"');
+        out.append(reinterpret_cast<const char*>(p), reinterpret_cast<const char*>(p) + h.arg);
+        out.push_back('"');
+        return true;
+      case 4:
+        fmt::format_to(out, "[\n");
+        for (uint64_t i = 0; i != h.arg; ++i) {
+          put_indent(indent + 2, out);
+          if (!decode_value(indent + 2, depth + 1, out)) {
+            return false;
+          }
+          fmt::format_to(out, "{}\n", i + 1 != h.arg ? "," : "");
+        }
+        put_indent(indent, out);
+        out.push_back(']');
+        return true;
+      case 5:
+        fmt::format_to(out, "{{\n");
+        if (!decode_members(h.arg, indent + 2, depth + 1, out)) {
+          return false;
+        }
+        put_indent(indent, out);
+        out.push_back('}');
+        return true;
+      case 7:
+        return decode_simple(h, out);
+      default:
+        return false;
+    }
+  }
+
+  bool decode_simple(const head_t& h, fmt::memory_buffer& out)
+  {
+    switch (h.info) {
+      case 20:
+        fmt::format_to(out, "false");
+        return true;
+      case 21:
+        fmt::format_to(out, "true");
+        return true;
+      case 26: {
+        uint32_t bits = h.arg;
+        float    f;
+        std::memcpy(&f, &bits, sizeof(f));
+        fmt::format_to(out, "{}", f);
+        return true;
+      }
+      case 27: {
+        double d;
+        std::memcpy(&d, &h.arg, sizeof(d));
+        fmt::format_to(out, "{}", d);
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+  static void put_indent(unsigned indent, fmt::memory_buffer& out)
+  {
+    for (unsigned i = 0; i != indent; ++i) {
+      out.push_back(' ');
+    }
+  }
+
+private:
+  const uint8_t*           data;
+  size_t                   size;
+  size_t                   pos    = 0;
+  bool                     synced = false;
+  bool                     valid  = true;
+  std::vector<std::string> dict;
+};
+
+} // namespace
+
+bool srslog::cbor_to_json(const uint8_t* data, size_t size, fmt::memory_buffer& out)
+{
+  return cbor_json_decoder(data, size).decode(out);
+}
@@ -0,0 +1,246 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "cbor_formatter.h"
+#include "srsran/srslog/detail/log_entry_metadata.h"
+#include <cstring>
+
+using namespace srslog;
+
+namespace {
+
+/// CBOR major types.
+enum cbor_major : uint8_t {
+  uint_major  = 0,
+  nint_major  = 1,
+  bytes_major = 2,
+  text_major  = 3,
+  array_major = 4,
+  map_major   = 5
+};
+
+/// Tag marking self-described CBOR, used to flag a dictionary restart.
+const uint8_t self_described_tag[] = {0xd9, 0xd9, 0xf7};
+
+/// Writes the header of a data item with the shortest argument encoding.
+void put_head(cbor_major major, uint64_t value, fmt::memory_buffer& buffer)
+{
+  uint8_t mt = major << 5;
+  if (value < 24) {
+    buffer.push_back(mt | value);
+    return;
+  }
+  unsigned nof_bytes = value <= 0xff ? 1 : value <= 0xffff ? 2 : value <= 0xffffffff ? 4 : 8;
+  buffer.push_back(mt | (24 + __builtin_ctz(nof_bytes)));
+  for (int i = nof_bytes - 1; i >= 0; --i) {
+    buffer.push_back(value >> (8 * i));
+  }
+}
+
+void put_string(cbor_major major, fmt::string_view str, fmt::memory_buffer& buffer)
+{
+  put_head(major, str.size(), buffer);
+  buffer.append(str.data(), str.data() + str.size());
+}
+
+template <typename T, typename U>
+void put_float(uint8_t initial_byte, T value, fmt::memory_buffer& buffer)
+{
+  U bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  buffer.push_back(initial_byte);
+  for (int i = sizeof(bits) - 1; i >= 0; --i) {
+    buffer.push_back(bits >> (8 * i));
+  }
+}
+
+/// Writes the text of the log entry.
+void put_log_entry(const detail::log_entry_metadata& md, fmt::memory_buffer& buffer)
+{
+  if (!md.store) {
+    put_string(text_major, md.fmtstring, buffer);
+    return;
+  }
+
+  fmt::memory_buffer                                         text;
+  fmt::basic_format_args<fmt::basic_printf_context_t<char> > args(*md.store);
+  try {
+    fmt::vprintf(text, fmt::to_string_view(md.fmtstring), args);
+  } catch (...) {
+    fmt::print(stderr, "srsLog error - Invalid format string: \"{}\"\n", md.fmtstring);
+    fmt::format_to(text, " -> srsLog error - Invalid format string: \"{}\"", md.fmtstring);
+#ifdef STOP_ON_WARNING
+    std::abort();
+#endif
+  }
+  put_string(text_major, fmt::string_view(text.data(), text.size()), buffer);
+}
+
+} // namespace
+
+std::unique_ptr<log_formatter> cbor_formatter::clone() const
+{
+  return std::unique_ptr<log_formatter>(new cbor_formatter);
+}
+
+void cbor_formatter::begin_entry(fmt::memory_buffer& buffer)
+{
+  if (nof_entries++ % dict_refresh_period == 0) {
+    dict.clear();
+    nof_keys = 0;
+    buffer.append(std::begin(self_described_tag), std::end(self_described_tag));
+  }
+}
+
+void cbor_formatter::put_key(fmt::string_view key, fmt::memory_buffer& buffer)
+{
+  auto it = dict.find(key.data());
+  if (it != dict.end() && it->second.text == key) {
+    put_head(uint_major, it->second.index, buffer);
+    return;
+  }
+  dict[key.data()] = {std::string(key.data(), key.size()), nof_keys++};
+  put_string(text_major, key, buffer);
+}
+
+void cbor_formatter::format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer)
+{
+  begin_entry(buffer);
+  put_head(map_major, (metadata.fmtstring ? 1 : 0) + (metadata.hex_dump.empty() ? 0 : 1), buffer);
+
+  if (metadata.fmtstring) {
+    put_key("log_entry", buffer);
+    put_log_entry(metadata, buffer);
+  }
+
+  if (!metadata.hex_dump.empty()) {
+    put_key("hex_dump", buffer);
+    put_head(bytes_major, metadata.hex_dump.size(), buffer);
+    buffer.append(metadata.hex_dump.data(), metadata.hex_dump.data() + metadata.hex_dump.size());
+  }
+}
+
+void cbor_formatter::format_context_begin(const detail::log_entry_metadata& md,
+                                          fmt::string_view                  ctx_name,
+                                          unsigned                          size,
+                                          fmt::memory_buffer&               buffer)
+{
+  assert(list_stack.empty() && "Stack should be empty");
+
+  begin_entry(buffer);
+  put_head(map_major, size + (md.fmtstring ? 1 : 0), buffer);
+  list_stack.push_back(false);
+
+  if (md.fmtstring) {
+    put_key("log_entry", buffer);
+    put_log_entry(md, buffer);
+  }
+}
+
+void cbor_formatter::format_context_end(const detail::log_entry_metadata& md,
+                                        fmt::string_view                  ctx_name,
+                                        fmt::memory_buffer&               buffer)
+{
+  list_stack.pop_back();
+
+  assert(list_stack.empty() && "Stack should be empty");
+}
+
+void cbor_formatter::format_metric_set_begin(fmt::string_view    set_name,
+                                             unsigned            size,
+                                             unsigned            level,
+                                             fmt::memory_buffer& buffer)
+{
+  // Metric sets inside a list are wrapped in a single element map, following
+  // the structure of the JSON formatter.
+  if (list_stack.back()) {
+    put_head(map_major, 1, buffer);
+  }
+
+  put_key(set_name, buffer);
+  put_head(map_major, size, buffer);
+  list_stack.push_back(false);
+}
+
+void cbor_formatter::format_metric_set_end(fmt::string_view set_name, unsigned level, fmt::memory_buffer& buffer)
+{
+  list_stack.pop_back();
+}
+
+void cbor_formatter::format_list_begin(fmt::string_view    list_name,
+                                       unsigned            size,
+                                       unsigned            level,
+                                       fmt::memory_buffer& buffer)
+{
+  put_key(list_name, buffer);
+  put_head(array_major, size, buffer);
+  list_stack.push_back(true);
+}
+
+void cbor_formatter::format_list_end(fmt::string_view list_name, unsigned level, fmt::memory_buffer& buffer)
+{
+  list_stack.pop_back();
+}
+
+void cbor_formatter::format_metric(fmt::string_view    metric_name,
+                                   fmt::string_view    metric_value,
+                                   fmt::string_view    metric_units,
+                                   metric_kind         kind,
+                                   unsigned            level,
+                                   fmt::memory_buffer& buffer)
+{
+  put_key(metric_name, buffer);
+
+  // The value comes null terminated from the formatter base class.
+  fmt::string_view value(metric_value.data(), std::strlen(metric_value.data()));
+  put_string(text_major, value, buffer);
+}
+
+void cbor_formatter::format_metric_number(fmt::string_view    metric_name,
+                                          metric_number       metric_value,
+                                          fmt::string_view    metric_units,
+                                          unsigned            level,
+                                          fmt::memory_buffer& buffer)
+{
+  put_key(metric_name, buffer);
+
+  switch (metric_value.type) {
+    case metric_number::num_type::boolean:
+      buffer.push_back(metric_value.u ? 0xf5 : 0xf4);
+      break;
+    case metric_number::num_type::sint:
+      if (metric_value.i < 0) {
+        put_head(nint_major, -(metric_value.i + 1), buffer);
+      } else {
+        put_head(uint_major, metric_value.i, buffer);
+      }
+      break;
+    case metric_number::num_type::uint:
+      put_head(uint_major, metric_value.u, buffer);
+      break;
+    case metric_number::num_type::float32:
+      put_float<float, uint32_t>(0xfa, metric_value.f, buffer);
+      break;
+    case metric_number::num_type::float64:
+      put_float<double, uint64_t>(0xfb, metric_value.d, buffer);
+      break;
+  }
+}
@@ -0,0 +1,120 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_CBOR_FORMATTER_H
+#define SRSLOG_CBOR_FORMATTER_H
+
+#include "srsran/srslog/formatter.h"
+#include <unordered_map>
+
+namespace srslog {
+
+/// CBOR formatter class implementation.
+/// Encodes each log entry and context into the same object structure as the
+/// JSON formatter, as one CBOR data item (RFC 8949) per entry so that the
+/// output is a CBOR sequence. Arithmetic metrics are stored in their native
+/// binary representation, no text conversion takes place.
+///
+/// Keys are compressed with a dictionary built along the stream: the first
+/// occurrence of a key is written as a text string and takes the next index,
+/// later occurrences are written as that unsigned index. The dictionary is
+/// restarted every dict_refresh_period entries, entries that start a new
+/// dictionary are tagged as self-described CBOR (tag 55799), so a reader can
+/// join the stream at these points, e.g. after a file sink rotation.
+class cbor_formatter : public log_formatter
+{
+public:
+  /// Number of entries after which the key dictionary is restarted.
+  static constexpr unsigned dict_refresh_period = 256;
+
+  std::unique_ptr<log_formatter> clone() const override;
+
+  void format(detail::log_entry_metadata&& metadata, fmt::memory_buffer& buffer) override;
+
+private:
+  void format_context_begin(const detail::log_entry_metadata& md,
+                            fmt::string_view                  ctx_name,
+                            unsigned                          size,
+                            fmt::memory_buffer&               buffer) override;
+
+  void format_context_end(const detail::log_entry_metadata& md,
+                          fmt::string_view                  ctx_name,
+                          fmt::memory_buffer&               buffer) override;
+
+  void format_metric_set_begin(fmt::string_view    set_name,
+                               unsigned            size,
+                               unsigned            level,
+                               fmt::memory_buffer& buffer) override;
+
+  void format_metric_set_end(fmt::string_view set_name, unsigned level, fmt::memory_buffer& buffer) override;
+
+  void
+  format_list_begin(fmt::string_view list_name, unsigned size, unsigned level, fmt::memory_buffer& buffer) override;
+
+  void format_list_end(fmt::string_view list_name, unsigned level, fmt::memory_buffer& buffer) override;
+
+  void format_metric(fmt::string_view    metric_name,
+                     fmt::string_view    metric_value,
+                     fmt::string_view    metric_units,
+                     metric_kind         kind,
+                     unsigned            level,
+                     fmt::memory_buffer& buffer) override;
+
+  bool formats_native_numbers() const override { return true; }
+
+  void format_metric_number(fmt::string_view    metric_name,
+                            metric_number       metric_value,
+                            fmt::string_view    metric_units,
+                            unsigned            level,
+                            fmt::memory_buffer& buffer) override;
+
+  /// Starts a new entry, restarting the dictionary when needed.
+  void begin_entry(fmt::memory_buffer& buffer);
+
+  /// Writes a map key, either as text or as its dictionary index.
+  void put_key(fmt::string_view key, fmt::memory_buffer& buffer);
+
+private:
+  /// Key names come from the static metric declarations, so the dictionary is
+  /// looked up by the address of the name. The text is kept to detect
+  /// different names at the same address.
+  struct dict_entry {
+    std::string text;
+    unsigned    index;
+  };
+
+  std::unordered_map<const char*, dict_entry> dict;
+  unsigned                                    nof_keys    = 0;
+  unsigned                                    nof_entries = 0;
+  /// Tracks which nesting levels are lists.
+  std::vector<bool> list_stack;
+};
+
+/// Converts a stream written by the CBOR formatter into the text the JSON
+/// formatter would have written for the same entries. Entries that use keys
+/// defined before the point where the stream starts are dropped until the next
+/// dictionary restart. Returns false if the stream is malformed or truncated,
+/// in which case out holds the text of the entries decoded up to that point.
+bool cbor_to_json(const uint8_t* data, size_t size, fmt::memory_buffer& out);
+
+} // namespace srslog
+
+#endif // SRSLOG_CBOR_FORMATTER_H
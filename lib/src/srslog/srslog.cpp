@@ -20,6 +20,7 @@
  */
 
 #include "srsran/srslog/srslog.h"
+#include "formatters/cbor_formatter.h"
 #include "formatters/json_formatter.h"
 #include "sinks/file_sink.h"
 #include "sinks/syslog_sink.h"
@@ -105,6 +106,11 @@ std::unique_ptr<log_formatter> srslog::create_json_formatter()
   return std::unique_ptr<log_formatter>(new json_formatter);
 }
 
+std::unique_ptr<log_formatter> srslog::create_cbor_formatter()
+{
+  return std::unique_ptr<log_formatter>(new cbor_formatter);
+}
+
 ///
 /// Sink management function implementations.
 ///
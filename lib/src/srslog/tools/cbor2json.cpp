@@ -0,0 +1,63 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/// Converts the output of the srslog CBOR formatter into JSON text.
+/// Usage: srslog_cbor2json <input file> [output file]
+
+#include "../formatters/cbor_formatter.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+  if (argc < 2 || argc > 3) {
+    fmt::print(stderr, "Usage: {} <input file> [output file]\n", argv[0]);
+    return -1;
+  }
+
+  std::ifstream in(argv[1], std::ios::binary);
+  if (!in) {
+    fmt::print(stderr, "Unable to open input file \"{}\"\n", argv[1]);
+    return -1;
+  }
+  std::vector<uint8_t> data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+
+  fmt::memory_buffer out;
+  bool               ok = srslog::cbor_to_json(data.data(), data.size(), out);
+
+  std::FILE* f = (argc == 3) ? std::fopen(argv[2], "w") : stdout;
+  if (f == nullptr) {
+    fmt::print(stderr, "Unable to open output file \"{}\"\n", argv[2]);
+    return -1;
+  }
+  std::fwrite(out.data(), 1, out.size(), f);
+  if (f != stdout) {
+    std::fclose(f);
+  }
+
+  if (!ok) {
+    fmt::print(stderr, "Input is malformed or truncated, the last entry was dropped\n");
+    return -1;
+  }
+  return 0;
+}
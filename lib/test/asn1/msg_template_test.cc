@@ -0,0 +1,139 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/asn1/msg_template.h"
+#include "srsran/asn1/nas_5g_msg.h"
+#include "srsran/asn1/rrc_nr.h"
+#include "srsran/common/test_common.h"
+#include <cstring>
+#include <random>
+
+using namespace asn1;
+
+std::mt19937 rand_gen(0);
+
+static void fill_setup_request(rrc_nr::ul_ccch_msg_s& msg, uint64_t ue_id, uint32_t cause)
+{
+  rrc_nr::rrc_setup_request_ies_s& req = msg.msg.set_c1().set_rrc_setup_request().rrc_setup_request;
+  req.ue_id.set_random_value().from_number(ue_id, 39);
+  req.establishment_cause = (rrc_nr::establishment_cause_opts::options)cause;
+}
+
+int test_bit_fields()
+{
+  uint8_t ref[8] = {};
+  uint8_t out[8];
+
+  msg_template tmpl;
+  tmpl.set_reference(ref, sizeof(ref));
+  TESTASSERT(tmpl.add_field(3, 11) == 0);
+  TESTASSERT(tmpl.add_field(14, 1) == 1);
+  TESTASSERT(tmpl.add_field(60, 5) < 0);
+
+  tmpl.set_field(0, 0x7ff);
+  tmpl.set_field(1, 0xff);
+  TESTASSERT(tmpl.write(out, sizeof(out)) == sizeof(out));
+  TESTASSERT(out[0] == 0x1f and out[1] == 0xfe and out[2] == 0);
+
+  // Only the field bits are modified
+  tmpl.set_field(0, 0x401);
+  TESTASSERT(tmpl.data()[0] == 0x10 and tmpl.data()[1] == 0x06);
+  TESTASSERT(tmpl.write(out, sizeof(out) - 1) == 0);
+  return SRSRAN_SUCCESS;
+}
+
+int test_rrc_setup_request()
+{
+  rrc_nr::ul_ccch_msg_s msg;
+  msg_template          tmpl;
+
+  fill_setup_request(msg, 0, 0);
+  TESTASSERT(tmpl.pack_reference(msg) == SRSASN_SUCCESS);
+  fill_setup_request(msg, (1ULL << 39) - 1, 0);
+  int ue_id_field = tmpl.learn_field(msg);
+  fill_setup_request(msg, 0, 15);
+  int cause_field = tmpl.learn_field(msg);
+  TESTASSERT(ue_id_field == 0 and tmpl.field_length(ue_id_field) == 39);
+  TESTASSERT(cause_field == 1 and tmpl.field_length(cause_field) == 4);
+
+  for (uint32_t i = 0; i < 1000; i++) {
+    uint64_t ue_id = ((uint64_t)rand_gen() << 32 | rand_gen()) & ((1ULL << 39) - 1);
+    uint32_t cause = rand_gen() % 16;
+    tmpl.set_field(ue_id_field, ue_id);
+    tmpl.set_field(cause_field, cause);
+
+    uint8_t               buf[32];
+    rrc_nr::ul_ccch_msg_s expected;
+    fill_setup_request(expected, ue_id, cause);
+    bit_ref bref(buf, sizeof(buf));
+    TESTASSERT(expected.pack(bref) == SRSASN_SUCCESS);
+    bref.align_bytes_zero();
+    TESTASSERT((uint32_t)bref.distance_bytes() == tmpl.size());
+    TESTASSERT(memcmp(buf, tmpl.data(), tmpl.size()) == 0);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int test_nas_registration_request()
+{
+  using namespace srsran::nas_5g;
+
+  nas_5gs_msg             msg;
+  std::vector<uint8_t>    buf;
+  registration_request_t& reg_req = msg.set_registration_request();
+  reg_req.registration_type_5gs.registration_type =
+      registration_type_5gs_t::registration_type_type_::options::initial_registration;
+  mobile_identity_5gs_t::suci_s& suci = reg_req.mobile_identity_5gs.set_suci();
+  suci.supi_format                    = mobile_identity_5gs_t::suci_s::supi_format_type_::options::imsi;
+  suci.mcc                            = {0, 0, 1};
+  suci.mnc                            = {0, 1, 0xf};
+  suci.scheme_output                  = {0, 0, 0, 0, 0};
+
+  msg_template tmpl;
+  TESTASSERT(msg.pack(buf) == SRSASN_SUCCESS);
+  tmpl.set_reference(buf.data(), buf.size());
+  suci.scheme_output = {0xff, 0xff, 0xff, 0xff, 0xff};
+  TESTASSERT(msg.pack(buf) == SRSASN_SUCCESS);
+  int msin_field = tmpl.learn_field(buf.data(), buf.size());
+  TESTASSERT(msin_field == 0 and tmpl.field_length(msin_field) == 40 and tmpl.field_offset(msin_field) % 8 == 0);
+
+  suci.scheme_output = {0x21, 0x43, 0x65, 0x87, 0xf9};
+  TESTASSERT(msg.pack(buf) == SRSASN_SUCCESS);
+  tmpl.set_field(msin_field, 0x21436587f9);
+  TESTASSERT(buf.size() == tmpl.size() and memcmp(buf.data(), tmpl.data(), buf.size()) == 0);
+
+  // Equal encodings do not define a field
+  TESTASSERT(tmpl.learn_field(buf.data(), buf.size()) < 0);
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  srslog::init();
+
+  TESTASSERT(test_bit_fields() == SRSRAN_SUCCESS);
+  TESTASSERT(test_rrc_setup_request() == SRSRAN_SUCCESS);
+  TESTASSERT(test_nas_registration_request() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Success\n");
+  return SRSRAN_SUCCESS;
+}
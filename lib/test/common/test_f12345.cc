@@ -21,8 +21,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <vector>
 
 #include "srsran/common/liblte_security.h"
+#include "srsran/common/milenage.h"
 #include "srsran/common/security.h"
 #include "srsran/common/test_common.h"
 /*
@@ -162,6 +165,103 @@ int test_set_2()
   return SRSRAN_SUCCESS;
 }
 
+/*
+ * Milenage engine with test set 2, single evaluation, from AUTN and in a batch against the single evaluation
+ */
+int test_set_2_milenage_engine()
+{
+  uint8_t k[]    = {0x46, 0x5b, 0x5c, 0xe8, 0xb1, 0x99, 0xb4, 0x9f, 0xaa, 0x5f, 0x0a, 0x2e, 0xe2, 0x38, 0xa6, 0xbc};
+  uint8_t rand[] = {0x23, 0x55, 0x3c, 0xbe, 0x96, 0x37, 0xa8, 0x9d, 0x21, 0x8a, 0xe6, 0x4d, 0xae, 0x47, 0xbf, 0x35};
+  uint8_t sqn[]  = {0xff, 0x9b, 0xb4, 0xd0, 0xb6, 0x07};
+  uint8_t amf[]  = {0xb9, 0xb9};
+  uint8_t op[]   = {0xcd, 0xc2, 0x02, 0xd5, 0x12, 0x3e, 0x20, 0xf6, 0x2b, 0x6d, 0x67, 0x6a, 0xc7, 0x2c, 0xb3, 0x18};
+
+  uint8_t opc[]     = {0xcd, 0x63, 0xcb, 0x71, 0x95, 0x4a, 0x9f, 0x4e, 0x48, 0xa5, 0x99, 0x4e, 0x37, 0xa0, 0x2b, 0xaf};
+  uint8_t mac_a[]   = {0x4a, 0x9f, 0xfa, 0xc3, 0x54, 0xdf, 0xaf, 0xb3};
+  uint8_t mac_s[]   = {0x01, 0xcf, 0xaf, 0x9e, 0xc4, 0xe8, 0x71, 0xe9};
+  uint8_t res[]     = {0xa5, 0x42, 0x11, 0xd5, 0xe3, 0xba, 0x50, 0xbf};
+  uint8_t ck[]      = {0xb4, 0x0b, 0xa9, 0xa3, 0xc5, 0x8b, 0x2a, 0x05, 0xbb, 0xf0, 0xd9, 0x87, 0xb2, 0x1b, 0xf8, 0xcb};
+  uint8_t ik[]      = {0xf7, 0x69, 0xbc, 0xd7, 0x51, 0x04, 0x46, 0x04, 0x12, 0x76, 0x72, 0x71, 0x1c, 0x6d, 0x34, 0x41};
+  uint8_t ak[]      = {0xaa, 0x68, 0x9c, 0x64, 0x83, 0x70};
+  uint8_t ak_star[] = {0x45, 0x1e, 0x8b, 0xec, 0xa4, 0x3b};
+
+  srsran::milenage subscriber;
+  subscriber.set_k_op(k, op);
+  TESTASSERT(arrcmp(subscriber.get_opc(), opc, sizeof(opc)) == 0);
+
+  srsran::milenage_input_t in = {};
+  memcpy(in.rand, rand, sizeof(rand));
+  memcpy(in.sqn, sqn, sizeof(sqn));
+  memcpy(in.amf, amf, sizeof(amf));
+
+  srsran::milenage_vector_t v = {};
+  subscriber.compute(in, v);
+  TESTASSERT(arrcmp(v.mac_a, mac_a, sizeof(mac_a)) == 0);
+  TESTASSERT(arrcmp(v.mac_s, mac_s, sizeof(mac_s)) == 0);
+  TESTASSERT(arrcmp(v.res, res, sizeof(res)) == 0);
+  TESTASSERT(arrcmp(v.ck, ck, sizeof(ck)) == 0);
+  TESTASSERT(arrcmp(v.ik, ik, sizeof(ik)) == 0);
+  TESTASSERT(arrcmp(v.ak, ak, sizeof(ak)) == 0);
+  TESTASSERT(arrcmp(v.ak_star, ak_star, sizeof(ak_star)) == 0);
+
+  // USIM side, SQN comes back from AUTN = SQN xor AK || AMF || MAC-A
+  uint8_t autn[16];
+  for (uint32_t i = 0; i < 6; i++) {
+    autn[i] = sqn[i] ^ ak[i];
+  }
+  memcpy(&autn[6], amf, sizeof(amf));
+  memcpy(&autn[8], mac_a, sizeof(mac_a));
+
+  srsran::milenage_vector_t v_autn = {};
+  uint8_t                   sqn_o[6];
+  subscriber.compute_from_autn(rand, autn, v_autn, sqn_o);
+  TESTASSERT(arrcmp(sqn_o, sqn, sizeof(sqn)) == 0);
+  TESTASSERT(memcmp(&v_autn, &v, sizeof(v)) == 0);
+
+  // Copies held in a vector, which copies them again when growing, must keep the test set key after the source is
+  // given another key
+  srsran::milenage source;
+  source.set_k_op(k, op);
+  std::vector<srsran::milenage> copies;
+  for (uint32_t i = 0; i < 9; i++) {
+    copies.push_back(source);
+  }
+  copies[1] = copies[0];
+  source.set_k_op(op, op);
+  std::vector<const srsran::milenage*>   copy_subscribers;
+  std::vector<srsran::milenage_input_t>  copy_in(copies.size(), in);
+  std::vector<srsran::milenage_vector_t> copy_out(copies.size());
+  for (const srsran::milenage& m : copies) {
+    copy_subscribers.push_back(&m);
+  }
+  srsran::milenage::compute_batch(copy_subscribers.data(), copy_in.data(), copy_out.data(), copies.size());
+  for (const srsran::milenage_vector_t& c : copy_out) {
+    TESTASSERT(memcmp(&c, &v, sizeof(v)) == 0);
+  }
+
+  // Batch over several subscribers, not a multiple of the internal group size
+  const uint32_t            nof_vectors = 11;
+  srsran::milenage          subscribers[nof_vectors];
+  const srsran::milenage*   batch_subscribers[nof_vectors];
+  srsran::milenage_input_t  batch_in[nof_vectors];
+  srsran::milenage_vector_t batch_out[nof_vectors];
+  for (uint32_t i = 0; i < nof_vectors; i++) {
+    k[0] ^= (uint8_t)i;
+    subscribers[i].set_k_op(k, op);
+    batch_subscribers[i] = &subscribers[(i * 7) % nof_vectors];
+    batch_in[i]          = in;
+    batch_in[i].rand[3] ^= (uint8_t)i;
+  }
+  srsran::milenage::compute_batch(batch_subscribers, batch_in, batch_out, nof_vectors);
+  for (uint32_t i = 0; i < nof_vectors; i++) {
+    srsran::milenage_vector_t expected = {};
+    batch_subscribers[i]->compute(batch_in[i], expected);
+    TESTASSERT(memcmp(&batch_out[i], &expected, sizeof(expected)) == 0);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 /*
   Own test sets
 */
@@ -223,6 +323,7 @@ int main(int argc, char* argv[])
   srslog::init();
 
   TESTASSERT(test_set_2() == SRSRAN_SUCCESS);
+  TESTASSERT(test_set_2_milenage_engine() == SRSRAN_SUCCESS);
   TESTASSERT(test_set_xor_own_set_1() == SRSRAN_SUCCESS);
   return SRSRAN_SUCCESS;
 }
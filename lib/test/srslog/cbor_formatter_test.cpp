@@ -0,0 +1,235 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "src/srslog/formatters/cbor_formatter.h"
+#include "src/srslog/formatters/json_formatter.h"
+#include "srsran/srslog/detail/log_entry_metadata.h"
+#include "testing_helpers.h"
+#include <numeric>
+
+using namespace srslog;
+
+/// Helper to build a log entry.
+static detail::log_entry_metadata build_log_entry_metadata(fmt::dynamic_format_arg_store<fmt::printf_context>* store)
+{
+  // Create a time point 50000us from epoch.
+  using tp_ty = std::chrono::time_point<std::chrono::high_resolution_clock>;
+  tp_ty tp(std::chrono::microseconds(50000));
+
+  if (store) {
+    store->push_back(88);
+  }
+
+  return {tp, {10, true}, "Text %d", store, "ABC", 'Z'};
+}
+
+/// Decodes the input buffer into JSON text.
+static std::string decode(const fmt::memory_buffer& buffer)
+{
+  fmt::memory_buffer out;
+  if (!cbor_to_json(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size(), out)) {
+    return "decoding error";
+  }
+  return fmt::to_string(out);
+}
+
+namespace {
+DECLARE_METRIC("SNR", snr_t, float, "dB");
+DECLARE_METRIC("PWR", pwr_t, int, "dBm");
+DECLARE_METRIC("CenterFreq", cfreq_t, unsigned, "MHz");
+DECLARE_METRIC("Timestamp", tstamp_t, double, "s");
+DECLARE_METRIC("Enabled", enabled_t, bool, "");
+DECLARE_METRIC_SET("RF", myset1, snr_t, pwr_t, cfreq_t, tstamp_t, enabled_t);
+
+DECLARE_METRIC("Throughput", thr_t, float, "MB/s");
+DECLARE_METRIC("Address", ip_addr_t, std::string, "");
+DECLARE_METRIC_SET("Network", myset2, thr_t, ip_addr_t);
+
+using basic_ctx_t = srslog::build_context_type<myset1, myset2>;
+
+DECLARE_METRIC("bearer_id", bearer_id_t, unsigned, "");
+DECLARE_METRIC("qci", qci_t, unsigned, "");
+DECLARE_METRIC_SET("bearer_container", bearer_set, bearer_id_t, qci_t);
+DECLARE_METRIC_LIST("bearer_list", bearer_list_t, std::vector<bearer_set>);
+DECLARE_METRIC("ue_rnti", ue_rnti_t, unsigned, "");
+DECLARE_METRIC_SET("ue_container", ue_set, ue_rnti_t, bearer_list_t);
+DECLARE_METRIC_LIST("ue_list", ue_list_t, std::vector<ue_set>);
+DECLARE_METRIC_LIST("empty_list", empty_list_t, std::vector<bearer_set>);
+
+using complex_ctx_t = srslog::build_context_type<ue_list_t, empty_list_t>;
+} // namespace
+
+static void fill_basic_context(basic_ctx_t& ctx)
+{
+  ctx.get<myset1>().write<snr_t>(-55.1);
+  ctx.get<myset1>().write<pwr_t>(-10);
+  ctx.get<myset1>().write<cfreq_t>(1500);
+  ctx.get<myset1>().write<tstamp_t>(1234567.891);
+  ctx.get<myset1>().write<enabled_t>(true);
+  ctx.get<myset2>().write<thr_t>(150.01);
+  ctx.get<myset2>().write<ip_addr_t>("192.168.1.0");
+}
+
+static bool when_log_entry_with_hex_dump_is_decoded_then_json_output_is_reproduced()
+{
+  fmt::dynamic_format_arg_store<fmt::printf_context> store;
+  auto                                               entry = build_log_entry_metadata(&store);
+  entry.hex_dump.resize(12);
+  std::iota(entry.hex_dump.begin(), entry.hex_dump.end(), 0);
+  auto json_entry = entry;
+
+  fmt::memory_buffer buffer;
+  cbor_formatter{}.format(std::move(entry), buffer);
+  fmt::memory_buffer expected;
+  json_formatter{}.format(std::move(json_entry), expected);
+
+  ASSERT_EQ(decode(buffer), fmt::to_string(expected));
+
+  return true;
+}
+
+static bool when_basic_context_is_decoded_then_json_output_is_reproduced()
+{
+  basic_ctx_t ctx("UL Context");
+  fill_basic_context(ctx);
+
+  fmt::dynamic_format_arg_store<fmt::printf_context> store;
+  fmt::memory_buffer                                 buffer;
+  cbor_formatter{}.format_ctx(ctx, build_log_entry_metadata(&store), buffer);
+  fmt::dynamic_format_arg_store<fmt::printf_context> json_store;
+  fmt::memory_buffer                                 expected;
+  json_formatter{}.format_ctx(ctx, build_log_entry_metadata(&json_store), expected);
+
+  ASSERT_EQ(decode(buffer), fmt::to_string(expected));
+
+  return true;
+}
+
+static bool when_complex_context_is_decoded_then_json_output_is_reproduced()
+{
+  complex_ctx_t ctx("UL Context");
+  auto          entry = build_log_entry_metadata(nullptr);
+  entry.fmtstring     = nullptr;
+
+  ctx.get<ue_list_t>().emplace_back();
+  ctx.get<ue_list_t>().emplace_back();
+  ctx.at<ue_list_t>(0).write<ue_rnti_t>(0x4601);
+  ctx.at<ue_list_t>(1).write<ue_rnti_t>(0x4602);
+  ctx.at<ue_list_t>(0).get<bearer_list_t>().emplace_back();
+  ctx.at<ue_list_t>(1).get<bearer_list_t>().emplace_back();
+  ctx.at<ue_list_t>(1).get<bearer_list_t>().emplace_back();
+  ctx.at<ue_list_t>(1).at<bearer_list_t>(1).write<bearer_id_t>(4);
+  ctx.at<ue_list_t>(1).at<bearer_list_t>(1).write<qci_t>(9);
+
+  auto               json_entry = entry;
+  fmt::memory_buffer buffer;
+  cbor_formatter{}.format_ctx(ctx, std::move(entry), buffer);
+  fmt::memory_buffer expected;
+  json_formatter{}.format_ctx(ctx, std::move(json_entry), expected);
+
+  ASSERT_EQ(decode(buffer), fmt::to_string(expected));
+
+  return true;
+}
+
+static bool when_keys_repeat_then_dictionary_indexes_are_used()
+{
+  basic_ctx_t ctx("UL Context");
+  fill_basic_context(ctx);
+  auto entry      = build_log_entry_metadata(nullptr);
+  entry.fmtstring = nullptr;
+
+  cbor_formatter     formatter;
+  fmt::memory_buffer first;
+  formatter.format_ctx(ctx, detail::log_entry_metadata(entry), first);
+  fmt::memory_buffer second;
+  formatter.format_ctx(ctx, detail::log_entry_metadata(entry), second);
+
+  // Map of 2 sets, first key as text string "RF" after the restart tag.
+  ASSERT_EQ(first.size() > 5, true);
+  ASSERT_EQ(std::string(first.data(), 6), std::string("\xd9\xd9\xf7\xa2\x62RF", 6));
+  // The second entry refers to "RF" by its index.
+  ASSERT_EQ(std::string(second.data(), 3), std::string("\xa2\x00\xa5", 3));
+  // Besides the tag, each of the 9 text keys shrinks to a one byte index.
+  ASSERT_EQ(first.size() - second.size(), 3 + 2 + 3 + 3 + 10 + 9 + 7 + 7 + 10 + 7);
+
+  fmt::memory_buffer stream;
+  stream.append(first.data(), first.data() + first.size());
+  stream.append(second.data(), second.data() + second.size());
+  fmt::memory_buffer expected;
+  json_formatter{}.format_ctx(ctx, detail::log_entry_metadata(entry), expected);
+  ASSERT_EQ(decode(stream), fmt::to_string(expected) + fmt::to_string(expected));
+
+  return true;
+}
+
+static bool when_stream_is_joined_midway_then_entries_are_dropped_until_dictionary_restart()
+{
+  basic_ctx_t ctx("UL Context");
+  fill_basic_context(ctx);
+  auto entry      = build_log_entry_metadata(nullptr);
+  entry.fmtstring = nullptr;
+
+  cbor_formatter     formatter;
+  fmt::memory_buffer stream;
+  for (unsigned i = 0; i != cbor_formatter::dict_refresh_period + 2; ++i) {
+    fmt::memory_buffer buffer;
+    formatter.format_ctx(ctx, detail::log_entry_metadata(entry), buffer);
+    // Skip the first entry, as a reader opening a rotated file would.
+    if (i != 0) {
+      stream.append(buffer.data(), buffer.data() + buffer.size());
+    }
+  }
+
+  fmt::memory_buffer expected;
+  json_formatter{}.format_ctx(ctx, detail::log_entry_metadata(entry), expected);
+  ASSERT_EQ(decode(stream), fmt::to_string(expected) + fmt::to_string(expected));
+
+  return true;
+}
+
+static bool when_stream_is_truncated_then_decoding_fails()
+{
+  basic_ctx_t ctx("UL Context");
+  fill_basic_context(ctx);
+  auto entry      = build_log_entry_metadata(nullptr);
+  entry.fmtstring = nullptr;
+
+  fmt::memory_buffer buffer;
+  cbor_formatter{}.format_ctx(ctx, std::move(entry), buffer);
+
+  fmt::memory_buffer out;
+  ASSERT_EQ(cbor_to_json(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size() - 1, out), false);
+
+  return true;
+}
+
+int main()
+{
+  TEST_FUNCTION(when_log_entry_with_hex_dump_is_decoded_then_json_output_is_reproduced);
+  TEST_FUNCTION(when_basic_context_is_decoded_then_json_output_is_reproduced);
+  TEST_FUNCTION(when_complex_context_is_decoded_then_json_output_is_reproduced);
+  TEST_FUNCTION(when_keys_repeat_then_dictionary_indexes_are_used);
+  TEST_FUNCTION(when_stream_is_joined_midway_then_entries_are_dropped_until_dictionary_restart);
+  TEST_FUNCTION(when_stream_is_truncated_then_decoding_fails);
+
+  return 0;
+}
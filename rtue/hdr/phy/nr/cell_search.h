@@ -33,7 +33,8 @@ class cell_search
 public:
   struct args_t {
     double                      max_srate_hz;
-    srsran_subcarrier_spacing_t ssb_min_scs = srsran_subcarrier_spacing_15kHz;
+    srsran_subcarrier_spacing_t ssb_min_scs       = srsran_subcarrier_spacing_15kHz;
+    float                       pss_prescreen_thr = 0.0f; ///< PSS pre-screen threshold (0 means disabled)
   };
 
   struct cfg_t {
@@ -58,6 +59,8 @@ public:
   bool  start(const cfg_t& cfg);
   ret_t run_slot(const cf_t* buffer, uint32_t slot_sz);
 
+  srsran_ssb_prescreen_metrics_t get_prescreen_metrics();
+
 private:
   srslog::basic_logger&        logger;
   srsran_ssb_t                 ssb    = {};
@@ -22,6 +22,7 @@
 #define SRSRAN_INTRA_MEASURE_NR_H
 
 #include "intra_measure_base.h"
+#include <array>
 #include <srsran/srsran.h>
 
 namespace srsue {
@@ -43,6 +44,9 @@ public:
     double                      max_srate_hz      = 61.44e6;
     srsran_subcarrier_spacing_t min_scs           = srsran_subcarrier_spacing_15kHz;
     float                       thr_snr_db        = 5.0f; ///< minimum SNR threshold
+    uint32_t                    search_period     = 8;    ///< Measurements between full searches while tracking cells
+    float                       filter_alpha      = 0.5f; ///< Tracked cell RSRP filter coefficient, 1 disables it
+    uint32_t                    max_nof_misses    = 3;    ///< Missed measurements before a found cell is dropped
   };
 
   /**
@@ -120,11 +124,61 @@ private:
    */
   bool measure_rat(const measure_context_t& context, std::vector<cf_t>& buffer, float rx_gain_offset) override;
 
+  static constexpr uint32_t max_tracked_cells = 32;
+
+  /**
+   * @brief Neighbour cells measured at their known SSB position. Kept as structure of arrays, so that the filtering of
+   * all cells is done in one vector operation
+   */
+  struct tracked_cells_t {
+    uint32_t                                nof_cells = 0;
+    std::array<uint32_t, max_tracked_cells> pci;
+    std::array<uint32_t, max_tracked_cells> t_offset;   ///< SSB start within the measurement buffer in samples
+    std::array<uint32_t, max_tracked_cells> nof_misses; ///< Consecutive measurements below the SNR threshold
+    std::array<bool, max_tracked_cells>     known;      ///< Requested by higher layers, never dropped
+    std::array<bool, max_tracked_cells>     measured;   ///< Measured in the current period
+    std::array<bool, max_tracked_cells>     valid;      ///< Measured above the SNR threshold in the current period
+    std::array<float, max_tracked_cells>    rsrp_dB;
+    std::array<float, max_tracked_cells>    rsrp_filt_dB;
+    std::array<float, max_tracked_cells>    alpha; ///< Filter coefficient of the current period, 0 keeps the filter
+    std::array<float, max_tracked_cells>    cfo_hz;
+    std::array<float, max_tracked_cells>    tmp; ///< Filter scratch
+
+    int  find(uint32_t pci_) const;
+    int  add(uint32_t pci_, uint32_t t_offset_);
+    void remove_lost(uint32_t max_nof_misses);
+  };
+
+  /**
+   * @brief Searches the whole buffer for the strongest SSB and starts tracking it if it is a neighbour cell
+   * @return True if no error happen, otherwise false
+   */
+  bool search(const cf_t* buffer, uint32_t nof_samples);
+
+  /**
+   * @brief Stores a measurement of a tracked cell and follows its timing
+   */
+  void set_meas(uint32_t idx, const srsran_csi_trs_measurements_t& meas);
+
   srslog::basic_logger& logger;
   uint32_t              cc_idx           = 0;
   uint32_t              current_arfcn    = 0;
   float                 thr_snr_db       = 5.0f;
   int                   serving_cell_pci = -1;
+  double                srate_hz         = 0.0;
+
+  /// Neighbour tracking
+  uint32_t        search_period  = 8;
+  float           filter_alpha   = 0.5f;
+  uint32_t        max_nof_misses = 3;
+  uint32_t        search_count   = 0;  ///< Measurements since the last full search
+  int             ref_t_offset   = -1; ///< SSB position of the last detected cell, assumed for known PCIs
+  tracked_cells_t cells          = {};
+
+  /// Cells measured at a common SSB position
+  std::array<uint32_t, max_tracked_cells>                      meas_idx = {};
+  std::array<uint32_t, max_tracked_cells>                      meas_pci = {};
+  std::array<srsran_csi_trs_measurements_t, max_tracked_cells> meas_buf = {};
 
   /// Performance
   uint64_t perf_count_us      = 0; ///< Counts execution time in microseconds
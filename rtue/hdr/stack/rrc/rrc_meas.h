@@ -27,8 +27,10 @@
 #include "srsran/interfaces/ue_interfaces.h"
 #include "rtue/hdr/stack/rrc/rrc.h"
 
+#include <array>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace srsue {
 
@@ -145,36 +147,78 @@ private:
     void reportConfig_addmod_interrat(const report_cfg_to_add_mod_s& l);
     bool reportConfig_addmod_to_reportConfigList(const report_cfg_to_add_mod_s& l);
 
-    void eval_triggers_eutra(uint32_t            meas_id,
-                             report_cfg_eutra_s& report_cfg,
-                             meas_obj_eutra_s&   meas_obj,
-                             meas_cell_eutra*    serv_cell,
-                             float               Ofs,
-                             float               Ocs);
-    void report_triggers_eutra(uint32_t meas_id, report_cfg_eutra_s& report_cfg, meas_obj_eutra_s& meas_obj);
-    void report_triggers_eutra_check_new(int32_t meas_id, report_cfg_eutra_s& report_cfg, meas_obj_eutra_s& meas_obj);
-    void report_triggers_eutra_check_leaving(int32_t meas_id, report_cfg_eutra_s& report_cfg);
-    void report_triggers_eutra_removing_trigger(int32_t meas_id);
-    void eval_triggers_interrat_nr(uint32_t meas_id, report_cfg_inter_rat_s& report_cfg, meas_obj_nr_r15_s& meas_obj);
-    void report_triggers_interrat_nr(uint32_t meas_id, report_cfg_inter_rat_s& report_cfg, meas_obj_nr_r15_s& meas_obj);
-    void report_triggers_interrat_check_new(int32_t                 meas_id,
-                                            report_cfg_inter_rat_s& report_cfg,
-                                            meas_obj_nr_r15_s&      meas_obj);
-    void report_triggers_interrat_check_leaving(int32_t meas_id, report_cfg_inter_rat_s& report_cfg);
-    void report_triggers_interrat_removing_trigger(int32_t meas_id);
+    // Maximum measId, see maxMeasId in TS 36.331
+    static const uint32_t max_meas_id = 32;
 
-    class cell_trigger_state
+    typedef enum { event_none = 0, event_a1, event_a2, event_a3, event_a4, event_a5, event_b1_nr } event_t;
+
+    // A measId of measIdList with the parameters of its event resolved, rebuilt every time the configuration changes
+    struct meas_id_cfg_t {
+      uint32_t                           meas_id         = 0;
+      report_cfg_to_add_mod_s*           report_cfg      = nullptr;
+      meas_obj_to_add_mod_s*             meas_obj        = nullptr;
+      event_t                            event           = event_none;
+      uint32_t                           carrier_freq    = 0;
+      bool                               is_rsrp         = true;
+      bool                               report_on_leave = false;
+      uint32_t                           time_to_trigger = 0;
+      float                              hyst            = 0;
+      float                              thresh1         = 0;  // A1, A2, A4 and B1 threshold, A5 threshold1
+      float                              thresh2         = 0;  // A5 threshold2
+      float                              offset          = 0;  // A3 offset
+      float                              ofn             = 0;
+      std::array<int8_t, SRSRAN_NUM_PCI> ocn             = {}; // cellIndividualOffset indexed by PCI
+    };
+
+    // Event counters of the cells of one measId in SoA form, sorted by PCI
+    class cell_trigger_list
     {
     public:
-      void event_condition(const bool enter, const bool exit);
-      bool is_enter_equal(const uint32_t nof_tti);
-      bool is_exit_equal(const uint32_t nof_tti);
+      void     clear();
+      uint32_t size() const { return pci.size(); }
+      int32_t  find(uint32_t pci_) const;
+      void     begin_eval();
+      void     set_meas(uint32_t pci_, float value);
+      void     event_condition(float ref, float hyst, bool enter_allowed, bool exit_allowed);
+      bool     is_enter_equal(uint32_t idx, uint32_t nof_tti) const { return nof_tti < nof_tti_enter[idx]; }
+      bool     is_exit_equal(uint32_t idx, uint32_t nof_tti) const { return nof_tti < nof_tti_exit[idx]; }
 
-    private:
-      uint32_t nof_tti_enter = 0;
-      uint32_t nof_tti_exit  = 0;
+      std::vector<uint32_t> pci;
+      std::vector<uint32_t> nof_tti_enter;
+      std::vector<uint32_t> nof_tti_exit;
+      std::vector<float>    meas;     // measurement of the current evaluation, with offsets applied
+      std::vector<uint8_t>  measured; // cell measured in the current evaluation
+      std::vector<uint8_t>  entering;
+      std::vector<uint8_t>  leaving;
     };
 
+    // L3 filtered measurements of the neighbour cells, gathered once per evaluation
+    struct cell_meas_list_t {
+      std::vector<uint32_t> earfcn;
+      std::vector<uint32_t> pci;
+      std::vector<float>    rsrp;
+      std::vector<float>    rsrq;
+
+      void clear();
+      void push_back(uint32_t earfcn_, uint32_t pci_, float rsrp_, float rsrq_);
+    };
+
+    void compile_meas_ids();
+    void compile_event_eutra(meas_id_cfg_t& m);
+    void compile_event_interrat_nr(meas_id_cfg_t& m);
+    void gather_neighbour_meas();
+
+    void eval_triggers_eutra(const meas_id_cfg_t& m, meas_cell_eutra* serv_cell, float Ofs, float Ocs);
+    void report_triggers_eutra(const meas_id_cfg_t& m);
+    void report_triggers_eutra_check_new(const meas_id_cfg_t& m);
+    void report_triggers_eutra_check_leaving(const meas_id_cfg_t& m);
+    void report_triggers_eutra_removing_trigger(int32_t meas_id);
+    void eval_triggers_interrat_nr(const meas_id_cfg_t& m);
+    void report_triggers_interrat_nr(const meas_id_cfg_t& m);
+    void report_triggers_interrat_check_new(const meas_id_cfg_t& m);
+    void report_triggers_interrat_check_leaving(const meas_id_cfg_t& m);
+    void report_triggers_interrat_removing_trigger(int32_t meas_id);
+
     // varMeasConfig data
     std::map<uint32_t, meas_id_to_add_mod_s>    measIdList;       // Uses MeasId as key
     std::map<uint32_t, meas_obj_to_add_mod_s>   measObjectsList;  // Uses MeasObjectId as key
@@ -183,11 +227,15 @@ private:
     phy_quant_t filter_a = {1.0, 1.0}; // disable filtering until quantityConfig is received (see Sec. 5.5.3.2 Note 2)
     float       s_measure_value = 0.0;
 
-    // trigger counters. First key is measId, second key is cell id (pci)
-    // It is safe to use [] operator in this double-map because all members are uint32_t
-    std::map<uint32_t, std::map<uint32_t, cell_trigger_state> > trigger_state;
+    // measIdList compiled in measId order, evaluated on every TTI instead of the maps above
+    std::vector<meas_id_cfg_t> meas_ids;
+
+    // trigger counters, indexed by measId
+    std::array<cell_trigger_list, max_meas_id + 1> trigger_state;
+    std::array<cell_trigger_list, max_meas_id + 1> trigger_state_nr;
 
-    std::map<uint32_t, std::map<uint32_t, cell_trigger_state> > trigger_state_nr;
+    cell_meas_list_t neighbours;
+    cell_meas_list_t neighbours_nr;
 
     var_meas_report_list* meas_report = nullptr;
     srslog::basic_logger& logger;
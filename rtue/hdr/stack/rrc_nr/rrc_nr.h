@@ -27,6 +27,7 @@
 #include "rrc_nr_metrics.h"
 #include "rtue/hdr/stack/upper/gw.h"
 #include "srsran/adt/circular_map.h"
+#include "srsran/asn1/msg_template.h"
 #include "srsran/asn1/rrc_nr.h"
 #include "srsran/asn1/rrc_nr_utils.h"
 #include "srsran/common/block_queue.h"
@@ -150,6 +151,7 @@ private:
   int  send_ue_capability_info(const asn1::rrc_nr::ue_cap_enquiry_s& msg);
   void send_ul_info_transfer(srsran::unique_byte_buffer_t nas_msg);
   void send_ul_ccch_msg(const asn1::rrc_nr::ul_ccch_msg_s& msg);
+  void send_ul_ccch_pdu(const asn1::rrc_nr::ul_ccch_msg_s& msg, srsran::unique_byte_buffer_t pdu);
   void send_ul_dcch_msg(uint32_t lcid, const asn1::rrc_nr::ul_dcch_msg_s& msg);
   void send_security_mode_complete();
 
@@ -163,6 +165,7 @@ private:
   void handle_security_mode_command(const asn1::rrc_nr::security_mode_cmd_s& smc);
   void handle_rrc_release(const asn1::rrc_nr::rrc_release_s& rrc_release);
   void generate_as_keys();
+  int  make_setup_request_template();
 
   srsran::task_sched_handle task_sched;
   struct cmd_msg_t {
@@ -177,6 +180,11 @@ private:
 
   srsran_random_t random_gen;
 
+  // Packed RRCSetupRequest, only the UE identity and the establishment cause are patched per request
+  asn1::msg_template setup_request_tmpl;
+  int                setup_request_ue_id_field = -1;
+  int                setup_request_cause_field = -1;
+
   // PHY config
   srsran::phy_cfg_nr_t phy_cfg = {};
 
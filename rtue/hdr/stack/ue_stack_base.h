@@ -76,6 +76,7 @@ typedef struct {
   uint32_t         sync_queue_size; // Max allowed difference between PHY and Stack clocks (in TTI)
   bool             have_tti_time_stats;
   bool             sa_mode;
+  uint32_t         nof_up_workers; // Threads for LTE DRB processing, 0 runs all bearers in the stack thread
 } stack_args_t;
 
 class ue_stack_base
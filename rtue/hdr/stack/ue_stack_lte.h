@@ -43,6 +43,7 @@
 #include "srsran/upper/pdcp.h"
 #include "rtue/hdr/ue_metrics_interface.h"
 #include "ue_stack_base.h"
+#include "ue_up_shards.h"
 #include "upper/nas.h"
 #include "upper/nas_5g.h"
 #include "upper/sdap.h"
@@ -265,6 +266,9 @@ private:
 
   ue_bearer_manager bearers; // helper to manage mapping between EPS and radio bearers
 
+  // Per-bearer RLC/PDCP workers, only started if args.nof_up_workers > 0
+  ue_up_shards up_shards;
+
   // Metrics helper
   std::atomic<uint32_t> ul_dropped_sdus{0};
 };
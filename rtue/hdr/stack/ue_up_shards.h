@@ -0,0 +1,127 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSUE_UE_UP_SHARDS_H
+#define SRSUE_UE_UP_SHARDS_H
+
+#include "srsran/adt/circular_buffer.h"
+#include "srsran/adt/move_callback.h"
+#include "srsran/common/buffer_pool.h"
+#include "srsran/common/threads.h"
+#include "srsran/interfaces/ue_rlc_interfaces.h"
+#include "srsran/srslog/srslog.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <vector>
+
+namespace srsue {
+
+/**
+ * @brief User-plane shards of the LTE stack.
+ *
+ * Data radio bearers are spread over a fixed set of worker threads, LCID modulo the number of workers, so that the
+ * RLC/PDCP processing of different bearers runs in parallel and the order within a bearer is kept. DL PDUs are
+ * intercepted between MAC and RLC, which is why the class implements the RLC interface towards MAC. SRBs, broadcast and
+ * MCH PDUs and all MAC queries are forwarded to RLC on the calling thread.
+ *
+ * Shard tasks hold the control lock shared, the stack thread holds it exclusively while running its tasks and timers.
+ * Bearer (re)configuration, reestablishment and timer expiries thus never overlap with user-plane processing. The stack
+ * thread is given preference over the shards, with the glibc rwlock kind where available and with a writer gate
+ * otherwise.
+ */
+class ue_up_shards final : public rlc_interface_mac
+{
+public:
+  ue_up_shards();
+  ~ue_up_shards();
+
+  void init(uint32_t nof_workers, int prio, rlc_interface_mac* rlc_);
+  void stop();
+
+  bool enabled() const { return not shards.empty(); }
+
+  /// Whether the bearer is handled by a shard.
+  bool is_sharded(uint32_t lcid) const;
+
+  /// Runs the task in the shard of the given bearer. Returns false if the queue is full.
+  bool push(uint32_t lcid, srsran::move_task_t task);
+
+  // Exclusive control lock, taken by the stack thread
+  void lock();
+  void unlock();
+
+  // rlc_interface_mac
+  bool     has_data_locked(const uint32_t lcid) final { return rlc->has_data_locked(lcid); }
+  uint32_t get_buffer_state(const uint32_t lcid) final { return rlc->get_buffer_state(lcid); }
+  uint32_t read_pdu(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) final
+  {
+    return rlc->read_pdu(lcid, payload, nof_bytes);
+  }
+  void write_pdu(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) final;
+  void write_pdu_bcch_bch(srsran::unique_byte_buffer_t payload) final { rlc->write_pdu_bcch_bch(std::move(payload)); }
+  void write_pdu_bcch_dlsch(uint8_t* payload, uint32_t nof_bytes) final
+  {
+    rlc->write_pdu_bcch_dlsch(payload, nof_bytes);
+  }
+  void write_pdu_pcch(srsran::unique_byte_buffer_t payload) final { rlc->write_pdu_pcch(std::move(payload)); }
+  void write_pdu_mch(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) final
+  {
+    rlc->write_pdu_mch(lcid, payload, nof_bytes);
+  }
+
+private:
+  static const uint32_t SHARD_QUEUE_SIZE = 4096;
+
+  class shard_worker final : public srsran::thread
+  {
+  public:
+    shard_worker(ue_up_shards* parent_, uint32_t id);
+
+    void stop();
+
+    srsran::dyn_blocking_queue<srsran::move_task_t> queue;
+
+  private:
+    void run_thread() final;
+
+    ue_up_shards*     parent  = nullptr;
+    std::atomic<bool> running = {true};
+  };
+
+  // Shared control lock, taken by the shard tasks
+  void lock_shared();
+  void unlock_shared();
+
+  srslog::basic_logger&                      logger;
+  rlc_interface_mac*                         rlc = nullptr;
+  std::vector<std::unique_ptr<shard_worker>> shards;
+  pthread_rwlock_t                           control_lock;
+#ifndef __GLIBC__
+  // Held by a pending writer, so that new readers queue behind it
+  std::mutex writer_gate;
+#endif
+};
+
+} // namespace srsue
+
+#endif // SRSUE_UE_UP_SHARDS_H
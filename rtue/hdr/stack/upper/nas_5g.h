@@ -23,6 +23,7 @@
 #define SRSUE_NAS_5G_H
 
 #include "nas_base.h"
+#include "srsran/asn1/msg_template.h"
 #include "srsran/asn1/nas_5g_ies.h"
 #include "srsran/asn1/nas_5g_msg.h"
 #include "srsran/common/buffer_pool.h"
@@ -40,6 +41,8 @@
 #include "rtue/hdr/stack/upper/nas_5gmm_state.h"
 #include "rtue/hdr/stack/upper/nas_config.h"
 
+#include <chrono>
+
 using srsran::byte_buffer_t;
 
 #define MAX_PDU_SESSIONS 15
@@ -85,6 +88,9 @@ public:
   // Metrics getter
   void get_metrics(nas_5g_metrics_t& metrics);
 
+  // Adds offset to the BCD MSIN of a SUCI scheme output, wrapping around at its number of digits
+  static void storm_offset_msin(std::vector<uint8_t>& scheme_output, uint64_t offset);
+
 private:
   rrc_nr_interface_nas_5g* rrc_nr = nullptr;
   usim_interface_nas*      usim   = nullptr;
@@ -119,6 +125,8 @@ private:
   srsran::timer_handler::unique_timer t3511; // started when registration failure due to lower layer failure
   srsran::timer_handler::unique_timer t3521; // started when detach request is sent
   srsran::timer_handler::unique_timer reregistration_timer; // started to trigger delayed re-attach
+  srsran::timer_handler::unique_timer storm_pdu_guard;      // storm only, started with PDU SESSION ESTABLISHMENT REQUEST
+  srsran::timer_handler::unique_timer storm_dereg_guard;    // storm only, started with DEREGISTRATION REQUEST
 
   // Values according to TS 24.501 Sec 10.2
   const uint32_t t3502_duration_ms                = 12 * 60 * 1000; // 12m
@@ -126,6 +134,8 @@ private:
   const uint32_t t3511_duration_ms                = 10 * 1000;      // 10s
   const uint32_t t3521_duration_ms                = 15 * 1000;      // 15s
   const uint32_t reregistration_timer_duration_ms = 2 * 1000;       // 2s (arbitrarily chosen to delay re-attach)
+  const uint32_t storm_pdu_guard_duration_ms      = 16 * 1000;      // 16s (T3580)
+  const uint32_t storm_dereg_guard_duration_ms    = 15 * 1000;      // 15s (T3521)
 
   srsran::proc_manager_list_t callbacks;
 
@@ -207,6 +217,37 @@ private:
   };
 
   std::array<pdu_session_t, MAX_PDU_SESSIONS> pdu_sessions;
+
+  // Procedure latency tracking
+  class proc_latency_t
+  {
+  public:
+    void                         start();
+    void                         stop(bool success);
+    bool                         is_pending() const { return pending; }
+    const nas_5g_proc_metrics_t& get_metrics() const { return metrics; }
+
+  private:
+    bool                                  pending = false;
+    std::chrono::steady_clock::time_point t_start;
+    nas_5g_proc_metrics_t                 metrics = {};
+  };
+
+  proc_latency_t registration_latency;
+  proc_latency_t pdu_session_latency;
+  proc_latency_t deregistration_latency;
+
+  // Registration storm, each cycle uses the USIM MSIN plus storm_cycle * storm_id_stride as identity
+  uint32_t storm_cycle = 0;
+  bool     storm_enabled() const { return cfg.storm_cycles > 0; }
+  uint64_t storm_msin_offset() const { return (uint64_t)storm_cycle * cfg.storm_id_stride; }
+  void     storm_next_cycle();
+  int      storm_write_registration_request(srsran::byte_buffer_t& pdu);
+
+  // Packed Registration Request of the storm, only the MSIN is patched per cycle
+  asn1::msg_template storm_reg_req_tmpl;
+  int                storm_msin_field = -1;
+  void     handle_pdu_session_est_result(bool success);
 };
 } // namespace srsue
 #endif
\ No newline at end of file
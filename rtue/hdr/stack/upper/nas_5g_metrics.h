@@ -26,9 +26,23 @@
 
 namespace srsue {
 
+/// Outcome counters and latency histogram of a NAS procedure. Bucket 0 counts completions below 2 ms, bucket i > 0
+/// those in [2^i, 2^(i+1)) ms, the last bucket also holds everything above.
+struct nas_5g_proc_metrics_t {
+  static const uint32_t nof_buckets = 16;
+  uint32_t              nof_started;
+  uint32_t              nof_completed;
+  uint32_t              nof_failed;
+  uint32_t              latency_hist[nof_buckets];
+};
+
 struct nas_5g_metrics_t {
   uint32_t              nof_active_pdu_sessions;
   mm5g_state_t::state_t state;
+  uint32_t              storm_cycle;
+  nas_5g_proc_metrics_t registration;
+  nas_5g_proc_metrics_t pdu_session;
+  nas_5g_proc_metrics_t deregistration;
 };
 
 } // namespace srsue
@@ -71,6 +71,10 @@ public:
   bool enable_slicing;
   int  nssai_sst;
   int  nssai_sd;
+  // registration storm: cycles of registration, PDU session and deregistration, each with a new identity
+  uint32_t storm_cycles    = 0;
+  uint32_t storm_gap_ms    = 100;
+  uint32_t storm_id_stride = 1;
 };
 
 } // namespace srsue
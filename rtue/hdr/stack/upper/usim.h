@@ -23,6 +23,7 @@
 #define SRSUE_USIM_H
 
 #include "srsran/common/common.h"
+#include "srsran/common/milenage.h"
 #include "srsran/common/security.h"
 #include "usim_base.h"
 #include <string>
@@ -69,6 +70,9 @@ private:
   uint8_t     opc[16]   = {};
   uint8_t     k[16]     = {};
 
+  // Milenage key schedule of K and OPc
+  srsran::milenage milenage_keys;
+
   // Security variables
   uint8_t mac[8]   = {};
   uint8_t autn[16] = {};
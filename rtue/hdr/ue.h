@@ -35,6 +35,7 @@
 #include "phy/ue_phy_base.h"
 #include "srsran/common/buffer_pool.h"
 #include "srsran/radio/radio.h"
+#include "srsran/radio/radio_shared.h"
 #include "srsran/srslog/srslog.h"
 #include "srsran/system/sys_metrics_processor.h"
 #include "stack/ue_stack_base.h"
@@ -72,6 +73,7 @@ typedef struct {
   std::string metrics_csv_filename;
   bool        metrics_json_enable;
   std::string metrics_json_filename;
+  std::string metrics_json_format;
   bool        metrics_influxdb_enable;
   std::string metrics_influxdb_url;
   uint32_t    metrics_influxdb_port;
@@ -82,6 +84,8 @@ typedef struct {
   bool        tracing_enable;
   std::string tracing_filename;
   std::size_t tracing_buffcapacity;
+  uint32_t    nof_ues;
+  uint32_t    tx_lead_ms;
 } general_args_t;
 
 typedef struct {
@@ -107,7 +111,7 @@ public:
   ue();
   ~ue();
 
-  int  init(const all_args_t& args_);
+  int  init(const all_args_t& args_, srsran::radio_shared::port* shared_port = nullptr);
   void stop();
   bool switch_on();
   bool switch_off();
@@ -123,6 +127,7 @@ private:
   std::unique_ptr<ue_phy_base>        phy;
   std::unique_ptr<ue_phy_base>        dummy_phy;
   std::unique_ptr<srsran::radio_base> radio;
+  srsran::radio_base*                 radio_if = nullptr;
   std::unique_ptr<ue_stack_base>      stack;
   std::unique_ptr<gw>                 gw_inst;
 
@@ -33,6 +33,7 @@
 #include "stack/rrc/rrc_metrics.h"
 #include "stack/rrc_nr/rrc_nr_metrics.h"
 #include "stack/upper/gw_metrics.h"
+#include "stack/upper/nas_5g_metrics.h"
 #include "stack/upper/nas_metrics.h"
 
 namespace srsue {
@@ -43,6 +44,7 @@ typedef struct {
   mac_metrics_t         mac_nr[SRSRAN_MAX_CARRIERS];
   srsran::rlc_metrics_t rlc;
   nas_metrics_t         nas;
+  nas_5g_metrics_t      nas_5g;
   rrc_metrics_t         rrc;
   rrc_nr_metrics_t      rrc_nr;
 } stack_metrics_t;
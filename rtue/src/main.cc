@@ -47,6 +47,7 @@
 #include <string>
 #include <sys/mman.h>
 #include <unistd.h>
+#include <vector>
 
 extern std::atomic<bool> simulate_rlf;
 
@@ -85,6 +86,8 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
   common.add_options()
     ("ue.radio", bpo::value<string>(&args->rf.type)->default_value("multi"), "Type of the radio [multi]")
     ("ue.phy", bpo::value<string>(&args->phy.type)->default_value("lte"), "Type of the PHY [lte]")
+    ("ue.nof_ues", bpo::value<uint32_t>(&args->general.nof_ues)->default_value(1), "Number of UE instances sharing the RF front-end")
+    ("ue.tx_lead_ms", bpo::value<uint32_t>(&args->general.tx_lead_ms)->default_value(2), "Uplink lead in ms kept by the shared radio before transmitting the summed UE signals")
 
     ("rf.srate",        bpo::value<double>(&args->rf.srate_hz)->default_value(0.0),          "Force Tx and Rx sampling rate in Hz")
     ("rf.freq_offset",  bpo::value<float>(&args->rf.freq_offset)->default_value(0),          "(optional) Frequency offset")
@@ -106,6 +109,7 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     ("rf.device_args", bpo::value<string>(&args->rf.device_args)->default_value("auto"), "Front-end device arguments")
     ("rf.time_adv_nsamples", bpo::value<string>(&args->rf.time_adv_nsamples)->default_value("auto"), "Transmission time advance")
     ("rf.continuous_tx", bpo::value<string>(&args->rf.continuous_tx)->default_value("auto"), "Transmit samples continuously to the radio or on bursts (auto/yes/no). Default is auto (yes for UHD, no for rest)")
+    ("rf.rx_ring_ms", bpo::value<uint32_t>(&args->rf.rx_ring_ms)->default_value(0), "Receive from a dedicated RF thread into a ring of this many ms (0 to receive from the PHY sync thread)")
 
     ("rf.bands.rx[0].min", bpo::value<float>(&args->rf.ch_rx_bands[0].min)->default_value(0), "Lower frequency boundary for CH0-RX")
     ("rf.bands.rx[0].max", bpo::value<float>(&args->rf.ch_rx_bands[0].max)->default_value(0), "Higher frequency boundary for CH0-RX")
@@ -162,6 +166,8 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     ("nas.force_imsi_attach", bpo::value<bool>(&args->stack.nas.force_imsi_attach)->default_value(false),  "Whether to always perform an IMSI attach")
     ("nas.eia",               bpo::value<string>(&args->stack.nas.eia)->default_value("1,2,3"),  "List of integrity algorithms included in UE capabilities")
     ("nas.eea",               bpo::value<string>(&args->stack.nas.eea)->default_value("0,1,2,3"),  "List of ciphering algorithms included in UE capabilities")
+    ("nas.storm_cycles",      bpo::value<uint32_t>(&args->stack.nas_5g.storm_cycles)->default_value(0),  "Number of 5G registration, PDU session and deregistration cycles, each with a new identity (0 to disable)")
+    ("nas.storm_gap_ms",      bpo::value<uint32_t>(&args->stack.nas_5g.storm_gap_ms)->default_value(100),  "Time between the end of a registration storm cycle and the next registration")
 
     ("slicing.enable",        bpo::value<bool>(&args->stack.nas_5g.enable_slicing)->default_value(false),  "enable slicing in the UE")
     ("slicing.nssai-sst",     bpo::value<int>(&args->stack.nas_5g.nssai_sst)->default_value(1),  "sst of requested slice")
@@ -448,6 +454,14 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
       bpo::value<bool>(&args->phy.nr_store_pdsch_ko)->default_value(false),
       "Dumps the PDSCH baseband samples into a file on KO reception.")
 
+    ("phy.nr.pusch_encoder_threads",
+      bpo::value<uint32_t>(&args->phy.nr_pusch_encoder_threads)->default_value(0),
+      "Helper threads encoding PUSCH code blocks straight into the resource grid (0 encodes in the PHY worker).")
+
+    ("phy.nr.pss_prescreen_thr",
+      bpo::value<float>(&args->phy.nr_pss_prescreen_thr)->default_value(0.0f),
+      "Cell search CP autocorrelation threshold to run the PSS correlation on a window (0 correlates every window).")
+
     // UE simulation args
     ("sim.airplane_t_on_ms",
      bpo::value<int>(&args->stack.nas.sim.airplane_t_on_ms)->default_value(-1),
@@ -486,6 +500,10 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
      bpo::value<string>(&args->general.metrics_json_filename)->default_value("/tmp/ue_metrics.json"),
      "Metrics JSON filename")
 
+    ("general.metrics_json_format",
+     bpo::value<string>(&args->general.metrics_json_format)->default_value("json"),
+     "Metrics JSON file format: json or cbor (binary, convert with srslog_cbor2json)")
+
     ("general.metrics_influxdb_enable",
      bpo::value<bool>(&args->general.metrics_influxdb_enable)->default_value(false),
      "Write UE metrics to an influxdb instance")
@@ -528,7 +546,11 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
 
     ("stack.have_tti_time_stats",
         bpo::value<bool>(&args->stack.have_tti_time_stats)->default_value(true),
-        "Calculate TTI execution statistics");
+        "Calculate TTI execution statistics")
+
+    ("stack.nof_up_workers",
+        bpo::value<uint32_t>(&args->stack.nof_up_workers)->default_value(0),
+        "Number of threads processing LTE data bearers in RLC/PDCP (0 runs them in the stack thread)");
 
 
   // Positional options - config file location
@@ -606,6 +628,12 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     exit(1);
   }
 
+  // Only the formatters the metrics JSON channel knows about are accepted
+  if (args->general.metrics_json_format != "json" && args->general.metrics_json_format != "cbor") {
+    cout << "Error, invalid metrics JSON format: " << args->general.metrics_json_format << " (json or cbor)" << endl;
+    return SRSRAN_ERROR;
+  }
+
   // Apply all_level to any unset layers
   if (vm.count("log.all_level")) {
     if (!vm.count("log.rf_level")) {
@@ -729,6 +757,37 @@ static void* input_loop(void*)
   return nullptr;
 }
 
+/// Offsets a decimal identity (IMSI, IMEI) by k, keeping its number of digits. Carries beyond the most significant
+/// digit are dropped, so the identity wraps around instead of growing.
+static std::string offset_identity(const std::string& id, uint32_t k)
+{
+  if (id.empty() or k == 0) {
+    return id;
+  }
+  std::string ret   = id;
+  uint32_t    carry = k;
+  for (auto it = ret.rbegin(); it != ret.rend() and carry > 0; ++it) {
+    uint32_t digit = (uint32_t)(*it - '0') + carry;
+    *it            = (char)('0' + digit % 10);
+    carry          = digit / 10;
+  }
+  return ret;
+}
+
+/// Appends the UE instance index k to a file path, before the extension if there is one. "stdout" is kept as is.
+static std::string instance_filename(const std::string& filename, uint32_t k)
+{
+  if (filename.empty() or filename == "stdout" or k == 0) {
+    return filename;
+  }
+  std::string::size_type slash = filename.find_last_of('/');
+  std::string::size_type dot   = filename.find_last_of('.');
+  if (dot == std::string::npos or (slash != std::string::npos and dot < slash)) {
+    return filename + "_" + std::to_string(k);
+  }
+  return filename.substr(0, dot) + "_" + std::to_string(k) + filename.substr(dot);
+}
+
 /// Adjusts the input value in args from kbytes to bytes.
 static size_t fixup_log_file_maxsize(int x)
 {
@@ -794,13 +853,52 @@ int main(int argc, char* argv[])
     fprintf(stderr, "Failed to `mlockall`: %d", errno);
   }
 
+  // Several UE instances share a single RF front-end through a shared radio, each one with its own port
+  std::unique_ptr<srsran::radio_shared> shared_radio;
+  if (args.general.nof_ues > 1) {
+    srsran::rf_args_t rf_args = args.rf;
+    rf_args.nof_carriers      = args.phy.nof_lte_carriers + args.phy.nof_nr_carriers;
+    shared_radio              = std::unique_ptr<srsran::radio_shared>(new srsran::radio_shared);
+    if (shared_radio->init(rf_args, args.general.nof_ues, args.general.tx_lead_ms)) {
+      cout << "Error initializing shared radio." << endl;
+      return SRSRAN_ERROR;
+    }
+  }
+
+  // Storm identities of all UE instances interleave, so that none of them is used twice
+  args.stack.nas_5g.storm_id_stride = std::max(args.general.nof_ues, 1u);
+
   // Create UE instance.
   srsue::ue ue;
-  if (ue.init(args)) {
+  if (ue.init(args, shared_radio ? shared_radio->get_port(0) : nullptr)) {
     ue.stop();
+    if (shared_radio) {
+      shared_radio->stop();
+    }
     return SRSRAN_SUCCESS;
   }
 
+  // Additional UE instances get consecutive identities, their own TUN device and their own capture files, metrics
+  // follow the first one
+  std::vector<std::unique_ptr<srsue::ue>> extra_ues;
+  for (uint32_t k = 1; k < args.general.nof_ues; k++) {
+    all_args_t ue_args                           = args;
+    ue_args.stack.usim.imsi                      = offset_identity(args.stack.usim.imsi, k);
+    ue_args.stack.usim.imei                      = offset_identity(args.stack.usim.imei, k);
+    ue_args.gw.tun_dev_name                      = args.gw.tun_dev_name + std::to_string(k);
+    ue_args.log.filename                         = instance_filename(args.log.filename, k);
+    ue_args.stack.pkt_trace.mac_pcap.filename    = instance_filename(args.stack.pkt_trace.mac_pcap.filename, k);
+    ue_args.stack.pkt_trace.mac_nr_pcap.filename = instance_filename(args.stack.pkt_trace.mac_nr_pcap.filename, k);
+    ue_args.stack.pkt_trace.nas_pcap.filename    = instance_filename(args.stack.pkt_trace.nas_pcap.filename, k);
+    std::unique_ptr<srsue::ue> extra_ue(new srsue::ue);
+    if (extra_ue->init(ue_args, shared_radio->get_port(k))) {
+      cout << "Error initializing UE instance " << k << "." << endl;
+      extra_ue->stop();
+      continue;
+    }
+    extra_ues.push_back(std::move(extra_ue));
+  }
+
   srsran::metrics_hub<ue_metrics_t> metricshub;
   metrics_stdout                    _metrics_screen;
 
@@ -830,7 +928,11 @@ int main(int argc, char* argv[])
 
   // Set up the JSON log channel used by metrics.
   srslog::sink& json_sink =
-      srslog::fetch_file_sink(args.general.metrics_json_filename, 0, false, srslog::create_json_formatter());
+      srslog::fetch_file_sink(args.general.metrics_json_filename,
+                              0,
+                              false,
+                              args.general.metrics_json_format == "cbor" ? srslog::create_cbor_formatter()
+                                                                         : srslog::create_json_formatter());
   srslog::log_channel& json_channel = srslog::fetch_log_channel("JSON_channel", json_sink, {});
   json_channel.set_enabled(args.general.metrics_json_enable);
 
@@ -845,6 +947,9 @@ int main(int argc, char* argv[])
 
   cout << "Attaching UE..." << endl;
   ue.switch_on();
+  for (auto& extra_ue : extra_ues) {
+    extra_ue->switch_on();
+  }
 
   if (args.gui.enable) {
     ue.start_plot();
@@ -855,11 +960,20 @@ int main(int argc, char* argv[])
   }
 
   ue.switch_off();
+  for (auto& extra_ue : extra_ues) {
+    extra_ue->switch_off();
+  }
   pthread_cancel(input);
   pthread_join(input, nullptr);
   metricshub.stop();
   metrics_file.stop();
   ue.stop();
+  for (auto& extra_ue : extra_ues) {
+    extra_ue->stop();
+  }
+  if (shared_radio) {
+    shared_radio->stop();
+  }
   cout << "---  exiting  ---" << endl;
 
   return SRSRAN_SUCCESS;
@@ -21,6 +21,7 @@
 
 #include "rtue/hdr/metrics_stdout.h"
 
+#include <array>
 #include <float.h>
 #include <iomanip>
 #include <iostream>
@@ -60,6 +61,56 @@ char const* const prefixes[2][9] = {
     },
 };
 
+static void print_rf_status(const srsran::rf_metrics_t& rf)
+{
+  if (rf.rf_ring_sz > 0) {
+    fmt::print("RF status: O={}, U={}, L={}, ring O={}, ring depth={}/{}\n",
+               rf.rf_o,
+               rf.rf_u,
+               rf.rf_l,
+               rf.rf_ring_o,
+               rf.rf_ring_depth,
+               rf.rf_ring_sz);
+  } else {
+    fmt::print("RF status: O={}, U={}, L={}\n", rf.rf_o, rf.rf_u, rf.rf_l);
+  }
+}
+
+/// Upper bound of the latency histogram bucket holding the given percentile, n/a without completions
+static std::string proc_latency_percentile(const nas_5g_proc_metrics_t& proc, float percentile)
+{
+  if (proc.nof_completed == 0) {
+    return " n/a";
+  }
+  uint32_t rank  = (uint32_t)ceilf(proc.nof_completed * percentile / 100.0f);
+  uint32_t acc   = 0;
+  uint32_t bound = 2u << (nas_5g_proc_metrics_t::nof_buckets - 1);
+  for (uint32_t i = 0; i < nas_5g_proc_metrics_t::nof_buckets; i++) {
+    acc += proc.latency_hist[i];
+    if (acc >= rank) {
+      bound = 2u << i;
+      break;
+    }
+  }
+  return fmt::format("<{}ms", bound);
+}
+
+static void print_storm_status(const nas_5g_metrics_t& nas_5g)
+{
+  fmt::print("Storm cycle {}:", nas_5g.storm_cycle);
+  const std::array<std::pair<const char*, const nas_5g_proc_metrics_t*>, 3> procs = {
+      {{"reg", &nas_5g.registration}, {"pdu", &nas_5g.pdu_session}, {"dereg", &nas_5g.deregistration}}};
+  for (const auto& proc : procs) {
+    fmt::print(" {} ok={} fail={} p50{} p95{}",
+               proc.first,
+               proc.second->nof_completed,
+               proc.second->nof_failed,
+               proc_latency_percentile(*proc.second, 50),
+               proc_latency_percentile(*proc.second, 95));
+  }
+  fmt::print("\n");
+}
+
 void metrics_stdout::set_ue_handle(ue_metrics_interface* ue_)
 {
   std::lock_guard<std::mutex> lock(mutex);
@@ -183,13 +234,18 @@ void metrics_stdout::set_metrics(const ue_metrics_t& metrics, const uint32_t per
 
   // always print RF error
   if (metrics.rf.rf_error) {
-    fmt::print("RF status: O={}, U={}, L={}\n", metrics.rf.rf_o, metrics.rf.rf_u, metrics.rf.rf_l);
+    print_rf_status(metrics.rf);
   }
 
   if (!do_print) {
     return;
   }
 
+  // registration storm progress, most of the time the UE is not connected
+  if (metrics.stack.nas_5g.storm_cycle > 0) {
+    print_storm_status(metrics.stack.nas_5g);
+  }
+
   if (metrics.stack.rrc.state != RRC_STATE_CONNECTED && metrics.stack.rrc_nr.state != RRC_NR_STATE_CONNECTED) {
     fmt::print("--- disconnected ---\n");
     return;
@@ -229,7 +285,7 @@ void metrics_stdout::set_metrics(const ue_metrics_t& metrics, const uint32_t per
   }
 
   if (metrics.rf.rf_error) {
-    fmt::print("RF status: O={}, U={}, L={}\n", metrics.rf.rf_o, metrics.rf.rf_u, metrics.rf.rf_l);
+    print_rf_status(metrics.rf);
   }
 }
 
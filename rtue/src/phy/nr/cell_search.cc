@@ -42,6 +42,7 @@ bool cell_search::init(const args_t& args)
   ssb_args.min_scs           = args.ssb_min_scs;
   ssb_args.enable_search     = true;
   ssb_args.enable_decode     = true;
+  ssb_args.pss_prescreen_thr = args.pss_prescreen_thr;
 
   // Initialise SSB
   if (srsran_ssb_init(&ssb, &ssb_args) < SRSRAN_SUCCESS) {
@@ -95,5 +96,12 @@ cell_search::ret_t cell_search::run_slot(const cf_t* buffer, uint32_t slot_sz)
   return ret;
 }
 
+srsran_ssb_prescreen_metrics_t cell_search::get_prescreen_metrics()
+{
+  srsran_ssb_prescreen_metrics_t metrics = {};
+  srsran_ssb_get_prescreen_metrics(&ssb, &metrics);
+  return metrics;
+}
+
 } // namespace nr
 } // namespace srsue
@@ -28,6 +28,8 @@
 namespace srsue {
 namespace scell {
 
+constexpr uint32_t intra_measure_nr::max_tracked_cells;
+
 intra_measure_nr::intra_measure_nr(srslog::basic_logger& logger_, meas_itf& new_meas_itf_) :
   logger(logger_), intra_measure_base(logger_, new_meas_itf_)
 {}
@@ -39,8 +41,11 @@ intra_measure_nr::~intra_measure_nr()
 
 bool intra_measure_nr::init(uint32_t cc_idx_, const args_t& args)
 {
-  cc_idx     = cc_idx_;
-  thr_snr_db = args.thr_snr_db;
+  cc_idx         = cc_idx_;
+  thr_snr_db     = args.thr_snr_db;
+  search_period  = args.search_period;
+  filter_alpha   = args.filter_alpha;
+  max_nof_misses = args.max_nof_misses;
 
   // Initialise generic side
   intra_measure_base::args_t base_args = {};
@@ -55,6 +60,7 @@ bool intra_measure_nr::init(uint32_t cc_idx_, const args_t& args)
   ssb_args.max_srate_hz      = args.max_srate_hz;
   ssb_args.min_scs           = args.min_scs;
   ssb_args.enable_search     = true;
+  ssb_args.enable_measure    = true;
   if (srsran_ssb_init(&ssb, &ssb_args) < SRSRAN_SUCCESS) {
     Log(error, "Error initiating SSB");
     return false;
@@ -68,6 +74,12 @@ bool intra_measure_nr::set_config(const config_t& cfg)
   // Update ARFCN
   current_arfcn    = cfg.arfcn;
   serving_cell_pci = cfg.serving_cell_pci;
+  srate_hz         = cfg.srate_hz;
+
+  // Forget the tracked cells, the next measurement starts with a full search
+  cells.nof_cells = 0;
+  search_count    = 0;
+  ref_t_offset    = -1;
 
   // Reset performance measurement
   perf_count_samples = 0;
@@ -90,48 +102,238 @@ bool intra_measure_nr::set_config(const config_t& cfg)
   return true;
 }
 
-bool intra_measure_nr::measure_rat(const measure_context_t& context, std::vector<cf_t>& buffer, float rx_gain_offset)
+int intra_measure_nr::tracked_cells_t::find(uint32_t pci_) const
 {
-  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < nof_cells; i++) {
+    if (pci[i] == pci_) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+int intra_measure_nr::tracked_cells_t::add(uint32_t pci_, uint32_t t_offset_)
+{
+  if (nof_cells == max_tracked_cells) {
+    return -1;
+  }
+  uint32_t i    = nof_cells++;
+  pci[i]        = pci_;
+  t_offset[i]   = t_offset_;
+  nof_misses[i] = 0;
+  known[i]      = false;
+  measured[i]   = false;
+  valid[i]      = false;
+  rsrp_dB[i]    = 0.0f;
+  // The first valid measurement initialises the filter
+  rsrp_filt_dB[i] = NAN;
+  alpha[i]        = 0.0f;
+  cfo_hz[i]       = 0.0f;
+  return (int)i;
+}
+
+void intra_measure_nr::tracked_cells_t::remove_lost(uint32_t max_nof_misses)
+{
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < nof_cells; i++) {
+    if (nof_misses[i] >= max_nof_misses and not known[i]) {
+      continue;
+    }
+    pci[n]          = pci[i];
+    t_offset[n]     = t_offset[i];
+    nof_misses[n]   = nof_misses[i];
+    known[n]        = known[i];
+    rsrp_filt_dB[n] = rsrp_filt_dB[i];
+    cfo_hz[n]       = cfo_hz[i];
+    n++;
+  }
+  nof_cells = n;
+}
+
+void intra_measure_nr::set_meas(uint32_t idx, const srsran_csi_trs_measurements_t& meas)
+{
+  cells.measured[idx] = true;
+  cells.valid[idx]    = (meas.snr_dB >= thr_snr_db);
+  if (not cells.valid[idx]) {
+    cells.nof_misses[idx]++;
+    return;
+  }
 
+  cells.nof_misses[idx] = 0;
+  cells.rsrp_dB[idx]    = meas.rsrp_dB + rx_gain_offset_db;
+  cells.cfo_hz[idx]     = meas.cfo_hz;
+  cells.alpha[idx]      = std::isnan(cells.rsrp_filt_dB[idx]) ? 1.0f : filter_alpha;
+  if (std::isnan(cells.rsrp_filt_dB[idx])) {
+    cells.rsrp_filt_dB[idx] = 0.0f;
+  }
+
+  // Follow the cell timing, the delay is counted from the start of the buffer
+  cells.t_offset[idx] = (uint32_t)std::max(std::round(meas.delay_us * 1e-6 * srate_hz), 0.0);
+}
+
+bool intra_measure_nr::search(const cf_t* buffer, uint32_t nof_samples)
+{
   // Search and measure the best cell
   srsran_csi_trs_measurements_t meas = {};
   uint32_t                      N_id = 0;
-  if (srsran_ssb_csi_search(&ssb, buffer.data(), context.sf_len * context.meas_len_ms, &N_id, &meas) < SRSRAN_SUCCESS) {
+  if (srsran_ssb_csi_search(&ssb, buffer, nof_samples, &N_id, &meas) < SRSRAN_SUCCESS) {
     Log(error, "Error searching for SSB");
     return false;
   }
 
-  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
-  perf_count_us += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
-  perf_count_samples += (uint64_t)context.sf_len * (uint64_t)context.meas_len_ms;
-
-  // Early return if the found PCI matches with the serving cell ID
-  if (serving_cell_pci == (int)N_id) {
-    return true;
-  }
-
   // Take valid decision if SNR threshold is exceeded
   bool valid = (meas.snr_dB >= thr_snr_db);
 
   // Log finding
-  if ((logger.info.enabled() and valid) or logger.debug.enabled()) {
+  if (serving_cell_pci != (int)N_id and ((logger.info.enabled() and valid) or logger.debug.enabled())) {
     std::array<char, 512> str_info = {};
     srsran_csi_rs_measure_info(&meas, str_info.data(), (uint32_t)str_info.size());
     Log(info, "%s neighbour cell: PCI=%03d %s", valid ? "Found" : "Best", N_id, str_info.data());
   }
 
-  // Check threshold
-  if (valid) {
-    // Prepare found measurements
-    std::vector<phy_meas_t> meas_list(1);
-    meas_list[0].rat    = get_rat();
-    meas_list[0].rsrp   = meas.rsrp_dB + rx_gain_offset_db;
-    meas_list[0].cfo_hz = meas.cfo_hz;
-    meas_list[0].earfcn = get_earfcn();
-    meas_list[0].pci    = N_id;
+  if (not valid) {
+    return true;
+  }
+
+  // The serving cell only provides the reference timing
+  ref_t_offset = (int)std::max(std::round(meas.delay_us * 1e-6 * srate_hz), 0.0);
+  if (serving_cell_pci == (int)N_id) {
+    return true;
+  }
+
+  int idx = cells.find(N_id);
+  if (idx < 0) {
+    idx = cells.add(N_id, (uint32_t)ref_t_offset);
+  }
+  if (idx < 0) {
+    Log(debug, "Not tracking PCI=%03d, already tracking %d cells", N_id, max_tracked_cells);
+    return true;
+  }
+  set_meas((uint32_t)idx, meas);
+
+  return true;
+}
+
+bool intra_measure_nr::measure_rat(const measure_context_t& context, std::vector<cf_t>& buffer, float rx_gain_offset)
+{
+  std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+  uint32_t nof_samples = context.sf_len * context.meas_len_ms;
+  for (uint32_t i = 0; i < cells.nof_cells; i++) {
+    cells.known[i]    = context.active_pci.count(cells.pci[i]) > 0;
+    cells.measured[i] = false;
+    cells.valid[i]    = false;
+    cells.alpha[i]    = 0.0f;
+  }
+
+  // The full search runs while no cell is tracked and periodically to find new cells, every other measurement only
+  // looks at the known SSB positions
+  bool searched = (cells.nof_cells == 0 or search_count >= search_period);
+  if (searched) {
+    search_count = 0;
+    if (not search(buffer.data(), nof_samples)) {
+      return false;
+    }
+  } else {
+    search_count++;
+  }
+
+  // Requested cells that are not tracked yet are assumed to be synchronised with the detected cells
+  if (ref_t_offset >= 0) {
+    for (uint32_t pci : context.active_pci) {
+      if ((int)pci != serving_cell_pci and cells.find(pci) < 0) {
+        int idx = cells.add(pci, (uint32_t)ref_t_offset);
+        if (idx >= 0) {
+          cells.known[idx] = true;
+        }
+      }
+    }
+  }
+
+  // A requested cell that was lost is searched again at the reference position
+  for (uint32_t i = 0; i < cells.nof_cells; i++) {
+    if (not cells.measured[i] and cells.known[i] and cells.nof_misses[i] >= max_nof_misses and ref_t_offset >= 0) {
+      cells.t_offset[i]   = (uint32_t)ref_t_offset;
+      cells.nof_misses[i] = 0;
+    }
+  }
+
+  // Measure the tracked cells at their SSB position, the SSB is demodulated once for all the cells sharing a position
+  for (uint32_t i = 0; i < cells.nof_cells; i++) {
+    if (cells.measured[i]) {
+      continue;
+    }
+    uint32_t t_offset = cells.t_offset[i];
+    if (t_offset + ssb.ssb_sz > nof_samples) {
+      cells.nof_misses[i]++;
+      continue;
+    }
+
+    uint32_t nof_pci = 0;
+    for (uint32_t j = i; j < cells.nof_cells; j++) {
+      if (not cells.measured[j] and cells.t_offset[j] == t_offset) {
+        meas_idx[nof_pci]   = j;
+        meas_pci[nof_pci++] = cells.pci[j];
+      }
+    }
+    if (srsran_ssb_csi_measure_offset(
+            &ssb, meas_pci.data(), nof_pci, buffer.data(), nof_samples, t_offset, meas_buf.data()) < SRSRAN_SUCCESS) {
+      Log(error, "Error measuring %d cells at %d", nof_pci, t_offset);
+      return false;
+    }
+    for (uint32_t k = 0; k < nof_pci; k++) {
+      set_meas(meas_idx[k], meas_buf[k]);
+    }
+  }
+
+  // A cell missed for the first time has most likely moved, search the buffer again rather than waiting for it to be
+  // dropped
+  if (not searched) {
+    for (uint32_t i = 0; i < cells.nof_cells; i++) {
+      if (cells.nof_misses[i] == 1) {
+        search_count = 0;
+        if (not search(buffer.data(), nof_samples)) {
+          return false;
+        }
+        break;
+      }
+    }
+  }
+
+  // Exponential filter of all cells at once, rsrp_filt += alpha * (rsrp - rsrp_filt)
+  srsran_vec_sub_fff(cells.rsrp_dB.data(), cells.rsrp_filt_dB.data(), cells.tmp.data(), cells.nof_cells);
+  srsran_vec_prod_fff(cells.tmp.data(), cells.alpha.data(), cells.tmp.data(), cells.nof_cells);
+  srsran_vec_sum_fff(cells.rsrp_filt_dB.data(), cells.tmp.data(), cells.rsrp_filt_dB.data(), cells.nof_cells);
+
+  std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+  perf_count_us += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+  perf_count_samples += (uint64_t)nof_samples;
+
+  // Report the cells measured above the threshold
+  std::vector<phy_meas_t> meas_list;
+  for (uint32_t i = 0; i < cells.nof_cells; i++) {
+    if (not cells.valid[i]) {
+      continue;
+    }
+    phy_meas_t m = {};
+    m.rat        = get_rat();
+    m.rsrp       = cells.rsrp_filt_dB[i];
+    m.cfo_hz     = cells.cfo_hz[i];
+    m.earfcn     = get_earfcn();
+    m.pci        = cells.pci[i];
+    meas_list.push_back(m);
+  }
+  Log(debug, "Tracking %d cells, %zd above threshold", cells.nof_cells, meas_list.size());
+
+  // Drop the found cells that have not been seen for a while, a lost cell also triggers a new full search
+  uint32_t nof_cells = cells.nof_cells;
+  cells.remove_lost(max_nof_misses);
+  if (cells.nof_cells < nof_cells) {
+    search_count = search_period;
+  }
 
-    // Push measurements to higher layers
+  // Push measurements to higher layers
+  if (not meas_list.empty()) {
     context.new_cell_itf.new_cell_meas(cc_idx, meas_list);
   }
 
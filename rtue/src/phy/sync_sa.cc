@@ -265,6 +265,12 @@ void sync_sa::run_state_cell_search()
 
   // Leave CELL_SEARCH state if error or success and transition to IDLE
   if (cs_ret.result == cell_search::ret_t::CELL_FOUND || cell_search_nof_trials >= cell_search_max_trials) {
+    srsran_ssb_prescreen_metrics_t prescreen = searcher.get_prescreen_metrics();
+    if (prescreen.nof_windows > 0) {
+      logger.info("Cell search: PSS pre-screen passed %" PRIu64 " of %" PRIu64 " windows",
+                  prescreen.nof_hits,
+                  prescreen.nof_windows);
+    }
     phy_state.state_exit();
   }
 }
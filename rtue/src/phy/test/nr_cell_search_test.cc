@@ -39,6 +39,8 @@ class test_gnb
 private:
   uint32_t              pci;
   uint32_t              sf_len        = 0;
+  float                 gain          = 1.0f;
+  uint32_t              off_ms        = 0;
   srsran_ssb_t          ssb           = {};
   std::vector<cf_t>     signal_buffer = {};
   srslog::basic_logger& logger;
@@ -53,6 +55,8 @@ public:
     double                      ssb_freq_hz    = 3.5e9 - 960e3;
     srsran_subcarrier_spacing_t ssb_scs        = srsran_subcarrier_spacing_30kHz;
     uint32_t                    ssb_period_ms  = 20;
+    float                       gain_db        = 0.0f; ///< SSB power relative to full scale
+    uint32_t                    off_ms         = 0;    ///< Stops transmitting from this subframe, 0 never stops
     uint16_t                    band;
     srsran::channel::args_t     channel;
     std::string                 log_level = "error";
@@ -69,6 +73,8 @@ public:
     // Initialise internals
     pci    = args.pci;
     sf_len = (uint32_t)round(args.srate_hz / 1000);
+    gain   = srsran_convert_dB_to_amplitude(args.gain_db);
+    off_ms = args.off_ms;
 
     // Allocate buffer
     buffer.resize(sf_len);
@@ -109,7 +115,7 @@ public:
     srsran_vec_cf_zero(buffer.data(), (uint32_t)buffer.size());
 
     // Check if SSB needs to be sent
-    if (srsran_ssb_send(&ssb, sf_idx)) {
+    if ((off_ms == 0 or sf_idx < off_ms) and srsran_ssb_send(&ssb, sf_idx)) {
       // Prepare PBCH message
       srsran_pbch_msg_nr_t msg = {};
 
@@ -118,6 +124,7 @@ public:
         logger.error("Error adding SSB");
         return SRSRAN_ERROR;
       }
+      srsran_vec_sc_prod_cfc(buffer.data(), gain, buffer.data(), (uint32_t)buffer.size());
     }
 
     // Run channel
@@ -154,7 +161,11 @@ struct args_t {
 
   // Simulation parameters
   std::set<uint32_t> pcis_to_simulate;
+  std::set<uint32_t> pcis_to_switch_off;
   uint32_t           ssb_period_ms = 20;
+  float              gain_step_db  = 0.0f; // Each simulated cell is this much weaker than the previous one
+  uint32_t           switch_off_ms = 0;    // Time at which the cells to switch off stop transmitting
+  float              rsrp_error_db = 1.5f; // Maximum error of the reported RSRP of the simulated cells
   float channel_delay_min          = 0.0f; // Set to non-zero value to stir the delay from zero to this value in usec
   float channel_delay_max          = 0.0f; // Set to non-zero value to stir the delay from zero to this value in usec
 
@@ -213,10 +224,23 @@ public:
   bool print_stats(args_t args)
   {
     printf("\n-- Statistics:\n");
-    uint32_t true_counts        = 0;
-    uint32_t false_counts       = 0;
-    uint32_t tti_count          = (1000 * args.duration_s) / args.meas_period_ms;
-    uint32_t ideal_true_counts  = args.pcis_to_simulate.size() * tti_count;
+    uint32_t true_counts       = 0;
+    uint32_t false_counts      = 0;
+    uint32_t tti_count         = (1000 * args.duration_s) / args.meas_period_ms;
+    uint32_t ideal_true_counts = 0;
+    bool     rsrp_ok           = true;
+
+    // Measurements expected and RSRP of each simulated cell, the cells switched off are only measured until then
+    std::map<uint32_t, uint32_t> expected_count;
+    std::map<uint32_t, float>    expected_rsrp;
+    float                        gain_db = 0.0f;
+    for (uint32_t pci : args.pcis_to_simulate) {
+      bool switch_off     = args.pcis_to_switch_off.count(pci) > 0 and args.switch_off_ms > 0;
+      expected_count[pci] = switch_off ? SRSRAN_MIN(args.switch_off_ms / args.meas_period_ms, tti_count) : tti_count;
+      expected_rsrp[pci]  = gain_db;
+      ideal_true_counts += expected_count[pci];
+      gain_db -= args.gain_step_db;
+    }
     uint32_t ideal_false_counts = tti_count * cells.size() - ideal_true_counts;
 
     for (auto& e : cells) {
@@ -229,8 +253,21 @@ public:
 
       if (false_alarm) {
         false_counts += e.second.count;
-      } else {
+      } else if (args.pcis_to_simulate.empty()) {
         true_counts += e.second.count;
+      } else {
+        // Reports of a cell after it was switched off are false alarms
+        uint32_t count = SRSRAN_MIN(e.second.count, expected_count[e.first]);
+        true_counts += count;
+        false_counts += e.second.count - count;
+
+        // The filtered RSRP must follow the power of the cell
+        float rsrp = expected_rsrp[e.first];
+        if (std::abs(e.second.rsrp_min - rsrp) > args.rsrp_error_db or
+            std::abs(e.second.rsrp_max - rsrp) > args.rsrp_error_db) {
+          printf("  pci=%03d; rsrp expected %+.1fdBfs\n", e.first, rsrp);
+          rsrp_ok = false;
+        }
       }
 
       printf("  pci=%03d; count=%3d; false=%s; rsrp=%+.1f|%+.1f|%+.1fdBfs;  rsrq=%+.1f|%+.1f|%+.1fdB;\n",
@@ -251,7 +288,7 @@ public:
     printf("    Probability of detection: %.6f\n", prob_detection);
     printf("  Probability of false alarm: %.6f\n", prob_false_alarm);
 
-    return (prob_detection >= 0.9f && prob_false_alarm <= 0.1f);
+    return (prob_detection >= 0.9f && prob_false_alarm <= 0.1f && rsrp_ok);
   }
 };
 
@@ -282,6 +319,7 @@ int parse_args(int argc, char** argv, args_t& args)
 
   std::string active_cell_list     = "500";
   std::string simulation_cell_list = "";
+  std::string switch_off_cell_list = "";
   std::string ssb_scs              = "30";
 
   bpo::options_description options("General options");
@@ -308,6 +346,10 @@ int parse_args(int argc, char** argv, args_t& args)
   simulation.add_options()
       ("simulation_cell_list", bpo::value<std::string>(&simulation_cell_list)->default_value(simulation_cell_list), "Comma separated PCI cell list to simulate")
       ("ssb_period",           bpo::value<uint32_t>(&args.ssb_period_ms)->default_value(args.ssb_period_ms),        "SSB period in ms")
+      ("gain_step_db",         bpo::value<float>(&args.gain_step_db)->default_value(args.gain_step_db),             "Power step between the simulated cells in dB")
+      ("switch_off_cell_list", bpo::value<std::string>(&switch_off_cell_list)->default_value(switch_off_cell_list), "Comma separated PCI list of the simulated cells to switch off")
+      ("switch_off_ms",        bpo::value<uint32_t>(&args.switch_off_ms)->default_value(args.switch_off_ms),        "Time in ms at which the cells are switched off, 0 disables it")
+      ("rsrp_error_db",        bpo::value<float>(&args.rsrp_error_db)->default_value(args.rsrp_error_db),           "Maximum error of the reported RSRP of the simulated cells in dB")
       ("channel.delay_min",    bpo::value<float>(&args.channel_delay_min)->default_value(args.channel_delay_min),   "Channel delay minimum in usec.")
       ("channel.delay_max",    bpo::value<float>(&args.channel_delay_max)->default_value(args.channel_delay_max),   "Channel delay maximum in usec. Set to 0 to disable, otherwise it will steer the delay for the duration of the simulation")
       ;
@@ -347,6 +389,7 @@ int parse_args(int argc, char** argv, args_t& args)
   // Parse PCI lists
   pci_list_parse_helper(active_cell_list, args.pcis_to_meas);
   pci_list_parse_helper(simulation_cell_list, args.pcis_to_simulate);
+  pci_list_parse_helper(switch_off_cell_list, args.pcis_to_switch_off);
 
   // Parse SSB SCS
   args.ssb_scs = srsran_subcarrier_spacing_from_str(ssb_scs.c_str());
@@ -455,6 +498,7 @@ int main(int argc, char** argv)
 
   } else {
     // Create test eNb's if radio is not available
+    float gain_db = 0.0f;
     for (const uint32_t& pci : args.pcis_to_simulate) {
       // Initialise channel and push back
       test_gnb::args_t gnb_args          = {};
@@ -464,6 +508,8 @@ int main(int argc, char** argv)
       gnb_args.ssb_freq_hz               = ssb_freq_hz;
       gnb_args.ssb_scs                   = args.ssb_scs;
       gnb_args.ssb_period_ms             = args.ssb_period_ms;
+      gnb_args.gain_db                   = gain_db;
+      gnb_args.off_ms                    = args.pcis_to_switch_off.count(pci) ? args.switch_off_ms : 0;
       gnb_args.band                      = band;
       gnb_args.log_level                 = args.log_level;
       gnb_args.channel.delay_enable      = std::isnormal(args.channel_delay_max);
@@ -474,6 +520,7 @@ int main(int argc, char** argv)
       gnb_args.channel.enable            = (gnb_args.channel.delay_enable || gnb_args.channel.awgn_enable ||
                                  gnb_args.channel.fading_enable || gnb_args.channel.hst_enable);
       test_gnb_v.push_back(std::unique_ptr<test_gnb>(new test_gnb(gnb_args)));
+      gain_db -= args.gain_step_db;
     }
   }
 
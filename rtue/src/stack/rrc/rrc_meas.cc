@@ -526,19 +526,19 @@ cell_triggered_t rrc::rrc_meas::var_meas_report_list::get_measId_cells(const uin
   }
 }
 
-void rrc::rrc_meas::var_meas_cfg::report_triggers_eutra_check_new(int32_t             meas_id,
-                                                                  report_cfg_eutra_s& report_cfg,
-                                                                  meas_obj_eutra_s&   meas_obj)
+void rrc::rrc_meas::var_meas_cfg::report_triggers_eutra_check_new(const meas_id_cfg_t& m)
 {
-  bool             new_cell_trigger     = false;
-  cell_triggered_t cells_triggered_list = meas_report->get_measId_cells(meas_id);
-  for (auto& cell : trigger_state[meas_id]) {
-    if (cell.second.is_enter_equal(report_cfg.trigger_type.event().time_to_trigger.to_number())) {
+  bool               new_cell_trigger     = false;
+  cell_triggered_t   cells_triggered_list = meas_report->get_measId_cells(m.meas_id);
+  cell_trigger_list& cells                = trigger_state[m.meas_id];
+  for (uint32_t i = 0; i < cells.size(); i++) {
+    if (cells.is_enter_equal(i, m.time_to_trigger)) {
+      uint32_t pci = cells.pci[i];
       // Do not add if already exists
-      if (std::find_if(cells_triggered_list.begin(), cells_triggered_list.end(), [&cell](const phy_cell_t& c) {
-            return cell.first == c.pci;
+      if (std::find_if(cells_triggered_list.begin(), cells_triggered_list.end(), [pci](const phy_cell_t& c) {
+            return pci == c.pci;
           }) == cells_triggered_list.end()) {
-        cells_triggered_list.push_back({cell.first, meas_obj.carrier_freq});
+        cells_triggered_list.push_back({pci, m.carrier_freq});
         new_cell_trigger = true;
       }
     }
@@ -547,35 +547,37 @@ void rrc::rrc_meas::var_meas_cfg::report_triggers_eutra_check_new(int32_t
   if (new_cell_trigger) {
     // include a measurement reporting entry within the VarMeasReportList for this measId (nof_reports reset
     // inside) include the concerned cell(s) in the cellsTriggeredList defined within the VarMeasReportList
-    meas_report->set_measId(meas_id, meas_obj.carrier_freq, report_cfg, cells_triggered_list);
+    meas_report->set_measId(
+        m.meas_id, m.carrier_freq, m.report_cfg->report_cfg.report_cfg_eutra(), cells_triggered_list);
 
     // initiate the measurement reporting procedure, as specified in 5.5.5;
-    meas_report->generate_report(meas_id);
+    meas_report->generate_report(m.meas_id);
   }
 }
 
-void rrc::rrc_meas::var_meas_cfg::report_triggers_eutra_check_leaving(int32_t meas_id, report_cfg_eutra_s& report_cfg)
+void rrc::rrc_meas::var_meas_cfg::report_triggers_eutra_check_leaving(const meas_id_cfg_t& m)
 {
   // if the triggerType is set to ‘event’ and if the leaving condition applicable for this event is fulfilled ...
-  cell_triggered_t cells_triggered_list = meas_report->get_measId_cells(meas_id);
+  cell_triggered_t   cells_triggered_list = meas_report->get_measId_cells(m.meas_id);
+  cell_trigger_list& cells                = trigger_state[m.meas_id];
 
   // remove the concerned cell(s) in the cellsTriggeredList defined within the VarMeasReportList
   auto it = cells_triggered_list.begin();
   while (it != cells_triggered_list.end()) {
-    if (trigger_state[meas_id][it->pci].is_exit_equal(report_cfg.trigger_type.event().time_to_trigger.to_number())) {
+    int32_t idx = cells.find(it->pci);
+    if (idx >= 0 && cells.is_exit_equal(idx, m.time_to_trigger)) {
       it = cells_triggered_list.erase(it);
-      meas_report->upd_measId(meas_id, cells_triggered_list);
+      meas_report->upd_measId(m.meas_id, cells_triggered_list);
 
       // if reportOnLeave is set to TRUE for the corresponding reporting configuration
-      if (report_cfg.trigger_type.event().event_id.type() == eutra_event_s::event_id_c_::types::event_a3 &&
-          report_cfg.trigger_type.event().event_id.event_a3().report_on_leave) {
+      if (m.event == event_a3 && m.report_on_leave) {
         // initiate the measurement reporting procedure, as specified in 5.5.5;
-        meas_report->generate_report(meas_id);
+        meas_report->generate_report(m.meas_id);
       }
 
       // if the cellsTriggeredList defined within the VarMeasReportList for this measId is empty:
       if (cells_triggered_list.empty()) {
-        remove_varmeas_report(meas_id);
+        remove_varmeas_report(m.meas_id);
       }
     } else {
       it++;
@@ -611,31 +613,29 @@ void rrc::rrc_meas::var_meas_cfg::report_triggers_eutra_removing_trigger(int32_t
   }
 }
 
-void rrc::rrc_meas::var_meas_cfg::report_triggers_eutra(uint32_t            meas_id,
-                                                        report_cfg_eutra_s& report_cfg,
-                                                        meas_obj_eutra_s&   meas_obj)
+void rrc::rrc_meas::var_meas_cfg::report_triggers_eutra(const meas_id_cfg_t& m)
 {
-  if (report_cfg.trigger_type.type() == report_cfg_eutra_s::trigger_type_c_::types::event) {
+  if (m.event != event_none) {
     // if the triggerType is set to ‘event’ and if the entry condition applicable for this event,
-    report_triggers_eutra_check_new(meas_id, report_cfg, meas_obj);
-    report_triggers_eutra_check_leaving(meas_id, report_cfg);
-    report_triggers_eutra_removing_trigger(meas_id);
+    report_triggers_eutra_check_new(m);
+    report_triggers_eutra_check_leaving(m);
+    report_triggers_eutra_removing_trigger(m.meas_id);
   }
 }
 
-void rrc::rrc_meas::var_meas_cfg::report_triggers_interrat_check_new(int32_t                 meas_id,
-                                                                     report_cfg_inter_rat_s& report_cfg,
-                                                                     meas_obj_nr_r15_s&      meas_obj)
+void rrc::rrc_meas::var_meas_cfg::report_triggers_interrat_check_new(const meas_id_cfg_t& m)
 {
-  bool             new_cell_trigger     = false;
-  cell_triggered_t cells_triggered_list = meas_report->get_measId_cells(meas_id);
-  for (auto& cell : trigger_state_nr[meas_id]) {
-    if (cell.second.is_enter_equal(report_cfg.trigger_type.event().time_to_trigger.to_number())) {
+  bool               new_cell_trigger     = false;
+  cell_triggered_t   cells_triggered_list = meas_report->get_measId_cells(m.meas_id);
+  cell_trigger_list& cells                = trigger_state_nr[m.meas_id];
+  for (uint32_t i = 0; i < cells.size(); i++) {
+    if (cells.is_enter_equal(i, m.time_to_trigger)) {
+      uint32_t pci = cells.pci[i];
       // Do not add if already exists
-      if (std::find_if(cells_triggered_list.begin(), cells_triggered_list.end(), [&cell](const phy_cell_t& c) {
-            return cell.first == c.pci;
+      if (std::find_if(cells_triggered_list.begin(), cells_triggered_list.end(), [pci](const phy_cell_t& c) {
+            return pci == c.pci;
           }) == cells_triggered_list.end()) {
-        cells_triggered_list.push_back({cell.first, meas_obj.carrier_freq_r15});
+        cells_triggered_list.push_back({pci, m.carrier_freq});
         new_cell_trigger = true;
       }
     }
@@ -644,36 +644,36 @@ void rrc::rrc_meas::var_meas_cfg::report_triggers_interrat_check_new(int32_t
   if (new_cell_trigger) {
     // include a measurement reporting entry within the VarMeasReportList for this measId (nof_reports reset
     // inside) include the concerned cell(s) in the cellsTriggeredList defined within the VarMeasReportList
-    meas_report->set_measId(meas_id, meas_obj.carrier_freq_r15, report_cfg, cells_triggered_list);
+    meas_report->set_measId(
+        m.meas_id, m.carrier_freq, m.report_cfg->report_cfg.report_cfg_inter_rat(), cells_triggered_list);
 
     // initiate the measurement reporting procedure, as specified in 5.5.5;
-    meas_report->generate_report(meas_id);
+    meas_report->generate_report(m.meas_id);
   }
 }
-void rrc::rrc_meas::var_meas_cfg::report_triggers_interrat_check_leaving(int32_t                 meas_id,
-                                                                         report_cfg_inter_rat_s& report_cfg)
+void rrc::rrc_meas::var_meas_cfg::report_triggers_interrat_check_leaving(const meas_id_cfg_t& m)
 {
   // if the triggerType is set to ‘event’ and if the leaving condition applicable for this event is fulfilled ...
-  cell_triggered_t cells_triggered_list = meas_report->get_measId_cells(meas_id);
+  cell_triggered_t   cells_triggered_list = meas_report->get_measId_cells(m.meas_id);
+  cell_trigger_list& cells                = trigger_state_nr[m.meas_id];
 
   // remove the concerned cell(s) in the cellsTriggeredList defined within the VarMeasReportList
   auto it = cells_triggered_list.begin();
   while (it != cells_triggered_list.end()) {
-    if (trigger_state_nr[meas_id][it->pci].is_exit_equal(report_cfg.trigger_type.event().time_to_trigger.to_number())) {
+    int32_t idx = cells.find(it->pci);
+    if (idx >= 0 && cells.is_exit_equal(idx, m.time_to_trigger)) {
       it = cells_triggered_list.erase(it);
-      meas_report->upd_measId(meas_id, cells_triggered_list);
+      meas_report->upd_measId(m.meas_id, cells_triggered_list);
 
       // if reportOnLeave is set to TRUE for the corresponding reporting configuration
-      if (report_cfg.trigger_type.event().event_id.type() ==
-              report_cfg_inter_rat_s::trigger_type_c_::event_s_::event_id_c_::types_opts::options::event_b1_nr_r15 &&
-          report_cfg.trigger_type.event().event_id.event_b1_nr_r15().report_on_leave_r15 == true) {
+      if (m.report_on_leave) {
         // initiate the measurement reporting procedure, as specified in 5.5.5;
-        meas_report->generate_report(meas_id);
+        meas_report->generate_report(m.meas_id);
       }
 
       // if the cellsTriggeredList defined within the VarMeasReportList for this measId is empty:
       if (cells_triggered_list.empty()) {
-        remove_varmeas_report(meas_id);
+        remove_varmeas_report(m.meas_id);
       }
     } else {
       it++;
@@ -702,53 +702,35 @@ void rrc::rrc_meas::var_meas_cfg::report_triggers_interrat_removing_trigger(int3
   }
 }
 
-void rrc::rrc_meas::var_meas_cfg::report_triggers_interrat_nr(uint32_t                meas_id,
-                                                              report_cfg_inter_rat_s& report_cfg,
-                                                              meas_obj_nr_r15_s&      meas_obj)
+void rrc::rrc_meas::var_meas_cfg::report_triggers_interrat_nr(const meas_id_cfg_t& m)
 {
-  if (report_cfg.trigger_type.type() == report_cfg_inter_rat_s::trigger_type_c_::types::event) {
+  if (m.event != event_none) {
     // if the triggerType is set to ‘event’ and if the entry condition applicable for this event,
-    report_triggers_interrat_check_new(meas_id, report_cfg, meas_obj);
-    report_triggers_interrat_check_leaving(meas_id, report_cfg);
-    report_triggers_interrat_removing_trigger(meas_id);
+    report_triggers_interrat_check_new(m);
+    report_triggers_interrat_check_leaving(m);
+    report_triggers_interrat_removing_trigger(m.meas_id);
   }
 }
 void rrc::rrc_meas::var_meas_cfg::report_triggers()
 {
   // for each measId included in the measIdList within VarMeasConfig
-  for (auto& m : measIdList) {
-    if (!reportConfigList.count(m.second.report_cfg_id) || !measObjectsList.count(m.second.meas_obj_id)) {
-      logger.error("MEAS:  Computing report triggers. MeasId=%d has invalid report or object settings", m.first);
-      continue;
-    }
-
-    report_cfg_to_add_mod_s& report_cfg = reportConfigList.at(m.second.report_cfg_id);
-    meas_obj_to_add_mod_s&   meas_obj   = measObjectsList.at(m.second.meas_obj_id);
-
+  for (const meas_id_cfg_t& m : meas_ids) {
     logger.debug("MEAS:  Calculating reports for MeasId=%d, ObjectId=%d (Type %s), ReportId=%d (Type %s)",
-                 m.first,
-                 m.second.meas_obj_id,
-                 report_cfg.report_cfg.type().to_string(),
-                 m.second.report_cfg_id,
-                 meas_obj.meas_obj.type().to_string());
-
-    if (meas_obj.meas_obj.type().value == meas_obj_to_add_mod_s::meas_obj_c_::types_opts::meas_obj_eutra &&
-        report_cfg.report_cfg.type().value == report_cfg_to_add_mod_s::report_cfg_c_::types::report_cfg_eutra) {
-      report_triggers_eutra(m.first, report_cfg.report_cfg.report_cfg_eutra(), meas_obj.meas_obj.meas_obj_eutra());
-    } else if (meas_obj.meas_obj.type().value == meas_obj_to_add_mod_s::meas_obj_c_::types_opts::meas_obj_nr_r15 &&
-               report_cfg.report_cfg.type().value ==
-                   report_cfg_to_add_mod_s::report_cfg_c_::types::report_cfg_inter_rat) {
-      report_triggers_interrat_nr(
-          m.first, report_cfg.report_cfg.report_cfg_inter_rat(), meas_obj.meas_obj.meas_obj_nr_r15());
+                 m.meas_id,
+                 m.meas_obj->meas_obj_id,
+                 m.report_cfg->report_cfg.type().to_string(),
+                 m.report_cfg->report_cfg_id,
+                 m.meas_obj->meas_obj.type().to_string());
+
+    if (m.event == event_b1_nr) {
+      report_triggers_interrat_nr(m);
     } else {
-      logger.error("Unsupported combination of measurement object type %s and report config type %s ",
-                   meas_obj.meas_obj.type().to_string(),
-                   report_cfg.report_cfg.type().to_string());
+      report_triggers_eutra(m);
     }
 
     // upon expiry of the periodical reporting timer for this measId
-    if (meas_report->is_timer_expired(m.first)) {
-      meas_report->generate_report(m.first);
+    if (meas_report->is_timer_expired(m.meas_id)) {
+      meas_report->generate_report(m.meas_id);
     }
   }
 }
@@ -758,204 +740,138 @@ bool rrc::rrc_meas::var_meas_cfg::is_rsrp(report_cfg_eutra_s::trigger_quant_opts
   return q == report_cfg_eutra_s::trigger_quant_opts::rsrp;
 }
 
-void rrc::rrc_meas::var_meas_cfg::eval_triggers_eutra(uint32_t            meas_id,
-                                                      report_cfg_eutra_s& report_cfg,
-                                                      meas_obj_eutra_s&   meas_obj,
-                                                      meas_cell_eutra*    serv_cell,
-                                                      float               Ofs,
-                                                      float               Ocs)
+void rrc::rrc_meas::var_meas_cfg::eval_triggers_eutra(const meas_id_cfg_t& m,
+                                                      meas_cell_eutra*     serv_cell,
+                                                      float                Ofs,
+                                                      float                Ocs)
 {
-  auto asn1_quant_convert = [](report_cfg_eutra_s::trigger_quant_e_ q) {
-    if (q == report_cfg_eutra_s::trigger_quant_opts::rsrp) {
-      return quant_rsrp;
-    } else {
-      return quant_rsrq;
-    }
-  };
-
-  eutra_event_s::event_id_c_ event_id = report_cfg.trigger_type.event().event_id;
-
   // For A1/A2 events, get serving cell from current carrier
-  if (event_id.type().value < eutra_event_s::event_id_c_::types::event_a3 &&
-      meas_obj.carrier_freq != serv_cell->get_earfcn()) {
+  if ((m.event == event_a1 || m.event == event_a2) && m.carrier_freq != serv_cell->get_earfcn()) {
     uint32_t scell_pci = 0;
-    if (!rrc_ptr->meas_cells.get_scell_cc_idx(meas_obj.carrier_freq, scell_pci)) {
-      logger.error("MEAS:  Could not find serving cell for carrier earfcn=%d", meas_obj.carrier_freq);
+    if (!rrc_ptr->meas_cells.get_scell_cc_idx(m.carrier_freq, scell_pci)) {
+      logger.error("MEAS:  Could not find serving cell for carrier earfcn=%d", m.carrier_freq);
       return;
     }
-    serv_cell = rrc_ptr->meas_cells.get_neighbour_cell_handle(meas_obj.carrier_freq, scell_pci);
+    serv_cell = rrc_ptr->meas_cells.get_neighbour_cell_handle(m.carrier_freq, scell_pci);
     if (!serv_cell) {
-      logger.error(
-          "MEAS:  Could not find serving cell for carrier earfcn=%d and pci=%d", meas_obj.carrier_freq, scell_pci);
+      logger.error("MEAS:  Could not find serving cell for carrier earfcn=%d and pci=%d", m.carrier_freq, scell_pci);
       return;
     }
   }
 
-  double hyst = 0.5 * report_cfg.trigger_type.event().hysteresis;
-  float  Ms   = is_rsrp(report_cfg.trigger_quant.value) ? serv_cell->get_rsrp() : serv_cell->get_rsrq();
+  float Ms = m.is_rsrp ? serv_cell->get_rsrp() : serv_cell->get_rsrq();
   if (!std::isnormal(Ms)) {
     logger.debug("MEAS:  Serving cell Ms=%f invalid when evaluating triggers", Ms);
     return;
   }
 
-  if (report_cfg.trigger_type.type() == report_cfg_eutra_s::trigger_type_c_::types::event) {
-    // A1 & A2 are for serving cell only
-    if (event_id.type().value < eutra_event_s::event_id_c_::types::event_a3) {
-      float thresh          = 0.0;
-      bool  enter_condition = false;
-      bool  exit_condition  = false;
-      if (event_id.type() == eutra_event_s::event_id_c_::types::event_a1) {
-        if (event_id.event_a1().a1_thres.type().value == thres_eutra_c::types::thres_rsrp) {
-          thresh = rrc_range_to_value(asn1_quant_convert(report_cfg.trigger_quant),
-                                      event_id.event_a1().a1_thres.thres_rsrp());
-        } else {
-          thresh = rrc_range_to_value(asn1_quant_convert(report_cfg.trigger_quant),
-                                      event_id.event_a1().a1_thres.thres_rsrq());
-        }
-        enter_condition = Ms - hyst > thresh;
-        exit_condition  = Ms + hyst < thresh;
-      } else {
-        if (event_id.event_a2().a2_thres.type() == thres_eutra_c::types::thres_rsrp) {
-          thresh = rrc_range_to_value(asn1_quant_convert(report_cfg.trigger_quant),
-                                      event_id.event_a2().a2_thres.thres_rsrp());
-        } else {
-          thresh = rrc_range_to_value(asn1_quant_convert(report_cfg.trigger_quant),
-                                      event_id.event_a2().a2_thres.thres_rsrq());
-        }
-        enter_condition = Ms + hyst < thresh;
-        exit_condition  = Ms - hyst > thresh;
-      }
-
-      trigger_state[meas_id][serv_cell->get_pci()].event_condition(enter_condition, exit_condition);
+  // All events are evaluated as M - hyst > ref to enter and M + hyst < ref to leave, where M is the measurement of
+  // each cell with its offsets applied
+  cell_trigger_list& cells         = trigger_state[m.meas_id];
+  float              ref           = 0;
+  bool               enter_allowed = true;
+  bool               exit_allowed  = true;
+  cells.begin_eval();
+  switch (m.event) {
+    case event_a1:
+      // A1 & A2 are for serving cell only
+      cells.set_meas(serv_cell->get_pci(), Ms);
+      ref = m.thresh1;
+      break;
+    case event_a2:
+      // A2 is A1 with the sign of both sides inverted
+      cells.set_meas(serv_cell->get_pci(), -Ms);
+      ref = -m.thresh1;
+      break;
+    case event_a3:
+      ref = Ms + Ofs + Ocs + m.offset;
+      break;
+    case event_a4:
+      ref = m.thresh1;
+      break;
+    case event_a5:
+      ref           = m.thresh2;
+      enter_allowed = Ms + m.hyst < m.thresh1;
+      exit_allowed  = Ms - m.hyst > m.thresh1;
+      break;
+    default:
+      return;
+  }
 
-      logger.debug("MEAS:  eventId=%s, Ms=%.2f, hyst=%.2f, Thresh=%.2f, enter_condition=%d, exit_condition=%d",
-                   event_id.type().to_string(),
-                   Ms,
-                   hyst,
-                   thresh,
-                   enter_condition,
-                   exit_condition);
+  // Rest are evaluated for every cell in frequency
+  if (m.event != event_a1 && m.event != event_a2) {
+    const std::vector<float>& Mn = m.is_rsrp ? neighbours.rsrp : neighbours.rsrq;
+    for (uint32_t i = 0; i < neighbours.pci.size(); i++) {
+      if (neighbours.earfcn[i] == m.carrier_freq) {
+        uint32_t pci = neighbours.pci[i];
+        float    Ocn = pci < m.ocn.size() ? m.ocn[pci] : 0;
+        cells.set_meas(pci, Mn[i] + m.ofn + Ocn);
+      }
+    }
+  }
 
-      // Rest are evaluated for every cell in frequency
-    } else {
-      auto cells = rrc_ptr->get_cells(meas_obj.carrier_freq);
-      for (auto& pci : cells) {
-        logger.debug("MEAS:  eventId=%s, pci=%d, earfcn=%d", event_id.type().to_string(), pci, meas_obj.carrier_freq);
-        float Ofn = offset_val(meas_obj);
-        float Ocn = 0;
-        // If the cell was provided by the configuration, check if it has an individual q_offset
-        auto n = find_pci_in_meas_obj(meas_obj, pci);
-        if (n != meas_obj.cells_to_add_mod_list.end()) {
-          Ocn = n->cell_individual_offset.to_number();
-        }
-        float Mn = 0;
-        if (is_rsrp(report_cfg.trigger_quant.value)) {
-          Mn = rrc_ptr->get_cell_rsrp(meas_obj.carrier_freq, pci);
-        } else {
-          Mn = rrc_ptr->get_cell_rsrq(meas_obj.carrier_freq, pci);
-        }
-        double  Off    = 0;
-        float   thresh = 0, th1 = 0, th2 = 0;
-        bool    enter_condition = false;
-        bool    exit_condition  = false;
-        uint8_t range, range2;
-        switch (event_id.type().value) {
-          case eutra_event_s::event_id_c_::types::event_a3:
-            Off             = 0.5 * event_id.event_a3().a3_offset;
-            enter_condition = Mn + Ofn + Ocn - hyst > Ms + Ofs + Ocs + Off;
-            exit_condition  = Mn + Ofn + Ocn + hyst < Ms + Ofs + Ocs + Off;
-            break;
-          case eutra_event_s::event_id_c_::types::event_a4:
-            if (event_id.event_a4().a4_thres.type() == thres_eutra_c::types::thres_rsrp) {
-              range = event_id.event_a4().a4_thres.thres_rsrp();
-            } else {
-              range = event_id.event_a4().a4_thres.thres_rsrq();
-            }
-            thresh          = rrc_range_to_value(asn1_quant_convert(report_cfg.trigger_quant.value), range);
-            enter_condition = Mn + Ofn + Ocn - hyst > thresh;
-            exit_condition  = Mn + Ofn + Ocn + hyst < thresh;
-            break;
-          case eutra_event_s::event_id_c_::types::event_a5:
-            if (event_id.event_a5().a5_thres1.type() == thres_eutra_c::types::thres_rsrp) {
-              range = event_id.event_a5().a5_thres1.thres_rsrp();
-            } else {
-              range = event_id.event_a5().a5_thres1.thres_rsrq();
-            }
-            if (event_id.event_a5().a5_thres2.type() == thres_eutra_c::types::thres_rsrp) {
-              range2 = event_id.event_a5().a5_thres2.thres_rsrp();
-            } else {
-              range2 = event_id.event_a5().a5_thres2.thres_rsrq();
-            }
-            th1             = rrc_range_to_value(asn1_quant_convert(report_cfg.trigger_quant.value), range);
-            th2             = rrc_range_to_value(asn1_quant_convert(report_cfg.trigger_quant.value), range2);
-            enter_condition = (Ms + hyst < th1) && (Mn + Ofn + Ocn - hyst > th2);
-            exit_condition  = (Ms - hyst > th1) && (Mn + Ofn + Ocn + hyst < th2);
-            break;
-          default:
-            logger.error("Error event %s not implemented", event_id.type().to_string());
-        }
+  cells.event_condition(ref, m.hyst, enter_allowed, exit_allowed);
 
-        trigger_state[meas_id][pci].event_condition(enter_condition, exit_condition);
-
-        logger.debug(
-            "MEAS:  eventId=%s, pci=%d, Ms=%.2f, hyst=%.2f, Thresh=%.2f, enter_condition=%d, exit_condition=%d",
-            event_id.type().to_string(),
-            pci,
-            Ms,
-            hyst,
-            thresh,
-            enter_condition,
-            exit_condition);
+  if (logger.debug.enabled()) {
+    const char* event_str = m.report_cfg->report_cfg.report_cfg_eutra().trigger_type.event().event_id.type().to_string();
+    for (uint32_t i = 0; i < cells.size(); i++) {
+      if (cells.measured[i]) {
+        logger.debug("MEAS:  eventId=%s, pci=%d, earfcn=%d, Ms=%.2f, hyst=%.2f, ref=%.2f, enter_condition=%d, "
+                     "exit_condition=%d",
+                     event_str,
+                     cells.pci[i],
+                     m.carrier_freq,
+                     Ms,
+                     m.hyst,
+                     ref,
+                     cells.entering[i],
+                     cells.leaving[i]);
       }
     }
   }
 }
 
-void rrc::rrc_meas::var_meas_cfg::eval_triggers_interrat_nr(uint32_t                meas_id,
-                                                            report_cfg_inter_rat_s& report_cfg,
-                                                            meas_obj_nr_r15_s&      meas_obj)
+void rrc::rrc_meas::var_meas_cfg::eval_triggers_interrat_nr(const meas_id_cfg_t& m)
 {
-  if (!(report_cfg.trigger_type.type() == report_cfg_inter_rat_s::trigger_type_c_::types::event)) {
-    logger.error("Unsupported trigger type for interrat nr eval");
-    return;
+  cell_trigger_list& cells = trigger_state_nr[m.meas_id];
+  cells.begin_eval();
+  for (uint32_t i = 0; i < neighbours_nr.pci.size(); i++) {
+    if (neighbours_nr.earfcn[i] == m.carrier_freq) {
+      cells.set_meas(neighbours_nr.pci[i], neighbours_nr.rsrp[i]);
+    }
   }
 
-  report_cfg_inter_rat_s::trigger_type_c_::event_s_::event_id_c_ event_id = report_cfg.trigger_type.event().event_id;
-
-  double hyst = (double)report_cfg.trigger_type.event().hysteresis;
-
-  auto cells = rrc_ptr->get_cells_nr(meas_obj.carrier_freq_r15);
+  cells.event_condition(m.thresh1, m.hyst, true, true);
 
-  for (auto& pci : cells) {
-    float thresh          = 0.0;
-    bool  enter_condition = false;
-    bool  exit_condition  = false;
-    float Mn              = 0.0;
-
-    logger.debug("MEAS:  eventId=%s, pci=%d, earfcn=%d", event_id.type().to_string(), pci, meas_obj.carrier_freq_r15);
-
-    if (event_id.event_b1_nr_r15().b1_thres_nr_r15.type().value == thres_nr_r15_c::types::nr_rsrp_r15) {
-      Mn     = rrc_ptr->get_cell_rsrp_nr(meas_obj.carrier_freq_r15, pci);
-      thresh = range_to_value_nr(asn1::rrc::thres_nr_r15_c::types_opts::options::nr_rsrp_r15,
-                                 event_id.event_b1_nr_r15().b1_thres_nr_r15.nr_rsrp_r15());
-    } else {
-      logger.warning("Other threshold values are not supported yet!");
+  if (logger.debug.enabled()) {
+    for (uint32_t i = 0; i < cells.size(); i++) {
+      if (cells.measured[i]) {
+        logger.debug("MEAS (NR):  pci=%d, earfcn=%d, Mn=%.2f, hyst=%.2f, Thresh=%.2f, enter_condition=%d, "
+                     "exit_condition=%d",
+                     cells.pci[i],
+                     m.carrier_freq,
+                     cells.meas[i],
+                     m.hyst,
+                     m.thresh1,
+                     cells.entering[i],
+                     cells.leaving[i]);
+      }
     }
+  }
+}
 
-    enter_condition = Mn - hyst > thresh;
-    exit_condition  = Mn + hyst < thresh;
-
-    trigger_state_nr[meas_id][pci].event_condition(enter_condition, exit_condition);
-
-    logger.debug("MEAS (NR):  eventId=%s, Mn=%.2f, hyst=%.2f, Thresh=%.2f, enter_condition=%d, exit_condition=%d",
-                 event_id.type().to_string(),
-                 Mn,
-                 hyst,
-                 thresh,
-                 enter_condition,
-                 exit_condition);
+void rrc::rrc_meas::var_meas_cfg::gather_neighbour_meas()
+{
+  neighbours.clear();
+  for (auto& c : rrc_ptr->meas_cells) {
+    neighbours.push_back(c->get_earfcn(), c->get_pci(), c->get_rsrp(), c->get_rsrq());
+  }
+  neighbours_nr.clear();
+  for (auto& c : rrc_ptr->meas_cells_nr) {
+    neighbours_nr.push_back(c->get_earfcn(), c->get_pci(), c->get_rsrp(), c->get_rsrq());
   }
 }
+
 /* Evaluate event trigger conditions for each cell 5.5.4 */
 void rrc::rrc_meas::var_meas_cfg::eval_triggers()
 {
@@ -983,39 +899,150 @@ void rrc::rrc_meas::var_meas_cfg::eval_triggers()
     }
   }
 
+  gather_neighbour_meas();
+
+  for (const meas_id_cfg_t& m : meas_ids) {
+    logger.debug("MEAS:  Calculating trigger for MeasId=%d, ObjectId=%d (Type %s), ReportId=%d (Type %s)",
+                 m.meas_id,
+                 m.meas_obj->meas_obj_id,
+                 m.report_cfg->report_cfg.type().to_string(),
+                 m.report_cfg->report_cfg_id,
+                 m.meas_obj->meas_obj.type().to_string());
+
+    if (m.event == event_b1_nr) {
+      eval_triggers_interrat_nr(m);
+    } else if (m.event != event_none) {
+      eval_triggers_eutra(m, serv_cell, Ofs, Ocs);
+    }
+  }
+}
+
+// Resolves the objects and event parameters of every measId, so that eval_triggers() and report_triggers() neither
+// look up the maps nor decode the ASN.1 configuration on every TTI
+void rrc::rrc_meas::var_meas_cfg::compile_meas_ids()
+{
+  meas_ids.clear();
   for (auto& m : measIdList) {
     if (!reportConfigList.count(m.second.report_cfg_id) || !measObjectsList.count(m.second.meas_obj_id)) {
       logger.error("MEAS:  Computing report triggers. MeasId=%d has invalid report or object settings", m.first);
       continue;
     }
+    if (m.first > max_meas_id) {
+      logger.error("MEAS:  MeasId=%d exceeds the maximum %d", m.first, max_meas_id);
+      continue;
+    }
 
-    report_cfg_to_add_mod_s& report_cfg = reportConfigList.at(m.second.report_cfg_id);
-    meas_obj_to_add_mod_s&   meas_obj   = measObjectsList.at(m.second.meas_obj_id);
+    meas_id_cfg_t c = {};
+    c.meas_id       = m.first;
+    c.report_cfg    = &reportConfigList.at(m.second.report_cfg_id);
+    c.meas_obj      = &measObjectsList.at(m.second.meas_obj_id);
 
-    logger.debug("MEAS:  Calculating trigger for MeasId=%d, ObjectId=%d (Type %s), ReportId=%d (Type %s)",
-                 m.first,
-                 m.second.meas_obj_id,
-                 report_cfg.report_cfg.type().to_string(),
-                 m.second.report_cfg_id,
-                 meas_obj.meas_obj.type().to_string());
-
-    if (meas_obj.meas_obj.type().value == meas_obj_to_add_mod_s::meas_obj_c_::types_opts::meas_obj_eutra &&
-        report_cfg.report_cfg.type().value == report_cfg_to_add_mod_s::report_cfg_c_::types::report_cfg_eutra) {
-      eval_triggers_eutra(
-          m.first, report_cfg.report_cfg.report_cfg_eutra(), meas_obj.meas_obj.meas_obj_eutra(), serv_cell, Ofs, Ocs);
-    } else if (meas_obj.meas_obj.type().value == meas_obj_to_add_mod_s::meas_obj_c_::types_opts::meas_obj_nr_r15 &&
-               report_cfg.report_cfg.type().value ==
-                   report_cfg_to_add_mod_s::report_cfg_c_::types::report_cfg_inter_rat)
-      eval_triggers_interrat_nr(
-          m.first, report_cfg.report_cfg.report_cfg_inter_rat(), meas_obj.meas_obj.meas_obj_nr_r15());
-    else {
+    if (c.meas_obj->meas_obj.type().value == meas_obj_to_add_mod_s::meas_obj_c_::types_opts::meas_obj_eutra &&
+        c.report_cfg->report_cfg.type().value == report_cfg_to_add_mod_s::report_cfg_c_::types::report_cfg_eutra) {
+      compile_event_eutra(c);
+    } else if (c.meas_obj->meas_obj.type().value == meas_obj_to_add_mod_s::meas_obj_c_::types_opts::meas_obj_nr_r15 &&
+               c.report_cfg->report_cfg.type().value ==
+                   report_cfg_to_add_mod_s::report_cfg_c_::types::report_cfg_inter_rat) {
+      compile_event_interrat_nr(c);
+    } else {
       logger.error("Unsupported combination of measurement object type %s and report config type %s ",
-                   meas_obj.meas_obj.type().to_string(),
-                   report_cfg.report_cfg.type().to_string());
+                   c.meas_obj->meas_obj.type().to_string(),
+                   c.report_cfg->report_cfg.type().to_string());
     }
+
+    // Periodical and unsupported measIds are kept, the periodical reporting timer is checked for all of them
+    meas_ids.push_back(c);
   }
 }
 
+void rrc::rrc_meas::var_meas_cfg::compile_event_eutra(meas_id_cfg_t& m)
+{
+  report_cfg_eutra_s& report_cfg = m.report_cfg->report_cfg.report_cfg_eutra();
+  meas_obj_eutra_s&   meas_obj   = m.meas_obj->meas_obj.meas_obj_eutra();
+
+  m.carrier_freq = meas_obj.carrier_freq;
+  m.is_rsrp      = is_rsrp(report_cfg.trigger_quant.value);
+  m.ofn          = offset_val(meas_obj);
+  // In reverse order, so that the first entry of a PCI listed twice prevails
+  for (uint32_t i = meas_obj.cells_to_add_mod_list.size(); i > 0; i--) {
+    const cells_to_add_mod_s& cell = meas_obj.cells_to_add_mod_list[i - 1];
+    if (cell.pci < m.ocn.size()) {
+      m.ocn[cell.pci] = cell.cell_individual_offset.to_number();
+    }
+  }
+
+  if (report_cfg.trigger_type.type() != report_cfg_eutra_s::trigger_type_c_::types::event) {
+    return;
+  }
+
+  const eutra_event_s::event_id_c_& event_id = report_cfg.trigger_type.event().event_id;
+
+  quant_s quant     = m.is_rsrp ? quant_rsrp : quant_rsrq;
+  auto    thres_val = [quant](const thres_eutra_c& thres) {
+    return rrc_range_to_value(
+        quant, thres.type().value == thres_eutra_c::types::thres_rsrp ? thres.thres_rsrp() : thres.thres_rsrq());
+  };
+
+  m.hyst            = 0.5f * report_cfg.trigger_type.event().hysteresis;
+  m.time_to_trigger = report_cfg.trigger_type.event().time_to_trigger.to_number();
+  switch (event_id.type().value) {
+    case eutra_event_s::event_id_c_::types::event_a1:
+      m.event   = event_a1;
+      m.thresh1 = thres_val(event_id.event_a1().a1_thres);
+      break;
+    case eutra_event_s::event_id_c_::types::event_a2:
+      m.event   = event_a2;
+      m.thresh1 = thres_val(event_id.event_a2().a2_thres);
+      break;
+    case eutra_event_s::event_id_c_::types::event_a3:
+      m.event           = event_a3;
+      m.offset          = 0.5f * event_id.event_a3().a3_offset;
+      m.report_on_leave = event_id.event_a3().report_on_leave;
+      break;
+    case eutra_event_s::event_id_c_::types::event_a4:
+      m.event   = event_a4;
+      m.thresh1 = thres_val(event_id.event_a4().a4_thres);
+      break;
+    case eutra_event_s::event_id_c_::types::event_a5:
+      m.event   = event_a5;
+      m.thresh1 = thres_val(event_id.event_a5().a5_thres1);
+      m.thresh2 = thres_val(event_id.event_a5().a5_thres2);
+      break;
+    default:
+      logger.error("Error event %s not implemented", event_id.type().to_string());
+  }
+}
+
+void rrc::rrc_meas::var_meas_cfg::compile_event_interrat_nr(meas_id_cfg_t& m)
+{
+  report_cfg_inter_rat_s& report_cfg = m.report_cfg->report_cfg.report_cfg_inter_rat();
+  m.carrier_freq                     = m.meas_obj->meas_obj.meas_obj_nr_r15().carrier_freq_r15;
+
+  if (!(report_cfg.trigger_type.type() == report_cfg_inter_rat_s::trigger_type_c_::types::event)) {
+    logger.error("Unsupported trigger type for interrat nr eval");
+    return;
+  }
+
+  const report_cfg_inter_rat_s::trigger_type_c_::event_s_::event_id_c_& event_id =
+      report_cfg.trigger_type.event().event_id;
+  if (event_id.type().value !=
+      report_cfg_inter_rat_s::trigger_type_c_::event_s_::event_id_c_::types_opts::event_b1_nr_r15) {
+    logger.error("Error event %s not implemented", event_id.type().to_string());
+    return;
+  }
+  if (event_id.event_b1_nr_r15().b1_thres_nr_r15.type().value != thres_nr_r15_c::types::nr_rsrp_r15) {
+    logger.warning("Other threshold values are not supported yet!");
+    return;
+  }
+
+  m.event           = event_b1_nr;
+  m.hyst            = (float)report_cfg.trigger_type.event().hysteresis;
+  m.time_to_trigger = report_cfg.trigger_type.event().time_to_trigger.to_number();
+  m.thresh1         = range_to_value_nr(asn1::rrc::thres_nr_r15_c::types_opts::options::nr_rsrp_r15,
+                                event_id.event_b1_nr_r15().b1_thres_nr_r15.nr_rsrp_r15());
+  m.report_on_leave = event_id.event_b1_nr_r15().report_on_leave_r15;
+}
+
 /***
  *
  * varMeasConfig class
@@ -1034,6 +1061,7 @@ void rrc::rrc_meas::var_meas_cfg::reset()
   measIdList.clear();
   measObjectsList.clear();
   reportConfigList.clear();
+  compile_meas_ids();
 }
 
 rrc::rrc_meas::phy_quant_t rrc::rrc_meas::var_meas_cfg::get_filter_a()
@@ -1047,13 +1075,16 @@ rrc::rrc_meas::phy_quant_t rrc::rrc_meas::var_meas_cfg::get_filter_a()
 void rrc::rrc_meas::var_meas_cfg::remove_measId(const uint32_t measId)
 {
   measIdList.erase(measId);
+  compile_meas_ids();
 }
 
 void rrc::rrc_meas::var_meas_cfg::remove_varmeas_report(const uint32_t meas_id)
 {
   meas_report->remove_varmeas_report(meas_id);
-  trigger_state.erase(meas_id);
-  trigger_state_nr.erase(meas_id);
+  if (meas_id <= max_meas_id) {
+    trigger_state[meas_id].clear();
+    trigger_state_nr[meas_id].clear();
+  }
 }
 
 std::list<meas_obj_to_add_mod_s> rrc::rrc_meas::var_meas_cfg::get_active_objects()
@@ -1161,7 +1192,10 @@ void rrc::rrc_meas::var_meas_cfg::ho_reest_finish(const uint32_t src_earfcn, con
   }
 
   meas_report->remove_all_varmeas_reports();
-  trigger_state.clear();
+  for (cell_trigger_list& cells : trigger_state) {
+    cells.clear();
+  }
+  compile_meas_ids();
 }
 
 // Measurement object removal 5.5.2.4
@@ -1587,6 +1621,8 @@ bool rrc::rrc_meas::var_meas_cfg::parse_meas_config(const meas_cfg_s* cfg, bool
     }
   }
 
+  compile_meas_ids();
+
   // According to 5.5.6.1, if the new configuration after a HO/Reest does not configure the target frequency, we need
   // to swap frequencies with source
   if (is_ho_reest) {
@@ -1608,28 +1644,82 @@ bool rrc::rrc_meas::var_meas_cfg::parse_meas_config(const meas_cfg_s* cfg, bool
   return true;
 }
 
-void rrc::rrc_meas::var_meas_cfg::cell_trigger_state::event_condition(const bool enter, const bool exit)
+void rrc::rrc_meas::var_meas_cfg::cell_trigger_list::clear()
 {
-  if (enter) {
-    nof_tti_enter++;
-    nof_tti_exit = 0;
-  } else if (exit) {
-    nof_tti_enter = 0;
-    nof_tti_exit++;
-  } else {
-    nof_tti_enter = 0;
-    nof_tti_exit  = 0;
+  pci.clear();
+  nof_tti_enter.clear();
+  nof_tti_exit.clear();
+  meas.clear();
+  measured.clear();
+  entering.clear();
+  leaving.clear();
+}
+
+int32_t rrc::rrc_meas::var_meas_cfg::cell_trigger_list::find(uint32_t pci_) const
+{
+  auto it = std::lower_bound(pci.begin(), pci.end(), pci_);
+  return (it != pci.end() && *it == pci_) ? (int32_t)(it - pci.begin()) : -1;
+}
+
+void rrc::rrc_meas::var_meas_cfg::cell_trigger_list::begin_eval()
+{
+  std::fill(measured.begin(), measured.end(), 0);
+}
+
+void rrc::rrc_meas::var_meas_cfg::cell_trigger_list::set_meas(uint32_t pci_, float value)
+{
+  auto     it  = std::lower_bound(pci.begin(), pci.end(), pci_);
+  uint32_t idx = it - pci.begin();
+  if (it == pci.end() || *it != pci_) {
+    pci.insert(it, pci_);
+    nof_tti_enter.insert(nof_tti_enter.begin() + idx, 0);
+    nof_tti_exit.insert(nof_tti_exit.begin() + idx, 0);
+    meas.insert(meas.begin() + idx, 0);
+    measured.insert(measured.begin() + idx, 0);
+    entering.insert(entering.begin() + idx, 0);
+    leaving.insert(leaving.begin() + idx, 0);
+  }
+  meas[idx]     = value;
+  measured[idx] = 1;
+}
+
+// Updates the counters of all measured cells at once. Cells not measured in this evaluation keep their counters
+void rrc::rrc_meas::var_meas_cfg::cell_trigger_list::event_condition(float ref,
+                                                                     float hyst,
+                                                                     bool  enter_allowed,
+                                                                     bool  exit_allowed)
+{
+  uint32_t  n         = pci.size();
+  uint32_t* tti_enter = nof_tti_enter.data();
+  uint32_t* tti_exit  = nof_tti_exit.data();
+  for (uint32_t i = 0; i < n; i++) {
+    uint8_t en  = (uint8_t)(enter_allowed && meas[i] - hyst > ref);
+    uint8_t ex  = (uint8_t)(exit_allowed && meas[i] + hyst < ref);
+    entering[i] = en;
+    leaving[i]  = ex;
+  }
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t e   = entering[i] ? tti_enter[i] + 1 : 0;
+    uint32_t x   = (!entering[i] && leaving[i]) ? tti_exit[i] + 1 : 0;
+    tti_enter[i] = measured[i] ? e : tti_enter[i];
+    tti_exit[i]  = measured[i] ? x : tti_exit[i];
   }
 }
 
-bool rrc::rrc_meas::var_meas_cfg::cell_trigger_state::is_enter_equal(const uint32_t nof_tti)
+void rrc::rrc_meas::var_meas_cfg::cell_meas_list_t::clear()
 {
-  return nof_tti < nof_tti_enter;
+  earfcn.clear();
+  pci.clear();
+  rsrp.clear();
+  rsrq.clear();
 }
 
-bool rrc::rrc_meas::var_meas_cfg::cell_trigger_state::is_exit_equal(const uint32_t nof_tti)
+void rrc::rrc_meas::var_meas_cfg::cell_meas_list_t::push_back(uint32_t earfcn_, uint32_t pci_, float rsrp_, float rsrq_)
 {
-  return nof_tti < nof_tti_exit;
+  earfcn.push_back(earfcn_);
+  pci.push_back(pci_);
+  rsrp.push_back(rsrp_);
+  rsrq.push_back(rsrq_);
 }
 
 } // namespace srsue
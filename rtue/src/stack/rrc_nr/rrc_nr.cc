@@ -625,7 +625,47 @@ void rrc_nr::send_setup_request(srsran::nr_establishment_cause_t cause)
   rrc_setup_req->ue_id.random_value().from_number(random_id, rrc_setup_req->ue_id.random_value().length());
   rrc_setup_req->establishment_cause = (establishment_cause_opts::options)cause;
 
-  send_ul_ccch_msg(ul_ccch_msg);
+  // Requests only differ in the UE identity and the cause, which are patched into the packed message
+  if (setup_request_tmpl.empty() and make_setup_request_template() != SRSRAN_SUCCESS) {
+    send_ul_ccch_msg(ul_ccch_msg);
+    return;
+  }
+
+  unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+  if (pdu == nullptr) {
+    logger.error("Couldn't allocate PDU in %s().", __FUNCTION__);
+    return;
+  }
+  setup_request_tmpl.set_field(setup_request_ue_id_field, random_id);
+  setup_request_tmpl.set_field(setup_request_cause_field, rrc_setup_req->establishment_cause.value);
+  pdu->N_bytes = setup_request_tmpl.write(pdu->msg, pdu->get_tailroom());
+  send_ul_ccch_pdu(ul_ccch_msg, std::move(pdu));
+}
+
+int rrc_nr::make_setup_request_template()
+{
+  ul_ccch_msg_s            msg;
+  rrc_setup_request_ies_s& req   = msg.msg.set_c1().set_rrc_setup_request().rrc_setup_request;
+  auto&                    ue_id = req.ue_id.set_random_value();
+
+  // Reference with zero fields, then one probe per field with all its bits set
+  ue_id.from_number(0, ue_id.length());
+  req.establishment_cause = establishment_cause_opts::emergency;
+  if (setup_request_tmpl.pack_reference(msg) != SRSASN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+  ue_id.from_number(UINT64_MAX, ue_id.length());
+  setup_request_ue_id_field = setup_request_tmpl.learn_field(msg);
+  ue_id.from_number(0, ue_id.length());
+  req.establishment_cause   = establishment_cause_opts::spare1;
+  setup_request_cause_field = setup_request_tmpl.learn_field(msg);
+
+  if (setup_request_ue_id_field < 0 or setup_request_cause_field < 0) {
+    logger.error("Couldn't create RRC Setup Request template");
+    setup_request_tmpl = {};
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
 }
 
 void rrc_nr::send_ul_ccch_msg(const asn1::rrc_nr::ul_ccch_msg_s& msg)
@@ -643,6 +683,11 @@ void rrc_nr::send_ul_ccch_msg(const asn1::rrc_nr::ul_ccch_msg_s& msg)
   }
   bref.align_bytes_zero();
   pdu->N_bytes = (uint32_t)bref.distance_bytes(pdu->msg);
+  send_ul_ccch_pdu(msg, std::move(pdu));
+}
+
+void rrc_nr::send_ul_ccch_pdu(const asn1::rrc_nr::ul_ccch_msg_s& msg, srsran::unique_byte_buffer_t pdu)
+{
   pdu->set_timestamp();
 
   // Set UE contention resolution ID in MAC
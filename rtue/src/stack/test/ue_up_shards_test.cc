@@ -0,0 +1,175 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/task_scheduler.h"
+#include "srsran/support/srsran_test.h"
+#include "srsran/test/ue_test_interfaces.h"
+#include "rtue/hdr/stack/ue_up_shards.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace srsue;
+
+static const uint32_t nof_workers = 3;
+static const uint32_t first_lcid  = 3;
+static const uint32_t nof_lcids   = 8;
+static const uint32_t nof_rounds  = 200;
+
+/// Records the order of the tasks of every bearer and any overlap between shard tasks and exclusive sections
+class shard_checker
+{
+public:
+  void shard_task(uint32_t lcid, uint32_t sn)
+  {
+    nof_active++;
+    if (exclusive) {
+      nof_overlaps++;
+    }
+    // Only the shard of the bearer touches its sequence number
+    if (sn != next_sn[lcid]) {
+      nof_out_of_order++;
+    }
+    next_sn[lcid] = sn + 1;
+    spin();
+    nof_active--;
+    nof_shard_tasks++;
+  }
+
+  void exclusive_task()
+  {
+    exclusive = true;
+    if (nof_active > 0) {
+      nof_overlaps++;
+    }
+    spin();
+    if (nof_active > 0) {
+      nof_overlaps++;
+    }
+    exclusive = false;
+    nof_exclusive_tasks++;
+  }
+
+  std::array<uint32_t, SRSRAN_N_RADIO_BEARERS> next_sn = {};
+  std::atomic<uint32_t>                        nof_active{0};
+  std::atomic<bool>                            exclusive{false};
+  std::atomic<uint32_t>                        nof_overlaps{0};
+  std::atomic<uint32_t>                        nof_out_of_order{0};
+  std::atomic<uint32_t>                        nof_shard_tasks{0};
+  std::atomic<uint32_t>                        nof_exclusive_tasks{0};
+
+private:
+  // Gives the other threads a chance to run while the task is in progress
+  static void spin()
+  {
+    for (uint32_t i = 0; i < 10; i++) {
+      std::this_thread::yield();
+    }
+  }
+};
+
+/// DL PDUs carry their sequence number
+class rlc_dummy : public srsue::rlc_dummy_interface
+{
+public:
+  explicit rlc_dummy(shard_checker& checker_) : checker(checker_) {}
+
+  void write_pdu(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) override
+  {
+    uint32_t sn = 0;
+    memcpy(&sn, payload, sizeof(sn));
+    checker.shard_task(lcid, sn);
+  }
+
+private:
+  shard_checker& checker;
+};
+
+int test_interleaved_tasks()
+{
+  shard_checker             checker;
+  rlc_dummy                 rlc(checker);
+  ue_up_shards              up_shards;
+  srsran::task_scheduler    task_sched;
+  srsran::task_queue_handle stack_queue = task_sched.make_task_queue();
+
+  up_shards.init(nof_workers, -1, &rlc);
+  for (uint32_t lcid = first_lcid; lcid < first_lcid + nof_lcids; lcid++) {
+    TESTASSERT(up_shards.is_sharded(lcid));
+  }
+
+  // The stack thread runs its tasks with the control lock held exclusively
+  std::atomic<bool> running{true};
+  std::thread       stack_thread([&]() {
+    while (running) {
+      task_sched.run_next_task(up_shards);
+    }
+  });
+
+  // Interleave DL PDUs, UL tasks and stack tasks
+  for (uint32_t round = 0; round < nof_rounds; round++) {
+    for (uint32_t lcid = first_lcid; lcid < first_lcid + nof_lcids; lcid++) {
+      uint32_t sn = 2 * round;
+      up_shards.write_pdu(lcid, reinterpret_cast<uint8_t*>(&sn), sizeof(sn));
+
+      sn += 1;
+      while (not up_shards.push(lcid, [&checker, lcid, sn]() { checker.shard_task(lcid, sn); })) {
+        std::this_thread::yield();
+      }
+    }
+    stack_queue.push([&checker]() { checker.exclusive_task(); });
+  }
+
+  // Wait for all tasks to complete
+  const uint32_t nof_shard_tasks = 2 * nof_rounds * nof_lcids;
+  for (uint32_t i = 0; i < 10000; i++) {
+    if (checker.nof_shard_tasks == nof_shard_tasks and checker.nof_exclusive_tasks == nof_rounds) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  running = false;
+  task_sched.stop();
+  stack_thread.join();
+  up_shards.stop();
+
+  TESTASSERT_EQ(nof_shard_tasks, checker.nof_shard_tasks.load());
+  TESTASSERT_EQ(nof_rounds, checker.nof_exclusive_tasks.load());
+  TESTASSERT_EQ(0, checker.nof_out_of_order.load());
+  TESTASSERT_EQ(0, checker.nof_overlaps.load());
+  for (uint32_t lcid = first_lcid; lcid < first_lcid + nof_lcids; lcid++) {
+    TESTASSERT_EQ(2 * nof_rounds, checker.next_sn[lcid]);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  srslog::init();
+
+  TESTASSERT_SUCCESS(test_interleaved_tasks());
+
+  srslog::flush();
+  return SRSRAN_SUCCESS;
+}
@@ -221,7 +221,12 @@ int ue_stack_lte::init(const stack_args_t& args_)
   // add sync queue
   sync_task_queue = task_sched.make_task_queue(args.sync_queue_size);
 
-  mac.init(phy, &rlc, &rrc);
+  if (args.nof_up_workers > 0) {
+    up_shards.init(args.nof_up_workers, STACK_MAIN_THREAD_PRIO, &rlc);
+    mac.init(phy, &up_shards, &rrc);
+  } else {
+    mac.init(phy, &rlc, &rrc);
+  }
   rlc.init(&pdcp, &rrc, task_sched.get_timer_handler(), 0 /* RB_ID_SRB0 */);
   nas.init(usim.get(), &rrc, gw, args.nas);
 
@@ -263,6 +268,8 @@ int ue_stack_lte::init(const stack_args_t& args_)
 void ue_stack_lte::stop()
 {
   if (running) {
+    // Shards are joined here, the stack thread may be waiting for a shard task to release the control lock
+    up_shards.stop();
     ue_task_queue.try_push([this]() { stop_impl(); });
     wait_thread_finish();
   }
@@ -373,6 +380,7 @@ bool ue_stack_lte::get_metrics(stack_metrics_t* metrics)
     mac_nr.get_metrics(metrics.mac_nr);
     rlc.get_metrics(metrics.rlc, metrics.mac[0].nof_tti);
     nas.get_metrics(&metrics.nas);
+    nas_5g.get_metrics(metrics.nas_5g);
     rrc.get_metrics(metrics.rrc);
     rrc_nr.get_metrics(metrics.rrc_nr);
     pending_stack_metrics.push(metrics);
@@ -384,6 +392,12 @@ bool ue_stack_lte::get_metrics(stack_metrics_t* metrics)
 
 void ue_stack_lte::run_thread()
 {
+  if (up_shards.enabled()) {
+    while (running) {
+      task_sched.run_next_task(up_shards);
+    }
+    return;
+  }
   while (running) {
     task_sched.run_next_task();
   }
@@ -423,6 +437,17 @@ void ue_stack_lte::write_sdu(uint32_t eps_bearer_id, srsran::unique_byte_buffer_
 {
   auto bearer = bearers.get_radio_bearer(eps_bearer_id);
 
+  if (bearer.rat == srsran_rat_t::lte and up_shards.is_sharded(bearer.lcid)) {
+    auto shard_task = [this, bearer](srsran::unique_byte_buffer_t& sdu) {
+      pdcp.write_sdu(bearer.lcid, std::move(sdu));
+    };
+    if (not up_shards.push(bearer.lcid, std::bind(shard_task, std::move(sdu)))) {
+      pdcp_logger.info("GW SDU with lcid=%d was discarded.", bearer.lcid);
+      ul_dropped_sdus++;
+    }
+    return;
+  }
+
   auto task   = [this, eps_bearer_id, bearer](srsran::unique_byte_buffer_t& sdu) {
     // route SDU to PDCP entity
     if (bearer.rat == srsran_rat_t::lte) {
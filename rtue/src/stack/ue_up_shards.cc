@@ -0,0 +1,149 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rtue/hdr/stack/ue_up_shards.h"
+#include "srsran/common/common_lte.h"
+
+namespace srsue {
+
+ue_up_shards::shard_worker::shard_worker(ue_up_shards* parent_, uint32_t id) :
+  srsran::thread("UP_SHARD" + std::to_string(id)), queue(SHARD_QUEUE_SIZE), parent(parent_)
+{}
+
+void ue_up_shards::shard_worker::stop()
+{
+  if (not running.exchange(false)) {
+    return;
+  }
+  queue.stop();
+  wait_thread_finish();
+}
+
+void ue_up_shards::shard_worker::run_thread()
+{
+  while (running) {
+    bool                success = false;
+    srsran::move_task_t task    = queue.pop_blocking(&success);
+    if (not success) {
+      break;
+    }
+    parent->lock_shared();
+    task();
+    parent->unlock_shared();
+  }
+}
+
+ue_up_shards::ue_up_shards() : logger(srslog::fetch_basic_logger("STCK", false))
+{
+#ifdef __GLIBC__
+  // Writer preference, otherwise a steady DRB load could starve the stack thread
+  pthread_rwlockattr_t attr;
+  pthread_rwlockattr_init(&attr);
+  pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+  pthread_rwlock_init(&control_lock, &attr);
+  pthread_rwlockattr_destroy(&attr);
+#else
+  // The rwlock kind is a glibc extension, the writer gate gives the preference instead
+  pthread_rwlock_init(&control_lock, nullptr);
+#endif
+}
+
+ue_up_shards::~ue_up_shards()
+{
+  stop();
+  pthread_rwlock_destroy(&control_lock);
+}
+
+void ue_up_shards::lock()
+{
+#ifndef __GLIBC__
+  std::lock_guard<std::mutex> gate(writer_gate);
+#endif
+  pthread_rwlock_wrlock(&control_lock);
+}
+
+void ue_up_shards::unlock()
+{
+  pthread_rwlock_unlock(&control_lock);
+}
+
+void ue_up_shards::lock_shared()
+{
+#ifndef __GLIBC__
+  // Wait behind a pending writer instead of overtaking it
+  std::lock_guard<std::mutex> gate(writer_gate);
+#endif
+  pthread_rwlock_rdlock(&control_lock);
+}
+
+void ue_up_shards::unlock_shared()
+{
+  pthread_rwlock_unlock(&control_lock);
+}
+
+void ue_up_shards::init(uint32_t nof_workers, int prio, rlc_interface_mac* rlc_)
+{
+  rlc = rlc_;
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    shards.emplace_back(new shard_worker(this, i));
+    shards.back()->start(prio);
+  }
+  logger.info("Started %d user-plane shards", nof_workers);
+}
+
+void ue_up_shards::stop()
+{
+  // Workers are kept, pushes to a stopped queue fail
+  for (auto& s : shards) {
+    s->stop();
+  }
+}
+
+bool ue_up_shards::is_sharded(uint32_t lcid) const
+{
+  return enabled() and srsran::is_lte_drb(lcid);
+}
+
+bool ue_up_shards::push(uint32_t lcid, srsran::move_task_t task)
+{
+  return shards[lcid % shards.size()]->queue.try_push(std::move(task)).has_value();
+}
+
+void ue_up_shards::write_pdu(uint32_t lcid, uint8_t* payload, uint32_t nof_bytes)
+{
+  if (not is_sharded(lcid)) {
+    rlc->write_pdu(lcid, payload, nof_bytes);
+    return;
+  }
+
+  // The MAC PDU buffer is reused once demultiplexed, the shard works on a copy
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer(payload, nof_bytes, __FUNCTION__);
+  if (pdu == nullptr) {
+    logger.error("Dropping DL PDU for lcid=%d", lcid);
+    return;
+  }
+  auto task = [this, lcid](srsran::unique_byte_buffer_t& pdu) { rlc->write_pdu(lcid, pdu->msg, pdu->N_bytes); };
+  if (not push(lcid, std::bind(task, std::move(pdu)))) {
+    logger.warning("User-plane shard queue full, dropping DL PDU for lcid=%d", lcid);
+  }
+}
+
+} // namespace srsue
@@ -56,6 +56,8 @@ nas_5g::nas_5g(srslog::basic_logger& logger_, srsran::task_sched_handle task_sch
   t3511(task_sched_.get_unique_timer()),
   t3521(task_sched_.get_unique_timer()),
   reregistration_timer(task_sched_.get_unique_timer()),
+  storm_pdu_guard(task_sched_.get_unique_timer()),
+  storm_dereg_guard(task_sched_.get_unique_timer()),
   registration_proc(this),
   state(logger_),
   pdu_session_establishment_proc(this, logger_)
@@ -66,6 +68,8 @@ nas_5g::nas_5g(srslog::basic_logger& logger_, srsran::task_sched_handle task_sch
   t3511.set(t3511_duration_ms, [this](uint32_t tid) { timer_expired(tid); });
   t3521.set(t3521_duration_ms, [this](uint32_t tid) { timer_expired(tid); });
   reregistration_timer.set(reregistration_timer_duration_ms, [this](uint32_t tid) { timer_expired(tid); });
+  storm_pdu_guard.set(storm_pdu_guard_duration_ms, [this](uint32_t tid) { timer_expired(tid); });
+  storm_dereg_guard.set(storm_dereg_guard_duration_ms, [this](uint32_t tid) { timer_expired(tid); });
 }
 
 nas_5g::~nas_5g() {}
@@ -108,6 +112,12 @@ int nas_5g::init(usim_interface_nas*      usim_,
     logger.warning("Failure while configuring pdu sessions");
   }
 
+  // In a registration storm the re-registration timer spaces the cycles
+  if (storm_enabled()) {
+    reregistration_timer.set(std::max(cfg.storm_gap_ms, 1u), [this](uint32_t tid) { timer_expired(tid); });
+    logger.info("Registration storm enabled, %d cycles with identity stride %d", cfg.storm_cycles, cfg.storm_id_stride);
+  }
+
   running = true;
   return SRSRAN_SUCCESS;
 }
@@ -273,7 +283,12 @@ int nas_5g::send_registration_request()
 
   suci.scheme_output.resize(5);
   usim->get_home_msin_bcd(suci.scheme_output.data(), 5);
-  logger.info("Requesting IMSI attach (IMSI=%s)", usim->get_imsi_str().c_str());
+  if (storm_enabled()) {
+    storm_offset_msin(suci.scheme_output, storm_msin_offset());
+    logger.info("Requesting IMSI attach (IMSI=%s, storm cycle %d)", usim->get_imsi_str().c_str(), storm_cycle);
+  } else {
+    logger.info("Requesting IMSI attach (IMSI=%s)", usim->get_imsi_str().c_str());
+  }
 
   reg_req.ue_security_capability_present = true;
   fill_security_caps(reg_req.ue_security_capability);
@@ -284,7 +299,8 @@ int nas_5g::send_registration_request()
     set_nssai(nssai);
     reg_req.requested_nssai.s_nssai_list.push_back(nssai);
   }
-  if (initial_registration_request_stored.pack(pdu) != SRSASN_SUCCESS) {
+  bool packed = storm_enabled() and storm_write_registration_request(*pdu) == SRSRAN_SUCCESS;
+  if (not packed and initial_registration_request_stored.pack(pdu) != SRSASN_SUCCESS) {
     logger.error("Failed to pack registration request");
     return SRSRAN_ERROR;
   }
@@ -296,6 +312,7 @@ int nas_5g::send_registration_request()
   // start T3510
   logger.debug("Starting T3410. Timeout in %d ms.", t3510.duration());
   t3510.run();
+  registration_latency.start();
 
   logger.info("Sending Registration Request");
   if (rrc_nr->is_connected() == true) {
@@ -629,6 +646,10 @@ int nas_5g::send_pdu_session_establishment_request(uint32_t                 tran
                      &pdu->msg[MAC_5G_OFFSET]);
 
   logger.info("Sending PDU Session Establishment Request in UL NAS transport.");
+  pdu_session_latency.start();
+  if (storm_enabled()) {
+    storm_pdu_guard.run();
+  }
   rrc_nr->write_sdu(std::move(pdu));
   ctxt_base.tx_count++;
 
@@ -666,6 +687,10 @@ int nas_5g::send_deregistration_request_ue_originating(bool switch_off)
   usim->get_home_mcc_bytes(suci.mcc.data(), suci.mcc.size());
   usim->get_home_mnc_bytes(suci.mnc.data(), suci.mnc.size());
   suci.scheme_output.resize(5);
+  if (storm_enabled()) {
+    usim->get_home_msin_bcd(suci.scheme_output.data(), 5);
+    storm_offset_msin(suci.scheme_output, storm_msin_offset());
+  }
 
   deregistration_request.ng_ksi.nas_key_set_identifier.value =
       key_set_identifier_t::nas_key_set_identifier_type_::options::no_key_is_available_or_reserved;
@@ -680,6 +705,12 @@ int nas_5g::send_deregistration_request_ue_originating(bool switch_off)
   }
 
   logger.info("Sending Deregistration Request (UE Originating)");
+  if (not switch_off) {
+    deregistration_latency.start();
+    if (storm_enabled()) {
+      storm_dereg_guard.run();
+    }
+  }
   cipher_encrypt(pdu.get());
   integrity_generate(&ctxt_base.k_nas_int[16],
                      ctxt_base.tx_count,
@@ -813,6 +844,11 @@ int nas_5g::handle_registration_accept(registration_accept_t& registration_accep
     send_reg_complete = true;
   }
 
+  registration_latency.stop(true);
+  if (storm_enabled()) {
+    t3510.stop();
+  }
+
   // TODO: reset counters and everything what is needed by the specification
   t3521.set(registration_accept.t3512_value.timer_value);
   registration_proc.run();
@@ -853,6 +889,12 @@ int nas_5g::handle_registration_reject(registration_reject_t& registration_rejec
       logger.error("Unhandled Registration Reject cause");
   }
 
+  registration_latency.stop(false);
+  if (storm_enabled()) {
+    t3510.stop();
+    registration_proc.run();
+    storm_next_cycle();
+  }
   return SRSRAN_SUCCESS;
 }
 
@@ -1059,6 +1101,11 @@ int nas_5g::handle_deregistration_accept_ue_originating(
   }
 
   state.set_deregistered(mm5g_state_t::deregistered_substate_t::null);
+  deregistration_latency.stop(true);
+  if (storm_enabled()) {
+    storm_dereg_guard.stop();
+    storm_next_cycle();
+  }
   return SRSASN_SUCCESS;
 }
 
@@ -1076,6 +1123,28 @@ int nas_5g::handle_configuration_update_command(
  ******************************************************************************/
 void nas_5g::timer_expired(uint32_t timeout_id)
 {
+  // In a registration storm an unanswered registration counts as failed and the next identity is tried
+  if (storm_enabled() and timeout_id == t3510.id() and registration_latency.is_pending()) {
+    logger.warning("Registration of storm cycle %d timed out", storm_cycle);
+    registration_latency.stop(false);
+    registration_proc.run();
+    storm_next_cycle();
+  }
+  // Without an answer to the PDU session or deregistration request the cycle fails as well
+  if (storm_enabled() and timeout_id == storm_pdu_guard.id() and pdu_session_latency.is_pending()) {
+    logger.warning("PDU session establishment of storm cycle %d timed out", storm_cycle);
+    if (pdu_session_establishment_proc.is_busy()) {
+      // The procedure reports the failure through handle_pdu_session_est_result()
+      pdu_session_establishment_proc.trigger(pdu_session_establishment_procedure::timeout_t{});
+    } else {
+      handle_pdu_session_est_result(false);
+    }
+  }
+  if (storm_enabled() and timeout_id == storm_dereg_guard.id() and deregistration_latency.is_pending()) {
+    logger.warning("Deregistration of storm cycle %d timed out", storm_cycle);
+    deregistration_latency.stop(false);
+    storm_next_cycle();
+  }
   // TODO
 }
 
@@ -1134,6 +1203,10 @@ void nas_5g::get_metrics(nas_5g_metrics_t& metrics)
 {
   metrics.nof_active_pdu_sessions = num_of_est_pdu_sessions();
   metrics.state                   = state.get_state();
+  metrics.storm_cycle             = storm_cycle;
+  metrics.registration            = registration_latency.get_metrics();
+  metrics.pdu_session             = pdu_session_latency.get_metrics();
+  metrics.deregistration          = deregistration_latency.get_metrics();
 }
 
 int nas_5g::get_k_amf(as_key_t& k_amf)
@@ -1254,7 +1327,10 @@ int nas_5g::trigger_pdu_session_est()
     pdu_session_cfg_t pdu_session_cfg;
     uint16_t          pdu_session_id;
     get_unestablished_pdu_session(pdu_session_id, pdu_session_cfg);
-    pdu_session_establishment_proc.launch(pdu_session_id, pdu_session_cfg);
+    if (pdu_session_establishment_proc.launch(pdu_session_id, pdu_session_cfg)) {
+      pdu_session_establishment_proc.then(
+          [this](const srsran::proc_result_t<void>& result) { handle_pdu_session_est_result(result.is_success()); });
+    }
   }
   return SRSRAN_SUCCESS;
 }
@@ -1381,4 +1457,127 @@ int nas_5g::add_pdu_session(uint16_t                      pdu_session_id,
   return SRSRAN_SUCCESS;
 }
 
+/*******************************************************************************
+ * Procedure latency and registration storm
+ ******************************************************************************/
+void nas_5g::proc_latency_t::start()
+{
+  metrics.nof_started++;
+  pending = true;
+  t_start = std::chrono::steady_clock::now();
+}
+
+void nas_5g::proc_latency_t::stop(bool success)
+{
+  if (not pending) {
+    return;
+  }
+  pending = false;
+  if (not success) {
+    metrics.nof_failed++;
+    return;
+  }
+  metrics.nof_completed++;
+
+  uint64_t latency_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t_start).count();
+  uint32_t bucket = 0;
+  while (latency_ms >= 2 and bucket < nas_5g_proc_metrics_t::nof_buckets - 1) {
+    latency_ms >>= 1u;
+    bucket++;
+  }
+  metrics.latency_hist[bucket]++;
+}
+
+void nas_5g::storm_offset_msin(std::vector<uint8_t>& scheme_output, uint64_t offset)
+{
+  // BCD MSIN, the first digit is in the low nibble of the first octet. Filler nibbles end the number.
+  uint32_t nof_digits = 0;
+  uint64_t msin       = 0;
+  uint64_t modulo     = 1;
+  for (; nof_digits < 2 * scheme_output.size(); nof_digits++) {
+    uint8_t digit = (scheme_output[nof_digits / 2] >> (4 * (nof_digits % 2))) & 0xfu;
+    if (digit > 9) {
+      break;
+    }
+    msin   = msin * 10 + digit;
+    modulo = modulo * 10;
+  }
+
+  msin = (msin + offset % modulo) % modulo;
+  for (uint32_t i = nof_digits; i-- > 0;) {
+    uint32_t shift       = 4 * (i % 2);
+    scheme_output[i / 2] = (scheme_output[i / 2] & ~(0xfu << shift)) | ((msin % 10) << shift);
+    msin                 = msin / 10;
+  }
+}
+
+int nas_5g::storm_write_registration_request(srsran::byte_buffer_t& pdu)
+{
+  std::vector<uint8_t>& scheme_output =
+      initial_registration_request_stored.registration_request().mobile_identity_5gs.suci().scheme_output;
+
+  if (storm_reg_req_tmpl.empty()) {
+    // The MSIN is where a packing with all MSIN bits set differs from one with all of them cleared
+    std::vector<uint8_t> msin = scheme_output;
+    std::vector<uint8_t> buf;
+    scheme_output.assign(msin.size(), 0);
+    if (initial_registration_request_stored.pack(buf) == SRSASN_SUCCESS) {
+      storm_reg_req_tmpl.set_reference(buf.data(), buf.size());
+      scheme_output.assign(msin.size(), 0xff);
+      if (initial_registration_request_stored.pack(buf) == SRSASN_SUCCESS) {
+        storm_msin_field = storm_reg_req_tmpl.learn_field(buf.data(), buf.size());
+      }
+    }
+    scheme_output = msin;
+    if (storm_msin_field < 0) {
+      logger.warning("Couldn't create Registration Request template, packing each request");
+      storm_reg_req_tmpl = {};
+      return SRSRAN_ERROR;
+    }
+  }
+
+  uint64_t msin = 0;
+  for (uint8_t octet : scheme_output) {
+    msin = (msin << 8u) | octet;
+  }
+  storm_reg_req_tmpl.set_field(storm_msin_field, msin);
+  pdu.N_bytes = storm_reg_req_tmpl.write(pdu.msg, pdu.get_tailroom());
+  return pdu.N_bytes > 0 ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+}
+
+void nas_5g::storm_next_cycle()
+{
+  storm_cycle++;
+  has_sec_ctxt = false;
+  reset_pdu_sessions();
+  storm_pdu_guard.stop();
+  storm_dereg_guard.stop();
+
+  if (storm_cycle >= cfg.storm_cycles) {
+    logger.info("Registration storm finished after %d cycles", storm_cycle);
+    srsran::console("Registration storm finished after %d cycles\n", storm_cycle);
+    state.set_deregistered(mm5g_state_t::deregistered_substate_t::null);
+    return;
+  }
+
+  // run_tti() registers the next identity once the gap has elapsed
+  state.set_deregistered(mm5g_state_t::deregistered_substate_t::plmn_search);
+  reregistration_timer.run();
+}
+
+void nas_5g::handle_pdu_session_est_result(bool success)
+{
+  pdu_session_latency.stop(success);
+  if (not storm_enabled()) {
+    return;
+  }
+  storm_pdu_guard.stop();
+  if (success and state.get_state() == mm5g_state_t::state_t::registered) {
+    send_deregistration_request_ue_originating(false);
+  } else {
+    storm_next_cycle();
+  }
+}
+
 } // namespace srsue
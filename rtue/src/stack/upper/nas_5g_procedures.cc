@@ -93,6 +93,12 @@ srsran::proc_outcome_t nas_5g::pdu_session_establishment_procedure::react(
   return srsran::proc_outcome_t::error;
 }
 
+srsran::proc_outcome_t nas_5g::pdu_session_establishment_procedure::react(const timeout_t& timeout)
+{
+  logger.warning("PDU Session Establishment timed out");
+  return srsran::proc_outcome_t::error;
+}
+
 srsran::proc_outcome_t nas_5g::pdu_session_establishment_procedure::step()
 {
   return srsran::proc_outcome_t::success;
@@ -20,6 +20,7 @@
  */
 
 #include "srsran/common/bcd_helpers.h"
+#include "srsran/common/task_scheduler.h"
 #include "srsran/common/test_common.h"
 #include "srsran/common/tsan_options.h"
 #include "srsran/interfaces/ue_pdcp_interfaces.h"
@@ -93,6 +94,164 @@ int amf_attach_request_test(srsran::nas_pcap* pcap)
   return ret;
 }
 
+int storm_offset_msin_test()
+{
+  // BCD MSIN 0123456789, the first digit is in the low nibble
+  std::vector<uint8_t> msin = {0x10, 0x32, 0x54, 0x76, 0x98};
+  srsue::nas_5g::storm_offset_msin(msin, 11);
+  TESTASSERT(msin == std::vector<uint8_t>({0x10, 0x32, 0x54, 0x86, 0x00}));
+
+  // Wraps around at 10 digits
+  msin = {0x99, 0x99, 0x99, 0x99, 0x99};
+  srsue::nas_5g::storm_offset_msin(msin, 2);
+  TESTASSERT(msin == std::vector<uint8_t>({0x00, 0x00, 0x00, 0x00, 0x10}));
+
+  // 9 digit MSIN, the filler nibble is kept
+  msin = {0x21, 0x43, 0x65, 0x87, 0xf9};
+  srsue::nas_5g::storm_offset_msin(msin, 1);
+  TESTASSERT(msin == std::vector<uint8_t>({0x21, 0x43, 0x65, 0x97, 0xf0}));
+  srsue::nas_5g::storm_offset_msin(msin, 1000000000 - 1);
+  TESTASSERT(msin == std::vector<uint8_t>({0x21, 0x43, 0x65, 0x87, 0xf9}));
+
+  return SRSRAN_SUCCESS;
+}
+
+// Keeps the MSIN of every Registration Request sent by the NAS
+class rrc_nr_storm_dummy : public rrc_nr_dummy
+{
+public:
+  int write_sdu(unique_byte_buffer_t sdu) override
+  {
+    srsran::nas_5g::nas_5gs_msg nas_msg;
+    if (nas_msg.unpack_outer_hdr(sdu) == SRSRAN_SUCCESS and nas_msg.unpack(sdu) == SRSRAN_SUCCESS and
+        nas_msg.hdr.message_type == srsran::nas_5g::msg_opts::options::registration_request) {
+      reg_req_msins.push_back(nas_msg.registration_request().mobile_identity_5gs.suci().scheme_output);
+    }
+    return SRSRAN_SUCCESS;
+  }
+  std::vector<std::vector<uint8_t> > reg_req_msins;
+};
+
+int storm_write_pdu(srsue::nas_5g& nas, srsran::nas_5g::nas_5gs_msg& nas_msg)
+{
+  unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+  TESTASSERT(pdu != nullptr);
+  nas_msg.hdr.extended_protocol_discriminator = srsran::nas_5g::nas_5gs_hdr::extended_protocol_discriminator_5gmm;
+  TESTASSERT(nas_msg.pack(pdu) == SRSASN_SUCCESS);
+  TESTASSERT(nas.write_pdu(std::move(pdu)) == SRSRAN_SUCCESS);
+  return SRSRAN_SUCCESS;
+}
+
+int storm_cycle_test()
+{
+  using namespace srsran::nas_5g;
+
+  srsran::task_scheduler task_sched;
+  rrc_nr_storm_dummy     rrc_nr;
+  gw_dummy               gw;
+
+  srsue::usim usim(srslog::fetch_basic_logger("USIM"));
+  usim_args_t args;
+  args.mode = "soft";
+  args.algo = "xor";
+  args.imei = "353490069873319";
+  args.imsi = "001010123456789";
+  args.k    = "00112233445566778899aabbccddeeff";
+  args.op   = "63BFA50EE6523365FF14C1F45F88737D";
+  usim.init(&args);
+
+  nas_5g_args_t nas_5g_cfg;
+  pdu_session_cfg_t pdu_session;
+  pdu_session.apn_name = "test123";
+  nas_5g_cfg.pdu_session_cfgs.push_back(pdu_session);
+  nas_5g_cfg.ia5g         = "0,1,2,3";
+  nas_5g_cfg.ea5g         = "0,1,2,3";
+  nas_5g_cfg.storm_cycles = 4;
+  nas_5g_cfg.storm_gap_ms = 10;
+
+  srsue::nas_5g nas_5g(srslog::fetch_basic_logger("NAS-5G"), &task_sched);
+  nas_5g.init(&usim, &rrc_nr, &gw, nas_5g_cfg);
+  nas_5g.switch_on();
+
+  nas_5g_metrics_t metrics = {};
+  // Runs the NAS for up to max_ms, stopping early once the given number of Registration Requests was sent
+  auto run = [&](uint32_t max_ms, uint32_t nof_reg_reqs) {
+    for (uint32_t i = 0; i < max_ms and rrc_nr.reg_req_msins.size() < nof_reg_reqs; i++) {
+      task_sched.tic();
+      task_sched.run_pending_tasks();
+      nas_5g.run_tti();
+    }
+    nas_5g.get_metrics(metrics);
+  };
+
+  // Cycle 0, the network rejects the registration
+  run(20, 1);
+  TESTASSERT(rrc_nr.reg_req_msins.size() == 1);
+  nas_5gs_msg reject;
+  reject.set_registration_reject().cause_5gmm.cause_5gmm = cause_5gmm_t::cause_5gmm_type_::options::illegal_ue;
+  TESTASSERT(storm_write_pdu(nas_5g, reject) == SRSRAN_SUCCESS);
+
+  // Cycle 1, the registration is not answered until T3510 expires
+  run(20, 2);
+  TESTASSERT(rrc_nr.reg_req_msins.size() == 2);
+  TESTASSERT(metrics.storm_cycle == 1);
+  run(15000 + 20, 3);
+  TESTASSERT(rrc_nr.reg_req_msins.size() == 3);
+  TESTASSERT(metrics.storm_cycle == 2);
+
+  // Cycle 2, registered but the PDU session is not answered until its guard timer expires
+  nas_5gs_msg accept;
+  accept.set_registration_accept();
+  TESTASSERT(storm_write_pdu(nas_5g, accept) == SRSRAN_SUCCESS);
+  nas_5g.get_metrics(metrics);
+  TESTASSERT(metrics.pdu_session.nof_started == 1);
+  run(16000 + 20, 4);
+  TESTASSERT(rrc_nr.reg_req_msins.size() == 4);
+  TESTASSERT(metrics.storm_cycle == 3);
+
+  // Cycle 3, the PDU session is set up but the deregistration is not answered until its guard timer expires
+  TESTASSERT(storm_write_pdu(nas_5g, accept) == SRSRAN_SUCCESS);
+  // PDU Session Establishment Accept for PDU address 10.45.0.2 and DNN test123, packed by hand as packing of QoS rules
+  // is not supported
+  const std::vector<uint8_t> pdu_session_accept = {0x2e, 0x01, 0x00, 0xc2, 0x11, 0x00, 0x08, 0x01, 0x06, 0x31, 0x31,
+                                                   0x01, 0x01, 0x00, 0x09, 0x06, 0x01, 0xe8, 0x03, 0x01, 0xe8, 0x03,
+                                                   0x29, 0x05, 0x01, 0x0a, 0x2d, 0x00, 0x02, 0x25, 0x08, 0x07, 't',
+                                                   'e',  's',  't',  '1',  '2',  '3'};
+  nas_5gs_msg         dl_transport;
+  dl_nas_transport_t& dl_nas = dl_transport.set_dl_nas_transport();
+  dl_nas.payload_container_type.payload_container_type =
+      payload_container_type_t::Payload_container_type_type_::options::n1_sm_information;
+  dl_nas.payload_container.payload_container_contents = pdu_session_accept;
+  TESTASSERT(storm_write_pdu(nas_5g, dl_transport) == SRSRAN_SUCCESS);
+  nas_5g.get_metrics(metrics);
+  TESTASSERT(metrics.pdu_session.nof_completed == 1);
+  TESTASSERT(metrics.deregistration.nof_started == 1);
+  run(15000 + 20, 5);
+  TESTASSERT(metrics.storm_cycle == 4);
+
+  // Every cycle registers the next identity, the storm stops after the configured number of cycles
+  TESTASSERT(rrc_nr.reg_req_msins.size() == 4);
+  std::vector<uint8_t> msin = rrc_nr.reg_req_msins[0];
+  TESTASSERT(msin == std::vector<uint8_t>({0x10, 0x32, 0x54, 0x76, 0x98}));
+  for (uint32_t i = 1; i < rrc_nr.reg_req_msins.size(); i++) {
+    srsue::nas_5g::storm_offset_msin(msin, 1);
+    TESTASSERT(rrc_nr.reg_req_msins[i] == msin);
+  }
+
+  TESTASSERT(metrics.registration.nof_started == 4);
+  TESTASSERT(metrics.registration.nof_completed == 2);
+  TESTASSERT(metrics.registration.nof_failed == 2);
+  TESTASSERT(metrics.pdu_session.nof_started == 2);
+  TESTASSERT(metrics.pdu_session.nof_completed == 1);
+  TESTASSERT(metrics.pdu_session.nof_failed == 1);
+  TESTASSERT(metrics.deregistration.nof_started == 1);
+  TESTASSERT(metrics.deregistration.nof_completed == 0);
+  TESTASSERT(metrics.deregistration.nof_failed == 1);
+  TESTASSERT(metrics.state == mm5g_state_t::state_t::deregistered);
+
+  return SRSRAN_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
   // Setup logging.
@@ -119,6 +278,8 @@ int main(int argc, char** argv)
 #else
   TESTASSERT(amf_attach_request_test(nullptr) == SRSRAN_SUCCESS);
 #endif // HAVE_PCAP
+  TESTASSERT(storm_offset_msin_test() == SRSRAN_SUCCESS);
+  TESTASSERT(storm_cycle_test() == SRSRAN_SUCCESS);
 
   return SRSRAN_SUCCESS;
 }
@@ -67,6 +67,8 @@ int usim::init(usim_args_t* args)
         srsran::console("Invalid length for OPc: %zu should be %d\n", args->opc.length(), 32);
       }
     }
+    // Expand the key once, every authentication reuses it
+    milenage_keys.set_k_opc(k, opc);
   }
 
   if (15 == args->imsi.length()) {
@@ -177,23 +179,22 @@ usim::gen_auth_res_milenage(uint8_t* rand, uint8_t* autn_enb, uint8_t* res, int*
   uint32_t      i;
   uint8_t       sqn[6];
 
-  // Use RAND and K to compute RES, CK, IK and AK
-  security_milenage_f2345(k, opc, rand, res, ck, ik, ak);
+  // Compute RES, CK, IK, AK and MAC in one pass, SQN is recovered from AUTN on the way
+  srsran::milenage_vector_t vector;
+  milenage_keys.compute_from_autn(rand, autn_enb, vector, sqn);
+  memcpy(res, vector.res, 8);
+  memcpy(ck, vector.ck, CK_LEN);
+  memcpy(ik, vector.ik, IK_LEN);
+  memcpy(ak, vector.ak, AK_LEN);
+  memcpy(mac, vector.mac_a, 8);
 
   *res_len = 8;
 
-  // Extract sqn from autn
-  for (i = 0; i < 6; i++) {
-    sqn[i] = autn_enb[i] ^ ak[i];
-  }
   // Extract AMF from autn
   for (int i = 0; i < 2; i++) {
     amf[i] = autn_enb[6 + i];
   }
 
-  // Generate MAC
-  security_milenage_f1(k, opc, rand, sqn, amf, mac);
-
   // Construct AUTN
   for (i = 0; i < 6; i++) {
     autn[i] = sqn[i] ^ ak[i];
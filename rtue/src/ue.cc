@@ -25,6 +25,7 @@
 #include "srsran/common/string_helpers.h"
 #include "srsran/radio/radio.h"
 #include "srsran/radio/radio_null.h"
+#include "srsran/radio/radio_shared.h"
 #include "srsran/srsran.h"
 #include "rtue/hdr/phy/dummy_phy.h"
 #include "rtue/hdr/phy/phy.h"
@@ -50,7 +51,7 @@ ue::~ue()
   stack.reset();
 }
 
-int ue::init(const all_args_t& args_)
+int ue::init(const all_args_t& args_, srsran::radio_shared::port* shared_port)
 {
   int ret = SRSRAN_SUCCESS;
 
@@ -77,10 +78,18 @@ int ue::init(const all_args_t& args_)
     return SRSRAN_ERROR;
   }
 
-  std::unique_ptr<srsran::radio> lte_radio = std::unique_ptr<srsran::radio>(new srsran::radio);
-  if (!lte_radio) {
-    srsran::console("Error creating radio multi instance.\n");
-    return SRSRAN_ERROR;
+  // A UE sharing the front-end with other instances uses its port of the shared radio
+  std::unique_ptr<srsran::radio> lte_radio;
+  srsran::radio_base*            radio_dev = shared_port;
+  srsran::radio_interface_phy*   radio_phy = shared_port;
+  if (shared_port == nullptr) {
+    lte_radio = std::unique_ptr<srsran::radio>(new srsran::radio);
+    if (!lte_radio) {
+      srsran::console("Error creating radio multi instance.\n");
+      return SRSRAN_ERROR;
+    }
+    radio_dev = lte_radio.get();
+    radio_phy = lte_radio.get();
   }
 
   srsue::phy_args_nr_t phy_args_nr = {};
@@ -93,6 +102,9 @@ int ue::init(const all_args_t& args_)
   phy_args_nr.store_pdsch_ko       = args.phy.nr_store_pdsch_ko;
   phy_args_nr.srate_hz             = args.rf.srate_hz;
 
+  phy_args_nr.ul.pusch.nof_encoder_threads = args.phy.nr_pusch_encoder_threads;
+  phy_args_nr.pss_prescreen_thr            = args.phy.nr_pss_prescreen_thr;
+
   // init layers
   if (args.phy.nof_lte_carriers == 0) {
     // SA mode
@@ -103,11 +115,11 @@ int ue::init(const all_args_t& args_)
     }
 
     // In SA mode, pass the NR SA phy to the radio
-    if (lte_radio->init(args.rf, nr_phy.get())) {
+    if (radio_dev->init(args.rf, nr_phy.get())) {
       srsran::console("Error initializing radio.\n");
       return SRSRAN_ERROR;
     }
-    if (nr_phy->init(phy_args_nr, lte_stack.get(), lte_radio.get())) {
+    if (nr_phy->init(phy_args_nr, lte_stack.get(), radio_phy)) {
       srsran::console("Error initializing PHY NR SA.\n");
       ret = SRSRAN_ERROR;
     }
@@ -134,17 +146,17 @@ int ue::init(const all_args_t& args_)
       return SRSRAN_ERROR;
     }
 
-    if (lte_radio->init(args.rf, lte_phy.get())) {
+    if (radio_dev->init(args.rf, lte_phy.get())) {
       srsran::console("Error initializing radio.\n");
       return SRSRAN_ERROR;
     }
     // from here onwards do not exit immediately if something goes wrong as sub-layers may already use interfaces
-    if (lte_phy->init(args.phy, lte_stack.get(), lte_radio.get())) {
+    if (lte_phy->init(args.phy, lte_stack.get(), radio_phy)) {
       srsran::console("Error initializing PHY.\n");
       ret = SRSRAN_ERROR;
     }
     if (args.phy.nof_nr_carriers > 0) {
-      if (lte_phy->init(phy_args_nr, lte_stack.get(), lte_radio.get())) {
+      if (lte_phy->init(phy_args_nr, lte_stack.get(), radio_phy)) {
         srsran::console("Error initializing NR PHY.\n");
         ret = SRSRAN_ERROR;
       }
@@ -162,9 +174,10 @@ int ue::init(const all_args_t& args_)
   }
 
   // move ownership
-  stack   = std::move(lte_stack);
-  gw_inst = std::move(gw_ptr);
-  radio   = std::move(lte_radio);
+  stack    = std::move(lte_stack);
+  gw_inst  = std::move(gw_ptr);
+  radio    = std::move(lte_radio);
+  radio_if = radio_dev;
 
   if (phy) {
     srsran::console("Waiting PHY to initialize ... ");
@@ -340,8 +353,8 @@ void ue::stop()
     phy->stop();
   }
 
-  if (radio) {
-    radio->stop();
+  if (radio_if) {
+    radio_if->stop();
   }
 }
 
@@ -387,7 +400,7 @@ bool ue::get_metrics(ue_metrics_t* m)
   *m = {};
   phy->get_metrics(srsran::srsran_rat_t::lte, &m->phy);
   phy->get_metrics(srsran::srsran_rat_t::nr, &m->phy_nr);
-  radio->get_metrics(&m->rf);
+  radio_if->get_metrics(&m->rf);
   stack->get_metrics(&m->stack);
   gw_inst->get_metrics(m->gw, m->stack.mac[0].nof_tti);
   m->sys = sys_proc.get_metrics();
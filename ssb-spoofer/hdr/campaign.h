@@ -0,0 +1,68 @@
+#ifndef SSB_SPOOFER_CAMPAIGN_H
+#define SSB_SPOOFER_CAMPAIGN_H
+
+#include "config.h"
+#include "rf_handler.h"
+#include "ssb_processor.h"
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ssb_spoofer {
+
+/**
+* Statistics of one campaign configuration
+*/
+struct CampaignStats {
+  uint32_t      index;
+  AttackConfig  attack;
+  uint64_t      bursts;
+  uint64_t      tx_errors;
+  uint64_t      samples;
+  double        duration_sec;
+  bool          template_cached;   ///< SSB template reused from an earlier configuration
+};
+
+/**
+* Campaign runner, sweeps attack configurations back-to-back on an already
+* initialized RF device and SSB processor
+*/
+class CampaignRunner {
+public:
+  CampaignRunner(RfHandler& rf, SsbProcessor& ssb_proc, const Config& config);
+
+  /**
+  * @brief Expand the campaign lists into attack configurations
+  * @param config Complete configuration, the attack section provides the defaults
+  * @return One attack configuration per campaign point
+  */
+  static std::vector<AttackConfig> expand(const Config& config);
+
+  /**
+  * @brief Transmit every campaign configuration against the target cell
+  * @param target SSB found by the scan
+  * @param running Cleared by the signal handler to stop the campaign
+  * @return true if all configurations were transmitted, false otherwise
+  */
+  bool run(const SsbSearchResult& target, const std::atomic<bool>& running);
+
+  const std::vector<CampaignStats>& get_stats() const { return stats_; }
+
+private:
+  RfHandler& rf_;
+  SsbProcessor& ssb_proc_;
+  const Config& config_;
+  std::vector<CampaignStats> stats_;
+  std::vector<std::complex<float>> burst_buffer_;
+
+  bool build_burst(const SsbSearchResult& target, const AttackConfig& attack, bool& cached);
+  bool transmit_config(const AttackConfig& attack, CampaignStats& stats, const std::atomic<bool>& running);
+  void print_summary() const;
+  bool write_stats(const std::string& filename) const;
+};
+
+} // namespace ssb_spoofer
+
+#endif // SSB_SPOOFER_CAMPAIGN_H
@@ -3,6 +3,7 @@
 
 #include <string> 
 #include <cstdint>
+#include <vector>
 
 namespace ssb_spoofer {
 
@@ -32,6 +33,7 @@ struct SsbConfig {
   float       beta_sss;         ///< SSS power allocation
   float       beta_pbch;        ///< PBCH power allocation
   float       beta_pbch_dmrs;   ///< PBCH DMRS power allocation 
+  float       pss_prescreen_thr; ///< CP autocorrelation pre-screen for the PSS search, 0 disables
   
 };
 
@@ -76,6 +78,25 @@ struct OperationalConfig {
 
 };
 
+/**
+* Campaign parameters. Every list holds the values to sweep for one attack
+* field, an empty list keeps the value from the attack section.
+*/
+struct CampaignConfig {
+  bool                  enable;
+  std::string           mode;                       ///< "grid" (cartesian product) or "list" (i-th value of every list)
+  std::vector<bool>     cell_barred_values;
+  std::vector<uint32_t> coreset0_idx_values;
+  std::vector<uint32_t> ss0_idx_values;
+  std::vector<bool>     intra_freq_resel_values;
+  std::vector<double>   tx_power_offset_db_values;
+  std::vector<uint32_t> burst_length_ms_values;
+  std::vector<uint32_t> burst_interval_us_values;
+  uint64_t              bursts_per_config;          ///< Bursts sent per configuration (0 = use dwell_sec only)
+  double                dwell_sec;                  ///< Time spent per configuration (0 = use bursts_per_config only)
+  std::string           stats_file;                 ///< CSV file with one line per configuration (empty = none)
+};
+
 /**
 * Complete configuration structure
 */
@@ -84,6 +105,7 @@ struct Config {
   SsbConfig ssb;
   AttackConfig attack;
   OperationalConfig operation;
+  CampaignConfig campaign;
 };
 
 /**
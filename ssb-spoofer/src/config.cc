@@ -5,6 +5,7 @@
 #include <iostream>
 #include <sstream>
 #include <map>
+#include <algorithm>
 
 namespace ssb_spoofer {
 
@@ -102,6 +103,27 @@ bool get_value<bool>(const std::map<std::string, std::string>& config_map,
   return (value == "true" || value == "True" || value == "TRUE" || value == "1");
 }
 
+// parses a comma separated list, e.g. "0, 5, 15"
+template<typename T>
+static std::vector<T> get_list(const std::map<std::string, std::string>& config_map,
+                         const std::string& key) {
+  std::vector<T> values;
+  auto it = config_map.find(key);
+  if (it == config_map.end()) {
+      return values;
+  }
+  
+  std::istringstream iss(it->second);
+  std::string item;
+  while (std::getline(iss, item, ',')) {
+      item.erase(0, item.find_first_not_of(" \t"));
+      item.erase(item.find_last_not_of(" \t") + 1);
+      if (item.empty()) continue;
+      values.push_back(get_value<T>({{key, item}}, key, T()));
+  }
+  return values;
+}
+
 bool ConfigParser::load_from_file(const std::string& filename, Config& config) {
   auto config_map = parse_config_file(filename);
   
@@ -111,7 +133,7 @@ bool ConfigParser::load_from_file(const std::string& filename, Config& config) {
   }
   
   // RF config
-  config.rf.device_name                 = get_value<std::string>(config_map, "rf.device_name", "uhd");
+  config.rf.device_name                 = get_value<std::string>(config_map, "rf.device_name", "auto");
   config.rf.device_args                 = get_value<std::string>(config_map, "rf.device_args", "");
   config.rf.rx_freq_hz                  = get_value<double>(config_map, "rf.rx_freq_hz", 3510000000.0);
   config.rf.tx_freq_hz                  = get_value<double>(config_map, "rf.tx_freq_hz", 3510000000.0);
@@ -128,6 +150,7 @@ bool ConfigParser::load_from_file(const std::string& filename, Config& config) {
   config.ssb.beta_sss                   = get_value<float>(config_map, "ssb.beta_sss", 0.0f);
   config.ssb.beta_pbch                  = get_value<float>(config_map, "ssb.beta_pbch", 0.0f);
   config.ssb.beta_pbch_dmrs             = get_value<float>(config_map, "ssb.beta_pbch_dmrs", 0.0f);
+  config.ssb.pss_prescreen_thr          = get_value<float>(config_map, "ssb.pss_prescreen_thr", 0.0f);
   
   // attack config
   config.attack.target_pci              = get_value<uint32_t>(config_map, "attack.target_pci", 0);
@@ -155,6 +178,20 @@ bool ConfigParser::load_from_file(const std::string& filename, Config& config) {
   config.operation.save_samples         = get_value<bool>(config_map, "operation.save_samples", false);
   config.operation.samples_file         = get_value<std::string>(config_map, "operation.samples_file", "rx_samples.dat");
   
+  // campaign config
+  config.campaign.enable                    = get_value<bool>(config_map, "campaign.enable", false);
+  config.campaign.mode                      = get_value<std::string>(config_map, "campaign.mode", "grid");
+  config.campaign.cell_barred_values        = get_list<bool>(config_map, "campaign.cell_barred_value");
+  config.campaign.coreset0_idx_values       = get_list<uint32_t>(config_map, "campaign.coreset0_idx_value");
+  config.campaign.ss0_idx_values            = get_list<uint32_t>(config_map, "campaign.ss0_idx_value");
+  config.campaign.intra_freq_resel_values   = get_list<bool>(config_map, "campaign.intra_freq_resel_value");
+  config.campaign.tx_power_offset_db_values = get_list<double>(config_map, "campaign.tx_power_offset_db");
+  config.campaign.burst_length_ms_values    = get_list<uint32_t>(config_map, "campaign.burst_length_ms");
+  config.campaign.burst_interval_us_values  = get_list<uint32_t>(config_map, "campaign.burst_interval_us");
+  config.campaign.bursts_per_config         = get_value<uint64_t>(config_map, "campaign.bursts_per_config", 1000);
+  config.campaign.dwell_sec                 = get_value<double>(config_map, "campaign.dwell_sec", 0.0);
+  config.campaign.stats_file                = get_value<std::string>(config_map, "campaign.stats_file", "campaign_stats.csv");
+  
   return validate(config);
 }
 
@@ -198,6 +235,59 @@ bool ConfigParser::validate(const Config& config) {
       valid = false;
   }
   
+  if (config.campaign.enable) {
+      const CampaignConfig& campaign = config.campaign;
+      if (campaign.mode != "grid" && campaign.mode != "list") {
+          std::cerr << "[!] invalid campaign mode (need grid or list)\n";
+          valid = false;
+      }
+      
+      if (campaign.bursts_per_config == 0 && campaign.dwell_sec <= 0) {
+          std::cerr << "[!] campaign needs bursts_per_config or dwell_sec\n";
+          valid = false;
+      }
+      
+      for (uint32_t idx : campaign.coreset0_idx_values) {
+          if (idx > 15) {
+              std::cerr << "[!] invalid campaign CORESET0 idx " << idx << " (max 15)\n";
+              valid = false;
+          }
+      }
+      
+      for (uint32_t idx : campaign.ss0_idx_values) {
+          if (idx > 15) {
+              std::cerr << "[!] invalid campaign SS0 idx " << idx << " (max 15)\n";
+              valid = false;
+          }
+      }
+      
+      for (uint32_t len : campaign.burst_length_ms_values) {
+          if (len == 0) {
+              std::cerr << "[!] invalid campaign burst length (min 1 ms)\n";
+              valid = false;
+          }
+      }
+      
+      // in list mode every list is either a single value or as long as the longest one
+      if (campaign.mode == "list") {
+          std::vector<size_t> sizes = {campaign.cell_barred_values.size(),
+                                       campaign.coreset0_idx_values.size(),
+                                       campaign.ss0_idx_values.size(),
+                                       campaign.intra_freq_resel_values.size(),
+                                       campaign.tx_power_offset_db_values.size(),
+                                       campaign.burst_length_ms_values.size(),
+                                       campaign.burst_interval_us_values.size()};
+          size_t longest = *std::max_element(sizes.begin(), sizes.end());
+          for (size_t size : sizes) {
+              if (size > 1 && size != longest) {
+                  std::cerr << "[!] campaign lists must have the same length in list mode\n";
+                  valid = false;
+                  break;
+              }
+          }
+      }
+  }
+  
   return valid;
 }
 
@@ -216,6 +306,9 @@ void ConfigParser::print(const Config& config) {
   std::cout << "  pattern: " << config.ssb.pattern << "\n";
   std::cout << "  SCS: " << config.ssb.scs_khz << " kHz\n";
   std::cout << "  period: " << config.ssb.periodicity_ms << " ms\n";
+  if (config.ssb.pss_prescreen_thr > 0.0f) {
+      std::cout << "  PSS pre-screen: " << config.ssb.pss_prescreen_thr << "\n";
+  }
   
   std::cout << "\n[Attack]\n";
   std::cout << "  target PCI: " << config.attack.target_pci << "\n";
@@ -237,6 +330,14 @@ void ConfigParser::print(const Config& config) {
   std::cout << "  burst interval: " << config.attack.burst_interval_us << " us\n";
   std::cout << "  burst length: " << config.attack.burst_length_ms << " ms\n";
   
+  if (config.campaign.enable) {
+      std::cout << "\n[Campaign]\n";
+      std::cout << "  mode: " << config.campaign.mode << "\n";
+      std::cout << "  bursts per config: " << config.campaign.bursts_per_config << "\n";
+      std::cout << "  dwell: " << config.campaign.dwell_sec << " s\n";
+      std::cout << "  stats file: " << config.campaign.stats_file << "\n";
+  }
+  
   std::cout << "\n--------------------\n\n";
 }
 
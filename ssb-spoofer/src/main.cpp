@@ -10,6 +10,7 @@
  * This causes UE misconfiguration and prevents network attachment.
  */
 
+#include "campaign.h"
 #include "config.h"
 #include "rf_handler.h"
 #include "ssb_processor.h"
@@ -54,6 +55,16 @@ void print_usage(const char* program_name) {
   std::cout << std::endl;
 }
 
+void print_prescreen_metrics(SsbProcessor& ssb_proc) {
+  srsran_ssb_prescreen_metrics_t metrics = ssb_proc.get_prescreen_metrics();
+  if (metrics.nof_windows == 0) {
+      return;
+  }
+  std::cout << "  PSS pre-screen: " << metrics.nof_hits << "/" << metrics.nof_windows << " windows correlated ("
+            << std::fixed << std::setprecision(1) << 100.0 * metrics.nof_hits / metrics.nof_windows << "%)"
+            << std::endl;
+}
+
 bool scan_for_ssb(RfHandler& rf, SsbProcessor& ssb_proc, const Config& config,
             SsbSearchResult& result) {
   std::cout << "\n  ======================================================================"         << std::endl;
@@ -185,6 +196,7 @@ bool scan_for_ssb(RfHandler& rf, SsbProcessor& ssb_proc, const Config& config,
                        << " | SSB#" << result.ssb_idx << "     " << std::endl;
               std::cout << "  ======================================================================" << std::endl;
               SsbProcessor::print_mib(result.mib);
+              print_prescreen_metrics(ssb_proc);
               
               rf.stop_rx();
               return true;
@@ -196,6 +208,7 @@ bool scan_for_ssb(RfHandler& rf, SsbProcessor& ssb_proc, const Config& config,
   }
   
   rf.stop_rx();
+  print_prescreen_metrics(ssb_proc);
   
   // Close file if it was opened
   if (config.operation.save_samples && sample_file.is_open()) {
@@ -508,8 +521,15 @@ int main(int argc, char** argv) {
       return 1;
   }
   
-  // Transmit spoofed SSB
-  if (!transmit_spoofed_ssb(rf, ssb_proc, config, ssb_result)) {
+  // Sweep the campaign on the same RF device and SSB processor
+  if (config.campaign.enable) {
+      CampaignRunner campaign(rf, ssb_proc, config);
+      if (!campaign.run(ssb_result, running) && running) {
+          std::cerr << "  ERROR: Campaign aborted" << std::endl;
+          return 1;
+      }
+  } else if (!transmit_spoofed_ssb(rf, ssb_proc, config, ssb_result)) {
+      // Transmit spoofed SSB
       std::cerr << "  ERROR: Failed to transmit spoofed SSB" << std::endl;
       return 1;
   }
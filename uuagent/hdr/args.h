@@ -2,6 +2,7 @@
 #define ARGS_H
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 typedef struct rf_args_s {
@@ -14,10 +15,38 @@ typedef struct rf_args_s {
   float rx_freq;
   float tx_freq;
   size_t num_samples;
+  std::string output_format;   // Raw capture file format, "fc32" or "sc16"
+  size_t block_samples;        // Samples per receive block handed to the writer
+  size_t nof_blocks;           // Number of receive blocks in the pool
 } rf_args_t;
 
+typedef struct trigger_args_s {
+  std::string mode;            // "none", "energy" or "ssb"
+  double pre_trigger_ms;       // Samples kept in memory before the trigger point
+  double post_trigger_ms;      // Samples written after the trigger point
+  uint32_t max_events;         // Stop after this many events (0 = run forever)
+  float energy_thr_dbfs;       // Energy detector threshold (average power in dBFS)
+  double energy_window_us;     // Energy detector averaging window
+  double ssb_freq;             // SSB center frequency in Hz (0 = RX frequency)
+  uint32_t ssb_scs_khz;        // SSB subcarrier spacing
+  std::string ssb_pattern;     // SSB pattern (A-E)
+  float ssb_snr_thr_db;        // Minimum SSB SNR for the detector to fire
+  int32_t ssb_pci;             // Only fire on this PCI (-1 = any)
+} trigger_args_t;
+
+typedef struct psd_args_s {
+  bool enable;                 // Stream spectrum summaries instead of raw IQ
+  uint32_t fft_size;           // Number of frequency bins
+  double interval_ms;          // Averaging interval per record
+  std::string percentiles;     // Comma-separated per-bin percentiles, e.g. "10,50,90"
+  std::string output;          // Output file, or tcp:// / ipc:// endpoint for a ZMQ PUB socket
+  double duration_s;           // Stop after this many seconds of samples (0 = run forever)
+} psd_args_t;
+
 typedef struct all_args_s {
   rf_args_t rf;
+  trigger_args_t trigger;
+  psd_args_t psd;
 } all_args_t;
 
 #endif // !ARGS_H
@@ -0,0 +1,51 @@
+#ifndef BLOCK_WRITER_H
+#define BLOCK_WRITER_H
+
+#include "iq_sink.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// Pool of large sc16 blocks that the receiver fills in place and a writer
+// thread hands to the sink, so samples are never copied between the radio and
+// the sink. Only the writer thread touches the sink.
+class BlockWriter {
+public:
+  BlockWriter(IqSink &sink_, size_t block_samples_, size_t nof_blocks);
+  ~BlockWriter();
+
+  // Returns a free block, waiting for the writer if the pool is exhausted
+  std::complex<int16_t> *acquire();
+
+  // Queues the first nsamples of a block for writing
+  void commit(std::complex<int16_t> *block, size_t nsamples);
+
+  // Writes all queued blocks and joins the writer thread
+  void stop();
+
+  size_t block_samples() const { return block_sz; }
+  bool done() const { return sink_done; }
+  bool failed() const { return write_failed; }
+
+private:
+  void run();
+
+  IqSink &sink;
+  size_t block_sz;
+  std::vector<std::vector<std::complex<int16_t>>> storage;
+
+  std::mutex mutex;
+  std::condition_variable cvar;
+  std::deque<std::complex<int16_t> *> free_blocks;
+  std::deque<std::pair<std::complex<int16_t> *, size_t>> full_blocks;
+  bool stopping = false;
+
+  std::atomic<bool> sink_done{false};
+  std::atomic<bool> write_failed{false};
+  std::thread thread;
+};
+
+#endif // !BLOCK_WRITER_H
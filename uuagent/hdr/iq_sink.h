@@ -0,0 +1,61 @@
+#ifndef IQ_SINK_H
+#define IQ_SINK_H
+
+#include "args.h"
+#include <complex>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+// Destination for the samples produced by an RF backend
+class IqSink {
+public:
+  virtual ~IqSink() = default;
+
+  // Consumes a block of received samples, returns false on a write error
+  virtual bool write(const std::complex<float> *samples, size_t nsamples) = 0;
+
+  // Consumes a block of sc16 samples as delivered by the radio. By default the
+  // block is converted to fc32 and passed to write()
+  virtual bool write_sc16(const std::complex<int16_t> *samples, size_t nsamples);
+
+  // Writes out anything the sink still holds once the capture is over,
+  // returns false on a write error
+  virtual bool flush() { return true; }
+
+  // True once the sink does not need any more samples
+  virtual bool done() const = 0;
+
+  // Total number of samples the sink needs, 0 if it runs until done()
+  virtual size_t nof_samples() const = 0;
+
+private:
+  std::vector<std::complex<float>> conversion_buffer;
+};
+
+// Writes the first num_samples received samples to the output file, as fc32
+// or as sc16. sc16 is raw from the radio when it delivers sc16, fc32 samples
+// are converted
+class FileSink : public IqSink {
+public:
+  explicit FileSink(const rf_args_t &args);
+
+  bool is_open() const { return outfile.is_open(); }
+  bool write(const std::complex<float> *samples, size_t nsamples) override;
+  bool write_sc16(const std::complex<int16_t> *samples, size_t nsamples) override;
+  bool done() const override { return total_written >= num_samples; }
+  size_t nof_samples() const override { return num_samples; }
+
+private:
+  std::ofstream outfile;
+  bool raw_sc16;
+  size_t num_samples;
+  size_t total_written = 0;
+  std::vector<std::complex<int16_t>> sc16_buffer;
+};
+
+// Factory function declaration, returns nullptr if the sink cannot be created
+std::unique_ptr<IqSink> create_iq_sink(const all_args_t &args);
+
+#endif // !IQ_SINK_H
@@ -0,0 +1,75 @@
+#ifndef PSD_H
+#define PSD_H
+
+#include "iq_sink.h"
+#include "srsran/srsran.h"
+#include <vector>
+#include <zmq.hpp>
+
+// Header of every spectrogram record. It is followed by nof_percentiles floats
+// holding the percentile values, then nof_bins floats (dBFS, DC in the center)
+// for the average, the max-hold and each percentile in that order.
+typedef struct psd_record_header_s {
+  char magic[4];             // "PSD1"
+  uint32_t nof_bins;
+  uint32_t nof_percentiles;
+  uint32_t nof_frames;       // FFT frames summarized in this record
+  uint64_t first_sample;     // Stream position of the first summarized sample
+  double srate_hz;
+  double center_freq_hz;
+} psd_record_header_t;
+
+// Windowed FFT power spectrum, averaged over an interval with max-hold and
+// per-bin percentiles, written as compact records to a file or ZMQ PUB socket
+class PsdSink : public IqSink {
+public:
+  PsdSink();
+  ~PsdSink();
+
+  bool init(const all_args_t &args);
+  bool write(const std::complex<float> *samples, size_t nsamples) override;
+  bool flush() override;
+  bool done() const override {
+    return max_samples != 0 && stream_pos >= max_samples;
+  }
+  size_t nof_samples() const override { return 0; }
+
+private:
+  void process_frame();
+  bool emit_record();
+  float percentile(const uint32_t *bin_hist, uint32_t rank) const;
+
+  srsran_dft_plan_t plan = {};
+  bool plan_initialized = false;
+  uint32_t fft_size = 0;
+  uint32_t frames_per_record = 0;
+  double srate_hz = 0;
+  double center_freq_hz = 0;
+  uint64_t max_samples = 0;
+  uint64_t stream_pos = 0;
+  uint64_t record_start = 0;
+
+  std::vector<float> window;
+  float power_scale = 1.0f;
+  cf_t *frame = nullptr;
+  cf_t *spectrum = nullptr;
+  uint32_t frame_fill = 0;
+
+  // Per-interval accumulators
+  std::vector<float> power;
+  std::vector<float> power_sum;
+  std::vector<float> power_max;
+  std::vector<uint32_t> hist;          // fft_size x PSD_HIST_NOF_BUCKETS
+  std::vector<uint32_t> hist_idx;
+  uint32_t nof_frames = 0;
+
+  std::vector<float> percentiles;
+  std::vector<float> record;
+
+  std::ofstream outfile;
+  zmq::context_t context;
+  zmq::socket_t socket;
+  bool use_zmq = false;
+};
+
+#endif // !PSD_H
@@ -2,6 +2,7 @@
 #define RF_BASE_H
 
 #include "args.h"
+#include "iq_sink.h"
 #include <memory>
 
 typedef enum uuagent_error_enum {
@@ -10,13 +11,14 @@ typedef enum uuagent_error_enum {
   UUAGENT_UHD_ERROR,
   UUAGENT_ZMQ_ERROR,
   UUAGENT_SAMPLE_ERROR,
-  UUAGENT_INVALID_RF_TYPE
+  UUAGENT_INVALID_RF_TYPE,
+  UUAGENT_SINK_ERROR
 } uuagent_error_e;
 
 class RFBase {
   public:
     virtual ~RFBase() = default;
-    virtual uuagent_error_e collect_iq_data(const all_args_t& args) = 0;
+    virtual uuagent_error_e collect_iq_data(const all_args_t& args, IqSink& sink) = 0;
 };
 
 // Factory function declaration
@@ -0,0 +1,13 @@
+#ifndef RF_SHM_H
+#define RF_SHM_H
+
+#include "rf_base.h"
+
+// Reads from a shared-memory ring fed by another process on the same host
+// (srsRAN "shm" RF device), next to any other reader of the same segment
+class RF_SHM : public RFBase {
+public:
+  uuagent_error_e collect_iq_data(const all_args_t& args, IqSink& sink) override;
+};
+
+#endif  // !RF_SHM_H
@@ -7,7 +7,7 @@
 
 class RF_UHD : public RFBase {
 public:
-  uuagent_error_e collect_iq_data(const all_args_t& args) override;
+  uuagent_error_e collect_iq_data(const all_args_t& args, IqSink& sink) override;
 };
 
 #endif  // !RF_UHD_H
@@ -8,7 +8,7 @@ class RF_ZMQ : public RFBase {
 public:
   RF_ZMQ();
   ~RF_ZMQ();
-  uuagent_error_e collect_iq_data(const all_args_t& args) override;
+  uuagent_error_e collect_iq_data(const all_args_t& args, IqSink& sink) override;
 
 private:
   zmq::context_t context;
@@ -0,0 +1,95 @@
+#ifndef TRIGGER_H
+#define TRIGGER_H
+
+#include "iq_sink.h"
+#include "srsran/srsran.h"
+#include <string>
+#include <vector>
+
+// Evaluates one detection window of the incoming stream
+class TriggerDetector {
+public:
+  virtual ~TriggerDetector() = default;
+
+  // Number of samples evaluated per detection
+  virtual size_t window_len() const = 0;
+
+  // Samples shared by two consecutive windows, so events on a window edge are not lost
+  virtual size_t overlap_len() const { return 0; }
+
+  // Returns true if the window contains an event, metric holds a printable description
+  virtual bool detect(const std::complex<float> *window, std::string &metric) = 0;
+};
+
+// Fires when the average power over the window exceeds a threshold
+class EnergyDetector : public TriggerDetector {
+public:
+  EnergyDetector(size_t window_len_, float threshold_dbfs_);
+
+  size_t window_len() const override { return window_sz; }
+  bool detect(const std::complex<float> *window, std::string &metric) override;
+
+private:
+  size_t window_sz;
+  float threshold_dbfs;
+};
+
+// Fires when an NR SSB (PSS + SSS) is found with enough SNR
+class SsbDetector : public TriggerDetector {
+public:
+  SsbDetector();
+  ~SsbDetector();
+
+  bool init(const all_args_t &args);
+  size_t window_len() const override { return window_sz; }
+  size_t overlap_len() const override { return ssb.ssb_sz; }
+  bool detect(const std::complex<float> *window, std::string &metric) override;
+
+private:
+  srsran_ssb_t ssb = {};
+  bool initialized = false;
+  size_t window_sz = 0;
+  float snr_thr_db = 0.0f;
+  int32_t pci = -1;
+};
+
+// Keeps a rolling pre-trigger ring in memory and writes pre- plus post-trigger windows
+// to a new file every time the detector fires
+class TriggerSink : public IqSink {
+public:
+  TriggerSink(const all_args_t &args, std::unique_ptr<TriggerDetector> detector_);
+
+  bool write(const std::complex<float> *samples, size_t nsamples) override;
+  bool done() const override {
+    return max_events != 0 && nof_events >= max_events;
+  }
+  size_t nof_samples() const override { return 0; }
+
+private:
+  void ring_push(const std::complex<float> *samples, size_t nsamples);
+  bool start_event(const std::string &metric);
+  std::string event_filename(uint32_t event_idx) const;
+
+  std::unique_ptr<TriggerDetector> detector;
+  std::string output_file;
+  double srate_hz;
+  uint32_t max_events;
+
+  // Pre-trigger ring
+  std::vector<std::complex<float>> ring;
+  size_t ring_wr = 0;
+  size_t ring_fill = 0;
+
+  // Detection window
+  std::vector<std::complex<float>> window;
+  size_t window_fill = 0;
+
+  // Event state
+  std::ofstream event_file;
+  size_t post_len;
+  size_t post_remaining = 0;
+  uint32_t nof_events = 0;
+  uint64_t stream_pos = 0;
+};
+
+#endif // !TRIGGER_H
@@ -0,0 +1,71 @@
+#include "block_writer.h"
+#include <algorithm>
+
+BlockWriter::BlockWriter(IqSink &sink_, size_t block_samples_,
+                         size_t nof_blocks)
+    : sink(sink_), block_sz(std::max<size_t>(block_samples_, 1)),
+      storage(std::max<size_t>(nof_blocks, 2)) {
+  for (auto &block : storage) {
+    block.resize(block_sz);
+    free_blocks.push_back(block.data());
+  }
+  thread = std::thread(&BlockWriter::run, this);
+}
+
+BlockWriter::~BlockWriter() { stop(); }
+
+std::complex<int16_t> *BlockWriter::acquire() {
+  std::unique_lock<std::mutex> lock(mutex);
+  cvar.wait(lock, [this] { return !free_blocks.empty(); });
+  std::complex<int16_t> *block = free_blocks.front();
+  free_blocks.pop_front();
+  return block;
+}
+
+void BlockWriter::commit(std::complex<int16_t> *block, size_t nsamples) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    full_blocks.emplace_back(block, nsamples);
+  }
+  cvar.notify_all();
+}
+
+void BlockWriter::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  cvar.notify_all();
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+void BlockWriter::run() {
+  while (true) {
+    std::pair<std::complex<int16_t> *, size_t> block;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cvar.wait(lock, [this] { return stopping || !full_blocks.empty(); });
+      if (full_blocks.empty()) {
+        return;
+      }
+      block = full_blocks.front();
+      full_blocks.pop_front();
+    }
+
+    // Once the sink is complete or failed, remaining blocks are just recycled
+    if (!sink_done && !write_failed) {
+      if (!sink.write_sc16(block.first, block.second)) {
+        write_failed = true;
+      }
+      sink_done = sink.done();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      free_blocks.push_back(block.first);
+    }
+    cvar.notify_all();
+  }
+}
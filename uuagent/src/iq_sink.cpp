@@ -0,0 +1,112 @@
+#include "iq_sink.h"
+#include "psd.h"
+#include "srsran/srsran.h"
+#include "trigger.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+bool IqSink::write_sc16(const std::complex<int16_t> *samples,
+                        size_t nsamples) {
+  if (conversion_buffer.size() < nsamples) {
+    conversion_buffer.resize(nsamples);
+  }
+
+  // Same scaling UHD applies for the fc32 CPU format
+  srsran_vec_convert_if(reinterpret_cast<const int16_t *>(samples), 32768.0f,
+                        reinterpret_cast<float *>(conversion_buffer.data()),
+                        (uint32_t)(2 * nsamples));
+  return write(conversion_buffer.data(), nsamples);
+}
+
+FileSink::FileSink(const rf_args_t &args)
+    : outfile(args.output_file, std::ios::binary),
+      raw_sc16(args.output_format == "sc16"), num_samples(args.num_samples) {}
+
+bool FileSink::write(const std::complex<float> *samples, size_t nsamples) {
+  // Write exactly the number of samples that is requested
+  size_t n = std::min(nsamples, num_samples - total_written);
+
+  // Backends that only deliver fc32 are converted back to sc16, so that the
+  // file always has the requested format
+  if (raw_sc16) {
+    if (sc16_buffer.size() < n) {
+      sc16_buffer.resize(n);
+    }
+    srsran_vec_convert_fi(reinterpret_cast<const float *>(samples), 32767.0f,
+                          reinterpret_cast<int16_t *>(sc16_buffer.data()),
+                          (uint32_t)(2 * n));
+    return write_sc16(sc16_buffer.data(), n);
+  }
+
+  outfile.write(reinterpret_cast<const char *>(samples),
+                n * sizeof(std::complex<float>));
+  total_written += n;
+  return outfile.good();
+}
+
+bool FileSink::write_sc16(const std::complex<int16_t> *samples,
+                          size_t nsamples) {
+  if (!raw_sc16) {
+    return IqSink::write_sc16(samples, nsamples);
+  }
+
+  size_t n = std::min(nsamples, num_samples - total_written);
+  outfile.write(reinterpret_cast<const char *>(samples),
+                n * sizeof(std::complex<int16_t>));
+  total_written += n;
+  return outfile.good();
+}
+
+std::unique_ptr<IqSink> create_iq_sink(const all_args_t &args) {
+  if (args.psd.enable) {
+    if (args.trigger.mode != "none") {
+      std::cerr << "PSD mode and trigger mode are mutually exclusive"
+                << std::endl;
+      return nullptr;
+    }
+    auto sink = std::make_unique<PsdSink>();
+    if (!sink->init(args)) {
+      return nullptr;
+    }
+    return sink;
+  }
+
+  if (args.rf.output_format != "fc32" && args.rf.output_format != "sc16") {
+    std::cerr << "Unknown output format: " << args.rf.output_format
+              << std::endl;
+    return nullptr;
+  }
+
+  if (args.trigger.mode == "none") {
+    auto sink = std::make_unique<FileSink>(args.rf);
+    if (!sink->is_open()) {
+      std::cerr << "failed to open output file: " << args.rf.output_file
+                << std::endl;
+      return nullptr;
+    }
+    return sink;
+  }
+
+  std::unique_ptr<TriggerDetector> detector;
+  if (args.trigger.mode == "energy") {
+    size_t window_len =
+        (size_t)std::round(args.trigger.energy_window_us * 1e-6 * args.rf.srate_hz);
+    detector = std::make_unique<EnergyDetector>(window_len,
+                                                args.trigger.energy_thr_dbfs);
+  } else if (args.trigger.mode == "ssb") {
+    auto ssb_detector = std::make_unique<SsbDetector>();
+    if (!ssb_detector->init(args)) {
+      return nullptr;
+    }
+    detector = std::move(ssb_detector);
+  } else {
+    std::cerr << "Unknown trigger mode: " << args.trigger.mode << std::endl;
+    return nullptr;
+  }
+
+  std::cout << "Trigger mode " << args.trigger.mode << ": "
+            << args.trigger.pre_trigger_ms << "ms pre-trigger, "
+            << args.trigger.post_trigger_ms << "ms post-trigger" << std::endl;
+  return std::make_unique<TriggerSink>(args, std::move(detector));
+}
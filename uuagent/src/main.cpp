@@ -7,6 +7,7 @@
 #include <stdexcept>
 
 #include "args.h"
+#include "iq_sink.h"
 #include "rf_base.h"
 
 namespace bpo = boost::program_options;
@@ -24,7 +25,7 @@ void parse_args(all_args_t &args, int argc, char *argv[]) {
   common.add_options()(
       "rf.type",
       bpo::value<std::string>(&args.rf.rf_type)->default_value("uhd"),
-      "RF hardware type")(
+      "RF hardware type (uhd, zmq or shm)")(
       "rf.srate", bpo::value<double>(&args.rf.srate_hz)->default_value(24.04e6),
       "Sampling rate in Hz")(
       "rf.rx_gain", bpo::value<float>(&args.rf.rx_gain)->default_value(30),
@@ -44,10 +45,75 @@ void parse_args(all_args_t &args, int argc, char *argv[]) {
       "Output binary file")(
       "rf.device_args",
       bpo::value<std::string>(&args.rf.device_args)->default_value(""),
-      "Deivice arguments for RF");
+      "Deivice arguments for RF")(
+      "rf.output_format",
+      bpo::value<std::string>(&args.rf.output_format)->default_value("fc32"),
+      "Capture file format: fc32 (complex float) or sc16 (raw complex int16)")(
+      "rf.block_samples",
+      bpo::value<size_t>(&args.rf.block_samples)->default_value(262144),
+      "Samples per receive block handed to the writer thread")(
+      "rf.nof_blocks",
+      bpo::value<size_t>(&args.rf.nof_blocks)->default_value(16),
+      "Number of receive blocks in the pool");
+
+  bpo::options_description trigger("Trigger options");
+  trigger.add_options()(
+      "trigger.mode",
+      bpo::value<std::string>(&args.trigger.mode)->default_value("none"),
+      "Trigger mode: none (fixed-length capture), energy or ssb")(
+      "trigger.pre_trigger_ms",
+      bpo::value<double>(&args.trigger.pre_trigger_ms)->default_value(10),
+      "Samples kept in memory and written before the trigger point (ms)")(
+      "trigger.post_trigger_ms",
+      bpo::value<double>(&args.trigger.post_trigger_ms)->default_value(40),
+      "Samples written after the trigger point (ms)")(
+      "trigger.max_events",
+      bpo::value<uint32_t>(&args.trigger.max_events)->default_value(1),
+      "Number of events to capture before exiting (0 = unlimited)")(
+      "trigger.energy_thr_dbfs",
+      bpo::value<float>(&args.trigger.energy_thr_dbfs)->default_value(-30),
+      "Energy detector threshold, average power in dBFS")(
+      "trigger.energy_window_us",
+      bpo::value<double>(&args.trigger.energy_window_us)->default_value(100),
+      "Energy detector averaging window (us)")(
+      "trigger.ssb_freq",
+      bpo::value<double>(&args.trigger.ssb_freq)->default_value(0),
+      "SSB center frequency in Hz (0 = RX frequency)")(
+      "trigger.ssb_scs_khz",
+      bpo::value<uint32_t>(&args.trigger.ssb_scs_khz)->default_value(30),
+      "SSB subcarrier spacing in kHz (15 or 30)")(
+      "trigger.ssb_pattern",
+      bpo::value<std::string>(&args.trigger.ssb_pattern)->default_value("C"),
+      "SSB pattern (A-E)")(
+      "trigger.ssb_snr_thr_db",
+      bpo::value<float>(&args.trigger.ssb_snr_thr_db)->default_value(5),
+      "Minimum SSB SNR for the SSB detector to fire (dB)")(
+      "trigger.ssb_pci",
+      bpo::value<int32_t>(&args.trigger.ssb_pci)->default_value(-1),
+      "Only fire on this PCI (-1 = any)");
+
+  bpo::options_description psd("Spectrum summary options");
+  psd.add_options()(
+      "psd.enable", bpo::value<bool>(&args.psd.enable)->default_value(false),
+      "Stream spectrum summaries instead of raw IQ")(
+      "psd.fft_size",
+      bpo::value<uint32_t>(&args.psd.fft_size)->default_value(1024),
+      "Number of frequency bins")(
+      "psd.interval_ms",
+      bpo::value<double>(&args.psd.interval_ms)->default_value(1000),
+      "Averaging interval per record (ms)")(
+      "psd.percentiles",
+      bpo::value<std::string>(&args.psd.percentiles)->default_value("10,50,90"),
+      "Comma-separated per-bin percentiles")(
+      "psd.output",
+      bpo::value<std::string>(&args.psd.output)->default_value("psd.bin"),
+      "Output file, or tcp:// / ipc:// endpoint for a ZMQ PUB socket")(
+      "psd.duration_s",
+      bpo::value<double>(&args.psd.duration_s)->default_value(0),
+      "Stop after this many seconds (0 = run forever)");
 
   bpo::options_description all_options;
-  all_options.add(general).add(common);
+  all_options.add(general).add(common).add(trigger).add(psd);
 
   bpo::variables_map vm;
   bpo::store(bpo::parse_command_line(argc, argv, all_options), vm);
@@ -64,7 +130,9 @@ void parse_args(all_args_t &args, int argc, char *argv[]) {
 
   std::ifstream config_file(conf_filepath);
   if (config_file) {
-    bpo::store(bpo::parse_config_file(config_file, common), vm);
+    bpo::options_description config_options;
+    config_options.add(common).add(trigger).add(psd);
+    bpo::store(bpo::parse_config_file(config_file, config_options), vm);
     bpo::notify(vm);
   } else {
     std::cerr << "Failed to open config file: " << conf_filepath << std::endl;
@@ -80,7 +148,18 @@ uuagent_error_e collect_iq_data(const all_args_t &args) {
     return UUAGENT_INVALID_RF_TYPE;
   }
 
-  return rf_instance->collect_iq_data(args);
+  auto sink = create_iq_sink(args);
+  if (!sink) {
+    return UUAGENT_SINK_ERROR;
+  }
+
+  uuagent_error_e result = rf_instance->collect_iq_data(args, *sink);
+
+  // Keep what the sink summarized so far, also when the capture failed
+  if (!sink->flush() && result == UUAGENT_SUCCESS) {
+    return UUAGENT_FILE_ERROR;
+  }
+  return result;
 }
 
 int main(int argc, char *argv[]) {
@@ -0,0 +1,255 @@
+#include "psd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+// Power histograms use the float exponent plus the 3 most significant mantissa
+// bits as bucket index (~0.5 dB resolution), so no logarithm is computed per bin
+// and frame. Buckets hold the normalized power and cover 2^PSD_HIST_MIN_EXP to
+// 2^(PSD_HIST_MIN_EXP + PSD_HIST_OCTAVES), about -144 to +48 dBFS.
+#define PSD_HIST_MIN_EXP -48
+#define PSD_HIST_OCTAVES 64
+#define PSD_HIST_NOF_BUCKETS (PSD_HIST_OCTAVES * 8)
+#define PSD_HIST_FIRST_BUCKET ((127 + PSD_HIST_MIN_EXP) * 8)
+
+PsdSink::PsdSink() {}
+
+PsdSink::~PsdSink() {
+  if (plan_initialized) {
+    srsran_dft_plan_free(&plan);
+  }
+  free(frame);
+  free(spectrum);
+}
+
+static bool parse_percentiles(const std::string &str, std::vector<float> &out) {
+  std::istringstream is(str);
+  std::string item;
+  while (std::getline(is, item, ',')) {
+    if (item.find_first_not_of(" \t") == std::string::npos) {
+      continue;
+    }
+    float p = std::stof(item);
+    if (p < 0.0f || p > 100.0f) {
+      return false;
+    }
+    out.push_back(p);
+  }
+  return true;
+}
+
+bool PsdSink::init(const all_args_t &args) {
+  fft_size = args.psd.fft_size;
+  if (fft_size == 0) {
+    std::cerr << "Invalid PSD FFT size" << std::endl;
+    return false;
+  }
+
+  srate_hz = args.rf.srate_hz;
+  center_freq_hz = args.rf.rx_freq;
+  frames_per_record = std::max<uint32_t>(
+      (uint32_t)std::round(args.psd.interval_ms * 1e-3 * srate_hz / fft_size), 1);
+  max_samples = (uint64_t)std::round(args.psd.duration_s * srate_hz);
+
+  try {
+    if (!parse_percentiles(args.psd.percentiles, percentiles)) {
+      std::cerr << "PSD percentiles must be between 0 and 100" << std::endl;
+      return false;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Invalid PSD percentiles: " << args.psd.percentiles
+              << std::endl;
+    return false;
+  }
+
+  if (srsran_dft_plan_c(&plan, fft_size, SRSRAN_DFT_FORWARD) < SRSRAN_SUCCESS) {
+    std::cerr << "Error creating PSD DFT plan" << std::endl;
+    return false;
+  }
+  plan_initialized = true;
+  srsran_dft_plan_set_mirror(&plan, true);
+
+  // Hann window, power is normalized so that the bins add up to the average
+  // input power in dBFS
+  window.resize(fft_size);
+  float window_energy = 0.0f;
+  for (uint32_t i = 0; i < fft_size; i++) {
+    window[i] = 0.5f * (1.0f - cosf(2.0f * (float)M_PI * i / fft_size));
+    window_energy += window[i] * window[i];
+  }
+  power_scale = 1.0f / (window_energy * fft_size);
+
+  frame = srsran_vec_cf_malloc(fft_size);
+  spectrum = srsran_vec_cf_malloc(fft_size);
+  if (frame == nullptr || spectrum == nullptr) {
+    std::cerr << "Error allocating PSD buffers" << std::endl;
+    return false;
+  }
+
+  power.resize(fft_size);
+  power_sum.assign(fft_size, 0.0f);
+  power_max.assign(fft_size, 0.0f);
+  hist.assign((size_t)fft_size * PSD_HIST_NOF_BUCKETS, 0);
+  hist_idx.resize(fft_size);
+  record.resize((size_t)(2 + percentiles.size()) * fft_size);
+
+  const std::string &output = args.psd.output;
+  use_zmq = output.compare(0, 6, "tcp://") == 0 ||
+            output.compare(0, 6, "ipc://") == 0;
+  if (use_zmq) {
+    try {
+      socket = zmq::socket_t(context, zmq::socket_type::pub);
+      socket.bind(output);
+    } catch (const zmq::error_t &e) {
+      std::cerr << "ZMQ Error: " << e.what() << std::endl;
+      return false;
+    }
+  } else {
+    outfile.open(output, std::ios::binary);
+    if (!outfile) {
+      std::cerr << "failed to open PSD output file: " << output << std::endl;
+      return false;
+    }
+  }
+
+  std::cout << "PSD mode: " << fft_size << " bins, " << frames_per_record
+            << " frames per record -> " << output << std::endl;
+  return true;
+}
+
+void PsdSink::process_frame() {
+  srsran_dft_run_c(&plan, frame, spectrum);
+  srsran_vec_abs_square_cf(spectrum, power.data(), fft_size);
+
+  // Normalize to dBFS before accumulating, so that the histogram range does not
+  // depend on the FFT size
+  srsran_vec_sc_prod_fff(power.data(), power_scale, power.data(), fft_size);
+
+  // Average and max-hold
+  srsran_vec_sum_fff(power_sum.data(), power.data(), power_sum.data(), fft_size);
+  for (uint32_t k = 0; k < fft_size; k++) {
+    power_max[k] = std::max(power_max[k], power[k]);
+  }
+
+  // Histogram bucket per bin, the index loop vectorizes
+  for (uint32_t k = 0; k < fft_size; k++) {
+    uint32_t bits;
+    std::memcpy(&bits, &power[k], sizeof(bits));
+    int32_t bucket = (int32_t)(bits >> 20) - PSD_HIST_FIRST_BUCKET;
+    bucket = std::min(std::max(bucket, 0), PSD_HIST_NOF_BUCKETS - 1);
+    hist_idx[k] = k * PSD_HIST_NOF_BUCKETS + (uint32_t)bucket;
+  }
+  for (uint32_t k = 0; k < fft_size; k++) {
+    hist[hist_idx[k]]++;
+  }
+
+  nof_frames++;
+}
+
+float PsdSink::percentile(const uint32_t *bin_hist, uint32_t rank) const {
+  uint32_t acc = 0;
+  int32_t b = 0;
+  for (; b < PSD_HIST_NOF_BUCKETS - 1; b++) {
+    acc += bin_hist[b];
+    if (acc >= rank) {
+      break;
+    }
+  }
+
+  // Bucket center, in the same normalized scale as the accumulated power
+  int32_t bucket = b + PSD_HIST_FIRST_BUCKET;
+  float mantissa = 1.0f + ((bucket & 7) + 0.5f) / 8.0f;
+  return ldexpf(mantissa, (bucket >> 3) - 127);
+}
+
+bool PsdSink::emit_record() {
+  float *avg_db = record.data();
+  float *max_db = avg_db + fft_size;
+  float avg_scale = 1.0f / nof_frames;
+  for (uint32_t k = 0; k < fft_size; k++) {
+    avg_db[k] = srsran_convert_power_to_dB(power_sum[k] * avg_scale);
+    max_db[k] = srsran_convert_power_to_dB(power_max[k]);
+  }
+
+  for (size_t p = 0; p < percentiles.size(); p++) {
+    float *pct_db = max_db + (p + 1) * fft_size;
+    uint32_t rank = std::max<uint32_t>(
+        (uint32_t)std::ceil(percentiles[p] / 100.0f * nof_frames), 1);
+    for (uint32_t k = 0; k < fft_size; k++) {
+      float value = percentile(&hist[(size_t)k * PSD_HIST_NOF_BUCKETS], rank);
+      pct_db[k] = srsran_convert_power_to_dB(value);
+    }
+  }
+
+  psd_record_header_t header = {};
+  std::memcpy(header.magic, "PSD1", sizeof(header.magic));
+  header.nof_bins = fft_size;
+  header.nof_percentiles = (uint32_t)percentiles.size();
+  header.nof_frames = nof_frames;
+  header.first_sample = record_start;
+  header.srate_hz = srate_hz;
+  header.center_freq_hz = center_freq_hz;
+
+  // Reset accumulators for the next interval
+  std::fill(power_sum.begin(), power_sum.end(), 0.0f);
+  std::fill(power_max.begin(), power_max.end(), 0.0f);
+  std::fill(hist.begin(), hist.end(), 0);
+  nof_frames = 0;
+  record_start = stream_pos;
+
+  size_t pct_bytes = percentiles.size() * sizeof(float);
+  size_t record_bytes = record.size() * sizeof(float);
+  if (use_zmq) {
+    zmq::message_t message(sizeof(header) + pct_bytes + record_bytes);
+    uint8_t *ptr = static_cast<uint8_t *>(message.data());
+    std::memcpy(ptr, &header, sizeof(header));
+    std::memcpy(ptr + sizeof(header), percentiles.data(), pct_bytes);
+    std::memcpy(ptr + sizeof(header) + pct_bytes, record.data(), record_bytes);
+    // PUB sockets drop records for slow subscribers, never block the receiver
+    socket.send(message, zmq::send_flags::dontwait);
+    return true;
+  }
+
+  outfile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  outfile.write(reinterpret_cast<const char *>(percentiles.data()), pct_bytes);
+  outfile.write(reinterpret_cast<const char *>(record.data()), record_bytes);
+  return outfile.good();
+}
+
+bool PsdSink::write(const std::complex<float> *samples, size_t nsamples) {
+  const cf_t *in = reinterpret_cast<const cf_t *>(samples);
+  size_t i = 0;
+  while (i < nsamples && !done()) {
+    // Windowing doubles as the copy into the frame buffer
+    uint32_t n = (uint32_t)std::min<size_t>(nsamples - i, fft_size - frame_fill);
+    if (max_samples != 0) {
+      n = (uint32_t)std::min<uint64_t>(n, max_samples - stream_pos);
+    }
+    srsran_vec_prod_cfc(in + i, &window[frame_fill], &frame[frame_fill], n);
+    frame_fill += n;
+    stream_pos += n;
+    i += n;
+
+    if (frame_fill < fft_size) {
+      continue;
+    }
+    frame_fill = 0;
+    process_frame();
+
+    if (nof_frames == frames_per_record && !emit_record()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PsdSink::flush() {
+  // Frames of the last interval are summarized in a shorter record, the
+  // incomplete frame is dropped
+  if (nof_frames == 0) {
+    return true;
+  }
+  return emit_record();
+}
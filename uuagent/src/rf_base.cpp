@@ -1,4 +1,5 @@
 #include "rf_base.h"
+#include "rf_shm.h"
 #include "rf_zmq.h"
 #include "rf_uhd.h"
 #include <iostream>
@@ -9,6 +10,8 @@ std::unique_ptr<RFBase> create_rf_instance(const std::string& rf_type) {
     return std::make_unique<RF_UHD>();
   } else if (rf_type == "zmq") {
     return std::make_unique<RF_ZMQ>();
+  } else if (rf_type == "shm") {
+    return std::make_unique<RF_SHM>();
   } else {
     std::cerr << "Unknown/Unsupported RF type: " << rf_type << std::endl;
     return nullptr;
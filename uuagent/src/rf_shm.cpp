@@ -0,0 +1,58 @@
+#include "rf_shm.h"
+#include "srsran/phy/rf/rf.h"
+#include <algorithm>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+// Collect IQ data from a shared-memory segment
+uuagent_error_e RF_SHM::collect_iq_data(const all_args_t &args, IqSink &sink) {
+  // The device consumes the argument string while parsing it
+  std::string device_args = args.rf.device_args.empty() ? "rx_port=/srsran_iq"
+                                                        : args.rf.device_args;
+  std::vector<char> dev_args(device_args.begin(), device_args.end());
+  dev_args.push_back('\0');
+
+  srsran_rf_t rf = {};
+  if (srsran_rf_open_devname(&rf, "shm", dev_args.data(), 1) != SRSRAN_SUCCESS) {
+    std::cerr << "SHM Error: could not open " << device_args << std::endl;
+    return UUAGENT_SAMPLE_ERROR;
+  }
+  srsran_rf_set_rx_srate(&rf, args.rf.srate_hz);
+
+  // Read in 1 ms chunks, the ring itself absorbs the writer's bursts
+  size_t chunk = std::max<size_t>((size_t)(args.rf.srate_hz / 1000), 1);
+  std::vector<std::complex<float>> buffer(chunk);
+  size_t total_received = 0;
+
+  if (sink.nof_samples() > 0) {
+    std::cout << "SHM: Receiving " << sink.nof_samples() << " samples from "
+              << device_args << "..." << std::endl;
+  } else {
+    std::cout << "SHM: Receiving from " << device_args
+              << " until the capture is complete..." << std::endl;
+  }
+
+  uuagent_error_e ret = UUAGENT_SUCCESS;
+  while (!sink.done()) {
+    int n = srsran_rf_recv_with_time(&rf, buffer.data(), (uint32_t)chunk, true,
+                                     nullptr, nullptr);
+    if (n <= 0) {
+      std::cerr << "SHM Error: failed to receive samples" << std::endl;
+      ret = UUAGENT_SAMPLE_ERROR;
+      break;
+    }
+
+    if (!sink.write(buffer.data(), (size_t)n)) {
+      std::cerr << "Failed to write samples to " << args.rf.output_file
+                << std::endl;
+      ret = UUAGENT_FILE_ERROR;
+      break;
+    }
+    total_received += (size_t)n;
+  }
+
+  srsran_rf_close(&rf);
+  std::cout << "SHM: Received " << total_received << " samples" << std::endl;
+  return ret;
+}
@@ -1,12 +1,12 @@
 #include "rf_uhd.h"
+#include "block_writer.h"
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <complex>
 #include <algorithm>
 
 // Collect IQ data using UHD
-uuagent_error_e RF_UHD::collect_iq_data(const all_args_t &args) {
+uuagent_error_e RF_UHD::collect_iq_data(const all_args_t &args, IqSink &sink) {
   // Create a USRP device
   try {
     uhd::usrp::multi_usrp::sptr usrp =
@@ -17,50 +17,78 @@ uuagent_error_e RF_UHD::collect_iq_data(const all_args_t &args) {
     usrp->set_rx_freq(uhd::tune_request_t(args.rf.rx_freq));
     usrp->set_rx_gain(args.rf.rx_gain);
 
-    // Set up the RX streamer
-    uhd::stream_args_t stream_args("fc32",
-                                   "sc16"); // Floating-point complex format
+    // Set up the RX streamer. Samples stay in the native sc16 format, the sink
+    // converts to fc32 only if it needs to
+    uhd::stream_args_t stream_args("sc16", "sc16");
     uhd::rx_streamer::sptr rx_stream = usrp->get_rx_stream(stream_args);
 
-    // Buffer for IQ data
-    const size_t samps_per_buff = rx_stream->get_max_num_samps();
-    std::vector<std::complex<float>> buffer(samps_per_buff);
+    // Each recv call fills a writer block straight from many UHD packets
+    BlockWriter writer(sink, args.rf.block_samples, args.rf.nof_blocks);
     uhd::rx_metadata_t md;
+    size_t total_received = 0;
 
-    std::ofstream outfile(args.rf.output_file, std::ios::binary);
-    if (!outfile) {
-      std::cerr << "failed to open output file: " << args.rf.output_file
-                << std::endl;
-      return UUAGENT_FILE_ERROR;
-    }
-    // Start streaming
-    std::cout << "Receiving " << args.rf.num_samples << " samples...\n";
+    // Start streaming, open-ended sinks (trigger mode) stream until done
     uhd::stream_cmd_t stream_cmd(
         uhd::stream_cmd_t::STREAM_MODE_NUM_SAMPS_AND_DONE);
-    stream_cmd.num_samps  = args.rf.num_samples;
+    if (sink.nof_samples() > 0) {
+      std::cout << "Receiving " << sink.nof_samples() << " samples...\n";
+      stream_cmd.num_samps = sink.nof_samples();
+    } else {
+      std::cout << "Receiving until the capture is complete...\n";
+      stream_cmd.stream_mode = uhd::stream_cmd_t::STREAM_MODE_START_CONTINUOUS;
+    }
     stream_cmd.stream_now = true;
     rx_stream->issue_stream_cmd(stream_cmd);
 
-    // Loop until we receive all the samples needed
-    size_t total_received = 0;
-    while (total_received < args.rf.num_samples) {
-      size_t num_to_recv = std::min(samps_per_buff,
-                                   args.rf.num_samples - total_received);
-      size_t n = rx_stream->recv(buffer.data(), num_to_recv, md, 3.0);
+    // Loop until the sink has all the samples it needs
+    std::complex<int16_t> *block = writer.acquire();
+    size_t block_fill = 0;
+    while (!writer.done() && !writer.failed()) {
+      size_t num_to_recv = writer.block_samples() - block_fill;
+      if (sink.nof_samples() > 0) {
+        if (total_received >= sink.nof_samples()) {
+          break;
+        }
+        num_to_recv = std::min(num_to_recv, sink.nof_samples() - total_received);
+      }
+      size_t n = rx_stream->recv(block + block_fill, num_to_recv, md, 3.0);
+      block_fill += n;
+      total_received += n;
 
-      if (md.error_code != uhd::rx_metadata_t::ERROR_CODE_NONE) {
+      // Overflows are expected while streaming continuously, keep going
+      if (md.error_code == uhd::rx_metadata_t::ERROR_CODE_OVERFLOW &&
+          sink.nof_samples() == 0) {
+        std::cerr << "O" << std::flush;
+      } else if (md.error_code != uhd::rx_metadata_t::ERROR_CODE_NONE) {
         std::cerr << "Error receiving samples: " << md.strerror() << std::endl;
         return UUAGENT_SAMPLE_ERROR;
       }
 
-      outfile.write(reinterpret_cast<const char *>(buffer.data()),
-                    n * sizeof(std::complex<float>));
-      total_received += n;
+      // Hand full blocks to the writer without copying
+      if (block_fill == writer.block_samples()) {
+        writer.commit(block, block_fill);
+        block = writer.acquire();
+        block_fill = 0;
+      }
+    }
+
+    if (block_fill > 0) {
+      writer.commit(block, block_fill);
+    }
+    writer.stop();
+
+    if (sink.nof_samples() == 0) {
+      rx_stream->issue_stream_cmd(
+          uhd::stream_cmd_t(uhd::stream_cmd_t::STREAM_MODE_STOP_CONTINUOUS));
     }
 
-    outfile.close();
+    if (writer.failed()) {
+      std::cerr << "failed to write samples to " << args.rf.output_file
+                << std::endl;
+      return UUAGENT_FILE_ERROR;
+    }
 
-    std::cout << "IQ Data saved to " << args.rf.output_file << std::endl;
+    std::cout << "Received " << total_received << " samples" << std::endl;
     return UUAGENT_SUCCESS;
   } catch (const std::exception& e) {
     std::cerr << "UHD Error: " << e.what() << std::endl;
@@ -1,6 +1,5 @@
 #include "rf_zmq.h"
 #include <iostream>
-#include <fstream>
 #include <complex>
 
 RF_ZMQ::RF_ZMQ() : context(1), socket(context, ZMQ_SUB) {
@@ -11,7 +10,7 @@ RF_ZMQ::~RF_ZMQ() {
   // Cleanup handled by zmq objects
 }
 
-uuagent_error_e RF_ZMQ::collect_iq_data(const all_args_t& args) {
+uuagent_error_e RF_ZMQ::collect_iq_data(const all_args_t& args, IqSink& sink) {
   try {
     // Lets connect to the ZMQ publisher
     std::string address = args.rf.device_args.empty() ? "tcp://localhost:5555" : args.rf.device_args;
@@ -22,23 +21,22 @@ uuagent_error_e RF_ZMQ::collect_iq_data(const all_args_t& args) {
     socket.set(zmq::sockopt::rcvtimeo, 5000);
     std::cout << "ZMQ: Attempting to connect to the publisher at " << address << "..." << std::endl;
 
-    // Lets now create a buffer to keep the incoming IQ num_samples
-    std::vector<std::complex<float>> iq_buffer;
-    iq_buffer.reserve(args.rf.num_samples);
     size_t samples_collected = 0;
     bool is_connected = false;  // Just to track if we've received the first message
 
-    // Now, lets loop to collect the required number of samples
-    while (samples_collected < args.rf.num_samples) {
+    // Now, lets loop until the sink has all the samples it needs
+    while (!sink.done()) {
       zmq::message_t message;
 
       auto recv_result = socket.recv(message); // Evaluates to true with non-empty message reception success
       if (recv_result) {
         // Lets first print the successful connection
         if (!is_connected) {
-          std::cout << "ZMQ: Connection successful with " << address
-                    <<"\nReceiving " << args.rf.num_samples <<" samples...\n(Patiencee...)"
-                    << std::endl;
+          std::cout << "ZMQ: Connection successful with " << address;
+          if (sink.nof_samples() > 0) {
+            std::cout << "\nReceiving " << sink.nof_samples() << " samples...";
+          }
+          std::cout << "\n(Patiencee...)" << std::endl;
           is_connected = true;
         }
 
@@ -47,11 +45,12 @@ uuagent_error_e RF_ZMQ::collect_iq_data(const all_args_t& args) {
           continue; // Ignoring empty packets/messages
         }
 
-        // Lets get a typed pointer to the message's raw data
+        // Lets get a typed pointer to the message's raw data and hand it to the sink
         const auto* data_ptr = static_cast<const std::complex<float>*>(message.data());
-
-        // Append the samples from this message to our main buffeer
-        iq_buffer.insert(iq_buffer.end(), data_ptr, data_ptr + samples_in_msg);
+        if (!sink.write(data_ptr, samples_in_msg)) {
+          std::cerr << "Failed to write samples to " << args.rf.output_file << std::endl;
+          return UUAGENT_FILE_ERROR;
+        }
 
         samples_collected += samples_in_msg;
 
@@ -66,20 +65,7 @@ uuagent_error_e RF_ZMQ::collect_iq_data(const all_args_t& args) {
       }
     }
 
-    // Finally, lets save the IQ from our buffer to the file
-    std::ofstream outfile(args.rf.output_file, std::ios::binary);
-    if (!outfile) {
-      std::cerr << "Failed to open output file: " << args.rf.output_file << std::endl;
-      return UUAGENT_FILE_ERROR;
-    }
-
-    // Lets write exactly the number of samples that is requested
-    outfile.write(reinterpret_cast<const char*>(iq_buffer.data()),
-                  args.rf.num_samples * sizeof(std::complex<float>));
-    outfile.close();
-
-    std::cout << "ZMQ: Saved " << args.rf.num_samples << " samples to "
-              << args.rf.output_file << std::endl;
+    std::cout << "ZMQ: Received " << samples_collected << " samples" << std::endl;
     
     return UUAGENT_SUCCESS;
 
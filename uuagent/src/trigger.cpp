@@ -0,0 +1,223 @@
+#include "trigger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+EnergyDetector::EnergyDetector(size_t window_len_, float threshold_dbfs_)
+    : window_sz(std::max<size_t>(window_len_, 1)),
+      threshold_dbfs(threshold_dbfs_) {}
+
+bool EnergyDetector::detect(const std::complex<float> *window,
+                            std::string &metric) {
+  // SIMD average power over the whole window
+  const cf_t *cf_window = reinterpret_cast<const cf_t *>(window);
+  float power_dbfs = srsran_convert_power_to_dB(
+      srsran_vec_avg_power_cf(cf_window, (uint32_t)window_sz));
+
+  if (power_dbfs < threshold_dbfs) {
+    return false;
+  }
+
+  std::ostringstream os;
+  os << "power=" << power_dbfs << "dBFS";
+  metric = os.str();
+  return true;
+}
+
+SsbDetector::SsbDetector() {}
+
+SsbDetector::~SsbDetector() {
+  if (initialized) {
+    srsran_ssb_free(&ssb);
+  }
+}
+
+static srsran_ssb_pattern_t ssb_pattern_from_string(const std::string &pattern) {
+  if (pattern == "A") return SRSRAN_SSB_PATTERN_A;
+  if (pattern == "B") return SRSRAN_SSB_PATTERN_B;
+  if (pattern == "D") return SRSRAN_SSB_PATTERN_D;
+  if (pattern == "E") return SRSRAN_SSB_PATTERN_E;
+  return SRSRAN_SSB_PATTERN_C;
+}
+
+bool SsbDetector::init(const all_args_t &args) {
+  srsran_ssb_args_t ssb_args = {};
+  ssb_args.max_srate_hz = args.rf.srate_hz;
+  ssb_args.min_scs = srsran_subcarrier_spacing_15kHz;
+  ssb_args.enable_search = true;
+  ssb_args.enable_measure = true;
+  if (srsran_ssb_init(&ssb, &ssb_args) != SRSRAN_SUCCESS) {
+    std::cerr << "Error initializing SSB detector" << std::endl;
+    return false;
+  }
+  initialized = true;
+
+  srsran_ssb_cfg_t ssb_cfg = {};
+  ssb_cfg.srate_hz = args.rf.srate_hz;
+  ssb_cfg.center_freq_hz = args.rf.rx_freq;
+  ssb_cfg.ssb_freq_hz =
+      args.trigger.ssb_freq > 0 ? args.trigger.ssb_freq : args.rf.rx_freq;
+  ssb_cfg.scs = args.trigger.ssb_scs_khz == 15
+                    ? srsran_subcarrier_spacing_15kHz
+                    : srsran_subcarrier_spacing_30kHz;
+  ssb_cfg.pattern = ssb_pattern_from_string(args.trigger.ssb_pattern);
+  ssb_cfg.duplex_mode = SRSRAN_DUPLEX_MODE_FDD;
+  ssb_cfg.periodicity_ms = 20;
+  if (srsran_ssb_set_cfg(&ssb, &ssb_cfg) != SRSRAN_SUCCESS) {
+    std::cerr << "Error configuring SSB detector" << std::endl;
+    return false;
+  }
+
+  // Consecutive windows overlap by one SSB, so the PSS search regions tile the
+  // stream with a hop of one subframe
+  window_sz = ssb.sf_sz + ssb.ssb_sz;
+  snr_thr_db = args.trigger.ssb_snr_thr_db;
+  pci = args.trigger.ssb_pci;
+  return true;
+}
+
+bool SsbDetector::detect(const std::complex<float> *window,
+                         std::string &metric) {
+  uint32_t N_id = 0;
+  srsran_csi_trs_measurements_t meas = {};
+  const cf_t *cf_window = reinterpret_cast<const cf_t *>(window);
+  if (srsran_ssb_csi_search(&ssb, cf_window, (uint32_t)window_sz, &N_id,
+                            &meas) < SRSRAN_SUCCESS) {
+    return false;
+  }
+
+  // No SSB fully contained in the window
+  if (meas.nof_re == 0) {
+    return false;
+  }
+
+  if (meas.snr_dB < snr_thr_db || (pci >= 0 && N_id != (uint32_t)pci)) {
+    return false;
+  }
+
+  std::ostringstream os;
+  os << "pci=" << N_id << " snr=" << meas.snr_dB
+     << "dB rsrp=" << meas.rsrp_dB << "dB cfo=" << meas.cfo_hz << "Hz";
+  metric = os.str();
+  return true;
+}
+
+TriggerSink::TriggerSink(const all_args_t &args,
+                         std::unique_ptr<TriggerDetector> detector_)
+    : detector(std::move(detector_)), output_file(args.rf.output_file),
+      srate_hz(args.rf.srate_hz), max_events(args.trigger.max_events),
+      ring(std::max<size_t>(
+          (size_t)std::round(args.trigger.pre_trigger_ms * 1e-3 * args.rf.srate_hz), 1)),
+      window(detector->window_len()),
+      post_len((size_t)std::round(args.trigger.post_trigger_ms * 1e-3 *
+                                   args.rf.srate_hz)) {}
+
+void TriggerSink::ring_push(const std::complex<float> *samples,
+                            size_t nsamples) {
+  // Only the last ring.size() samples can survive
+  if (nsamples > ring.size()) {
+    samples += nsamples - ring.size();
+    nsamples = ring.size();
+  }
+
+  size_t first = std::min(nsamples, ring.size() - ring_wr);
+  std::memcpy(&ring[ring_wr], samples, first * sizeof(std::complex<float>));
+  std::memcpy(&ring[0], samples + first,
+              (nsamples - first) * sizeof(std::complex<float>));
+
+  ring_wr = (ring_wr + nsamples) % ring.size();
+  ring_fill = std::min(ring_fill + nsamples, ring.size());
+}
+
+std::string TriggerSink::event_filename(uint32_t event_idx) const {
+  std::string base = output_file;
+  std::string ext;
+  size_t dot = output_file.find_last_of('.');
+  size_t slash = output_file.find_last_of('/');
+  if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+    base = output_file.substr(0, dot);
+    ext = output_file.substr(dot);
+  }
+  return base + "_trig" + std::to_string(event_idx) + ext;
+}
+
+bool TriggerSink::start_event(const std::string &metric) {
+  std::string filename = event_filename(nof_events);
+  event_file.open(filename, std::ios::binary);
+  if (!event_file) {
+    std::cerr << "failed to open trigger output file: " << filename
+              << std::endl;
+    return false;
+  }
+
+  std::cout << "Trigger " << nof_events << " at sample " << stream_pos << " ("
+            << stream_pos / srate_hz << "s): " << metric << " -> " << filename
+            << std::endl;
+
+  // Flush the pre-trigger ring, oldest sample first
+  size_t start = (ring_wr + ring.size() - ring_fill) % ring.size();
+  size_t first = std::min(ring_fill, ring.size() - start);
+  event_file.write(reinterpret_cast<const char *>(&ring[start]),
+                   first * sizeof(std::complex<float>));
+  event_file.write(reinterpret_cast<const char *>(&ring[0]),
+                   (ring_fill - first) * sizeof(std::complex<float>));
+
+  post_remaining = post_len;
+  return event_file.good();
+}
+
+bool TriggerSink::write(const std::complex<float> *samples, size_t nsamples) {
+  size_t i = 0;
+  while (i < nsamples && !done()) {
+    if (event_file.is_open()) {
+      // Post-trigger capture
+      size_t n = std::min(nsamples - i, post_remaining);
+      event_file.write(reinterpret_cast<const char *>(samples + i),
+                       n * sizeof(std::complex<float>));
+      ring_push(samples + i, n);
+      post_remaining -= n;
+      stream_pos += n;
+      i += n;
+
+      if (post_remaining == 0) {
+        bool ok = event_file.good();
+        event_file.close();
+        nof_events++;
+        window_fill = 0;
+        if (!ok) {
+          return false;
+        }
+      }
+      continue;
+    }
+
+    // Armed: fill the detection window, never crossing its end
+    size_t n = std::min(nsamples - i, window.size() - window_fill);
+    std::memcpy(&window[window_fill], samples + i,
+                n * sizeof(std::complex<float>));
+    ring_push(samples + i, n);
+    window_fill += n;
+    stream_pos += n;
+    i += n;
+
+    if (window_fill < window.size()) {
+      continue;
+    }
+
+    std::string metric;
+    bool fired = detector->detect(window.data(), metric);
+
+    // Keep the overlapping tail for the next window
+    size_t overlap = std::min(detector->overlap_len(), window.size() - 1);
+    std::memmove(&window[0], &window[window.size() - overlap],
+                 overlap * sizeof(std::complex<float>));
+    window_fill = overlap;
+
+    if (fired && !start_event(metric)) {
+      return false;
+    }
+  }
+  return true;
+}
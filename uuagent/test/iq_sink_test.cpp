@@ -0,0 +1,73 @@
+#include "iq_sink.h"
+#include "srsran/common/test_common.h"
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+
+static std::string output = "iq_sink_test.bin";
+
+static void usage(const char *prog) {
+  std::cout << "Usage: " << prog << " [o]" << std::endl;
+  std::cout << "\t-o output file [default " << output << "]" << std::endl;
+}
+
+static void parse_args(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "o")) != -1) {
+    switch (opt) {
+    case 'o':
+      output = argv[optind];
+      break;
+    default:
+      usage(argv[0]);
+      exit(-1);
+    }
+  }
+}
+
+// fc32 samples, as delivered by the ZMQ and shared-memory backends, must land
+// in an sc16 capture file as sc16
+static int test_sc16_from_fc32() {
+  const size_t nof_samples = 1000;
+
+  rf_args_t args = {};
+  args.output_file = output;
+  args.output_format = "sc16";
+  args.num_samples = nof_samples;
+
+  std::vector<std::complex<float>> samples(nof_samples + 100);
+  for (size_t i = 0; i < samples.size(); i++) {
+    samples[i] = {(float)i / samples.size(), -(float)i / samples.size()};
+  }
+
+  {
+    FileSink sink(args);
+    TESTASSERT(sink.is_open());
+    TESTASSERT(sink.write(samples.data(), 333));
+    TESTASSERT(sink.write(samples.data() + 333, samples.size() - 333));
+    TESTASSERT(sink.done());
+  }
+
+  std::ifstream in(output, std::ios::binary | std::ios::ate);
+  TESTASSERT(in.tellg() ==
+             (std::streamoff)(nof_samples * sizeof(std::complex<int16_t>)));
+  in.seekg(0);
+
+  std::vector<std::complex<int16_t>> read(nof_samples);
+  TESTASSERT(in.read(reinterpret_cast<char *>(read.data()),
+                     read.size() * sizeof(std::complex<int16_t>)));
+  for (size_t i = 0; i < nof_samples; i++) {
+    TESTASSERT(std::abs(read[i].real() - samples[i].real() * 32767) <= 1.0f);
+    TESTASSERT(std::abs(read[i].imag() - samples[i].imag() * 32767) <= 1.0f);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+  parse_args(argc, argv);
+
+  TESTASSERT_SUCCESS(test_sc16_from_fc32());
+
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,95 @@
+#include "psd.h"
+#include "srsran/common/test_common.h"
+#include <cmath>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+
+static std::string output = "psd_test.bin";
+
+static void usage(const char *prog) {
+  std::cout << "Usage: " << prog << " [o]" << std::endl;
+  std::cout << "\t-o output file [default " << output << "]" << std::endl;
+}
+
+static void parse_args(int argc, char **argv) {
+  int opt;
+  while ((opt = getopt(argc, argv, "o")) != -1) {
+    switch (opt) {
+    case 'o':
+      output = argv[optind];
+      break;
+    default:
+      usage(argv[0]);
+      exit(-1);
+    }
+  }
+}
+
+// A full-scale tone on a bin center must report the same power in the average,
+// the max-hold and the median, whatever the FFT size
+static int test_full_scale_tone(uint32_t fft_size) {
+  const uint32_t nof_frames = 16;
+  const int32_t tone_bin = 37;
+
+  all_args_t args = {};
+  args.rf.srate_hz = 1e6;
+  args.rf.rx_freq = 1e9;
+  args.psd.fft_size = fft_size;
+  args.psd.interval_ms = 1e3 * nof_frames * fft_size / args.rf.srate_hz;
+  args.psd.percentiles = "50";
+  args.psd.output = output;
+
+  {
+    PsdSink sink;
+    TESTASSERT(sink.init(args));
+
+    std::vector<std::complex<float>> tone(fft_size);
+    for (uint32_t i = 0; i < fft_size; i++) {
+      tone[i] = std::polar(1.0f, (float)(2.0 * M_PI * tone_bin * i / fft_size));
+    }
+    for (uint32_t n = 0; n < nof_frames; n++) {
+      TESTASSERT(sink.write(tone.data(), tone.size()));
+    }
+    TESTASSERT(sink.flush());
+  }
+
+  std::ifstream in(output, std::ios::binary);
+  psd_record_header_t header = {};
+  TESTASSERT(in.read(reinterpret_cast<char *>(&header), sizeof(header)));
+  TESTASSERT(header.nof_bins == fft_size);
+  TESTASSERT(header.nof_percentiles == 1);
+  TESTASSERT(header.nof_frames == nof_frames);
+
+  float percentile = 0.0f;
+  std::vector<float> record(3 * fft_size);
+  TESTASSERT(in.read(reinterpret_cast<char *>(&percentile), sizeof(float)));
+  TESTASSERT(in.read(reinterpret_cast<char *>(record.data()),
+                     record.size() * sizeof(float)));
+
+  // DC is in the center of the record
+  uint32_t k = fft_size / 2 + tone_bin;
+  float avg_db = record[k];
+  float max_db = record[fft_size + k];
+  float p50_db = record[2 * fft_size + k];
+  std::cout << "fft_size=" << fft_size << " avg=" << avg_db
+            << " max=" << max_db << " p50=" << p50_db << " dBFS" << std::endl;
+
+  // The Hann window loses 10*log10(1.5) dB for a tone on a bin center
+  TESTASSERT(std::abs(avg_db + 1.76f) < 0.1f);
+  TESTASSERT(std::abs(max_db - avg_db) < 0.1f);
+
+  // Histogram buckets have a ~0.5 dB resolution
+  TESTASSERT(std::abs(p50_db - avg_db) < 0.5f);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+  parse_args(argc, argv);
+
+  TESTASSERT_SUCCESS(test_full_scale_tone(1024));
+  TESTASSERT_SUCCESS(test_full_scale_tone(8192));
+
+  return SRSRAN_SUCCESS;
+}